@@ -1,4 +1,4 @@
-QT += core gui widgets network
+QT += core gui widgets network concurrent
 
 CONFIG += c++17
 
@@ -14,17 +14,45 @@ SOURCES += \
     $$SRCDIR/models/Automaton/State.cpp \
     $$SRCDIR/models/Automaton/Transition.cpp \
     $$SRCDIR/models/Automaton/Automaton.cpp \
+    $$SRCDIR/models/Automaton/AutomatonLayout.cpp \
+    $$SRCDIR/models/Automaton/AutomatonHistory.cpp \
     $$SRCDIR/models/Grammar/Grammar.cpp \
     $$SRCDIR/ui/MainWindow.cpp \
     $$SRCDIR/ui/Automaton/AutomatonCanvas.cpp \
     $$SRCDIR/utils/Automaton/NFAtoDFA.cpp \
     $$SRCDIR/utils/Automaton/DFAMinimizer.cpp \
+    $$SRCDIR/utils/Automaton/CompiledDFA.cpp \
+    $$SRCDIR/utils/Automaton/BigInteger.cpp \
+    $$SRCDIR/utils/Automaton/LanguageCounter.cpp \
+    $$SRCDIR/utils/Automaton/ExecutionTrace.cpp \
+    $$SRCDIR/utils/Automaton/ApproximateMatcher.cpp \
+    $$SRCDIR/utils/Automaton/LanguageEnumerator.cpp \
+    $$SRCDIR/utils/Automaton/StateLayout.cpp \
+    $$SRCDIR/utils/Automaton/DFABenchmark.cpp \
+    $$SRCDIR/utils/Automaton/CompressedTable.cpp \
+    $$SRCDIR/utils/Automaton/ShuffleTable.cpp \
+    $$SRCDIR/utils/Automaton/DFACanonicalizer.cpp \
+    $$SRCDIR/utils/Automaton/RegexParser.cpp \
+    $$SRCDIR/utils/Automaton/GlushkovAutomaton.cpp \
+    $$SRCDIR/utils/Automaton/ExternalSubsetConstruction.cpp \
+    $$SRCDIR/utils/Automaton/AutomatonRegistry.cpp \
     $$SRCDIR/utils/Grammar/Parser.cpp \
+    $$SRCDIR/utils/Grammar/GrammarAnalyzer.cpp \
+    $$SRCDIR/utils/Grammar/IncrementalGrammarAnalyzer.cpp \
+    $$SRCDIR/utils/Grammar/ParserGenerator.cpp \
+    $$SRCDIR/utils/Grammar/TerminalBinding.cpp \
+    $$SRCDIR/utils/Grammar/AdaptiveParser.cpp \
     $$SRCDIR/utils/Semantic/SemanticAnalyzer.cpp \
     $$SRCDIR/utils/Semantic/CodeGenerator.cpp \
+    $$SRCDIR/utils/Semantic/LoopVectorizer.cpp \
+    $$SRCDIR/utils/Semantic/InstructionScheduler.cpp \
+    $$SRCDIR/utils/Semantic/ScheduleBenchmark.cpp \
+    $$SRCDIR/utils/Semantic/ProgramProfile.cpp \
+    $$SRCDIR/utils/Semantic/ParallelFrontEnd.cpp \
     $$SRCDIR/models/Grammar/ParseTree.cpp \
     $$SRCDIR/models/Grammar/Production.cpp \
     $$SRCDIR/models/LexicalAnalysis/Token.cpp \
+    $$SRCDIR/models/Semantic/SymbolEnvironment.cpp \
     $$SRCDIR/models/Semantic/SymbolTable.cpp \
     $$SRCDIR/ui/Grammar/ParseTreeWidget.cpp \
     $$SRCDIR/ui/Grammar/ParserWidget.cpp \
@@ -38,17 +66,46 @@ HEADERS += \
     $$SRCDIR/models/Automaton/State.h \
     $$SRCDIR/models/Automaton/Transition.h \
     $$SRCDIR/models/Automaton/Automaton.h \
+    $$SRCDIR/models/Automaton/AutomatonLayout.h \
+    $$SRCDIR/models/Automaton/AutomatonHistory.h \
     $$SRCDIR/models/Grammar/Grammar.h \
     $$SRCDIR/ui/MainWindow.h \
     $$SRCDIR/ui/Automaton/AutomatonCanvas.h \
     $$SRCDIR/utils/Automaton/NFAtoDFA.h \
     $$SRCDIR/utils/Automaton/DFAMinimizer.h \
+    $$SRCDIR/utils/Automaton/CompiledDFA.h \
+    $$SRCDIR/utils/Automaton/BigInteger.h \
+    $$SRCDIR/utils/Automaton/LanguageCounter.h \
+    $$SRCDIR/utils/Automaton/ExecutionTrace.h \
+    $$SRCDIR/utils/Automaton/ApproximateMatcher.h \
+    $$SRCDIR/utils/Automaton/LanguageEnumerator.h \
+    $$SRCDIR/utils/Automaton/StateLayout.h \
+    $$SRCDIR/utils/Automaton/DFABenchmark.h \
+    $$SRCDIR/utils/Automaton/CompressedTable.h \
+    $$SRCDIR/utils/Automaton/ShuffleTable.h \
+    $$SRCDIR/utils/Automaton/DFACanonicalizer.h \
+    $$SRCDIR/utils/Automaton/RegexParser.h \
+    $$SRCDIR/utils/Automaton/GlushkovAutomaton.h \
+    $$SRCDIR/utils/Automaton/ExternalSubsetConstruction.h \
+    $$SRCDIR/utils/Automaton/AutomatonRegistry.h \
+    $$SRCDIR/utils/Xorshift32.h \
     $$SRCDIR/utils/Semantic/SemanticAnalyzer.h \
     $$SRCDIR/utils/Semantic/CodeGenerator.h \
+    $$SRCDIR/utils/Semantic/LoopVectorizer.h \
+    $$SRCDIR/utils/Semantic/InstructionScheduler.h \
+    $$SRCDIR/utils/Semantic/ScheduleBenchmark.h \
+    $$SRCDIR/utils/Semantic/ProgramProfile.h \
+    $$SRCDIR/utils/Semantic/ParallelFrontEnd.h \
     $$SRCDIR/utils/Grammar/Parser.h \
+    $$SRCDIR/utils/Grammar/GrammarAnalyzer.h \
+    $$SRCDIR/utils/Grammar/IncrementalGrammarAnalyzer.h \
+    $$SRCDIR/utils/Grammar/ParserGenerator.h \
+    $$SRCDIR/utils/Grammar/TerminalBinding.h \
+    $$SRCDIR/utils/Grammar/AdaptiveParser.h \
     $$SRCDIR/models/Grammar/ParseTree.h \
     $$SRCDIR/models/Grammar/Production.h \
     $$SRCDIR/models/LexicalAnalysis/Token.h \
+    $$SRCDIR/models/Semantic/SymbolEnvironment.h \
     $$SRCDIR/models/Semantic/SymbolTable.h \
     $$SRCDIR/ui/Grammar/ParseTreeWidget.h \
     $$SRCDIR/ui/Grammar/ParserWidget.h \
@@ -65,12 +122,50 @@ INCLUDEPATH += \
     $$SRCDIR/utils \
     $$SRCDIR/ml_translator
 
+# Fixed grammars are compiled into direct-coded recursive-descent parsers
+# (grammars/Foo.grammar -> FooParser.h/.cpp) by tools/grammar2cpp
+GRAMMAR2CPP_DIR = $$OUT_PWD/grammar2cpp
+win32: GRAMMAR2CPP = $$GRAMMAR2CPP_DIR/release/grammar2cpp.exe
+else: GRAMMAR2CPP = $$GRAMMAR2CPP_DIR/grammar2cpp
+
+grammar2cpp.target = $$GRAMMAR2CPP
+grammar2cpp.commands = $$QMAKE_MKDIR $$shell_path($$GRAMMAR2CPP_DIR) $$escape_expand(\\n\\t) \
+    cd $$shell_path($$GRAMMAR2CPP_DIR) && $$QMAKE_QMAKE $$shell_path($$PWD/tools/grammar2cpp/grammar2cpp.pro) && $(MAKE)
+grammar2cpp.depends = $$PWD/tools/grammar2cpp/main.cpp $$SRCDIR/utils/Grammar/ParserGenerator.cpp $$SRCDIR/utils/Grammar/GrammarAnalyzer.cpp $$SRCDIR/utils/Grammar/TerminalBinding.cpp
+QMAKE_EXTRA_TARGETS += grammar2cpp
+
+GRAMMARS += \
+    $$SRCDIR/grammars/Expression.grammar
+
+grammar_header.input = GRAMMARS
+grammar_header.output = $$OUT_PWD/generated/${QMAKE_FILE_BASE}Parser.h
+grammar_header.commands = $$GRAMMAR2CPP --header ${QMAKE_FILE_NAME} ${QMAKE_FILE_OUT}
+grammar_header.depends = $$GRAMMAR2CPP
+grammar_header.variable_out = HEADERS
+grammar_header.CONFIG += target_predeps no_link
+QMAKE_EXTRA_COMPILERS += grammar_header
+
+grammar_source.input = GRAMMARS
+grammar_source.output = $$OUT_PWD/generated/${QMAKE_FILE_BASE}Parser.cpp
+grammar_source.commands = $$GRAMMAR2CPP --source ${QMAKE_FILE_NAME} ${QMAKE_FILE_OUT}
+grammar_source.depends = $$GRAMMAR2CPP
+grammar_source.variable_out = GENERATED_SOURCES
+QMAKE_EXTRA_COMPILERS += grammar_source
+
+INCLUDEPATH += $$OUT_PWD/generated
+
 
 OTHER_FILES += \
+    $$SRCDIR/grammars/Expression.grammar \
+    $$PWD/tools/grammar2cpp/grammar2cpp.pro \
+    $$PWD/tools/compilerc/compilerc.pro \
+    $$PWD/tools/frontendcheck/frontendcheck.pro \
+    $$PWD/tools/mlload/mlload.pro \
     $$SRCDIR/ml_translator/__init__.py \
     $$SRCDIR/ml_translator/app.py \
     $$SRCDIR/ml_translator/config.py \
     $$SRCDIR/ml_translator/requirements.txt \
+    $$SRCDIR/ml_translator/stand_in_server.py \
     $$SRCDIR/ml_translator/start_server.py \
     $$SRCDIR/ml_translator/models/__init__.py \
     $$SRCDIR/ml_translator/models/base_model.py \
@@ -108,6 +108,10 @@ def validate_translation_request(data):
     if "tokens" in data and not isinstance(data["tokens"], list):
         errors.append("tokens must be a list if provided")
 
+    # A rule-based translation the model verifies instead of generating from scratch
+    if "draft" in data and not isinstance(data["draft"], str):
+        errors.append("draft must be a string if provided")
+
     return errors
 
 @app.route('/health', methods=['GET'])
@@ -146,6 +150,7 @@ def translate_code():
         source_code = data["source_code"]
         target_language = data["target_language"].lower()
         tokens = data.get("tokens", [])
+        draft = data.get("draft") or None
 
         logger.info(f"Translation request: C++ -> {target_language}")
         logger.debug(f"Source code length: {len(source_code)} characters")
@@ -165,7 +170,7 @@ def translate_code():
 
         # Perform ML translation
         logger.info(f"Translating to {target_language}...")
-        translated = translator.translate(processed_input, target_language)
+        translated = translator.translate(processed_input, target_language, draft=draft)
 
         if not translated:
             return format_error_response(
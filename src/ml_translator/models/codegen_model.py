@@ -14,6 +14,7 @@ from .base_model import BaseTranslationModel
 try:
     import torch
     from transformers import AutoTokenizer, AutoModelForCausalLM
+    from transformers import LogitsProcessorList, NoRepeatNGramLogitsProcessor, RepetitionPenaltyLogitsProcessor
     TRANSFORMERS_AVAILABLE = True
 except ImportError:
     TRANSFORMERS_AVAILABLE = False
@@ -47,6 +48,13 @@ class CodeGenModel(BaseTranslationModel):
         self.repetition_penalty = 1.2  # Add repetition penalty
         self.no_repeat_ngram_size = 3   # Add n-gram repetition prevention
 
+        # Draft-assisted decoding: a rule-based translation proposes the next
+        # tokens and one forward pass verifies them all
+        self.use_draft_decoding = True
+        self.draft_tokens = 10          # candidates verified per forward pass
+        self.draft_ngram_size = 3       # longest output suffix looked up in the draft
+        self.last_decoding_stats = {}
+
         # Language-specific prompts
         self.translation_prompts = {
             "python": "Translate the following C++ code to Python:\n\nC++:\n{code}\n\nPython:\n",
@@ -130,8 +138,12 @@ class CodeGenModel(BaseTranslationModel):
             self._init_fallback_mode()
             return True
 
-    def translate(self, source_code: str, target_language: str) -> str:
-        """Translate C++ code to target language."""
+    def translate(self, source_code: str, target_language: str, draft: Optional[str] = None) -> str:
+        """Translate C++ code to target language.
+
+        draft is a plausible translation, e.g. from the rule-based generator,
+        used to speed up decoding; the rule-based fallback is used when omitted.
+        """
         if not self.is_initialized:
             raise RuntimeError("Model not initialized. Call load_model() first.")
 
@@ -145,9 +157,9 @@ class CodeGenModel(BaseTranslationModel):
             return self._fallback_translate(source_code, target_language)
 
         # Use ML model
-        return self._ml_translate(source_code, target_language)
+        return self._ml_translate(source_code, target_language, draft)
 
-    def _ml_translate(self, source_code: str, target_language: str) -> str:
+    def _ml_translate(self, source_code: str, target_language: str, draft: Optional[str] = None) -> str:
         """Translate using the actual ML model."""
         try:
             # Create prompt
@@ -159,22 +171,17 @@ class CodeGenModel(BaseTranslationModel):
             attention_mask = inputs.ne(self.tokenizer.pad_token_id).to(self.device)
             inputs = inputs.to(self.device)
 
-            # Generate translation with anti-repetition measures
-            with torch.no_grad():
-                outputs = self.model.generate(
-                    inputs,
-                    attention_mask=attention_mask,  # Add attention mask
-                    max_new_tokens=min(256, self.max_length - len(inputs[0])),  # Reduced max tokens
-                    temperature=self.temperature,
-                    top_p=self.top_p,
-                    top_k=self.top_k,
-                    do_sample=True,
-                    pad_token_id=self.tokenizer.pad_token_id,
-                    eos_token_id=self.tokenizer.eos_token_id,
-                    num_return_sequences=1,
-                    repetition_penalty=getattr(self, 'repetition_penalty', 1.2),
-                    no_repeat_ngram_size=getattr(self, 'no_repeat_ngram_size', 3)
-                )
+            max_new_tokens = min(256, self.max_length - len(inputs[0]))
+            if self.use_draft_decoding:
+                if not draft:
+                    draft = self._rule_based_translate(source_code, target_language)
+                draft_ids = self.tokenizer.encode(draft)
+                with torch.no_grad():
+                    outputs = self._draft_assisted_generate(inputs, draft_ids, max_new_tokens)
+            else:
+                # Generate translation with anti-repetition measures
+                with torch.no_grad():
+                    outputs = self._sample_generate(inputs, attention_mask, max_new_tokens)
 
             # Decode the generated text
             generated_text = self.tokenizer.decode(outputs[0], skip_special_tokens=True)
@@ -202,11 +209,129 @@ class CodeGenModel(BaseTranslationModel):
             # Fallback to rule-based translation
             return self._fallback_translate(source_code, target_language)
 
+    def _sample_generate(self, inputs, attention_mask, max_new_tokens: int):
+        """Sampled generation, used when draft-assisted decoding is off."""
+        return self.model.generate(
+            inputs,
+            attention_mask=attention_mask,  # Add attention mask
+            max_new_tokens=max_new_tokens,  # Reduced max tokens
+            temperature=self.temperature,
+            top_p=self.top_p,
+            top_k=self.top_k,
+            do_sample=True,
+            pad_token_id=self.tokenizer.pad_token_id,
+            eos_token_id=self.tokenizer.eos_token_id,
+            num_return_sequences=1,
+            repetition_penalty=getattr(self, 'repetition_penalty', 1.2),
+            no_repeat_ngram_size=getattr(self, 'no_repeat_ngram_size', 3)
+        )
+
+    def _draft_assisted_generate(self, inputs, draft_ids: List[int], max_new_tokens: int):
+        """
+        Greedy decoding that verifies draft tokens instead of generating them one by one.
+
+        Each step feeds the tokens not yet in the KV cache plus up to
+        draft_tokens candidates copied from the draft, where the draft continues
+        the output's latest n-gram (prompt lookup over the draft). The model's
+        choices at every fed position come out of that single forward pass: the
+        candidates are accepted up to the first disagreement, and the model's
+        own token at that position is appended. The output is exactly what
+        greedy generate() with the same repetition processors would produce;
+        only the number of sequential forward passes changes. Sampling is not
+        used on this path, since verifying sampled tokens is not exact.
+        """
+        processors = LogitsProcessorList()
+        if self.repetition_penalty and self.repetition_penalty != 1.0:
+            processors.append(RepetitionPenaltyLogitsProcessor(self.repetition_penalty))
+        if self.no_repeat_ngram_size:
+            processors.append(NoRepeatNGramLogitsProcessor(self.no_repeat_ngram_size))
+
+        eos_token_id = self.tokenizer.eos_token_id
+        sequence = inputs[0].tolist()
+        prompt_length = len(sequence)
+        pending = sequence[:]           # tokens the cache has not seen yet
+        past_key_values = None
+        cursor = 0
+        forward_passes = 0
+        accepted_total = 0
+
+        while len(sequence) - prompt_length < max_new_tokens:
+            generated = sequence[prompt_length:]
+            room = max_new_tokens - len(generated) - 1
+            candidates, cursor = self._draft_candidates(generated, draft_ids, cursor, min(self.draft_tokens, room))
+
+            feed = torch.tensor([pending + candidates], dtype=torch.long, device=self.device)
+            outputs = self.model(feed, past_key_values=past_key_values, use_cache=True)
+            forward_passes += 1
+            cached_length = len(sequence) - len(pending)
+
+            # Logits after the last pending token predict the first candidate, and so on
+            logits = outputs.logits[0, len(pending) - 1:, :]
+            accepted = 0
+            for position in range(len(candidates) + 1):
+                prefix = torch.tensor([sequence + candidates[:position]], dtype=torch.long, device=self.device)
+                scores = processors(prefix, logits[position:position + 1].float())
+                token = int(scores.argmax(dim=-1))
+                if position == len(candidates) or token != candidates[position]:
+                    break
+                accepted += 1
+
+            new_tokens = candidates[:accepted] + [token]
+            accepted_total += accepted
+            if eos_token_id is not None and eos_token_id in new_tokens:
+                sequence += new_tokens[:new_tokens.index(eos_token_id) + 1]
+                break
+            sequence += new_tokens
+
+            # The cache holds every fed token; keep the accepted ones only
+            past_key_values = self._crop_cache(outputs.past_key_values,
+                                               cached_length + len(pending) + accepted)
+            pending = [token]
+
+        generated_count = len(sequence) - prompt_length
+        self.last_decoding_stats = {
+            "generated_tokens": generated_count,
+            "forward_passes": forward_passes,
+            "accepted_draft_tokens": accepted_total,
+        }
+        logger.info(f"Draft-assisted decoding: {generated_count} tokens in {forward_passes} forward passes "
+                    f"({accepted_total} taken from the draft)")
+        return torch.tensor([sequence], dtype=torch.long)
+
+    def _draft_candidates(self, generated: List[int], draft_ids: List[int], cursor: int, count: int):
+        """Tokens that follow the output's latest n-gram in the draft, and the new draft cursor."""
+        if count <= 0 or not draft_ids:
+            return [], cursor
+        if not generated:
+            return draft_ids[:count], 0
+
+        # Longest suffix first; occurrences at or after the cursor keep the alignment moving forward
+        for n in range(min(self.draft_ngram_size, len(generated)), 0, -1):
+            suffix = generated[-n:]
+            last_start = len(draft_ids) - n
+            for start in list(range(cursor, last_start + 1)) + list(range(0, min(cursor, last_start + 1))):
+                if draft_ids[start:start + n] == suffix:
+                    end = start + n
+                    return draft_ids[end:end + count], end
+        return [], cursor
+
+    @staticmethod
+    def _crop_cache(past_key_values, length: int):
+        """Drops cached positions from length on."""
+        if hasattr(past_key_values, "crop"):
+            past_key_values.crop(length)
+            return past_key_values
+        # Legacy tuple cache: (key, value) per layer, sequence on dimension -2
+        return tuple(tuple(tensor[..., :length, :] for tensor in layer) for layer in past_key_values)
+
     def _fallback_translate(self, source_code: str, target_language: str) -> str:
         """Fallback rule-based translation."""
         logger.info(f"Using fallback rule-based translation to {target_language}")
         self.set_confidence(0.6)  # Lower confidence for fallback
+        return self._rule_based_translate(source_code, target_language)
 
+    def _rule_based_translate(self, source_code: str, target_language: str) -> str:
+        """Rule-based translation; also the default draft for draft-assisted decoding."""
         if target_language == "python":
             return self._cpp_to_python_fallback(source_code)
         elif target_language == "java":
@@ -389,7 +514,9 @@ class CodeGenModel(BaseTranslationModel):
             "max_length": self.max_length,
             "temperature": self.temperature,
             "transformers_available": TRANSFORMERS_AVAILABLE,
-            "fallback_mode": getattr(self, 'fallback_mode', False)
+            "fallback_mode": getattr(self, 'fallback_mode', False),
+            "draft_decoding": self.use_draft_decoding,
+            "last_decoding_stats": self.last_decoding_stats
         })
 
         if self.model is not None:
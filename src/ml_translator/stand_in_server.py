@@ -0,0 +1,337 @@
+#!/usr/bin/env python3
+"""
+Deterministic stand-in for the ML translation server
+
+Implements the same HTTP interface as app.py (/health, /translate,
+/models/info) without loading a model, so MLTranslationBridge can be
+load-tested offline. Latency, failures, server-side batching and response
+caching are configurable; outputs depend only on the request.
+
+Only the standard library is used.
+
+Example:
+    python stand_in_server.py --port 5001 --latency lognormal:80,0.4 \
+        --workers 2 --batch-size 8 --batch-window-ms 10 --error-rate 0.01
+"""
+
+import argparse
+import hashlib
+import json
+import logging
+import math
+import random
+import threading
+import time
+from collections import deque
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+logger = logging.getLogger("stand-in")
+
+SUPPORTED_LANGUAGES = ["python", "java", "javascript", "assembly"]
+COMMENT_PREFIX = {"python": "#", "java": "//", "javascript": "//", "assembly": ";"}
+
+
+class LatencyModel:
+    """Samples model latency in milliseconds from a spec such as 'lognormal:80,0.4'.
+
+    Supported distributions:
+        fixed:MS
+        uniform:LOW,HIGH
+        normal:MEAN,STDDEV          (clamped at 0)
+        exponential:MEAN
+        lognormal:MEDIAN,SIGMA
+    """
+
+    def __init__(self, spec):
+        kind, _, params = spec.partition(":")
+        self.kind = kind.strip().lower()
+        self.params = [float(p) for p in params.split(",") if p.strip()]
+        expected = {"fixed": 1, "uniform": 2, "normal": 2, "exponential": 1, "lognormal": 2}
+        if self.kind not in expected or len(self.params) != expected[self.kind]:
+            raise ValueError(f"invalid latency spec '{spec}'")
+        self.spec = spec
+
+    def sample(self, rng):
+        p = self.params
+        if self.kind == "fixed":
+            return p[0]
+        if self.kind == "uniform":
+            return rng.uniform(p[0], p[1])
+        if self.kind == "normal":
+            return max(0.0, rng.gauss(p[0], p[1]))
+        if self.kind == "exponential":
+            return rng.expovariate(1.0 / p[0]) if p[0] > 0 else 0.0
+        return p[0] * math.exp(rng.gauss(0.0, p[1]))
+
+
+def translate(source_code, target_language):
+    """Deterministic pseudo-translation: the source as comments plus a digest line."""
+    prefix = COMMENT_PREFIX[target_language]
+    digest = hashlib.sha256(f"{target_language}\n{source_code}".encode()).hexdigest()[:16]
+    lines = [f"{prefix} stand-in translation to {target_language} ({digest})"]
+    lines += [f"{prefix} {line}" if line.strip() else "" for line in source_code.splitlines()]
+    return "\n".join(lines) + "\n"
+
+
+class PendingRequest:
+    def __init__(self, key, source_code, target_language):
+        self.key = key
+        self.source_code = source_code
+        self.target_language = target_language
+        self.done = threading.Event()
+        self.result = None
+
+
+class StandInModel:
+    """Model workers that serve queued requests in batches.
+
+    A worker takes the oldest request, waits up to batch_window_ms for more
+    (at most batch_size in total), then sleeps for one latency sample plus
+    per_item_ms for every request in the batch. With one worker and batch
+    size 1 requests are served strictly one at a time, like a single model
+    instance without batching.
+    """
+
+    def __init__(self, options):
+        self.options = options
+        self.latency = LatencyModel(options.latency)
+        self.queue = deque()
+        self.condition = threading.Condition()
+        self.cache = {}
+        self.cache_lock = threading.Lock()
+        self.rng = random.Random(options.seed)
+        self.rng_lock = threading.Lock()
+        self.seen = {}
+        self.stats = {
+            "requests": 0,
+            "translated": 0,
+            "cache_hits": 0,
+            "batches": 0,
+            "batched_requests": 0,
+            "injected_errors": 0,
+            "injected_hangs": 0,
+            "injected_malformed": 0,
+            "injected_drops": 0,
+        }
+        self.stats_lock = threading.Lock()
+        for index in range(options.workers):
+            threading.Thread(target=self._worker, name=f"model-{index}", daemon=True).start()
+
+    def count(self, name, amount=1):
+        with self.stats_lock:
+            self.stats[name] += amount
+
+    def snapshot(self):
+        with self.stats_lock:
+            stats = dict(self.stats)
+        stats["mean_batch_size"] = stats["batched_requests"] / stats["batches"] if stats["batches"] else 0.0
+        return stats
+
+    def request_rng(self, body):
+        """Random stream for one request, fixed by the seed, the body and how often it was seen."""
+        key = hashlib.sha256(body).hexdigest()
+        with self.rng_lock:
+            occurrence = self.seen.get(key, 0)
+            self.seen[key] = occurrence + 1
+        return random.Random(f"{self.options.seed}:{key}:{occurrence}")
+
+    def cached(self, key):
+        if not self.options.cache:
+            return None
+        with self.cache_lock:
+            return self.cache.get(key)
+
+    def submit(self, source_code, target_language):
+        """Queues a translation and blocks until a worker has served it."""
+        key = (target_language, source_code)
+        pending = PendingRequest(key, source_code, target_language)
+        with self.condition:
+            self.queue.append(pending)
+            self.condition.notify()
+        pending.done.wait()
+        return pending.result
+
+    def _take_batch(self):
+        with self.condition:
+            while not self.queue:
+                self.condition.wait()
+            batch = [self.queue.popleft()]
+            deadline = time.monotonic() + self.options.batch_window_ms / 1000.0
+            while len(batch) < self.options.batch_size:
+                if not self.queue:
+                    remaining = deadline - time.monotonic()
+                    if remaining <= 0:
+                        break
+                    self.condition.wait(remaining)
+                    continue
+                batch.append(self.queue.popleft())
+            return batch
+
+    def _worker(self):
+        while True:
+            batch = self._take_batch()
+            with self.rng_lock:
+                model_ms = self.latency.sample(self.rng)
+            model_ms += self.options.per_item_ms * len(batch)
+            model_ms += self.options.ms_per_kchar * sum(len(p.source_code) for p in batch) / 1000.0
+            time.sleep(model_ms / 1000.0)
+
+            for pending in batch:
+                pending.result = translate(pending.source_code, pending.target_language)
+                if self.options.cache:
+                    with self.cache_lock:
+                        self.cache[pending.key] = pending.result
+                pending.done.set()
+            self.count("batches")
+            self.count("batched_requests", len(batch))
+            self.count("translated", len(batch))
+
+
+def make_handler(model, options):
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def log_message(self, format, *args):
+            logger.debug("%s - %s", self.address_string(), format % args)
+
+        def send_json(self, payload, status=200):
+            body = json.dumps(payload).encode()
+            self.send_response(status)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def send_error_json(self, message, details=None, status=500):
+            payload = {"error": message, "success": False}
+            if details:
+                payload["details"] = details
+            self.send_json(payload, status)
+
+        def do_GET(self):
+            if self.path == "/health":
+                self.send_json({"status": "healthy", "models_loaded": True,
+                                "server": "ml-translator-stand-in", "version": "1.0.0"})
+            elif self.path == "/models/info":
+                self.send_json({"available_models": ["stand-in"], "current_model": "stand-in",
+                                "model_loaded": True, "supported_languages": SUPPORTED_LANGUAGES})
+            elif self.path == "/stats":
+                self.send_json(model.snapshot())
+            else:
+                self.send_error_json("Endpoint not found", status=404)
+
+        def do_POST(self):
+            if self.path != "/translate":
+                self.send_error_json("Endpoint not found", status=404)
+                return
+
+            length = int(self.headers.get("Content-Length", 0))
+            body = self.rfile.read(length)
+            model.count("requests")
+            try:
+                data = json.loads(body)
+                source_code = data["source_code"]
+                target_language = data["target_language"].lower()
+            except (ValueError, KeyError, AttributeError, TypeError):
+                self.send_error_json("Invalid JSON request", status=400)
+                return
+            if not source_code.strip() or target_language not in SUPPORTED_LANGUAGES:
+                self.send_error_json("Validation failed", "source_code and a supported target_language are required", 400)
+                return
+
+            # Failure injection, decided before the request reaches the model
+            rng = model.request_rng(body)
+            roll = rng.random()
+            if roll < options.drop_rate:
+                model.count("injected_drops")
+                self.close_connection = True
+                self.connection.close()
+                return
+            roll -= options.drop_rate
+            if roll < options.hang_rate:
+                model.count("injected_hangs")
+                time.sleep(options.hang_ms / 1000.0)
+                self.send_error_json("Injected hang", status=504)
+                return
+            roll -= options.hang_rate
+            if roll < options.error_rate:
+                model.count("injected_errors")
+                self.send_error_json("Translation failed", "injected failure", 500)
+                return
+            roll -= options.error_rate
+            if roll < options.malformed_rate:
+                model.count("injected_malformed")
+                garbage = b"{\"translated_code\": "
+                self.send_response(200)
+                self.send_header("Content-Type", "application/json")
+                self.send_header("Content-Length", str(len(garbage)))
+                self.end_headers()
+                self.wfile.write(garbage)
+                return
+
+            translated = model.cached((target_language, source_code))
+            if translated is not None:
+                model.count("cache_hits")
+                time.sleep(options.cache_hit_ms / 1000.0)
+            else:
+                translated = model.submit(source_code, target_language)
+
+            self.send_json({"translated_code": translated, "confidence": 1.0,
+                            "model_used": "stand-in", "validation": {"valid": True}, "success": True})
+
+    return Handler
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Deterministic stand-in ML translation server")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=5000)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--latency", default="fixed:50",
+                        help="model latency per batch: fixed:MS, uniform:LO,HI, normal:MEAN,SD, "
+                             "exponential:MEAN or lognormal:MEDIAN,SIGMA")
+    parser.add_argument("--per-item-ms", type=float, default=0.0, help="extra model time per request in a batch")
+    parser.add_argument("--ms-per-kchar", type=float, default=0.0, help="extra model time per 1000 source characters")
+    parser.add_argument("--workers", type=int, default=1, help="model instances serving batches in parallel")
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--batch-window-ms", type=float, default=0.0, help="how long a worker waits to fill a batch")
+    parser.add_argument("--cache", action="store_true", help="answer repeated requests from a response cache")
+    parser.add_argument("--cache-hit-ms", type=float, default=1.0)
+    parser.add_argument("--error-rate", type=float, default=0.0, help="share of requests answered with HTTP 500")
+    parser.add_argument("--hang-rate", type=float, default=0.0, help="share of requests held for --hang-ms")
+    parser.add_argument("--hang-ms", type=float, default=60000.0)
+    parser.add_argument("--malformed-rate", type=float, default=0.0, help="share of requests answered with broken JSON")
+    parser.add_argument("--drop-rate", type=float, default=0.0, help="share of connections closed without a response")
+    parser.add_argument("--log-level", default="INFO")
+    options = parser.parse_args()
+
+    LatencyModel(options.latency)   # validate early
+    if options.workers < 1 or options.batch_size < 1:
+        parser.error("--workers and --batch-size must be at least 1")
+    if options.drop_rate + options.hang_rate + options.error_rate + options.malformed_rate > 1.0:
+        parser.error("failure rates add up to more than 1")
+    return options
+
+
+def main():
+    options = parse_args()
+    logging.basicConfig(level=getattr(logging, options.log_level.upper(), logging.INFO),
+                        format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+
+    model = StandInModel(options)
+    server = ThreadingHTTPServer((options.host, options.port), make_handler(model, options))
+    server.daemon_threads = True
+    logger.info("Stand-in server on http://%s:%d (latency %s, %d worker(s), batch %d/%.0f ms, cache %s)",
+                options.host, options.port, options.latency, options.workers,
+                options.batch_size, options.batch_window_ms, "on" if options.cache else "off")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+        logger.info("Served: %s", json.dumps(model.snapshot()))
+
+
+if __name__ == "__main__":
+    main()
@@ -11,11 +11,10 @@ Automaton::Automaton(const QString& id, const QString& name, AutomatonType type)
 
 // State Management
 bool Automaton::addState(const State& state) {
-    for (const auto& s : states) {
-        if (s.getId() == state.getId()) {
-            return false;
-        }
+    if (stateIndex.contains(state.getId())) {
+        return false;
     }
+    stateIndex.insert(state.getId(), states.size());
     states.push_back(state);
 
     if (state.getIsInitial()) {
@@ -35,14 +34,14 @@ bool Automaton::removeState(const QString& stateId) {
         transitions.end()
         );
 
-    auto it = std::find_if(states.begin(), states.end(),
-                           [&stateId](const State& s) { return s.getId() == stateId; });
-
-    if (it != states.end()) {
+    int index = indexOfState(stateId);
+    if (index >= 0) {
         if (initialStateId == stateId) {
             initialStateId = "";
         }
-        states.erase(it);
+        states.remove(index);
+        layout.removeState(stateId);
+        rebuildStateIndex();
         return true;
     }
 
@@ -50,21 +49,20 @@ bool Automaton::removeState(const QString& stateId) {
 }
 
 State* Automaton::getState(const QString& stateId) {
-    for (auto& state : states) {
-        if (state.getId() == stateId) {
-            return &state;
-        }
-    }
-    return nullptr;
+    int index = indexOfState(stateId);
+    return index >= 0 ? &states[index] : nullptr;
 }
 
 const State* Automaton::getState(const QString& stateId) const {
-    for (const auto& state : states) {
-        if (state.getId() == stateId) {
-            return &state;
-        }
+    int index = indexOfState(stateId);
+    return index >= 0 ? &states[index] : nullptr;
+}
+
+void Automaton::rebuildStateIndex() {
+    stateIndex.clear();
+    for (int i = 0; i < states.size(); ++i) {
+        stateIndex.insert(states[i].getId(), i);
     }
-    return nullptr;
 }
 
 // Transition Management
@@ -185,6 +183,8 @@ void Automaton::setInitialState(const QString& stateId) {
     if (state) {
         state->setIsInitial(true);
         initialStateId = stateId;
+    } else {
+        initialStateId = "";
     }
 }
 
@@ -350,6 +350,8 @@ bool Automaton::acceptsNFA(const QString& input) const {
 
 void Automaton::clear() {
     states.clear();
+    stateIndex.clear();
+    layout.clear();
     transitions.clear();
     alphabet.clear();
     initialStateId = "";
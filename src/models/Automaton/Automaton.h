@@ -3,7 +3,9 @@
 
 #include "State.h"
 #include "Transition.h"
+#include "AutomatonLayout.h"
 #include <QVector>
+#include <QHash>
 #include <QMap>
 #include <QString>
 #include <QSet>
@@ -19,9 +21,11 @@ private:
     QString name;
     AutomatonType type;
     QVector<State> states;
+    QHash<QString, int> stateIndex;     // state id -> slot in states
     QVector<Transition> transitions;
     QSet<QString> alphabet;
     QString initialStateId;
+    AutomatonLayout layout;             // canvas-only geometry and labels
 
 public:
     Automaton();
@@ -34,6 +38,11 @@ public:
     const State* getState(const QString& stateId) const;
     QVector<State>& getStates() { return states; }
     const QVector<State>& getStates() const { return states; }
+    int indexOfState(const QString& stateId) const { return stateIndex.value(stateId, -1); }
+
+    // Editor annotations (label, position, radius)
+    AutomatonLayout& getLayout() { return layout; }
+    const AutomatonLayout& getLayout() const { return layout; }
 
     // Transition management
     bool addTransition(const Transition& transition);
@@ -74,6 +83,7 @@ public:
     int getTransitionCount() const { return transitions.size(); }
 
 private:
+    void rebuildStateIndex();
     QSet<QString> epsilonClosureHelper(const QString& stateId) const;
     bool acceptsNFA(const QString& input) const;
     bool acceptsDFA(const QString& input) const;
@@ -0,0 +1,384 @@
+#include "AutomatonHistory.h"
+#include <algorithm>
+
+AutomatonEdit::AutomatonEdit(Kind kind, const QString& stateId)
+    : kind(kind), stateId(stateId), wasFinal(false), isFinal(false),
+    radius(StateGeometry::DefaultRadius) {}
+
+AutomatonEdit AutomatonEdit::inverted() const {
+    AutomatonEdit edit = *this;
+
+    switch (kind) {
+    case Kind::InsertState:   edit.kind = Kind::EraseState; break;
+    case Kind::EraseState:    edit.kind = Kind::InsertState; break;
+    case Kind::InsertSymbols: edit.kind = Kind::EraseSymbols; break;
+    case Kind::EraseSymbols:  edit.kind = Kind::InsertSymbols; break;
+    case Kind::Clear:         edit.kind = Kind::Restore; break;
+    case Kind::Restore:       edit.kind = Kind::Clear; break;
+    case Kind::SetInitial:
+    case Kind::SetLabel:
+        std::swap(edit.before, edit.after);
+        break;
+    case Kind::SetFinal:
+        std::swap(edit.wasFinal, edit.isFinal);
+        break;
+    case Kind::MoveState:
+        std::swap(edit.from, edit.to);
+        break;
+    }
+
+    return edit;
+}
+
+AutomatonHistory::AutomatonHistory(Automaton* automaton)
+    : automaton(automaton), position(0), groupDepth(0) {
+    addCheckpoint();
+}
+
+// Edits
+
+bool AutomatonHistory::addState(const QString& stateId, const QPointF& pos, double radius) {
+    if (stateId.isEmpty() || automaton->getState(stateId)) {
+        return false;
+    }
+
+    AutomatonEdit edit(AutomatonEdit::Kind::InsertState, stateId);
+    edit.after = stateId;
+    edit.to = pos;
+    edit.radius = radius;
+    record(edit);
+    return true;
+}
+
+bool AutomatonHistory::removeState(const QString& stateId) {
+    const State* state = automaton->getState(stateId);
+    if (!state) {
+        return false;
+    }
+
+    const AutomatonLayout& layout = automaton->getLayout();
+    AutomatonEdit erase(AutomatonEdit::Kind::EraseState, stateId);
+    erase.isFinal = state->getIsFinal();
+    erase.wasFinal = erase.isFinal;
+    erase.after = layout.getLabel(stateId);
+    erase.to = layout.getPosition(stateId);
+    erase.radius = layout.getRadius(stateId);
+
+    // Incident transitions go first so undo restores the state before them
+    QVector<AutomatonEdit> incident;
+    for (const auto& trans : automaton->getTransitions()) {
+        if (trans.getFromStateId() == stateId || trans.getToStateId() == stateId) {
+            AutomatonEdit edge(AutomatonEdit::Kind::EraseSymbols, trans.getFromStateId());
+            edge.targetId = trans.getToStateId();
+            edge.symbols = trans.getSymbols().values();
+            edge.symbols.sort();
+            incident.append(edge);
+        }
+    }
+
+    beginStep();
+    if (automaton->getInitialStateId() == stateId) {
+        setInitialState("");
+    }
+    for (const auto& edge : incident) {
+        record(edge);
+    }
+    record(erase);
+    endStep();
+    return true;
+}
+
+bool AutomatonHistory::addTransition(const QString& from, const QString& to,
+                                     const QString& symbol, QString* errorMsg) {
+    Transition trans(from, to, symbol);
+    if (!automaton->canAddTransition(trans, errorMsg)) {
+        return false;
+    }
+    if (symbolsBetween(from, to).contains(symbol)) {
+        return true; // nothing changes, nothing to undo
+    }
+
+    AutomatonEdit edit(AutomatonEdit::Kind::InsertSymbols, from);
+    edit.targetId = to;
+    edit.symbols << symbol;
+    record(edit);
+    return true;
+}
+
+bool AutomatonHistory::removeTransition(const QString& from, const QString& to, const QString& symbol) {
+    QSet<QString> present = symbolsBetween(from, to);
+
+    AutomatonEdit edit(AutomatonEdit::Kind::EraseSymbols, from);
+    edit.targetId = to;
+    if (symbol.isEmpty()) {
+        edit.symbols = present.values();
+        edit.symbols.sort();
+    } else if (present.contains(symbol)) {
+        edit.symbols << symbol;
+    }
+
+    if (edit.symbols.isEmpty()) {
+        return false;
+    }
+    record(edit);
+    return true;
+}
+
+bool AutomatonHistory::setInitialState(const QString& stateId) {
+    if (!stateId.isEmpty() && !automaton->getState(stateId)) {
+        return false;
+    }
+    if (automaton->getInitialStateId() == stateId) {
+        return true;
+    }
+
+    AutomatonEdit edit(AutomatonEdit::Kind::SetInitial, stateId);
+    edit.before = automaton->getInitialStateId();
+    edit.after = stateId;
+    record(edit);
+    return true;
+}
+
+bool AutomatonHistory::setFinal(const QString& stateId, bool final) {
+    const State* state = automaton->getState(stateId);
+    if (!state) {
+        return false;
+    }
+    if (state->getIsFinal() == final) {
+        return true;
+    }
+
+    AutomatonEdit edit(AutomatonEdit::Kind::SetFinal, stateId);
+    edit.wasFinal = !final;
+    edit.isFinal = final;
+    record(edit);
+    return true;
+}
+
+bool AutomatonHistory::setLabel(const QString& stateId, const QString& label) {
+    if (!automaton->getState(stateId)) {
+        return false;
+    }
+
+    QString current = automaton->getLayout().getLabel(stateId);
+    if (current == label) {
+        return true;
+    }
+
+    AutomatonEdit edit(AutomatonEdit::Kind::SetLabel, stateId);
+    edit.before = current;
+    edit.after = label;
+    record(edit);
+    return true;
+}
+
+bool AutomatonHistory::recordMove(const QString& stateId, const QPointF& from, const QPointF& to) {
+    if (!automaton->getState(stateId) || from == to) {
+        return false;
+    }
+
+    // The canvas already moved the state while dragging
+    AutomatonEdit edit(AutomatonEdit::Kind::MoveState, stateId);
+    edit.from = from;
+    edit.to = to;
+    record(edit, false);
+    return true;
+}
+
+bool AutomatonHistory::clearAutomaton() {
+    if (automaton->getStateCount() == 0 && automaton->getTransitionCount() == 0) {
+        return false;
+    }
+
+    AutomatonEdit edit(AutomatonEdit::Kind::Clear);
+    edit.snapshot = QSharedPointer<const Automaton>(new Automaton(*automaton));
+    record(edit);
+    return true;
+}
+
+void AutomatonHistory::beginStep() {
+    ++groupDepth;
+}
+
+void AutomatonHistory::endStep() {
+    if (groupDepth > 0 && --groupDepth == 0) {
+        commitPending();
+    }
+}
+
+// Navigation
+
+bool AutomatonHistory::undo() {
+    if (!canUndo()) {
+        return false;
+    }
+    applyStep(steps[--position], false);
+    return true;
+}
+
+bool AutomatonHistory::redo() {
+    if (!canRedo()) {
+        return false;
+    }
+    applyStep(steps[position++], true);
+    return true;
+}
+
+bool AutomatonHistory::jumpTo(int target) {
+    if (target < 0 || target > steps.size()) {
+        return false;
+    }
+
+    // Latest checkpoint at or before the target
+    auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), target,
+                               [](int pos, const Checkpoint& c) { return pos < c.position; });
+    const Checkpoint& checkpoint = *(it - 1);
+
+    // Restoring costs roughly one interval of edits; prefer it only when walking is longer
+    int walk = qAbs(target - position);
+    int replay = target - checkpoint.position;
+    if (replay + checkpointInterval() < walk) {
+        restore(checkpoint.snapshot);
+        position = checkpoint.position;
+    }
+
+    while (position < target) {
+        applyStep(steps[position++], true);
+    }
+    while (position > target) {
+        applyStep(steps[--position], false);
+    }
+    return true;
+}
+
+void AutomatonHistory::reset() {
+    steps.clear();
+    checkpoints.clear();
+    pending.clear();
+    position = 0;
+    groupDepth = 0;
+    addCheckpoint();
+}
+
+// Internals
+
+void AutomatonHistory::record(const AutomatonEdit& edit, bool applyNow) {
+    if (applyNow) {
+        apply(edit);
+    }
+    pending.append(edit);
+    if (groupDepth == 0) {
+        commitPending();
+    }
+}
+
+void AutomatonHistory::commitPending() {
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    // A new edit discards the redo branch and any checkpoints taken on it
+    steps.resize(position);
+    while (checkpoints.last().position > position) {
+        checkpoints.removeLast();
+    }
+
+    steps.append(pending);
+    pending.clear();
+    ++position;
+
+    if (position - checkpoints.last().position >= checkpointInterval()) {
+        addCheckpoint();
+    }
+}
+
+void AutomatonHistory::apply(const AutomatonEdit& edit) {
+    AutomatonLayout& layout = automaton->getLayout();
+
+    switch (edit.kind) {
+    case AutomatonEdit::Kind::InsertState:
+        automaton->addState(State(edit.stateId, edit.isFinal ? State::Final : 0));
+        if (edit.after != edit.stateId) {
+            layout.setLabel(edit.stateId, edit.after);
+        }
+        layout.setPosition(edit.stateId, edit.to);
+        layout.setRadius(edit.stateId, edit.radius);
+        break;
+    case AutomatonEdit::Kind::EraseState:
+        automaton->removeState(edit.stateId);
+        break;
+    case AutomatonEdit::Kind::InsertSymbols:
+        for (const auto& symbol : edit.symbols) {
+            automaton->addTransition(Transition(edit.stateId, edit.targetId, symbol));
+        }
+        break;
+    case AutomatonEdit::Kind::EraseSymbols:
+        for (const auto& symbol : edit.symbols) {
+            automaton->removeTransition(edit.stateId, edit.targetId, symbol);
+        }
+        break;
+    case AutomatonEdit::Kind::SetInitial:
+        automaton->setInitialState(edit.after);
+        break;
+    case AutomatonEdit::Kind::SetFinal:
+        if (State* state = automaton->getState(edit.stateId)) {
+            state->setIsFinal(edit.isFinal);
+        }
+        break;
+    case AutomatonEdit::Kind::SetLabel:
+        layout.setLabel(edit.stateId, edit.after);
+        break;
+    case AutomatonEdit::Kind::MoveState:
+        layout.setPosition(edit.stateId, edit.to);
+        break;
+    case AutomatonEdit::Kind::Clear:
+        automaton->clear();
+        break;
+    case AutomatonEdit::Kind::Restore:
+        restore(*edit.snapshot);
+        break;
+    }
+}
+
+void AutomatonHistory::applyStep(const QVector<AutomatonEdit>& step, bool forward) {
+    if (forward) {
+        for (const auto& edit : step) {
+            apply(edit);
+        }
+    } else {
+        for (int i = step.size() - 1; i >= 0; --i) {
+            apply(step[i].inverted());
+        }
+    }
+}
+
+void AutomatonHistory::restore(const Automaton& snapshot) {
+    // Name and type are not part of the history
+    QString name = automaton->getName();
+    AutomatonType type = automaton->getType();
+    *automaton = snapshot;
+    automaton->setName(name);
+    automaton->setType(type);
+}
+
+void AutomatonHistory::addCheckpoint() {
+    checkpoints.append(Checkpoint{position, *automaton});
+}
+
+int AutomatonHistory::checkpointInterval() const {
+    int size = automaton->getStateCount() + automaton->getTransitionCount();
+    int bits = 1;
+    while (bits < 31 && (1 << bits) < size) {
+        ++bits;
+    }
+    return qMax(MinCheckpointInterval, size / bits);
+}
+
+QSet<QString> AutomatonHistory::symbolsBetween(const QString& from, const QString& to) const {
+    for (const auto& trans : automaton->getTransitions()) {
+        if (trans.getFromStateId() == from && trans.getToStateId() == to) {
+            return trans.getSymbols();
+        }
+    }
+    return QSet<QString>();
+}
@@ -0,0 +1,110 @@
+#ifndef AUTOMATONHISTORY_H
+#define AUTOMATONHISTORY_H
+
+#include "Automaton.h"
+#include <QPointF>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+// One primitive change, stored with enough of its previous value that
+// inverted() undoes it exactly.
+struct AutomatonEdit {
+    enum class Kind {
+        InsertState,
+        EraseState,
+        InsertSymbols,
+        EraseSymbols,
+        SetInitial,
+        SetFinal,
+        SetLabel,
+        MoveState,
+        Clear,
+        Restore
+    };
+
+    Kind kind;
+    QString stateId;        // state, or transition source
+    QString targetId;       // transition destination
+    QStringList symbols;
+    QString before;         // previous label or initial state id
+    QString after;          // new label or initial state id (Insert/EraseState: label)
+    QPointF from;           // previous position
+    QPointF to;             // new position (Insert/EraseState: position)
+    bool wasFinal;
+    bool isFinal;
+    double radius;
+    QSharedPointer<const Automaton> snapshot;   // Clear/Restore only
+
+    explicit AutomatonEdit(Kind kind = Kind::SetLabel, const QString& stateId = QString());
+
+    AutomatonEdit inverted() const;
+};
+
+// Undo/redo log for one automaton. Each step keeps only the primitives it
+// changed; full snapshots are taken every max(64, n / log n) steps, so the
+// amortised cost per edit is O(log n) and jumpTo() replays at most one
+// checkpoint interval instead of walking the whole history.
+class AutomatonHistory {
+private:
+    struct Checkpoint {
+        int position;
+        Automaton snapshot;
+    };
+
+    Automaton* automaton;
+    QVector<QVector<AutomatonEdit>> steps;
+    QVector<Checkpoint> checkpoints;    // ascending positions, first one at 0
+    QVector<AutomatonEdit> pending;     // primitives of the step being built
+    int position;                       // number of steps currently applied
+    int groupDepth;
+
+public:
+    static const int MinCheckpointInterval = 64;
+
+    explicit AutomatonHistory(Automaton* automaton);
+
+    Automaton* getAutomaton() const { return automaton; }
+
+    // Edits: each one is applied immediately and becomes one undo step
+    bool addState(const QString& stateId, const QPointF& pos,
+                  double radius = StateGeometry::DefaultRadius);
+    bool removeState(const QString& stateId);
+    bool addTransition(const QString& from, const QString& to, const QString& symbol,
+                       QString* errorMsg = nullptr);
+    bool removeTransition(const QString& from, const QString& to, const QString& symbol = QString());
+    bool setInitialState(const QString& stateId);
+    bool setFinal(const QString& stateId, bool final);
+    bool setLabel(const QString& stateId, const QString& label);
+    bool recordMove(const QString& stateId, const QPointF& from, const QPointF& to);
+    bool clearAutomaton();
+
+    // Groups the edits in between into a single undo step
+    void beginStep();
+    void endStep();
+
+    // Navigation
+    bool canUndo() const { return position > 0; }
+    bool canRedo() const { return position < steps.size(); }
+    bool undo();
+    bool redo();
+    bool jumpTo(int target);
+    int getPosition() const { return position; }
+    int getStepCount() const { return steps.size(); }
+    int getCheckpointCount() const { return checkpoints.size(); }
+
+    // Forgets all steps; the current automaton becomes the new origin
+    void reset();
+
+private:
+    void record(const AutomatonEdit& edit, bool applyNow = true);
+    void commitPending();
+    void apply(const AutomatonEdit& edit);
+    void applyStep(const QVector<AutomatonEdit>& step, bool forward);
+    void restore(const Automaton& snapshot);
+    void addCheckpoint();
+    int checkpointInterval() const;
+    QSet<QString> symbolsBetween(const QString& from, const QString& to) const;
+};
+
+#endif // AUTOMATONHISTORY_H
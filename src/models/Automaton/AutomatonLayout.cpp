@@ -0,0 +1,55 @@
+#include "AutomatonLayout.h"
+#include <QtMath>
+
+QString AutomatonLayout::getLabel(const QString& stateId) const {
+    auto it = entries.constFind(stateId);
+    if (it == entries.constEnd() || it->label.isEmpty()) {
+        return stateId;
+    }
+    return it->label;
+}
+
+QPointF AutomatonLayout::getPosition(const QString& stateId) const {
+    auto it = entries.constFind(stateId);
+    return it == entries.constEnd() ? QPointF(0, 0) : it->position;
+}
+
+double AutomatonLayout::getRadius(const QString& stateId) const {
+    auto it = entries.constFind(stateId);
+    return it == entries.constEnd() ? StateGeometry::DefaultRadius : it->radius;
+}
+
+void AutomatonLayout::setLabel(const QString& stateId, const QString& label) {
+    entries[stateId].label = label;
+}
+
+void AutomatonLayout::setPosition(const QString& stateId, const QPointF& pos) {
+    entries[stateId].position = pos;
+}
+
+void AutomatonLayout::setRadius(const QString& stateId, double radius) {
+    entries[stateId].radius = radius;
+}
+
+bool AutomatonLayout::containsPoint(const QString& stateId, const QPointF& point) const {
+    QPointF center = getPosition(stateId);
+    double radius = getRadius(stateId);
+    double dx = point.x() - center.x();
+    double dy = point.y() - center.y();
+    return (dx * dx + dy * dy) <= (radius * radius);
+}
+
+void AutomatonLayout::arrangeInGrid(const QVector<State>& states, double spacing,
+                                    const QPointF& origin) {
+    int cols = qMax(1, qCeil(qSqrt(states.size())));
+    int row = 0, col = 0;
+
+    for (const auto& state : states) {
+        setPosition(state.getId(), origin + QPointF(col * spacing, row * spacing));
+        col++;
+        if (col >= cols) {
+            col = 0;
+            row++;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef AUTOMATONLAYOUT_H
+#define AUTOMATONLAYOUT_H
+
+#include "State.h"
+#include <QHash>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+struct StateGeometry {
+    static constexpr double DefaultRadius = 30.0;
+
+    QString label;       // empty means "show the id"
+    QPointF position;
+    double radius;
+
+    StateGeometry() : position(0, 0), radius(DefaultRadius) {}
+};
+
+// Canvas-side annotations keyed by state id. Only the editor reads or
+// writes this; automata built by algorithms start with an empty layout.
+class AutomatonLayout {
+private:
+    QHash<QString, StateGeometry> entries;
+
+public:
+    // Getters fall back to defaults for states that were never placed
+    QString getLabel(const QString& stateId) const;
+    QPointF getPosition(const QString& stateId) const;
+    double getRadius(const QString& stateId) const;
+    bool contains(const QString& stateId) const { return entries.contains(stateId); }
+
+    void setLabel(const QString& stateId, const QString& label);
+    void setPosition(const QString& stateId, const QPointF& pos);
+    void setRadius(const QString& stateId, double radius);
+
+    bool containsPoint(const QString& stateId, const QPointF& point) const;
+
+    // Places states row by row in a square-ish grid
+    void arrangeInGrid(const QVector<State>& states, double spacing = 120.0,
+                       const QPointF& origin = QPointF(100, 100));
+
+    void removeState(const QString& stateId) { entries.remove(stateId); }
+    void clear() { entries.clear(); }
+    int size() const { return entries.size(); }
+};
+
+#endif // AUTOMATONLAYOUT_H
@@ -2,40 +2,37 @@
 #define STATE_H
 
 #include <QString>
-#include <QPointF>
+#include <QtGlobal>
 
+// Logical part of a state only. Labels, positions and radii live in
+// AutomatonLayout so algorithms never carry canvas geometry around.
 class State {
+public:
+    enum Flag : quint8 {
+        Initial = 0x01,
+        Final = 0x02
+    };
+
 private:
     QString id;
-    QString label;
-    QPointF position;
-    bool isInitial;
-    bool isFinal;
-    double radius;
+    quint8 flags;
 
 public:
     State();
-    State(const QString& id, const QString& label = "",
-          const QPointF& pos = QPointF(0, 0));
+    explicit State(const QString& id, quint8 flags = 0);
 
     // Getters
     QString getId() const { return id; }
-    QString getLabel() const { return label; }
-    QPointF getPosition() const { return position; }
-    bool getIsInitial() const { return isInitial; }
-    bool getIsFinal() const { return isFinal; }
-    double getRadius() const { return radius; }
+    quint8 getFlags() const { return flags; }
+    bool getIsInitial() const { return flags & Initial; }
+    bool getIsFinal() const { return flags & Final; }
 
     // Setters
-    void setId(const QString& newId) { id = newId; }
-    void setLabel(const QString& newLabel) { label = newLabel; }
-    void setPosition(const QPointF& pos) { position = pos; }
-    void setIsInitial(bool initial) { isInitial = initial; }
-    void setIsFinal(bool final) { isFinal = final; }
-    void setRadius(double r) { radius = r; }
-
-    // Utility
-    bool containsPoint(const QPointF& point) const;
+    void setIsInitial(bool initial) { setFlag(Initial, initial); }
+    void setIsFinal(bool final) { setFlag(Final, final); }
+
+private:
+    void setFlag(Flag flag, bool on) { flags = on ? (flags | flag) : (flags & ~flag); }
 };
 
 #endif // STATE_H
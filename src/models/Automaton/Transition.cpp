@@ -11,6 +11,10 @@ Transition::Transition(const QString& from, const QString& to, const QString& sy
     }
 }
 
+bool Transition::isEpsilonSymbol(const QString& symbol) {
+    return symbol == "E" || symbol == "ε" || symbol == "epsilon" || symbol.isEmpty();
+}
+
 bool Transition::isEpsilonTransition() const {
     return symbols.contains("E") ||
            symbols.contains("ε") ||
@@ -33,7 +37,7 @@ QString Transition::getSymbolsString() const {
 
 bool Transition::hasSymbol(const QString& symbol) const {
     // Check for epsilon equivalents
-    if (symbol == "E" || symbol == "ε" || symbol == "epsilon" || symbol.isEmpty()) {
+    if (isEpsilonSymbol(symbol)) {
         return symbols.contains("E") ||
                symbols.contains("ε") ||
                symbols.contains("epsilon") ||
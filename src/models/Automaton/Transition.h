@@ -30,6 +30,8 @@ public:
     bool isEpsilonTransition() const;
     QString getSymbolsString() const;
     bool hasSymbol(const QString& symbol) const;
+    // E, ε, epsilon and "" all stand for epsilon
+    static bool isEpsilonSymbol(const QString& symbol);
 };
 
 #endif // TRANSITION_H
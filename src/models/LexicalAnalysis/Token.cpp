@@ -2,6 +2,17 @@
 #include <QMap>
 #include <QSet>
 
+namespace {
+
+#define TOKEN_TYPE_NAME(name) #name,
+const char* const TokenTypeEnumerators[] = {
+    TOKEN_TYPES(TOKEN_TYPE_NAME)
+};
+#undef TOKEN_TYPE_NAME
+const int TokenTypeCount = sizeof(TokenTypeEnumerators) / sizeof(TokenTypeEnumerators[0]);
+
+}
+
 Token::Token()
     : type(TokenType::UNKNOWN), lexeme(""), automatonId(""), line(0), column(0) {}
 
@@ -50,6 +61,20 @@ QString Token::tokenTypeToString(TokenType type) {
     return typeNames.value(type, "UNKNOWN");
 }
 
+QString Token::enumeratorName(TokenType type) {
+    int index = static_cast<int>(type);
+    return index >= 0 && index < TokenTypeCount ? QString(TokenTypeEnumerators[index]) : QString();
+}
+
+int Token::typeCount() {
+    return TokenTypeCount;
+}
+
+int Token::inputLength(const QVector<Token>& tokens) {
+    return !tokens.isEmpty() && tokens.last().getType() == TokenType::END_OF_FILE
+        ? tokens.size() - 1 : tokens.size();
+}
+
 bool Token::isKeyword(const QString& str) {
     static QSet<QString> keywords = {
         "if", "else", "while", "for", "do", "switch", "case", "default",
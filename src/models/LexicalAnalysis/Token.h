@@ -2,38 +2,36 @@
 #define TOKEN_H
 
 #include <QString>
+#include <QVector>
 #include <QMetaType>
 
+// Every token type in declaration order, so the enum and its enumerator
+// names (Token::enumeratorName) cannot drift apart
+#define TOKEN_TYPES(X) \
+    /* Keywords */ \
+    X(KEYWORD) \
+    /* Identifiers and Literals */ \
+    X(IDENTIFIER) X(INTEGER_LITERAL) X(FLOAT_LITERAL) X(STRING_LITERAL) X(CHAR_LITERAL) \
+    /* Operators */ \
+    X(PLUS) X(MINUS) X(MULTIPLY) X(DIVIDE) X(MODULO) \
+    X(ASSIGN) X(EQUAL) X(NOT_EQUAL) \
+    X(LESS_THAN) X(GREATER_THAN) X(LESS_EQUAL) X(GREATER_EQUAL) \
+    X(LOGICAL_AND) X(LOGICAL_OR) X(LOGICAL_NOT) \
+    X(BITWISE_AND) X(BITWISE_OR) X(BITWISE_XOR) X(BITWISE_NOT) \
+    /* Delimiters */ \
+    X(SEMICOLON) X(COMMA) X(DOT) X(COLON) \
+    /* Brackets */ \
+    X(LPAREN) X(RPAREN) X(LBRACE) X(RBRACE) X(LBRACKET) X(RBRACKET) \
+    /* Special */ \
+    X(WHITESPACE) X(COMMENT) X(NEWLINE) \
+    /* Error and End */ \
+    X(UNKNOWN) X(END_OF_FILE)
+
+#define TOKEN_TYPE_ENUMERATOR(name) name,
 enum class TokenType {
-    // Keywords
-    KEYWORD,
-
-    // Identifiers and Literals
-    IDENTIFIER,
-    INTEGER_LITERAL,
-    FLOAT_LITERAL,
-    STRING_LITERAL,
-    CHAR_LITERAL,
-
-    // Operators
-    PLUS, MINUS, MULTIPLY, DIVIDE, MODULO,
-    ASSIGN, EQUAL, NOT_EQUAL,
-    LESS_THAN, GREATER_THAN, LESS_EQUAL, GREATER_EQUAL,
-    LOGICAL_AND, LOGICAL_OR, LOGICAL_NOT,
-    BITWISE_AND, BITWISE_OR, BITWISE_XOR, BITWISE_NOT,
-
-    // Delimiters
-    SEMICOLON, COMMA, DOT, COLON,
-
-    // Brackets
-    LPAREN, RPAREN, LBRACE, RBRACE, LBRACKET, RBRACKET,
-
-    // Special
-    WHITESPACE, COMMENT, NEWLINE,
-
-    // Error and End
-    UNKNOWN, END_OF_FILE
+    TOKEN_TYPES(TOKEN_TYPE_ENUMERATOR)
 };
+#undef TOKEN_TYPE_ENUMERATOR
 
 class Token {
 private:
@@ -64,6 +62,12 @@ public:
     bool isValid() const;
 
     static QString tokenTypeToString(TokenType type);
+    static QString enumeratorName(TokenType type);     // "INTEGER_LITERAL", as written in C++
+    static int typeCount();
+
+    // Number of tokens before the end of input: Lexer::tokenize appends an
+    // END_OF_FILE token, which stands for the end marker $ rather than input
+    static int inputLength(const QVector<Token>& tokens);
     static bool isKeyword(const QString& str);
     static TokenType getKeywordType(const QString& str);
     static TokenType getOperatorType(const QString& str);
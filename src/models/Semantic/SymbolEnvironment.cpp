@@ -0,0 +1,158 @@
+#include "SymbolEnvironment.h"
+#include "SymbolTable.h"
+#include <QHash>
+#include <QtAlgorithms>
+
+// 32-way node. Each of the 32 slots for the next 5 hash bits holds nothing,
+// a symbol (dataMap) or a sub-trie (nodeMap); only used slots are stored,
+// in slot order. Once all 32 hash bits are used up, a node is a plain list
+// of the symbols whose hashes collide.
+struct SymbolEnvironment::Node {
+    quint32 dataMap = 0;
+    quint32 nodeMap = 0;
+    QVector<quint32> hashes;        // parallel to data
+    QVector<Symbol> data;
+    QVector<NodePtr> nodes;
+};
+
+static const int BitsPerLevel = 5;
+static const int HashBits = 32;
+
+static inline quint32 slotBit(quint32 hash, int shift) {
+    return 1u << ((hash >> shift) & 31);
+}
+
+static inline int indexOf(quint32 map, quint32 bit) {
+    return qPopulationCount(map & (bit - 1));
+}
+
+SymbolEnvironment::SymbolEnvironment() : root(std::make_shared<Node>()), count(0) {
+}
+
+quint32 SymbolEnvironment::hashOf(const QString& name) {
+    return static_cast<quint32>(qHash(name));
+}
+
+SymbolEnvironment SymbolEnvironment::insert(const Symbol& symbol) const {
+    bool added = false;
+    NodePtr newRoot = insert(root, hashOf(symbol.name), 0, symbol, &added);
+    return SymbolEnvironment(newRoot, added ? count + 1 : count);
+}
+
+const Symbol* SymbolEnvironment::lookup(const QString& name) const {
+    quint32 hash = hashOf(name);
+    const Node* node = root.get();
+
+    for (int shift = 0; shift < HashBits; shift += BitsPerLevel) {
+        quint32 bit = slotBit(hash, shift);
+        if (node->dataMap & bit) {
+            const Symbol& symbol = node->data[indexOf(node->dataMap, bit)];
+            return symbol.name == name ? &symbol : nullptr;
+        }
+        if (!(node->nodeMap & bit)) {
+            return nullptr;
+        }
+        node = node->nodes[indexOf(node->nodeMap, bit)].get();
+    }
+
+    for (const Symbol& symbol : node->data) {
+        if (symbol.name == name) {
+            return &symbol;
+        }
+    }
+    return nullptr;
+}
+
+QVector<Symbol> SymbolEnvironment::symbols() const {
+    QVector<Symbol> result;
+    result.reserve(count);
+    collect(root, result);
+    return result;
+}
+
+// Path copying: only the nodes from the root down to the changed slot are new
+SymbolEnvironment::NodePtr SymbolEnvironment::insert(const NodePtr& node, quint32 hash, int shift,
+                                                     const Symbol& symbol, bool* added) {
+    auto copy = std::make_shared<Node>(*node);
+
+    if (shift >= HashBits) {
+        for (Symbol& existing : copy->data) {
+            if (existing.name == symbol.name) {
+                existing = symbol;
+                return copy;
+            }
+        }
+        copy->hashes.append(hash);
+        copy->data.append(symbol);
+        *added = true;
+        return copy;
+    }
+
+    quint32 bit = slotBit(hash, shift);
+    if (node->dataMap & bit) {
+        int index = indexOf(node->dataMap, bit);
+        if (node->data[index].name == symbol.name) {
+            copy->data[index] = symbol;
+            return copy;
+        }
+
+        // Two names share this slot: push both one level down
+        NodePtr child = merge(node->hashes[index], node->data[index], hash, symbol, shift + BitsPerLevel);
+        copy->hashes.remove(index);
+        copy->data.remove(index);
+        copy->dataMap &= ~bit;
+        copy->nodeMap |= bit;
+        copy->nodes.insert(indexOf(copy->nodeMap, bit), child);
+        *added = true;
+        return copy;
+    }
+
+    if (node->nodeMap & bit) {
+        int index = indexOf(node->nodeMap, bit);
+        copy->nodes[index] = insert(node->nodes[index], hash, shift + BitsPerLevel, symbol, added);
+        return copy;
+    }
+
+    int index = indexOf(node->dataMap, bit);
+    copy->hashes.insert(index, hash);
+    copy->data.insert(index, symbol);
+    copy->dataMap |= bit;
+    *added = true;
+    return copy;
+}
+
+SymbolEnvironment::NodePtr SymbolEnvironment::merge(quint32 hash1, const Symbol& symbol1,
+                                                    quint32 hash2, const Symbol& symbol2, int shift) {
+    auto node = std::make_shared<Node>();
+
+    if (shift >= HashBits) {
+        node->hashes << hash1 << hash2;
+        node->data << symbol1 << symbol2;
+        return node;
+    }
+
+    quint32 bit1 = slotBit(hash1, shift);
+    quint32 bit2 = slotBit(hash2, shift);
+    if (bit1 == bit2) {
+        node->nodeMap = bit1;
+        node->nodes.append(merge(hash1, symbol1, hash2, symbol2, shift + BitsPerLevel));
+        return node;
+    }
+
+    node->dataMap = bit1 | bit2;
+    if (bit1 < bit2) {
+        node->hashes << hash1 << hash2;
+        node->data << symbol1 << symbol2;
+    } else {
+        node->hashes << hash2 << hash1;
+        node->data << symbol2 << symbol1;
+    }
+    return node;
+}
+
+void SymbolEnvironment::collect(const NodePtr& node, QVector<Symbol>& out) {
+    out += node->data;
+    for (const NodePtr& child : node->nodes) {
+        collect(child, out);
+    }
+}
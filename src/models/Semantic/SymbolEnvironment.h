@@ -0,0 +1,42 @@
+#ifndef SYMBOLENVIRONMENT_H
+#define SYMBOLENVIRONMENT_H
+
+#include <QString>
+#include <QVector>
+#include <memory>
+
+struct Symbol;
+
+// Immutable name -> symbol map (a hash array mapped trie). insert() returns a
+// new version that shares every untouched node with the old one, so keeping
+// a version per program point costs O(log n) memory per change instead of a
+// copy of the table. Inserting a name that is already present replaces it,
+// which is how inner declarations shadow outer ones.
+class SymbolEnvironment {
+public:
+    SymbolEnvironment();
+
+    SymbolEnvironment insert(const Symbol& symbol) const;
+    const Symbol* lookup(const QString& name) const;
+    bool contains(const QString& name) const { return lookup(name) != nullptr; }
+
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    QVector<Symbol> symbols() const;        // every visible symbol, unordered
+
+private:
+    struct Node;
+    typedef std::shared_ptr<const Node> NodePtr;
+
+    NodePtr root;
+    int count;
+
+    SymbolEnvironment(const NodePtr& root, int count) : root(root), count(count) {}
+
+    static NodePtr insert(const NodePtr& node, quint32 hash, int shift, const Symbol& symbol, bool* added);
+    static NodePtr merge(quint32 hash1, const Symbol& symbol1, quint32 hash2, const Symbol& symbol2, int shift);
+    static void collect(const NodePtr& node, QVector<Symbol>& out);
+    static quint32 hashOf(const QString& name);
+};
+
+#endif // SYMBOLENVIRONMENT_H
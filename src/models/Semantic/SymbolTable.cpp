@@ -17,19 +17,24 @@ QString Symbol::toString() const {
 
 SymbolTable::SymbolTable() : currentScope(0) {
     scopes.append(QMap<QString, Symbol>());
+    discoveredIndex.append(QMap<QString, int>());
 }
 
 void SymbolTable::enterScope() {
+    enclosingEnvironments.append(environment);
     currentScope++;
     if (currentScope >= scopes.size()) {
         scopes.append(QMap<QString, Symbol>());
+        discoveredIndex.append(QMap<QString, int>());
     }
 }
 
 void SymbolTable::exitScope() {
     if (currentScope > 0) {
         scopes[currentScope].clear();
+        discoveredIndex[currentScope].clear();
         currentScope--;
+        environment = enclosingEnvironments.takeLast();
     }
 }
 
@@ -41,29 +46,71 @@ bool SymbolTable::addSymbol(const Symbol& symbol) {
     Symbol newSymbol = symbol;
     newSymbol.scope = currentScope;
     scopes[currentScope][symbol.name] = newSymbol;
+    environment = environment.insert(newSymbol);
+    discoveredIndex[currentScope][symbol.name] = allDiscoveredSymbols.size();
     allDiscoveredSymbols.append(newSymbol);
 
     return true;
 }
 
+void SymbolTable::declareExternal(const Symbol& symbol) {
+    Symbol global = symbol;
+    global.scope = 0;
+    scopes[0][symbol.name] = global;
+    setVisible(global);
+}
+
+void SymbolTable::importDiscovered(const Symbol& symbol) {
+    if (symbol.scope == 0 && !scopes[0].contains(symbol.name)) {
+        scopes[0][symbol.name] = symbol;
+        setVisible(symbol);
+        discoveredIndex[0][symbol.name] = allDiscoveredSymbols.size();
+    }
+    allDiscoveredSymbols.append(symbol);
+}
+
 bool SymbolTable::updateSymbol(const QString& name, const QString& value) {
     Symbol* sym = lookup(name);
     if (sym) {
         sym->value = value;
         sym->isInitialized = true;
-
-        for(auto& discoveredSym : allDiscoveredSymbols) {
-            if(discoveredSym.name == name && discoveredSym.scope == sym->scope) {
-                discoveredSym.value = value;
-                discoveredSym.isInitialized = true;
-                break;
-            }
+        setVisible(*sym);
+
+        // The record of the declaration lookup found. Matching the first
+        // record with this name and scope number, as before, picked an
+        // earlier function's local at the same depth (every function body
+        // reuses scope 1), so a later function's assignment landed on it;
+        // per-batch analysis then disagreed with the sequential pass.
+        int index = discoveredIndexOf(name);
+        if (index >= 0) {
+            allDiscoveredSymbols[index].value = value;
+            allDiscoveredSymbols[index].isInitialized = true;
         }
         return true;
     }
     return false;
 }
 
+// Puts a symbol of an open scope into the current environment and into the
+// saved environments of the scopes opened since, so its new state survives
+// their exit. Nothing in those scopes shadows it, or lookup would not have
+// returned it.
+void SymbolTable::setVisible(const Symbol& symbol) {
+    environment = environment.insert(symbol);
+    for (int i = symbol.scope; i < enclosingEnvironments.size(); ++i) {
+        enclosingEnvironments[i] = enclosingEnvironments[i].insert(symbol);
+    }
+}
+
+int SymbolTable::discoveredIndexOf(const QString& name) const {
+    for (int i = currentScope; i >= 0; --i) {
+        if (scopes[i].contains(name)) {
+            return discoveredIndex[i].value(name, -1);
+        }
+    }
+    return -1;
+}
+
 Symbol* SymbolTable::lookup(const QString& name) {
     for (int i = currentScope; i >= 0; --i) {
         if (scopes[i].contains(name)) {
@@ -104,6 +151,10 @@ QVector<Symbol> SymbolTable::getSymbolsInScope(int scope) const {
 void SymbolTable::clear() {
     scopes.clear();
     scopes.append(QMap<QString, Symbol>());
+    discoveredIndex.clear();
+    discoveredIndex.append(QMap<QString, int>());
+    environment = SymbolEnvironment();
+    enclosingEnvironments.clear();
     currentScope = 0;
     allDiscoveredSymbols.clear();
 }
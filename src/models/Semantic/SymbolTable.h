@@ -4,6 +4,7 @@
 #include <QString>
 #include <QMap>
 #include <QVector>
+#include "SymbolEnvironment.h"
 
 enum class SymbolType {
     INTEGER,
@@ -42,6 +43,11 @@ private:
     QVector<QMap<QString, Symbol>> scopes;
     int currentScope;
     QVector<Symbol> allDiscoveredSymbols;
+    QVector<QMap<QString, int>> discoveredIndex;   // per scope: name -> index in allDiscoveredSymbols
+    SymbolEnvironment environment;                  // persistent view of every visible symbol
+    QVector<SymbolEnvironment> enclosingEnvironments; // environment on entry to each open scope
+
+    void setVisible(const Symbol& symbol);
 
 public:
     SymbolTable();
@@ -52,6 +58,10 @@ public:
 
     bool addSymbol(const Symbol& symbol);
     bool updateSymbol(const QString& name, const QString& value);
+    // Global declared outside the analyzed tokens; not reported as discovered
+    void declareExternal(const Symbol& symbol);
+    // Symbol discovered by another analyzer; globals become visible again
+    void importDiscovered(const Symbol& symbol);
     Symbol* lookup(const QString& name);
     const Symbol* lookup(const QString& name) const;
 
@@ -59,8 +69,13 @@ public:
     bool existsInCurrentScope(const QString& name) const;
 
     QVector<Symbol> getDiscoveredSymbols() const { return allDiscoveredSymbols; }
+    // Index of the visible declaration of name in getDiscoveredSymbols(), -1 if none
+    int discoveredIndexOf(const QString& name) const;
     QVector<Symbol> getSymbolsInScope(int scope) const;
 
+    // O(1) snapshot of what is visible now; stays valid after the scope exits
+    SymbolEnvironment getEnvironment() const { return environment; }
+
     void clear();
     QString toString() const;
 
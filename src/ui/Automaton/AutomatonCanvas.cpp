@@ -15,7 +15,7 @@
 #include <cmath>
 
 AutomatonCanvas::AutomatonCanvas(QWidget *parent)
-    : QWidget(parent), currentAutomaton(nullptr), currentMode(DrawMode::Select),
+    : QWidget(parent), currentAutomaton(nullptr), history(nullptr), currentMode(DrawMode::Select),
     selectedStateId(""), hoverStateId(""), currentSelectedStateForPropertiesId(""),
     isDrawingTransition(false), draggedStateId(""), isDragging(false) {
 
@@ -24,8 +24,9 @@ AutomatonCanvas::AutomatonCanvas(QWidget *parent)
     setStyleSheet("background-color: white;");
 }
 
-void AutomatonCanvas::setAutomaton(Automaton* automaton) {
+void AutomatonCanvas::setAutomaton(Automaton* automaton, AutomatonHistory* automatonHistory) {
     currentAutomaton = automaton;
+    history = automaton ? automatonHistory : nullptr;
 
     // Clear all state references using IDs instead of pointers
     selectedStateId = "";
@@ -34,6 +35,7 @@ void AutomatonCanvas::setAutomaton(Automaton* automaton) {
     draggedStateId = "";
     isDrawingTransition = false;
     isDragging = false;
+    activeStateIds.clear();
 
     emit stateSelected("");
     update();
@@ -48,6 +50,14 @@ void AutomatonCanvas::setDrawMode(DrawMode mode) {
     setCursor(mode == DrawMode::AddState ? Qt::CrossCursor : Qt::ArrowCursor);
 }
 
+void AutomatonCanvas::setActiveStates(const QSet<QString>& stateIds) {
+    if (stateIds == activeStateIds) {
+        return;
+    }
+    activeStateIds = stateIds;
+    update();
+}
+
 void AutomatonCanvas::paintEvent(QPaintEvent *event) {
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
@@ -69,7 +79,7 @@ void AutomatonCanvas::paintEvent(QPaintEvent *event) {
         State* selectedState = currentAutomaton->getState(selectedStateId);
         if (selectedState) { // Always check if state still exists
             painter.setPen(QPen(Qt::gray, 2, Qt::DashLine));
-            painter.drawLine(selectedState->getPosition(), tempTransitionEnd);
+            painter.drawLine(currentAutomaton->getLayout().getPosition(selectedStateId), tempTransitionEnd);
         } else {
             // State was deleted, stop drawing transition
             selectedStateId = "";
@@ -90,16 +100,21 @@ void AutomatonCanvas::paintEvent(QPaintEvent *event) {
 }
 
 void AutomatonCanvas::drawState(QPainter& painter, const State& state, bool highlight, bool isSelectedForProps) {
-    QPointF pos = state.getPosition();
-    double radius = state.getRadius();
+    const AutomatonLayout& layout = currentAutomaton->getLayout();
+    QPointF pos = layout.getPosition(state.getId());
+    double radius = layout.getRadius(state.getId());
 
     // Determine border color and width
     QColor borderColor = Qt::black;
     int borderWidth = 2;
+    bool isActive = activeStateIds.contains(state.getId());
 
     if (isSelectedForProps) {
         borderColor = QColor("#0078d7");  // Blue for selected
         borderWidth = 3;
+    } else if (isActive) {
+        borderColor = QColor("#ef6c00");  // Orange for the current test step
+        borderWidth = 3;
     } else if (highlight) {
         borderColor = Qt::blue;
         borderWidth = 2;
@@ -110,6 +125,8 @@ void AutomatonCanvas::drawState(QPainter& painter, const State& state, bool high
     // Add selection highlight background
     if (isSelectedForProps) {
         painter.setBrush(QColor("#e3f2fd"));  // Light blue background
+    } else if (isActive) {
+        painter.setBrush(QColor("#ffe0b2"));  // Light orange background
     } else {
         painter.setBrush(Qt::white);
     }
@@ -134,7 +151,7 @@ void AutomatonCanvas::drawState(QPainter& painter, const State& state, bool high
     painter.setFont(font);
 
     QRectF textRect(pos.x() - radius, pos.y() - radius, radius * 2, radius * 2);
-    painter.drawText(textRect, Qt::AlignCenter, state.getLabel());
+    painter.drawText(textRect, Qt::AlignCenter, layout.getLabel(state.getId()));
 }
 
 void AutomatonCanvas::drawTransition(QPainter& painter, const Transition& trans) {
@@ -149,8 +166,9 @@ void AutomatonCanvas::drawTransition(QPainter& painter, const Transition& trans)
         return;
     }
 
-    QPointF start = fromState->getPosition();
-    QPointF end = toState->getPosition();
+    const AutomatonLayout& layout = currentAutomaton->getLayout();
+    QPointF start = layout.getPosition(fromState->getId());
+    QPointF end = layout.getPosition(toState->getId());
 
     // Check if there's a reverse transition
     bool hasReverse = hasReverseTransition(trans.getFromStateId(), trans.getToStateId());
@@ -179,8 +197,8 @@ void AutomatonCanvas::drawTransition(QPainter& painter, const Transition& trans)
                              trans.getSymbolsString(), isForwardDirection);
     } else {
         // Draw straight transition
-        QPointF edgeStart = calculateEdgePoint(start, end, fromState->getRadius());
-        QPointF edgeEnd = calculateEdgePoint(end, start, toState->getRadius());
+        QPointF edgeStart = calculateEdgePoint(start, end, layout.getRadius(fromState->getId()));
+        QPointF edgeEnd = calculateEdgePoint(end, start, layout.getRadius(toState->getId()));
 
         painter.setPen(QPen(Qt::black, 2));
         painter.drawLine(edgeStart, edgeEnd);
@@ -366,8 +384,8 @@ void AutomatonCanvas::drawArrow(QPainter& painter, const QPointF& start, const Q
 }
 
 void AutomatonCanvas::drawSelfLoop(QPainter& painter, const State& state, const QString& label) {
-    QPointF pos = state.getPosition();
-    double radius = state.getRadius();
+    QPointF pos = currentAutomaton->getLayout().getPosition(state.getId());
+    double radius = currentAutomaton->getLayout().getRadius(state.getId());
 
     QRectF loopRect(pos.x() - 20, pos.y() - radius - 50, 40, 40);
 
@@ -412,7 +430,7 @@ bool AutomatonCanvas::hasReverseTransition(const QString& fromId, const QString&
 }
 
 void AutomatonCanvas::mousePressEvent(QMouseEvent *event) {
-    if (!currentAutomaton) return;
+    if (!currentAutomaton || !history) return;
 
     QPointF clickPos = event->pos();
     State* clickedState = findStateAtPosition(clickPos);
@@ -421,10 +439,7 @@ void AutomatonCanvas::mousePressEvent(QMouseEvent *event) {
     case DrawMode::AddState: {
         if (!clickedState) {
             QString stateId = generateStateId();
-            State newState(stateId, stateId, clickPos);
-            newState.setRadius(stateRadius);
-
-            if (currentAutomaton->addState(newState)) {
+            if (history->addState(stateId, clickPos, stateRadius)) {
                 emit stateAdded(stateId);
                 emit automatonModified();
                 update();
@@ -464,8 +479,8 @@ void AutomatonCanvas::mousePressEvent(QMouseEvent *event) {
                 QVBoxLayout* layout = new QVBoxLayout(&dialog);
 
                 QLabel* infoLabel = new QLabel(QString("From: <b>%1</b> → To: <b>%2</b>")
-                                                   .arg(fromState->getLabel())
-                                                   .arg(clickedState->getLabel()));
+                                                   .arg(currentAutomaton->getLayout().getLabel(fromState->getId()))
+                                                   .arg(currentAutomaton->getLayout().getLabel(clickedState->getId())));
                 infoLabel->setStyleSheet("color: black; padding: 5px;");
                 layout->addWidget(infoLabel);
 
@@ -513,27 +528,19 @@ void AutomatonCanvas::mousePressEvent(QMouseEvent *event) {
                             symbol = "E";
                         }
 
-                        Transition trans(fromState->getId(), clickedState->getId(), symbol);
-
                         QString errorMsg;
-                        if (currentAutomaton->canAddTransition(trans, &errorMsg)) {
-                            if (currentAutomaton->addTransition(trans)) {
-                                if (symbol != "E") {
-                                    currentAutomaton->addToAlphabet(symbol);
-                                }
-
-                                emit transitionAdded(fromState->getId(), clickedState->getId());
-                                emit automatonModified();
-
-                                QMainWindow* mainWindow = qobject_cast<QMainWindow*>(window());
-                                if (mainWindow && mainWindow->statusBar()) {
-                                    QString displaySymbol = (symbol == "E") ? "ε (epsilon)" : symbol;
-                                    mainWindow->statusBar()->showMessage(
-                                        QString("✓ Transition added: %1 --(%2)--> %3")
-                                            .arg(fromState->getLabel())
-                                            .arg(displaySymbol)
-                                            .arg(clickedState->getLabel()), 3000);
-                                }
+                        if (history->addTransition(fromState->getId(), clickedState->getId(), symbol, &errorMsg)) {
+                            emit transitionAdded(fromState->getId(), clickedState->getId());
+                            emit automatonModified();
+
+                            QMainWindow* mainWindow = qobject_cast<QMainWindow*>(window());
+                            if (mainWindow && mainWindow->statusBar()) {
+                                QString displaySymbol = (symbol == "E") ? "ε (epsilon)" : symbol;
+                                mainWindow->statusBar()->showMessage(
+                                    QString("✓ Transition added: %1 --(%2)--> %3")
+                                        .arg(currentAutomaton->getLayout().getLabel(fromState->getId()))
+                                        .arg(displaySymbol)
+                                        .arg(currentAutomaton->getLayout().getLabel(clickedState->getId())), 3000);
                             }
                         } else {
                             QMessageBox msgBox(this);
@@ -574,7 +581,7 @@ void AutomatonCanvas::mousePressEvent(QMouseEvent *event) {
             if (currentSelectedStateForPropertiesId == stateIdToDelete) currentSelectedStateForPropertiesId = "";
             if (draggedStateId == stateIdToDelete) draggedStateId = "";
 
-            if (currentAutomaton->removeState(stateIdToDelete)) {
+            if (history->removeState(stateIdToDelete)) {
                 emit stateRemoved(stateIdToDelete);
                 emit automatonModified();
                 update();
@@ -586,6 +593,7 @@ void AutomatonCanvas::mousePressEvent(QMouseEvent *event) {
     case DrawMode::Select: {
         if (clickedState) {
             draggedStateId = clickedState->getId();
+            dragStartPos = currentAutomaton->getLayout().getPosition(draggedStateId);
             isDragging = true;
 
             currentSelectedStateForPropertiesId = clickedState->getId();
@@ -614,7 +622,7 @@ void AutomatonCanvas::mouseMoveEvent(QMouseEvent *event) {
     if (isDragging && !draggedStateId.isEmpty()) {
         State* dragged = currentAutomaton->getState(draggedStateId);
         if (dragged) { // Always check if state still exists
-            dragged->setPosition(mousePos);
+            currentAutomaton->getLayout().setPosition(draggedStateId, mousePos);
             update();
         } else {
             // State was deleted during drag
@@ -630,6 +638,10 @@ void AutomatonCanvas::mouseMoveEvent(QMouseEvent *event) {
 
 void AutomatonCanvas::mouseReleaseEvent(QMouseEvent *event) {
     if (isDragging) {
+        if (history && currentAutomaton) {
+            history->recordMove(draggedStateId, dragStartPos,
+                                currentAutomaton->getLayout().getPosition(draggedStateId));
+        }
         isDragging = false;
         draggedStateId = "";
         emit automatonModified();
@@ -637,12 +649,13 @@ void AutomatonCanvas::mouseReleaseEvent(QMouseEvent *event) {
 }
 
 void AutomatonCanvas::mouseDoubleClickEvent(QMouseEvent *event) {
-    if (!currentAutomaton || currentMode != DrawMode::Select) return;
+    if (!currentAutomaton || !history || currentMode != DrawMode::Select) return;
 
     State* clickedState = findStateAtPosition(event->pos());
     if (clickedState) {
         QDialog dialog(this);
-        dialog.setWindowTitle("State Properties: " + clickedState->getLabel());
+        const AutomatonLayout& stateLayout = currentAutomaton->getLayout();
+        dialog.setWindowTitle("State Properties: " + stateLayout.getLabel(clickedState->getId()));
 
         dialog.setStyleSheet(
             "QDialog { background-color: #f0f0f0; }"
@@ -660,7 +673,7 @@ void AutomatonCanvas::mouseDoubleClickEvent(QMouseEvent *event) {
         labelLabel->setStyleSheet("color: black; font-weight: bold;");
         labelLayout->addWidget(labelLabel);
 
-        QLineEdit* labelEdit = new QLineEdit(clickedState->getLabel());
+        QLineEdit* labelEdit = new QLineEdit(stateLayout.getLabel(clickedState->getId()));
         labelLayout->addWidget(labelEdit);
         layout->addLayout(labelLayout);
 
@@ -703,21 +716,23 @@ void AutomatonCanvas::mouseDoubleClickEvent(QMouseEvent *event) {
         connect(cancelBtn, &QPushButton::clicked, &dialog, &QDialog::reject);
 
         if (dialog.exec() == QDialog::Accepted) {
+            QString stateId = clickedState->getId();
+
+            // All property changes from one dialog undo together
+            history->beginStep();
             QString newLabel = labelEdit->text().trimmed();
             if (!newLabel.isEmpty()) {
-                clickedState->setLabel(newLabel);
+                history->setLabel(stateId, newLabel);
             }
 
             if (initialCheck->isChecked() && !clickedState->getIsInitial()) {
-                currentAutomaton->setInitialState(clickedState->getId());
+                history->setInitialState(stateId);
             } else if (!initialCheck->isChecked() && clickedState->getIsInitial()) {
-                clickedState->setIsInitial(false);
-                if (currentAutomaton->getInitialStateId() == clickedState->getId()) {
-                    currentAutomaton->setInitialState("");
-                }
+                history->setInitialState("");
             }
 
-            clickedState->setIsFinal(finalCheck->isChecked());
+            history->setFinal(stateId, finalCheck->isChecked());
+            history->endStep();
 
             emit automatonModified();
             update();
@@ -726,7 +741,7 @@ void AutomatonCanvas::mouseDoubleClickEvent(QMouseEvent *event) {
 }
 
 void AutomatonCanvas::contextMenuEvent(QContextMenuEvent *event) {
-    if (!currentAutomaton) return;
+    if (!currentAutomaton || !history) return;
 
     State* clickedState = findStateAtPosition(event->pos());
     if (clickedState) {
@@ -761,17 +776,12 @@ void AutomatonCanvas::contextMenuEvent(QContextMenuEvent *event) {
             mouseDoubleClickEvent(&fakeEvent);
         }
         else if (selected == setInitialAction) {
-            if (clickedState->getIsInitial()) {
-                clickedState->setIsInitial(false);
-                currentAutomaton->setInitialState("");
-            } else {
-                currentAutomaton->setInitialState(clickedState->getId());
-            }
+            history->setInitialState(clickedState->getIsInitial() ? QString() : clickedState->getId());
             emit automatonModified();
             update();
         }
         else if (selected == setFinalAction) {
-            clickedState->setIsFinal(!clickedState->getIsFinal());
+            history->setFinal(clickedState->getId(), !clickedState->getIsFinal());
             emit automatonModified();
             update();
         }
@@ -784,7 +794,7 @@ void AutomatonCanvas::contextMenuEvent(QContextMenuEvent *event) {
             if (currentSelectedStateForPropertiesId == stateIdToDelete) currentSelectedStateForPropertiesId = "";
             if (draggedStateId == stateIdToDelete) draggedStateId = "";
 
-            currentAutomaton->removeState(stateIdToDelete);
+            history->removeState(stateIdToDelete);
             emit automatonModified();
             update();
         }
@@ -795,7 +805,7 @@ State* AutomatonCanvas::findStateAtPosition(const QPointF& pos) {
     if (!currentAutomaton) return nullptr;
 
     for (auto& state : currentAutomaton->getStates()) {
-        if (state.containsPoint(pos)) {
+        if (currentAutomaton->getLayout().containsPoint(state.getId(), pos)) {
             return &state;
         }
     }
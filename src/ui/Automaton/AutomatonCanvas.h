@@ -5,7 +5,8 @@
 #include <QPainter>
 #include <QMouseEvent>
 #include <QContextMenuEvent>
-#include "./src/models/Automaton/Automaton.h"
+#include <QSet>
+#include "./src/models/Automaton/AutomatonHistory.h"
 
 enum class DrawMode {
     Select,
@@ -19,6 +20,7 @@ class AutomatonCanvas : public QWidget {
 
 private:
     Automaton* currentAutomaton;
+    AutomatonHistory* history;      // every edit goes through this so it can be undone
     DrawMode currentMode;
 
     // REPLACED: State pointers with QString IDs to prevent dangling pointers
@@ -29,20 +31,26 @@ private:
     bool isDrawingTransition;
 
     QString draggedStateId;
+    QPointF dragStartPos;
     bool isDragging;
 
+    QSet<QString> activeStateIds;   // states reached at the current step of a test run
+
     const double stateRadius = 30.0;
     const double finalStateInnerRadius = 24.0;
 
 public:
     explicit AutomatonCanvas(QWidget *parent = nullptr);
 
-    void setAutomaton(Automaton* automaton);
+    void setAutomaton(Automaton* automaton, AutomatonHistory* automatonHistory = nullptr);
     Automaton* getAutomaton() { return currentAutomaton; }
 
     void setDrawMode(DrawMode mode);
     DrawMode getDrawMode() const { return currentMode; }
 
+    void setActiveStates(const QSet<QString>& stateIds);
+    void clearActiveStates() { setActiveStates(QSet<QString>()); }
+
 signals:
     void stateAdded(const QString& stateId);
     void stateRemoved(const QString& stateId);
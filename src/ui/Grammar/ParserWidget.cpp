@@ -11,6 +11,7 @@ ParserWidget::ParserWidget(QWidget *parent)
 
     currentGrammar = new Grammar();
     parser = new Parser(currentGrammar);
+    grammarAnalysis = new IncrementalGrammarAnalyzer(*currentGrammar);
     lexer = new Lexer();
 
     setupUI();
@@ -23,6 +24,7 @@ ParserWidget::ParserWidget(QWidget *parent)
 ParserWidget::~ParserWidget() {
     delete currentGrammar;
     delete parser;
+    delete grammarAnalysis;
     delete lexer;
 }
 
@@ -208,6 +210,7 @@ void ParserWidget::onLoadGrammar() {
         currentGrammar->clear();
         currentGrammar->setName("Custom Grammar");
         currentGrammar->setStartSymbol("S");
+        grammarAnalysis->reset(*currentGrammar);
     }
 
     updateGrammarDisplay();
@@ -229,6 +232,7 @@ void ParserWidget::loadPredefinedGrammar(const QString& grammarName) {
     }
 
     parser->setGrammar(currentGrammar);
+    grammarAnalysis->reset(*currentGrammar);
 }
 
 void ParserWidget::onAddProduction() {
@@ -248,8 +252,9 @@ void ParserWidget::onAddProduction() {
     }
 
     currentGrammar->addProduction(prod);
+    grammarAnalysis->addProduction(prod);
     updateGrammarDisplay();
-    updateProductionsList();
+    productionsList->addItem(prod.toString());
 
     productionInput->clear();
     statusLabel->setText(QString("Added: %1").arg(prod.toString()));
@@ -259,8 +264,9 @@ void ParserWidget::onDeleteProduction() {
     int currentRow = productionsList->currentRow();
     if (currentRow >= 0) {
         currentGrammar->removeProduction(currentRow);
+        grammarAnalysis->removeProduction(currentRow);
         updateGrammarDisplay();
-        updateProductionsList();
+        delete productionsList->takeItem(currentRow);
         statusLabel->setText("Production deleted");
     }
 }
@@ -273,6 +279,7 @@ void ParserWidget::onClearGrammar() {
 
     if (reply == QMessageBox::Yes) {
         currentGrammar->clear();
+        grammarAnalysis->reset(*currentGrammar);
         updateGrammarDisplay();
         updateProductionsList();
         statusLabel->setText("Grammar cleared");
@@ -347,6 +354,17 @@ void ParserWidget::updateGrammarDisplay() {
     info += QString("<br><b>Total Productions:</b> %1")
                 .arg(currentGrammar->getProductions().size());
 
+    // Conflicts come from the incremental analysis, so this stays cheap on large grammars
+    if (grammarAnalysis->isLL1()) {
+        info += "<br><b>LL(1):</b> yes";
+    } else {
+        info += QString("<br><b>LL(1):</b> no, %1 conflicting table cell(s)")
+                    .arg(grammarAnalysis->getConflictCellCount());
+        for (const QString& conflict : grammarAnalysis->getConflicts(5)) {
+            info += "<br>&nbsp;&nbsp;" + conflict.toHtmlEscaped();
+        }
+    }
+
     grammarInfoText->setHtml(info);
 }
 
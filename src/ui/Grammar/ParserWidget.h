@@ -11,6 +11,7 @@
 #include <QListWidget>
 #include "./src/models/Grammar/Grammar.h"
 #include "./src/utils/Grammar/Parser.h"
+#include "./src/utils/Grammar/IncrementalGrammarAnalyzer.h"
 #include "ParseTreeWidget.h"
 #include "./src/utils/LexicalAnalysis/Lexer.h"
 #include "./src/utils/LexicalAnalysis/AutomatonManager.h"
@@ -42,6 +43,7 @@ private:
     // Core components
     Grammar* currentGrammar;
     Parser* parser;
+    IncrementalGrammarAnalyzer* grammarAnalysis;   // FIRST/FOLLOW and LL(1) conflicts, kept current per edit
     Lexer* lexer;
     AutomatonManager* automatonManager;
 
@@ -1,8 +1,15 @@
 ﻿#include "MainWindow.h" // Includes the main window class definition.
-#include "./src/utils/Automaton/NFAtoDFA.h" // Provides functionality to convert NFA to DFA.
-#include "./src/utils/Automaton/DFAMinimizer.h" // Provides functionality to minimize DFA.
+#include "./src/utils/Automaton/AutomatonRegistry.h" // Cached NFA to DFA conversion and DFA minimization.
+#include "./src/utils/Automaton/LanguageCounter.h" // Counts accepted words per length.
+#include "./src/utils/Automaton/LanguageEnumerator.h" // Enumerates accepted words lazily.
+#include "./src/utils/Automaton/DFABenchmark.h" // Benchmarks state layouts of compiled DFAs.
+#include "./src/utils/Automaton/GlushkovAutomaton.h" // Regex to position automaton construction.
+#include "./src/utils/Automaton/ExternalSubsetConstruction.h" // Out-of-core NFA to DFA conversion.
+#include "./src/utils/Semantic/ScheduleBenchmark.h" // Scheduled vs. unscheduled assembly output.
 #include <QInputDialog> // For getting single-line text input from the user.
 #include <QFileDialog>  // For file open/save dialogs (currently placeholders).
+#include <QFile>        // For reading long test inputs from disk.
+#include <QFileInfo>    // For the file name shown with a loaded test input.
 #include <QDialog>      // Base class for dialog windows.
 #include <QCheckBox>    // For checkbox widgets.
 #include <QtMath>       // For mathematical functions like qCeil and qSqrt used in layout calculations.
@@ -10,6 +17,13 @@
 #include <QButtonGroup> // Manages a group of buttons (e.g., radio buttons) to ensure exclusivity.
 #include <QHeaderView>  // For customizing table headers.
 #include <QDebug>       // For debugging output (qDebug(), qWarning(), qCritical()).
+#include <QApplication> // For qApp, used to quit from the File menu.
+#include <QPaintEvent>  // For timing the first paint of the window.
+#include <QProgressDialog> // For progress and cancel of long conversions.
+#include <QFutureWatcher>  // For the result of a conversion run on a worker thread.
+#include <QtConcurrent>    // For running conversions off the GUI thread.
+#include <QTimer>          // For polling a worker's progress.
+#include <memory>          // For state shared with a worker thread.
 
 // Constructor for the MainWindow class.
 // Initializes the main application window and its components.
@@ -20,20 +34,29 @@ MainWindow::MainWindow(QWidget *parent)
     currentAutomaton(nullptr), automatonCounter(0),
     currentSelectedStateId(""), automatonManager(nullptr), canvas(nullptr),
     centralTabs(nullptr), automatonTab(nullptr), lexerWidget(nullptr),
+    parserWidget(nullptr), semanticWidget(nullptr),
+    lexerTab(nullptr), parserTab(nullptr), semanticTab(nullptr), startupReported(false),
     toolsDock(nullptr), automatonListDock(nullptr), propertiesDock(nullptr),
     testingDock(nullptr), automatonList(nullptr), testResultsText(nullptr),
     typeLabel(nullptr), stateCountLabel(nullptr), transitionCountLabel(nullptr),
     alphabetLabel(nullptr), selectedStateLabel(nullptr), deleteStateBtn(nullptr),
     transitionTable(nullptr), convertNFAtoDFABtn(nullptr), minimizeDFABtn(nullptr),
-    testInputField(nullptr), testInputBtn(nullptr), clearTestBtn(nullptr),
+    testInputField(nullptr), testInputBtn(nullptr), clearTestBtn(nullptr), samplesBtn(nullptr),
+    loadTestBtn(nullptr), maxErrorsSpin(nullptr), traceStepSlider(nullptr), traceStepLabel(nullptr),
+    testTrace(nullptr), testMatcher(nullptr), benchmarkApproximateAction(nullptr), benchmarkScheduleAction(nullptr),
     selectModeBtn(nullptr), addStateModeBtn(nullptr), addTransitionModeBtn(nullptr),
     deleteModeBtn(nullptr), clearCanvasBtn(nullptr), newAutomatonBtn(nullptr),
     deleteAutomatonBtn(nullptr), renameAutomatonBtn(nullptr),
     newAction(nullptr), openAction(nullptr), saveAction(nullptr), exitAction(nullptr),
-    convertAction(nullptr), minimizeAction(nullptr), aboutAction(nullptr),
+    undoAction(nullptr), redoAction(nullptr),
+    convertAction(nullptr), minimizeAction(nullptr), benchmarkLayoutAction(nullptr),
+    regexAction(nullptr), externalConvertAction(nullptr), aboutAction(nullptr),
     selectAction(nullptr), addStateAction(nullptr), addTransitionAction(nullptr),
     deleteAction(nullptr) {
 
+    // Time every startup phase up to the first paint.
+    startupTimer.start();
+
     // Set the window title and initial size.
     setWindowTitle("Compiler Project");
     resize(1200, 700);
@@ -45,15 +68,19 @@ MainWindow::MainWindow(QWidget *parent)
         qCritical() << "Failed to create AutomatonManager!"; // Log critical error if creation fails.
         return; // Exit if a critical component cannot be initialized.
     }
+    markStartupPhase("automaton manager");
 
     // Setup the central tab widget which houses the different analysis tools.
     // This must be done before creating menus and dock widgets that might interact with these tabs.
     setupCentralTabs();
+    markStartupPhase("central tabs");
 
     // Create the application's menu bar (File, Tools, Help).
     createMenus();
+    markStartupPhase("menus");
     // Create and arrange the dockable widgets (Tools, Automaton List, Properties, Test Input).
     createDockWidgets();
+    markStartupPhase("docks");
 
     // Connect signals from the automaton canvas to slots in MainWindow.
     // This allows the main window to react to changes on the canvas (e.g., state selected, automaton modified).
@@ -85,6 +112,38 @@ MainWindow::MainWindow(QWidget *parent)
 
     // Set the initial message in the status bar.
     statusBar()->showMessage("Ready - Click 'New' or switch to Lexical Analyzer tab");
+    markStartupPhase("constructor");
+}
+
+void MainWindow::paintEvent(QPaintEvent* event) {
+    QMainWindow::paintEvent(event);
+
+    if (!startupReported) {
+        startupReported = true;
+        markStartupPhase("first paint");
+        reportStartupTiming();
+    }
+}
+
+void MainWindow::markStartupPhase(const QString& phase) {
+    startupPhases.append(qMakePair(phase, startupTimer.elapsed()));
+}
+
+void MainWindow::reportStartupTiming() {
+    QStringList parts;
+    qint64 previous = 0;
+    for (const auto& phase : startupPhases) {
+        parts << QString("%1 %2 ms").arg(phase.first).arg(phase.second - previous);
+        previous = phase.second;
+    }
+
+    QString report = QString("Startup: %1 ms to first paint (budget %2 ms) - %3")
+                         .arg(previous).arg(StartupBudgetMs).arg(parts.join(", "));
+    if (previous > StartupBudgetMs) {
+        qWarning() << report;
+    } else {
+        qDebug() << report;
+    }
 }
 
 // Destructor for the MainWindow class.
@@ -111,6 +170,16 @@ MainWindow::~MainWindow() {
     }
     automatons.clear(); // Clears the map itself, removing all key-value pairs.
 
+    // Undo histories only point at the automatons, so they can go right after them.
+    qDeleteAll(histories);
+    histories.clear();
+
+    // The last test run keeps its own copy of the automaton tables.
+    delete testTrace;
+    testTrace = nullptr;
+    delete testMatcher;
+    testMatcher = nullptr;
+
     // Reset pointers to nullptr to avoid dangling pointers.
     currentAutomaton = nullptr;
 
@@ -154,6 +223,20 @@ void MainWindow::createMenus() {
     connect(exitAction, &QAction::triggered, this, &MainWindow::onExit);
     fileMenu->addAction(exitAction);
 
+    QMenu* editMenu = menuBar()->addMenu("&Edit");
+
+    undoAction = new QAction("&Undo", this);
+    undoAction->setShortcut(QKeySequence::Undo);
+    undoAction->setEnabled(false);
+    connect(undoAction, &QAction::triggered, this, &MainWindow::onUndo);
+    editMenu->addAction(undoAction);
+
+    redoAction = new QAction("&Redo", this);
+    redoAction->setShortcut(QKeySequence::Redo);
+    redoAction->setEnabled(false);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::onRedo);
+    editMenu->addAction(redoAction);
+
     QMenu* toolsMenu = menuBar()->addMenu("&Tools");
 
     convertAction = new QAction("Convert NFA to DFA", this);
@@ -166,6 +249,29 @@ void MainWindow::createMenus() {
     connect(minimizeAction, &QAction::triggered, this, &MainWindow::onMinimizeDFA);
     toolsMenu->addAction(minimizeAction);
 
+    regexAction = new QAction("New from Regex...", this);
+    regexAction->setShortcut(Qt::CTRL + Qt::Key_R);
+    connect(regexAction, &QAction::triggered, this, &MainWindow::onNewFromRegex);
+    toolsMenu->addAction(regexAction);
+
+    externalConvertAction = new QAction("Determinize to Disk...", this);
+    connect(externalConvertAction, &QAction::triggered, this, &MainWindow::onDeterminizeToDisk);
+    toolsMenu->addAction(externalConvertAction);
+
+    toolsMenu->addSeparator();
+
+    benchmarkLayoutAction = new QAction("Benchmark DFA Layout", this);
+    connect(benchmarkLayoutAction, &QAction::triggered, this, &MainWindow::onBenchmarkLayout);
+    toolsMenu->addAction(benchmarkLayoutAction);
+
+    benchmarkApproximateAction = new QAction("Benchmark Approximate Matching", this);
+    connect(benchmarkApproximateAction, &QAction::triggered, this, &MainWindow::onBenchmarkApproximate);
+    toolsMenu->addAction(benchmarkApproximateAction);
+
+    benchmarkScheduleAction = new QAction("Benchmark Instruction Scheduling", this);
+    connect(benchmarkScheduleAction, &QAction::triggered, this, &MainWindow::onBenchmarkSchedule);
+    toolsMenu->addAction(benchmarkScheduleAction);
+
     QMenu* helpMenu = menuBar()->addMenu("&Help");
 
     aboutAction = new QAction("&About", this);
@@ -400,6 +506,12 @@ void MainWindow::createTestingPanel() {
     connect(testInputField, &QLineEdit::returnPressed, this, &MainWindow::onTestInput);
     inputLayout->addWidget(testInputField);
 
+    inputLayout->addWidget(new QLabel("Errors:"));
+    maxErrorsSpin = new QSpinBox();
+    maxErrorsSpin->setRange(0, ApproximateMatcher::MaxErrors);
+    maxErrorsSpin->setToolTip("Insertions, deletions or substitutions allowed when the input is rejected");
+    inputLayout->addWidget(maxErrorsSpin);
+
     testInputBtn = new QPushButton("Test");
     testInputBtn->setMaximumWidth(60);
     connect(testInputBtn, &QPushButton::clicked, this, &MainWindow::onTestInput);
@@ -410,8 +522,35 @@ void MainWindow::createTestingPanel() {
     connect(clearTestBtn, &QPushButton::clicked, this, &MainWindow::onClearTest);
     inputLayout->addWidget(clearTestBtn);
 
+    samplesBtn = new QPushButton("Samples");
+    samplesBtn->setMaximumWidth(70);
+    samplesBtn->setToolTip("List the shortest accepted words and word counts per length");
+    connect(samplesBtn, &QPushButton::clicked, this, &MainWindow::onGenerateSamples);
+    inputLayout->addWidget(samplesBtn);
+
+    loadTestBtn = new QPushButton("Load...");
+    loadTestBtn->setMaximumWidth(70);
+    loadTestBtn->setToolTip("Test the contents of a text file, for inputs too long to type");
+    connect(loadTestBtn, &QPushButton::clicked, this, &MainWindow::onLoadTestInput);
+    inputLayout->addWidget(loadTestBtn);
+
     layout->addLayout(inputLayout);
 
+    // Step through the last run; the canvas highlights the states active at the chosen step
+    QHBoxLayout* stepLayout = new QHBoxLayout();
+    stepLayout->addWidget(new QLabel("Step:"));
+
+    traceStepSlider = new QSlider(Qt::Horizontal);
+    traceStepSlider->setEnabled(false);
+    connect(traceStepSlider, &QSlider::valueChanged, this, &MainWindow::onTraceStepChanged);
+    stepLayout->addWidget(traceStepSlider, 1);
+
+    traceStepLabel = new QLabel("Run a test to step through it");
+    traceStepLabel->setMinimumWidth(260);
+    stepLayout->addWidget(traceStepLabel, 1);
+
+    layout->addLayout(stepLayout);
+
     testResultsText = new QTextEdit();
     testResultsText->setReadOnly(true);
     testResultsText->setMaximumHeight(80);
@@ -419,7 +558,7 @@ void MainWindow::createTestingPanel() {
 
     testWidget->setLayout(layout);
     testingDock->setWidget(testWidget);
-    testingDock->setMaximumHeight(150);
+    testingDock->setMaximumHeight(180);
     addDockWidget(Qt::BottomDockWidgetArea, testingDock);
 }
 
@@ -767,16 +906,19 @@ void MainWindow::onDeleteAutomaton() {
             if (currentAutomaton && currentAutomaton->getId() == id) {
                 currentAutomaton = nullptr;
                 currentSelectedStateId = "";
+                resetTestMatcher();
                 if (canvas) {
                     canvas->setAutomaton(nullptr);
                 }
             }
 
+            delete histories.take(automatons[id]);
             delete automatons[id];
             automatons.remove(id);
 
             updateAutomatonList();
             updateProperties();
+            updateUndoActions();
             statusBar()->showMessage("Automaton deleted");
         }
     }
@@ -834,12 +976,13 @@ void MainWindow::onClearCanvas() {
     msgBox.setIcon(QMessageBox::Question);
 
     if (msgBox.exec() == QMessageBox::Yes) {
-        currentAutomaton->clear();
+        historyFor(currentAutomaton)->clearAutomaton();
         currentSelectedStateId = "";
         if (canvas) {
             canvas->update();
         }
         updateProperties();
+        updateUndoActions();
         statusBar()->showMessage("Canvas cleared");
     }
 }
@@ -885,7 +1028,8 @@ void MainWindow::onDeleteStateOrTransition() {
 
     QVBoxLayout* mainLayout = new QVBoxLayout(&dialog);
 
-    QLabel* titleLabel = new QLabel(QString("Delete options for state: <b>%1</b>").arg(selectedState->getLabel()));
+    QLabel* titleLabel = new QLabel(QString("Delete options for state: <b>%1</b>")
+                                        .arg(currentAutomaton->getLayout().getLabel(selectedState->getId())));
     titleLabel->setStyleSheet("color: white; font-size: 12pt; padding: 10px;");
     mainLayout->addWidget(titleLabel);
 
@@ -982,21 +1126,23 @@ void MainWindow::onDeleteStateOrTransition() {
                 "QPushButton { color: white; background-color: #3e3e3e; border: 1px solid #555; padding: 5px 15px; }"
                 );
             confirmBox.setWindowTitle("Confirm Delete State");
-            confirmBox.setText(QString("Really delete state '%1' and all its transitions?").arg(selectedState->getLabel()));
+            confirmBox.setText(QString("Really delete state '%1' and all its transitions?")
+                                   .arg(currentAutomaton->getLayout().getLabel(selectedState->getId())));
             confirmBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
             confirmBox.setIcon(QMessageBox::Warning);
 
             if (confirmBox.exec() == QMessageBox::Yes) {
                 QString stateId = currentSelectedStateId;
-                QString stateLabel = selectedState->getLabel();
+                QString stateLabel = currentAutomaton->getLayout().getLabel(selectedState->getId());
 
                 // Clear selection BEFORE deleting to prevent accessing deleted state
                 currentSelectedStateId = "";
 
                 // Safely delete the state
-                if (currentAutomaton->removeState(stateIdToDelete)) {
+                if (historyFor(currentAutomaton)->removeState(stateIdToDelete)) {
                     statusBar()->showMessage(QString("✓ State '%1' deleted").arg(stateLabel), 3000);
                     updateProperties();
+                    updateUndoActions();
                     if (canvas) {
                         canvas->update();
                     }
@@ -1014,6 +1160,9 @@ void MainWindow::onDeleteStateOrTransition() {
                 return;
             }
 
+            // Deleting several transitions at once is a single undo step
+            AutomatonHistory* history = historyFor(currentAutomaton);
+            history->beginStep();
             int deletedCount = 0;
             for (auto* item : selected) {
                 QString toState = item->data(Qt::UserRole).toString();
@@ -1027,15 +1176,17 @@ void MainWindow::onDeleteStateOrTransition() {
                         actualSymbol = "E";
                     }
 
-                    if (currentAutomaton->removeTransition(currentSelectedStateId, toState, actualSymbol)) {
+                    if (history->removeTransition(currentSelectedStateId, toState, actualSymbol)) {
                         deletedCount++;
                     }
                 }
             }
+            history->endStep();
 
             if (deletedCount > 0) {
                 statusBar()->showMessage(QString("✓ Deleted %1 transition(s)").arg(deletedCount), 3000);
                 updateProperties();
+                updateUndoActions();
                 if (canvas) {
                     canvas->update();
                 }
@@ -1066,25 +1217,15 @@ void MainWindow::onConvertNFAtoDFA() {
     }
 
     try {
-        NFAtoDFA converter;
-        Automaton* dfaAutomaton = converter.convert(currentAutomaton);
+        // Repeated conversions of the same NFA are served from the registry
+        bool fromCache = false;
+        Automaton* dfaAutomaton = automatonManager->getRegistry()->convertToDFA(currentAutomaton, &fromCache);
 
         if (dfaAutomaton) {
             QString id = generateAutomatonId();
             dfaAutomaton->setName(currentAutomaton->getName() + " (DFA)");
 
-            int stateCount = dfaAutomaton->getStateCount();
-            int cols = qCeil(qSqrt(stateCount));
-            int row = 0, col = 0;
-
-            for (auto& state : dfaAutomaton->getStates()) {
-                state.setPosition(QPointF(100 + col * 120, 100 + row * 120));
-                col++;
-                if (col >= cols) {
-                    col = 0;
-                    row++;
-                }
-            }
+            dfaAutomaton->getLayout().arrangeInGrid(dfaAutomaton->getStates());
 
             automatons[id] = dfaAutomaton;
             updateAutomatonList();
@@ -1106,7 +1247,7 @@ void MainWindow::onConvertNFAtoDFA() {
                                      .arg(dfaAutomaton->getStateCount()),
                                  QMessageBox::Information);
 
-            statusBar()->showMessage("NFA converted to DFA");
+            statusBar()->showMessage(fromCache ? "NFA converted to DFA (cached result)" : "NFA converted to DFA");
         }
     } catch (const std::exception& e) {
         showStyledMessageBox("Error",
@@ -1178,26 +1319,16 @@ void MainWindow::onMinimizeDFA() {
     }
 
     try {
-        DFAMinimizer minimizer;
-        Automaton* minimizedDFA = minimizer.minimize(currentAutomaton);
+        // Repeated minimizations of the same DFA are served from the registry
+        bool fromCache = false;
+        Automaton* minimizedDFA = automatonManager->getRegistry()->minimize(currentAutomaton, &fromCache);
 
         if (minimizedDFA) {
             QString id = generateAutomatonId();
             minimizedDFA->setName(currentAutomaton->getName() + " (Minimized)");
 
             // Layout minimized states
-            int stateCount = minimizedDFA->getStateCount();
-            int cols = qCeil(qSqrt(stateCount));
-            int row = 0, col = 0;
-
-            for (auto& state : minimizedDFA->getStates()) {
-                state.setPosition(QPointF(100 + col * 120, 100 + row * 120));
-                col++;
-                if (col >= cols) {
-                    col = 0;
-                    row++;
-                }
-            }
+            minimizedDFA->getLayout().arrangeInGrid(minimizedDFA->getStates());
 
             automatons[id] = minimizedDFA;
             updateAutomatonList();
@@ -1226,7 +1357,10 @@ void MainWindow::onMinimizeDFA() {
 
             showStyledMessageBox("Minimization Complete", resultMsg, QMessageBox::Information);
 
-            statusBar()->showMessage(QString("DFA minimized: %1 → %2 states").arg(originalStates).arg(minimizedStates), 5000);
+            statusBar()->showMessage(QString("DFA minimized: %1 → %2 states%3")
+                                         .arg(originalStates)
+                                         .arg(minimizedStates)
+                                         .arg(fromCache ? " (cached result)" : ""), 5000);
         } else {
             showStyledMessageBox("Error", "Failed to minimize DFA.", QMessageBox::Critical);
         }
@@ -1237,22 +1371,372 @@ void MainWindow::onMinimizeDFA() {
     }
 }
 
-void MainWindow::onTestInput() {
+void MainWindow::onNewFromRegex() {
+    bool ok = false;
+    QString pattern = QInputDialog::getText(this, "New from Regex",
+                                            "Regular expression (| * + ? {m,n} [a-z] \\d \\w):",
+                                            QLineEdit::Normal, QString(), &ok);
+    if (!ok || pattern.isEmpty()) {
+        return;
+    }
+
+    GlushkovAutomaton positions;
+    QString error;
+    if (!positions.build(pattern, &error)) {
+        showStyledMessageBox("Error", QString("Invalid regular expression: %1").arg(error),
+                             QMessageBox::Critical);
+        return;
+    }
+
+    // Epsilon-free by construction; typed DFA when no two successors share a symbol.
+    // An NFA reading 'E' would be misread (E is the editor's epsilon), so determinize it.
+    QString id = generateAutomatonId();
+    Automaton* automaton = nullptr;
+    if (!positions.isDeterministic() && positions.alphabet().contains('E')) {
+        CompiledDFA dfa;
+        if (!positions.toDFA(dfa, &error)) {
+            showStyledMessageBox("Error", error, QMessageBox::Critical);
+            return;
+        }
+        automaton = dfa.toAutomaton(id, pattern);
+    } else {
+        automaton = positions.toAutomaton(id, pattern);
+    }
+    automaton->getLayout().arrangeInGrid(automaton->getStates());
+
+    automatons[id] = automaton;
+    updateAutomatonList();
+
+    for (int i = 0; i < automatonList->count(); ++i) {
+        QListWidgetItem* item = automatonList->item(i);
+        if (item && item->data(Qt::UserRole).toString() == id) {
+            automatonList->setCurrentItem(item);
+            setCurrentAutomaton(automaton);
+            break;
+        }
+    }
+
+    statusBar()->showMessage(QString("Built %1 from %2 positions")
+                                 .arg(automaton->isDFA() ? "DFA" : "NFA")
+                                 .arg(positions.getPositionCount()), 5000);
+}
+
+void MainWindow::onDeterminizeToDisk() {
     if (!currentAutomaton) {
         showStyledMessageBox("Warning", "No automaton selected.", QMessageBox::Warning);
         return;
     }
 
+    QString path = QFileDialog::getSaveFileName(this, "Save DFA Table", currentAutomaton->getName() + ".xdfa",
+                                                "DFA tables (*.xdfa)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    // The worker converts its own copy, so the automaton stays editable meanwhile
+    QString name = currentAutomaton->getName();
+    auto nfa = std::make_shared<Automaton>(*currentAutomaton);
+    auto construction = std::make_shared<ExternalSubsetConstruction>();
+    auto error = std::make_shared<QString>();
+    auto cancelRequested = std::make_shared<QAtomicInt>(0);
+    auto level = std::make_shared<QAtomicInt>(0);
+    auto states = std::make_shared<QAtomicInteger<qint64>>(0);
+    construction->setProgressCallback([cancelRequested, level, states](int currentLevel, qint64 found) {
+        level->storeRelaxed(currentLevel);
+        states->storeRelaxed(found);
+        return cancelRequested->loadRelaxed() == 0;
+    });
+
+    QProgressDialog* progress = new QProgressDialog("Determinizing to disk...", "Cancel", 0, 0, this);
+    progress->setWindowTitle("Determinize to Disk");
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    connect(progress, &QProgressDialog::canceled, this, [cancelRequested]() {
+        cancelRequested->storeRelaxed(1);
+    });
+
+    QTimer* poll = new QTimer(progress);
+    connect(poll, &QTimer::timeout, progress, [progress, level, states]() {
+        progress->setLabelText(QString("Determinizing to disk...\nBFS level %1, %2 states found")
+                                   .arg(level->loadRelaxed() + 1)
+                                   .arg(states->loadRelaxed()));
+    });
+    poll->start(200);
+
+    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this,
+            [this, watcher, progress, construction, error, cancelRequested, path, name]() {
+        progress->deleteLater();
+        watcher->deleteLater();
+        if (!watcher->result()) {
+            statusBar()->clearMessage();
+            if (cancelRequested->loadRelaxed()) {
+                statusBar()->showMessage("Determinization cancelled", 5000);
+            } else {
+                showStyledMessageBox("Error", QString("Determinization failed: %1").arg(*error), QMessageBox::Critical);
+            }
+            return;
+        }
+        showDeterminizeResult(construction->getStats(), path, name);
+    });
+
+    statusBar()->showMessage("Determinizing to disk...");
+    watcher->setFuture(QtConcurrent::run([nfa, construction, path, error]() {
+        return construction->convert(nfa.get(), path, error.get());
+    }));
+}
+
+void MainWindow::showDeterminizeResult(const ExternalConstructionStats& stats, const QString& path,
+                                       const QString& name) {
+    QString error;
+    QString summary = QString("DFA table written to %1\n\n"
+                              "States: %2\nTransitions: %3\nBFS levels: %4\n"
+                              "Sorted runs spilled: %5\nBytes written: %6")
+                          .arg(path)
+                          .arg(stats.stateCount)
+                          .arg(stats.transitionCount)
+                          .arg(stats.levels)
+                          .arg(stats.spilledRuns)
+                          .arg(stats.bytesWritten);
+
+    // Small results are also opened in the editor
+    const qint64 maxEditableStates = 200;
+    if (stats.stateCount <= maxEditableStates) {
+        ExternalDFAReader reader;
+        CompiledDFA dfa;
+        if (reader.open(path, &error) && reader.loadInto(dfa, &error)) {
+            QString id = generateAutomatonId();
+            Automaton* dfaAutomaton = dfa.toAutomaton(id, name + " (DFA)");
+            dfaAutomaton->getLayout().arrangeInGrid(dfaAutomaton->getStates());
+            automatons[id] = dfaAutomaton;
+            updateAutomatonList();
+            summary += "\n\nThe DFA was also opened for editing.";
+        }
+    }
+
+    showStyledMessageBox("Determinize to Disk", summary, QMessageBox::Information);
+    statusBar()->showMessage(QString("Wrote %1 DFA states to disk").arg(stats.stateCount), 5000);
+}
+
+void MainWindow::onBenchmarkLayout() {
+    const int states = 400000;
+    const int symbols = 4;
+    // Sparse table with many symbol classes, as produced by lexer DFAs
+    const int sparseStates = 100000;
+    const int sparseSymbols = 64;
+    const int steps = DFABenchmark::LayoutSteps + DFABenchmark::EncodingSteps;
+
+    auto benchmark = std::make_shared<DFABenchmark>();
+    auto cancelRequested = std::make_shared<QAtomicInt>(0);
+    auto stepsDone = std::make_shared<QAtomicInt>(0);
+    benchmark->setProgressCallback([cancelRequested, stepsDone](int done) {
+        stepsDone->storeRelaxed(done);
+        return cancelRequested->loadRelaxed() == 0;
+    });
+
+    QProgressDialog* progress = new QProgressDialog("Benchmarking DFA layouts...", "Cancel", 0, steps, this);
+    progress->setWindowTitle("DFA Layout Benchmark");
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    connect(progress, &QProgressDialog::canceled, this, [cancelRequested]() {
+        cancelRequested->storeRelaxed(1);
+    });
+
+    QTimer* poll = new QTimer(progress);
+    connect(poll, &QTimer::timeout, progress, [progress, stepsDone]() {
+        progress->setValue(stepsDone->loadRelaxed());
+    });
+    poll->start(200);
+
+    typedef QPair<QVector<LayoutBenchmarkResult>, QVector<LayoutBenchmarkResult>> LayoutResults;
+    QFutureWatcher<LayoutResults>* watcher = new QFutureWatcher<LayoutResults>(this);
+    connect(watcher, &QFutureWatcher<LayoutResults>::finished, this,
+            [this, watcher, progress, cancelRequested, states, symbols, sparseStates, sparseSymbols]() {
+        progress->deleteLater();
+        watcher->deleteLater();
+        if (cancelRequested->loadRelaxed()) {
+            statusBar()->showMessage("DFA layout benchmark cancelled", 5000);
+            return;
+        }
+        statusBar()->showMessage("DFA layout benchmark finished", 3000);
+
+        LayoutResults results = watcher->result();
+        showStyledMessageBox("DFA Layout Benchmark",
+                             QString("State layout: %1 states, %2 symbols\n%3\n\n"
+                                     "Table encoding: %4 states, %5 symbols, 5% defined\n%6")
+                                 .arg(states)
+                                 .arg(symbols)
+                                 .arg(DFABenchmark::formatResults(results.first))
+                                 .arg(sparseStates)
+                                 .arg(sparseSymbols)
+                                 .arg(DFABenchmark::formatResults(results.second)));
+    });
+
+    statusBar()->showMessage("Running DFA layout benchmark...");
+    watcher->setFuture(QtConcurrent::run([benchmark, cancelRequested, states, symbols, sparseStates, sparseSymbols]() {
+        LayoutResults results;
+        results.first = benchmark->runLayoutBenchmark(states, symbols, 2000, 500);
+        if (cancelRequested->loadRelaxed() == 0) {
+            results.second = benchmark->runEncodingBenchmark(sparseStates, sparseSymbols, 0.05, 2000, 500);
+        }
+        return results;
+    }));
+}
+
+void MainWindow::onBenchmarkApproximate() {
+    if (!checkTestable()) {
+        return;
+    }
+
+    const int inputs = 200;
+    const int length = 1000;
+    const int maxErrors = qMax(4, maxErrorsSpin ? maxErrorsSpin->value() : 0);
+
+    // The worker measures its own copy, so the automaton stays editable meanwhile
+    QString name = currentAutomaton->getName();
+    auto automaton = std::make_shared<Automaton>(*currentAutomaton);
+
+    QFutureWatcher<QVector<ApproximateBenchmarkResult>>* watcher =
+        new QFutureWatcher<QVector<ApproximateBenchmarkResult>>(this);
+    connect(watcher, &QFutureWatcher<QVector<ApproximateBenchmarkResult>>::finished, this,
+            [this, watcher, name, inputs, length]() {
+        watcher->deleteLater();
+        benchmarkApproximateAction->setEnabled(true);
+        statusBar()->showMessage("Approximate matching benchmark finished", 3000);
+
+        showStyledMessageBox("Approximate Matching Benchmark",
+                             QString("%1: %2 inputs of %3 symbols (random walks with random edits)\n%4")
+                                 .arg(name)
+                                 .arg(inputs)
+                                 .arg(length)
+                                 .arg(ApproximateMatcher::formatBenchmark(watcher->result())));
+    });
+
+    benchmarkApproximateAction->setEnabled(false);
+    statusBar()->showMessage("Running approximate matching benchmark...");
+    watcher->setFuture(QtConcurrent::run([automaton, inputs, length, maxErrors]() {
+        ApproximateMatcher matcher(automaton.get());
+        return matcher.runBenchmark(inputs, length, maxErrors);
+    }));
+}
+
+void MainWindow::onBenchmarkSchedule() {
+    const int statements = 48;
+
+    // Same seed for both cores, so they schedule the same program
+    auto skylakeBenchmark = std::make_shared<ScheduleBenchmark>();
+    auto zen2Benchmark = std::make_shared<ScheduleBenchmark>();
+    auto cancelRequested = std::make_shared<QAtomicInt>(0);
+    auto stepsDone = std::make_shared<QAtomicInt>(0);
+    skylakeBenchmark->setProgressCallback([cancelRequested, stepsDone](int done) {
+        stepsDone->storeRelaxed(done);
+        return cancelRequested->loadRelaxed() == 0;
+    });
+    zen2Benchmark->setProgressCallback([cancelRequested, stepsDone](int done) {
+        stepsDone->storeRelaxed(ScheduleBenchmark::StepsPerRun + done);
+        return cancelRequested->loadRelaxed() == 0;
+    });
+
+    QProgressDialog* progress = new QProgressDialog("Benchmarking instruction scheduling...", "Cancel",
+                                                    0, 2 * ScheduleBenchmark::StepsPerRun, this);
+    progress->setWindowTitle("Instruction Scheduling Benchmark");
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    connect(progress, &QProgressDialog::canceled, this, [cancelRequested]() {
+        cancelRequested->storeRelaxed(1);
+    });
+
+    QTimer* poll = new QTimer(progress);
+    connect(poll, &QTimer::timeout, progress, [progress, stepsDone]() {
+        progress->setValue(stepsDone->loadRelaxed());
+    });
+    poll->start(200);
+
+    typedef QPair<QVector<ScheduleBenchmarkResult>, QVector<ScheduleBenchmarkResult>> ScheduleResults;
+    QFutureWatcher<ScheduleResults>* watcher = new QFutureWatcher<ScheduleResults>(this);
+    connect(watcher, &QFutureWatcher<ScheduleResults>::finished, this,
+            [this, watcher, progress, cancelRequested, statements]() {
+        progress->deleteLater();
+        watcher->deleteLater();
+        if (cancelRequested->loadRelaxed()) {
+            statusBar()->showMessage("Instruction scheduling benchmark cancelled", 5000);
+            return;
+        }
+        statusBar()->showMessage("Instruction scheduling benchmark finished", 3000);
+
+        ScheduleResults results = watcher->result();
+        showStyledMessageBox("Instruction Scheduling Benchmark",
+                             QString("%1 arithmetic statements with loads, multiplies and divides\n\n"
+                                     "%2:\n%3\n\n%4:\n%5")
+                                 .arg(statements)
+                                 .arg(InstructionScheduler::coreName(CoreModel::SKYLAKE))
+                                 .arg(ScheduleBenchmark::formatResults(results.first))
+                                 .arg(InstructionScheduler::coreName(CoreModel::ZEN2))
+                                 .arg(ScheduleBenchmark::formatResults(results.second)));
+    });
+
+    statusBar()->showMessage("Running instruction scheduling benchmark...");
+    watcher->setFuture(QtConcurrent::run([skylakeBenchmark, zen2Benchmark, cancelRequested, statements]() {
+        ScheduleResults results;
+        results.first = skylakeBenchmark->run(statements, CoreModel::SKYLAKE);
+        if (cancelRequested->loadRelaxed() == 0) {
+            results.second = zen2Benchmark->run(statements, CoreModel::ZEN2);
+        }
+        return results;
+    }));
+}
+
+void MainWindow::onTestInput() {
+    if (!checkTestable()) {
+        return;
+    }
+
+    QString input = testInputField->text();
+    runTest(input, input.isEmpty() ? "(empty string)" : input);
+}
+
+void MainWindow::onLoadTestInput() {
+    if (!checkTestable()) {
+        return;
+    }
+
+    QString fileName = QFileDialog::getOpenFileName(this, "Load Test Input", "",
+                                                    "Text Files (*.txt);;All Files (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        showStyledMessageBox("Error", "Cannot open file:\n" + fileName, QMessageBox::Critical);
+        return;
+    }
+
+    // The whole file is one input string; a trailing line break is not part of it
+    QString input = QString::fromUtf8(file.readAll());
+    while (input.endsWith('\n') || input.endsWith('\r')) {
+        input.chop(1);
+    }
+
+    runTest(input, QString("%1 (%2 symbols)").arg(QFileInfo(fileName).fileName()).arg(input.size()));
+}
+
+bool MainWindow::checkTestable() {
+    if (!currentAutomaton) {
+        showStyledMessageBox("Warning", "No automaton selected.", QMessageBox::Warning);
+        return false;
+    }
+
     if (currentAutomaton->getStateCount() == 0) {
         showStyledMessageBox("Warning", "Automaton has no states.", QMessageBox::Warning);
-        return;
+        return false;
     }
 
     if (currentAutomaton->getInitialStateId().isEmpty()) {
         showStyledMessageBox("Warning",
                              "No initial state defined.\n\nDouble-click a state and mark it as 'Initial State'.",
                              QMessageBox::Warning);
-        return;
+        return false;
     }
 
     bool hasFinalState = false;
@@ -1275,22 +1759,51 @@ void MainWindow::onTestInput() {
         msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
         msgBox.setIcon(QMessageBox::Question);
 
-        if (msgBox.exec() == QMessageBox::No) return;
+        if (msgBox.exec() == QMessageBox::No) return false;
     }
 
     if (!currentAutomaton->isValid()) {
         showStyledMessageBox("Warning", "Current automaton is not valid.", QMessageBox::Warning);
-        return;
+        return false;
     }
 
-    QString input = testInputField->text();
-    bool accepted = currentAutomaton->accepts(input);
+    return true;
+}
+
+void MainWindow::runTest(const QString& input, const QString& label) {
+    // Same verdict as Automaton::accepts(), but every step can be revisited afterwards
+    resetTestTrace();
+    testTrace = new ExecutionTrace(currentAutomaton);
+    testTrace->run(input);
+    bool accepted = testTrace->isAccepted();
 
     QString result = QString("<div style='color: black;'>");
-    result += QString("<hr><b>Input:</b> \"%1\"<br>").arg(input.isEmpty() ? "(empty string)" : input);
+    result += QString("<hr><b>Input:</b> \"%1\"<br>").arg(label.toHtmlEscaped());
     result += QString("<b>Result:</b> <span style='color: %1;'><b>%2</b></span><br>")
                   .arg(accepted ? "green" : "red")
                   .arg(accepted ? "✓ ACCEPTED" : "✗ REJECTED");
+    if (testTrace->getDeadStep() >= 0) {
+        result += QString("<b>Stuck:</b> no active state after symbol %1<br>")
+                      .arg(testTrace->getDeadStep());
+    }
+
+    // Nearest word of the language within the allowed number of edits
+    int maxErrors = maxErrorsSpin ? maxErrorsSpin->value() : 0;
+    if (!accepted && maxErrors > 0) {
+        // Compiled once per automaton version, not once per tested input
+        if (!testMatcher) {
+            testMatcher = new ApproximateMatcher(currentAutomaton);
+        }
+        ApproximateMatch match = testMatcher->match(input, maxErrors);
+        if (match.distance < 0) {
+            result += QString("<b>Distance:</b> more than %1 edit(s)<br>").arg(maxErrors);
+        } else {
+            result += QString("<b>Distance:</b> %1 edit(s)<br>").arg(match.distance);
+            if (!match.alignment.isEmpty()) {
+                result += QString("<b>Alignment:</b> %1<br>").arg(match.formatAlignment().toHtmlEscaped());
+            }
+        }
+    }
     result += QString("<b>Automaton:</b> %1 (%2)</div>")
                   .arg(currentAutomaton->getName())
                   .arg(currentAutomaton->isDFA() ? "DFA" : "NFA");
@@ -1300,9 +1813,60 @@ void MainWindow::onTestInput() {
         testResultsText->ensureCursorVisible();
     }
 
+    // Start at the last step that still has active states
+    int last = testTrace->getDeadStep() >= 0 ? qMax(0, testTrace->getDeadStep() - 1)
+                                             : testTrace->getStepCount();
+    traceStepSlider->blockSignals(true);
+    traceStepSlider->setRange(0, testTrace->getStepCount());
+    traceStepSlider->setValue(last);
+    traceStepSlider->blockSignals(false);
+    traceStepSlider->setEnabled(true);
+    onTraceStepChanged(last);
+
     statusBar()->showMessage(accepted ? "Input ACCEPTED ✓" : "Input REJECTED ✗");
 }
 
+void MainWindow::onTraceStepChanged(int step) {
+    if (!testTrace || !canvas) {
+        return;
+    }
+
+    QSet<QString> active = testTrace->activeStatesAt(step);
+    canvas->setActiveStates(active);
+
+    QStringList ids = active.values();
+    ids.sort();
+    QString states = ids.isEmpty() ? "none" : "{" + ids.join(", ") + "}";
+    QString text = QString("%1 / %2: %3").arg(step).arg(testTrace->getStepCount()).arg(states);
+    if (step < testTrace->getStepCount()) {
+        text += QString(", next '%1'").arg(testTrace->symbolAt(step));
+    }
+    traceStepLabel->setText(text);
+}
+
+void MainWindow::resetTestTrace() {
+    delete testTrace;
+    testTrace = nullptr;
+
+    if (canvas) {
+        canvas->clearActiveStates();
+    }
+    if (traceStepSlider) {
+        traceStepSlider->blockSignals(true);
+        traceStepSlider->setRange(0, 0);
+        traceStepSlider->blockSignals(false);
+        traceStepSlider->setEnabled(false);
+    }
+    if (traceStepLabel) {
+        traceStepLabel->setText("Run a test to step through it");
+    }
+}
+
+void MainWindow::resetTestMatcher() {
+    delete testMatcher;
+    testMatcher = nullptr;
+}
+
 void MainWindow::onClearTest() {
     if (testResultsText) {
         testResultsText->clear();
@@ -1310,10 +1874,63 @@ void MainWindow::onClearTest() {
     if (testInputField) {
         testInputField->clear();
     }
+    resetTestTrace();
+}
+
+void MainWindow::onGenerateSamples() {
+    if (!currentAutomaton) {
+        showStyledMessageBox("Warning", "No automaton selected.", QMessageBox::Warning);
+        return;
+    }
+
+    CompiledDFA compiled;
+    QString errorMsg;
+    if (!compiled.compile(currentAutomaton, &errorMsg)) {
+        showStyledMessageBox("Warning", errorMsg, QMessageBox::Warning);
+        return;
+    }
+
+    const int sampleCount = 10;
+    const int countLengths = 8;
+
+    LanguageEnumerator enumerator(&compiled);
+    QVector<QString> words = enumerator.take(sampleCount);
+
+    QStringList quoted;
+    for (const auto& word : words) {
+        quoted << (word.isEmpty() ? QString("ε") : word.toHtmlEscaped());
+    }
+
+    LanguageCounter counter(&compiled);
+    QVector<BigInteger> counts = counter.countWordsByLength(countLengths);
+    QStringList countParts;
+    for (int length = 0; length < counts.size(); ++length) {
+        countParts << QString("%1: %2").arg(length).arg(counts[length].toString());
+    }
+
+    QString result = QString("<div style='color: black;'>");
+    result += QString("<hr><b>Samples:</b> %1<br>")
+                  .arg(quoted.isEmpty() ? QString("(language is empty)") : quoted.join(", "));
+    result += QString("<b>Words per length:</b> %1<br>").arg(countParts.join(", "));
+    result += QString("<b>Longest word:</b> %1</div>")
+                  .arg(enumerator.getLongestWordLength() >= 0
+                           ? QString::number(enumerator.getLongestWordLength())
+                           : QString(words.isEmpty() ? "-" : "unbounded"));
+
+    if (testResultsText) {
+        testResultsText->append(result);
+        testResultsText->ensureCursorVisible();
+    }
+
+    statusBar()->showMessage(QString("Generated %1 sample word(s)").arg(words.size()));
 }
 
 void MainWindow::onAutomatonModified() {
+    // The trace and the matcher were compiled from the old states and transitions
+    resetTestTrace();
+    resetTestMatcher();
     updateProperties();
+    updateUndoActions();
 }
 
 void MainWindow::onStateSelected(const QString& stateId) {
@@ -1382,6 +1999,28 @@ void MainWindow::onAbout() {
                          QMessageBox::Information);
 }
 
+void MainWindow::onUndo() {
+    if (!currentAutomaton || !historyFor(currentAutomaton)->undo()) {
+        return;
+    }
+    if (canvas) {
+        canvas->update();
+    }
+    onAutomatonModified();
+    statusBar()->showMessage("Undo", 2000);
+}
+
+void MainWindow::onRedo() {
+    if (!currentAutomaton || !historyFor(currentAutomaton)->redo()) {
+        return;
+    }
+    if (canvas) {
+        canvas->update();
+    }
+    onAutomatonModified();
+    statusBar()->showMessage("Redo", 2000);
+}
+
 void MainWindow::updateProperties() {
     // Check if UI elements are initialized
     if (!typeLabel || !stateCountLabel || !transitionCountLabel ||
@@ -1475,7 +2114,8 @@ void MainWindow::updateProperties() {
     if (!currentSelectedStateId.isEmpty()) {
         const State* selectedState = currentAutomaton->getState(currentSelectedStateId);
         if (selectedState) {
-            QString stateInfo = QString("Selected: <b>%1</b>").arg(selectedState->getLabel());
+            QString stateInfo = QString("Selected: <b>%1</b>")
+                                    .arg(currentAutomaton->getLayout().getLabel(selectedState->getId()));
             if (selectedState->getIsInitial()) stateInfo += " [Initial]";
             if (selectedState->getIsFinal()) stateInfo += " [Final]";
 
@@ -1570,10 +2210,32 @@ QString MainWindow::generateAutomatonId() {
 void MainWindow::setCurrentAutomaton(Automaton* automaton) {
     currentAutomaton = automaton;
     currentSelectedStateId = "";
+    resetTestTrace();
+    resetTestMatcher();
     if (canvas) {
-        canvas->setAutomaton(automaton);
+        canvas->setAutomaton(automaton, automaton ? historyFor(automaton) : nullptr);
     }
     updateProperties();
+    updateUndoActions();
+}
+
+AutomatonHistory* MainWindow::historyFor(Automaton* automaton) {
+    AutomatonHistory* history = histories.value(automaton, nullptr);
+    if (!history) {
+        history = new AutomatonHistory(automaton);
+        histories.insert(automaton, history);
+    }
+    return history;
+}
+
+void MainWindow::updateUndoActions() {
+    if (!undoAction || !redoAction) {
+        return;
+    }
+
+    AutomatonHistory* history = currentAutomaton ? historyFor(currentAutomaton) : nullptr;
+    undoAction->setEnabled(history && history->canUndo());
+    redoAction->setEnabled(history && history->canRedo());
 }
 
 void MainWindow::showStyledMessageBox(const QString& title, const QString& message,
@@ -1618,31 +2280,19 @@ void MainWindow::setupCentralTabs() {
 
     centralTabs->addTab(automatonTab, "🤖 Automaton Designer");
 
-    // Tab 2: Lexical Analyzer
-    lexerWidget = new LexerWidget();
-    if (!lexerWidget) {
-        qCritical() << "Failed to create LexerWidget!";
-        return;
-    }
+    // Tabs 2-4 start as empty pages; their widgets are built by ensureTabBuilt()
+    // the first time the tab is activated, keeping them out of the startup path.
+    lexerTab = new QWidget();
+    (new QVBoxLayout(lexerTab))->setContentsMargins(0, 0, 0, 0);
+    centralTabs->addTab(lexerTab, "🔍 Lexical Analyzer");
 
-    // Set automaton manager AFTER creating widget - with null check
-    if (automatonManager && lexerWidget) {
-        lexerWidget->setAutomatonManager(automatonManager);
-    } else {
-        qWarning() << "AutomatonManager or LexerWidget is null, cannot set manager";
-    }
+    parserTab = new QWidget();
+    (new QVBoxLayout(parserTab))->setContentsMargins(0, 0, 0, 0);
+    centralTabs->addTab(parserTab, "🌳 Parser & Parse Tree");
 
-    centralTabs->addTab(lexerWidget, "🔍 Lexical Analyzer");
-
-    parserWidget = new ParserWidget();
-    if (automatonManager && parserWidget) {
-        parserWidget->setAutomatonManager(automatonManager);
-    }
-    centralTabs->addTab(parserWidget, "🌳 Parser & Parse Tree");
-
-    semanticWidget = new SemanticAnalyzerWidget();
-    if (automatonManager) semanticWidget->setAutomatonManager(automatonManager);
-    centralTabs->addTab(semanticWidget, "🔬 Semantic Analysis");
+    semanticTab = new QWidget();
+    (new QVBoxLayout(semanticTab))->setContentsMargins(0, 0, 0, 0);
+    centralTabs->addTab(semanticTab, "🔬 Semantic Analysis");
 
     // Set as central widget
     setCentralWidget(centralTabs);
@@ -1652,7 +2302,38 @@ void MainWindow::setupCentralTabs() {
             this, &MainWindow::onTabChanged);
 }
 
+void MainWindow::ensureTabBuilt(int index) {
+    // Set automaton manager AFTER creating the widget
+    QWidget* built = nullptr;
+    QWidget* page = nullptr;
+    if (index == 1 && !lexerWidget) {
+        lexerWidget = new LexerWidget();
+        if (automatonManager) lexerWidget->setAutomatonManager(automatonManager);
+        built = lexerWidget;
+        page = lexerTab;
+    } else if (index == 2 && !parserWidget) {
+        parserWidget = new ParserWidget();
+        if (automatonManager) parserWidget->setAutomatonManager(automatonManager);
+        built = parserWidget;
+        page = parserTab;
+    } else if (index == 3 && !semanticWidget) {
+        semanticWidget = new SemanticAnalyzerWidget();
+        if (automatonManager) semanticWidget->setAutomatonManager(automatonManager);
+        built = semanticWidget;
+        page = semanticTab;
+    }
+
+    if (!built || !page) {
+        return;
+    }
+
+    page->layout()->addWidget(built);
+}
+
 void MainWindow::onTabChanged(int index) {
+    // Build the tab's widget the first time it is shown
+    ensureTabBuilt(index);
+
     // Hide all docks for non-automaton tabs
     bool showDocks = (index == 0);
 
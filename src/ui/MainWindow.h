@@ -18,16 +18,26 @@
 #include <QRadioButton>  // For radio buttons (exclusive selection).
 #include <QTableWidget>  // For displaying data in a table format.
 #include <QMap>          // For storing key-value pairs (like a dictionary).
+#include <QHash>         // For the per-automaton undo histories.
 #include <QMessageBox>   // For displaying standard message boxes.
 #include <QTabWidget>    // For creating a tabbed interface.
+#include <QElapsedTimer> // For timing the startup phases.
+#include <QVector>       // For the recorded startup phases.
+#include <QPair>         // For (phase name, elapsed ms) entries.
+#include <QSlider>       // For stepping through a test run.
+#include <QSpinBox>      // For the number of edit errors allowed in a test.
 
 // Project-specific includes for various UI components and data models.
 #include "./src/ui/Automaton/AutomatonCanvas.h"          // Custom widget for drawing automatons.
 #include "./src/models/Automaton/Automaton.h"            // Data model for an automaton.
+#include "./src/models/Automaton/AutomatonHistory.h"     // Undo/redo log for automaton edits.
 #include "./src/ui/LexicalAnalysis/LexerWidget.h"        // Widget for lexical analysis features.
 #include "./src/utils/LexicalAnalysis/AutomatonManager.h" // Manages a collection of automatons.
 #include "./src/ui/Grammar/ParserWidget.h"                // Widget for parsing grammar.
 #include "./src/ui/Semantic/SemanticAnalyzerWidget.h"    // Widget for semantic analysis.
+#include "./src/utils/Automaton/ExecutionTrace.h"        // Checkpointed automaton runs for step-through.
+#include "./src/utils/Automaton/ApproximateMatcher.h"    // Edit distance from an input to the language.
+#include "./src/utils/Automaton/ExternalSubsetConstruction.h" // Statistics of an out-of-core conversion.
 
 /**
  * @brief The MainWindow class serves as the main application window for the Compiler Project.
@@ -47,6 +57,15 @@ private:
     AutomatonManager* automatonManager; // Manages the collection of NFA/DFA automatons.
     ParserWidget* parserWidget;        // Widget instance for the parsing tool.
     SemanticAnalyzerWidget* semanticWidget; // Widget instance for the semantic analysis and code generation tool.
+    QWidget* lexerTab;                // Placeholder page; lexerWidget is built into it on first activation.
+    QWidget* parserTab;               // Placeholder page; parserWidget is built into it on first activation.
+    QWidget* semanticTab;             // Placeholder page; semanticWidget is built into it on first activation.
+
+    // --- Startup Timing ---
+    static const int StartupBudgetMs = 200; // Target time from construction to first paint.
+    QElapsedTimer startupTimer;       // Started in the constructor, read at each startup phase.
+    QVector<QPair<QString, qint64>> startupPhases; // Phase name and elapsed milliseconds at its end.
+    bool startupReported;             // Set once the first paint has been timed and reported.
 
     // --- Automaton Canvas ---
     AutomatonCanvas* canvas;          // Custom drawing area for visualizing automatons.
@@ -55,6 +74,7 @@ private:
     QMap<QString, Automaton*> automatons; // Stores all created automatons, mapped by their unique IDs.
     Automaton* currentAutomaton;           // Pointer to the currently active automaton being displayed/edited.
     int automatonCounter;                  // Counter used to generate unique IDs for new automatons.
+    QHash<Automaton*, AutomatonHistory*> histories; // Undo/redo history per automaton, created on first use.
 
     // --- Dock Widgets ---
     QDockWidget* toolsDock;           // Dock for mode selection (select, add state, add transition, delete).
@@ -94,12 +114,21 @@ private:
     QPushButton* testInputBtn;         // Button to initiate the test of the input string.
     QTextEdit* testResultsText;        // Displays the results of automaton tests.
     QPushButton* clearTestBtn;         // Button to clear the test input and results.
+    QPushButton* samplesBtn;           // Button to list accepted words and per-length counts.
+    QPushButton* loadTestBtn;          // Button to test a long input read from a text file.
+    QSpinBox* maxErrorsSpin;           // Edit errors tolerated when a test is rejected; 0 = exact only.
+    QSlider* traceStepSlider;          // Selects the step of the last test run shown on the canvas.
+    QLabel* traceStepLabel;            // Shows the selected step, its next symbol and the active states.
+    ExecutionTrace* testTrace;         // Checkpointed run of the last tested input; nullptr if none.
+    ApproximateMatcher* testMatcher;   // Compiled on the first approximate test; nullptr after an edit.
 
     // --- Menu Actions ---
     QAction* newAction;                // Action for creating a new project/file.
     QAction* openAction;               // Action for opening an existing project/file.
     QAction* saveAction;               // Action for saving the current project/file.
     QAction* exitAction;               // Action for exiting the application.
+    QAction* undoAction;               // Action for undoing the last edit on the current automaton.
+    QAction* redoAction;               // Action for redoing the last undone edit.
     QAction* aboutAction;              // Action for displaying information about the application.
 
     QAction* selectAction;             // Action to set canvas mode to selection.
@@ -108,6 +137,11 @@ private:
     QAction* deleteAction;             // Action to set canvas mode to delete.
     QAction* convertAction;            // Action to convert NFA to DFA.
     QAction* minimizeAction;           // Action to minimize DFA.
+    QAction* benchmarkLayoutAction;    // Action to benchmark DFA state layouts.
+    QAction* benchmarkApproximateAction; // Action to measure approximate matching throughput on the current automaton.
+    QAction* benchmarkScheduleAction;  // Action to compare scheduled and unscheduled assembly output.
+    QAction* regexAction;              // Action to build an automaton from a regular expression.
+    QAction* externalConvertAction;    // Action to determinize an NFA into an on-disk table.
 
 public:
     /**
@@ -122,6 +156,9 @@ public:
      */
     ~MainWindow();
 
+protected:
+    void paintEvent(QPaintEvent* event) override; // Records the first paint and reports startup timing.
+
 private slots:
     // --- Canvas Mode Handlers ---
     void onSelectMode();             // Slot triggered when select mode radio button is activated.
@@ -139,10 +176,18 @@ private slots:
     // --- Automaton Conversion Handlers ---
     void onConvertNFAtoDFA();        // Slot to handle conversion of NFA to DFA.
     void onMinimizeDFA();            // Slot to handle minimization of DFA.
+    void onNewFromRegex();           // Slot to build an epsilon-free position automaton from a regex.
+    void onDeterminizeToDisk();      // Slot to run subset construction out of core into a table file.
+    void onBenchmarkLayout();        // Slot to compare state renumbering strategies on a large synthetic DFA.
+    void onBenchmarkApproximate();   // Slot to time k-error matching against the current automaton.
+    void onBenchmarkSchedule();      // Slot to compare the assembly backend at each optimization level.
 
     // --- Automaton Testing Handlers ---
     void onTestInput();              // Slot to handle testing an input string against the current automaton.
     void onClearTest();              // Slot to handle clearing the test input and results.
+    void onGenerateSamples();        // Slot to enumerate accepted words of the current automaton.
+    void onLoadTestInput();          // Slot to test the contents of a text file as one input string.
+    void onTraceStepChanged(int step); // Slot to highlight the active states after the given number of symbols.
 
     // --- Automaton Canvas Interaction Handlers ---
     void onAutomatonModified();      // Slot triggered when the current automaton data changes (e.g., state/transition added/removed).
@@ -155,6 +200,8 @@ private slots:
     void onSave();                   // Slot for the "Save" menu action.
     void onExit();                   // Slot for the "Exit" menu action.
     void onAbout();                  // Slot for the "About" menu action.
+    void onUndo();                   // Slot for the "Undo" menu action.
+    void onRedo();                   // Slot for the "Redo" menu action.
 
     // --- Tab Change Handler ---
     void onTabChanged(int index);    // Slot triggered when the active tab in centralTabs changes.
@@ -169,15 +216,26 @@ private:
     void createPropertiesPanel();    // Creates the content for the properties dock.
     void createTestingPanel();       // Creates the content for the testing dock.
     void setupCentralTabs();         // Sets up the central tab widget with different analysis tools.
+    void ensureTabBuilt(int index);  // Builds the widget of a lazily created tab on its first activation.
+    void markStartupPhase(const QString& phase); // Records the elapsed startup time at the end of a phase.
+    void reportStartupTiming();      // Logs the per-phase startup breakdown against StartupBudgetMs.
 
     // --- UI Update Methods ---
     void updateProperties();         // Updates the properties dock with information about the current automaton.
     void updateTransitionTable();    // Updates the transition table in the properties dock.
     void updateAutomatonList();      // Refreshes the list of automatons in the automaton list dock.
+    void resetTestTrace();           // Drops the last test run and its canvas highlight.
+    void resetTestMatcher();         // Drops the approximate matcher compiled from the old automaton.
+    void showDeterminizeResult(const ExternalConstructionStats& stats, const QString& path,
+                               const QString& name); // Reports a finished Determinize to Disk run.
 
     // --- Helper Methods ---
     QString generateAutomatonId();   // Generates a unique ID for a new automaton.
     void setCurrentAutomaton(Automaton* automaton); // Sets the currently active automaton and updates UI accordingly.
+    AutomatonHistory* historyFor(Automaton* automaton); // Returns (creating if needed) the undo history of an automaton.
+    bool checkTestable();            // Warns and returns false if the current automaton cannot be tested.
+    void runTest(const QString& input, const QString& label); // Traces input, reports the result and enables stepping.
+    void updateUndoActions();        // Enables or disables Undo/Redo for the current automaton.
 
     /**
      * @brief Displays a styled QMessageBox with custom title, message, and icon.
@@ -7,12 +7,15 @@
 #include <QMessageBox>
 
 SemanticAnalyzerWidget::SemanticAnalyzerWidget(QWidget *parent)
-    : QWidget(parent), automatonManager(nullptr) {
+    : QWidget(parent), automatonManager(nullptr), mlBridge(nullptr) {
 
     semanticAnalyzer = new SemanticAnalyzer();
     codeGenerator = new CodeGenerator();
     lexer = new Lexer();
-    mlBridge = new MLTranslationBridge(this);
+
+    prefetchTimer = new QTimer(this);
+    prefetchTimer->setSingleShot(true);
+    prefetchTimer->setInterval(PrefetchDelayMs);
 
     setupUI();
     createConnections();
@@ -171,6 +174,14 @@ void SemanticAnalyzerWidget::setupUI() {
     targetLanguageCombo->addItem("JavaScript", QVariant::fromValue(TargetLanguage::JAVASCRIPT));
     targetLanguageCombo->addItem("Assembly", QVariant::fromValue(TargetLanguage::ASSEMBLY));
     langLayout->addWidget(targetLanguageCombo);
+
+    langLayout->addWidget(new QLabel("Optimization:"));
+    optimizationCombo = new QComboBox();
+    optimizationCombo->addItem("O0 (as emitted)", 0);
+    optimizationCombo->addItem("O1 (scheduled)", 1);
+    optimizationCombo->addItem("O2 (scheduled + renamed)", 2);
+    optimizationCombo->setToolTip("List-schedules the assembly output; ignored for other targets");
+    langLayout->addWidget(optimizationCombo);
     langLayout->addStretch();
 
     translateLayout->addLayout(langLayout);
@@ -208,12 +219,26 @@ void SemanticAnalyzerWidget::createConnections() {
     connect(ruleBasedRadio, &QRadioButton::toggled, this, &SemanticAnalyzerWidget::onTranslationMethodChanged);
     connect(mlBasedRadio, &QRadioButton::toggled, this, &SemanticAnalyzerWidget::onTranslationMethodChanged);
 
-    // ML bridge connections
+    // Speculative ML translation
+    connect(sourceCodeEdit, &QTextEdit::textChanged, this, &SemanticAnalyzerWidget::onSourceEdited);
+    connect(targetLanguageCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &SemanticAnalyzerWidget::schedulePrefetch);
+    connect(prefetchTimer, &QTimer::timeout, this, &SemanticAnalyzerWidget::startPrefetch);
+}
+
+MLTranslationBridge* SemanticAnalyzerWidget::ensureMLBridge() {
+    if (mlBridge) {
+        return mlBridge;
+    }
+
+    // Network setup is deferred until ML translation is actually selected
+    mlBridge = new MLTranslationBridge(this);
     connect(mlBridge, &MLTranslationBridge::translationCompleted, this, &SemanticAnalyzerWidget::displayTranslatedCode);
     connect(mlBridge, &MLTranslationBridge::translationError, this, [this](const QString& error) {
         statusLabel->setText(QString("❌ ML Translation Error: %1").arg(error));
         statusLabel->setStyleSheet("QLabel { padding: 5px; background-color: #f8d7da; color: #721c24; border-radius: 3px; }");
     });
+    return mlBridge;
 }
 
 
@@ -236,8 +261,11 @@ void SemanticAnalyzerWidget::onAnalyzeClicked() {
     }
 
     // Semantic analysis
-    semanticAnalyzer->setTokens(lexer->getTokens());
-    bool success = semanticAnalyzer->analyzeProgram();
+    QVector<Token> tokens = lexer->getTokens();
+    semanticAnalyzer->setTokens(tokens);
+    bool success = tokens.size() >= ParallelAnalysisTokens
+                       ? semanticAnalyzer->analyzeProgramParallel()
+                       : semanticAnalyzer->analyzeProgram();
 
     // Display results
     displaySymbolTable();
@@ -245,10 +273,13 @@ void SemanticAnalyzerWidget::onAnalyzeClicked() {
 
     if (success && !semanticAnalyzer->hasErrors()) {
         translateButton->setEnabled(true);
+        analyzedSource = sourceCodeEdit->toPlainText();
+        schedulePrefetch();
         statusLabel->setText("✅ Semantic analysis passed - Ready to translate");
         statusLabel->setStyleSheet("QLabel { padding: 5px; background-color: #d4edda; color: #155724; border-radius: 3px; }");
     } else {
         translateButton->setEnabled(false);
+        analyzedSource.clear();
         statusLabel->setText(QString("❌ Semantic analysis found %1 error(s)")
                                  .arg(semanticAnalyzer->getErrors().size()));
         statusLabel->setStyleSheet("QLabel { padding: 5px; background-color: #f8d7da; color: #721c24; border-radius: 3px; }");
@@ -256,8 +287,6 @@ void SemanticAnalyzerWidget::onAnalyzeClicked() {
 }
 
 void SemanticAnalyzerWidget::onTranslateClicked() {
-    TargetLanguage targetLang = targetLanguageCombo->currentData().value<TargetLanguage>();
-
     if (mlBasedRadio->isChecked()) {
         // ML-based translation
         statusLabel->setText("🔄 Translating with ML model...");
@@ -267,22 +296,28 @@ void SemanticAnalyzerWidget::onTranslateClicked() {
         QString targetLanguageStr = targetLanguageCombo->currentText().toLower();
         QVector<Token> tokens = lexer->getTokens();
 
-        mlBridge->translateCode(sourceCode, targetLanguageStr, tokens);
+        prefetchTimer->stop();      // the request below supersedes it
+        // The draft runs the code generator, so it is only built if a request goes out
+        ensureMLBridge()->translateCode(sourceCode, targetLanguageStr, tokens,
+                                        [this]() { return ruleBasedTranslation(); });
     } else {
         // Rule-based translation (existing logic)
-        codeGenerator->setTokens(lexer->getTokens());
-        codeGenerator->setSymbolTable(semanticAnalyzer->getSymbolTable());
-        codeGenerator->setTargetLanguage(targetLang);
-        codeGenerator->setSourceCode(sourceCodeEdit->toPlainText()); // Pass original source
-
-        QString translatedCode = codeGenerator->generate();
-        displayTranslatedCode(translatedCode);
+        displayTranslatedCode(ruleBasedTranslation());
 
         statusLabel->setText(QString("✅ Code translated to %1 (Rule-Based)").arg(targetLanguageCombo->currentText()));
         statusLabel->setStyleSheet("QLabel { padding: 5px; background-color: #d4edda; color: #155724; border-radius: 3px; }");
     }
 }
 
+QString SemanticAnalyzerWidget::ruleBasedTranslation() {
+    codeGenerator->setTokens(lexer->getTokens());
+    codeGenerator->setSymbolTable(semanticAnalyzer->getSymbolTable());
+    codeGenerator->setTargetLanguage(targetLanguageCombo->currentData().value<TargetLanguage>());
+    codeGenerator->setOptimizationLevel(optimizationCombo->currentData().toInt());
+    codeGenerator->setSourceCode(sourceCodeEdit->toPlainText()); // Pass original source
+    return codeGenerator->generate();
+}
+
 void SemanticAnalyzerWidget::onClearClicked() {
     sourceCodeEdit->clear();
     symbolTableWidget->setRowCount(0);
@@ -372,8 +407,36 @@ void SemanticAnalyzerWidget::displayTranslatedCode(const QString& code) {
     translatedCodeEdit->setPlainText(code);
 }
 
+void SemanticAnalyzerWidget::onSourceEdited() {
+    // The prefetched input is stale now; it is requested again only if the
+    // text returns to what was analyzed
+    if (mlBridge) {
+        mlBridge->cancelPrefetch();
+    }
+    schedulePrefetch();
+}
+
+void SemanticAnalyzerWidget::schedulePrefetch() {
+    prefetchTimer->start();
+}
+
+void SemanticAnalyzerWidget::startPrefetch() {
+    if (!mlBasedRadio->isChecked() || analyzedSource.isEmpty() ||
+        sourceCodeEdit->toPlainText() != analyzedSource) {
+        return;
+    }
+
+    // Same arguments as onTranslateClicked, so the bridge can match the two
+    ensureMLBridge()->prefetchTranslation(analyzedSource,
+                                          targetLanguageCombo->currentText().toLower(),
+                                          lexer->getTokens(),
+                                          [this]() { return ruleBasedTranslation(); });
+}
+
 void SemanticAnalyzerWidget::onTranslationMethodChanged() {
     if (mlBasedRadio->isChecked()) {
+        ensureMLBridge();
+        schedulePrefetch();
         statusLabel->setText("ML Translation selected - Ensure ML server is running");
         statusLabel->setStyleSheet("QLabel { padding: 5px; background-color: #cce5ff; color: #004085; border-radius: 3px; }");
     } else {
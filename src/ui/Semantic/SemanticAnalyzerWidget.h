@@ -17,6 +17,7 @@
 #include "../../utils/Semantic/MLTranslationBridge.h"
 
 #include <QCheckBox>
+#include <QTimer>
 
 class SemanticAnalyzerWidget : public QWidget {
     Q_OBJECT
@@ -29,6 +30,7 @@ private:
     QPushButton* clearButton;
 
     QComboBox* targetLanguageCombo;
+    QComboBox* optimizationCombo;       // assembly scheduling level
 
     // Translation method selection
     QGroupBox* translationMethodGroup;
@@ -47,7 +49,14 @@ private:
     CodeGenerator* codeGenerator;
     Lexer* lexer;
     AutomatonManager* automatonManager;
-    MLTranslationBridge* mlBridge;
+    MLTranslationBridge* mlBridge;     // created when ML translation is first selected
+
+    // ML translation is prefetched once analysis passes, since Translate is nearly always next
+    QTimer* prefetchTimer;              // debounces edits and option changes
+    QString analyzedSource;             // text of the last successful analysis
+    static const int PrefetchDelayMs = 300;
+
+    static const int ParallelAnalysisTokens = 20000; // Larger inputs are analyzed per declaration on all cores.
 
 public:
     explicit SemanticAnalyzerWidget(QWidget *parent = nullptr);
@@ -60,6 +69,8 @@ private slots:
     void onTranslateClicked();
     void onClearClicked();
     void onTranslationMethodChanged();
+    void onSourceEdited();
+    void startPrefetch();
 
 
 private:
@@ -68,6 +79,10 @@ private:
     void displaySymbolTable();
     void displayErrorsWarnings();
     void displayTranslatedCode(const QString& code);
+    MLTranslationBridge* ensureMLBridge();
+    // Also sent to the ML server as the draft its decoder verifies
+    QString ruleBasedTranslation();
+    void schedulePrefetch();
 };
 
 #endif // SEMANTICANALYZERWIDGET_H
@@ -0,0 +1,557 @@
+#include "ApproximateMatcher.h"
+#include "./src/utils/Xorshift32.h"
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QPair>
+#include <algorithm>
+
+namespace {
+
+struct Edge {
+    int from;
+    int symbolClass;
+    int to;
+};
+
+}
+
+ApproximateMatcher::ApproximateMatcher(const Automaton* automaton)
+    : stateCount(automaton->getStates().size()), words((stateCount + 63) / 64), classCount(0),
+    latin1Class(256, -1) {
+    const QVector<State>& states = automaton->getStates();
+    const QVector<Transition>& transitions = automaton->getTransitions();
+
+    auto addClass = [&](QChar ch, bool consumes) {
+        if (classOf(ch) >= 0) return;
+        ushort code = ch.unicode();
+        if (code < 256) latin1Class[code] = classChars.size();
+        else otherClass.insert(code, classChars.size());
+        classChars.append(ch);
+        consuming.append(consumes);
+    };
+
+    // Single-character symbols are the alphabet. In an NFA, 'E' and 'ε' in
+    // the input follow epsilon edges, as in Transition::hasSymbol; a DFA has
+    // no epsilon edges, so there they are letters like any other, as in acceptsDFA
+    bool nfa = automaton->isNFA();
+    for (const Transition& t : transitions) {
+        for (const QString& symbol : t.getSymbols()) {
+            if (symbol.size() == 1 && (!nfa || (symbol != "E" && symbol != "ε"))) addClass(symbol[0], true);
+        }
+    }
+    for (const Transition& t : transitions) {
+        if (t.isEpsilonTransition()) {
+            addClass(QChar('E'), !nfa);
+            addClass(QChar(0x03B5), !nfa);
+            break;
+        }
+    }
+    classCount = classChars.size();
+
+    // Edges per class as Transition::hasSymbol sees them, grouped by state
+    // and class; epsilon edges are also the edges of the 'E'/'ε' classes
+    QVector<QVector<int>> epsilon(stateCount);
+    QVector<Edge> edges;
+    for (const Transition& t : transitions) {
+        int from = automaton->indexOfState(t.getFromStateId());
+        int to = automaton->indexOfState(t.getToStateId());
+        if (from < 0 || to < 0) continue;
+        if (t.isEpsilonTransition()) {
+            if (nfa) epsilon[from].append(to);
+            edges.append({from, classOf(QChar('E')), to});
+            edges.append({from, classOf(QChar(0x03B5)), to});
+        }
+        for (const QString& symbol : t.getSymbols()) {
+            if (symbol.size() == 1 && !Transition::isEpsilonSymbol(symbol)) {
+                edges.append({from, classOf(symbol[0]), to});
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return a.from != b.from ? a.from < b.from : a.symbolClass < b.symbolClass;
+    });
+
+    // Epsilon closure of every state, depth-first; seen[t] == s marks t as reached from s
+    QVector<int> closureBegin;
+    QVector<int> closureStates;
+    QVector<int> seen(stateCount, -1);
+    QVector<int> stack;
+    closureBegin.reserve(stateCount + 1);
+    for (int s = 0; s < stateCount; ++s) {
+        closureBegin.append(closureStates.size());
+        seen[s] = s;
+        stack.append(s);
+        while (!stack.isEmpty()) {
+            int u = stack.takeLast();
+            closureStates.append(u);
+            for (int t : epsilon[u]) {
+                if (seen[t] != s) {
+                    seen[t] = s;
+                    stack.append(t);
+                }
+            }
+        }
+    }
+    closureBegin.append(closureStates.size());
+
+    // Closes the targets of edges [first, last) into one sorted list
+    auto closeInto = [&](int first, int last, int mark, QVector<int>& out) {
+        int begin = out.size();
+        for (int e = first; e < last; ++e) {
+            for (int k = closureBegin[edges[e].to]; k < closureBegin[edges[e].to + 1]; ++k) {
+                int s = closureStates[k];
+                if (seen[s] != mark) {
+                    seen[s] = mark;
+                    out.append(s);
+                }
+            }
+        }
+        std::sort(out.begin() + begin, out.end());
+    };
+
+    // Moves are filled in state and class order, as the edges are sorted
+    seen.fill(-1);
+    int marks = 0;
+    moveBegin.fill(0, qint64(stateCount) * classCount + 1);
+    successorBegin.fill(0, stateCount + 1);
+    for (int first = 0, last = 0; first < edges.size(); first = last) {
+        int from = edges[first].from;
+        while (last < edges.size() && edges[last].from == from) ++last;
+
+        int consumingEnd = first;
+        for (int e = first; e < last; ) {
+            int c = edges[e].symbolClass;
+            int end = e;
+            while (end < last && edges[end].symbolClass == c) ++end;
+            int size = moveStates.size();
+            closeInto(e, end, marks++, moveStates);
+            moveBegin[qint64(from) * classCount + c + 1] = moveStates.size() - size;
+            if (consuming[c]) consumingEnd = end;
+            e = end;
+        }
+
+        // Non-consuming classes sort last, so the consuming edges come first
+        int size = successorStates.size();
+        closeInto(first, consumingEnd, marks++, successorStates);
+        successorBegin[from + 1] = successorStates.size() - size;
+    }
+    for (qint64 m = 0; m + 1 < moveBegin.size(); ++m) {
+        moveBegin[m + 1] += moveBegin[m];
+    }
+    for (int s = 0; s < stateCount; ++s) {
+        successorBegin[s + 1] += successorBegin[s];
+    }
+
+    buildByteTables();
+
+    initialSet.fill(0, words);
+    int initial = automaton->indexOfState(automaton->getInitialStateId());
+    if (initial >= 0 && automaton->isValid()) {
+        for (int k = closureBegin[initial]; k < closureBegin[initial + 1]; ++k) {
+            int s = closureStates[k];
+            initialSet[s / 64] |= quint64(1) << (s % 64);
+        }
+    }
+
+    finalSet.fill(0, words);
+    stateIds.resize(stateCount);
+    for (int s = 0; s < stateCount; ++s) {
+        stateIds[s] = states[s].getId();
+        if (states[s].getIsFinal()) finalSet[s / 64] |= quint64(1) << (s % 64);
+    }
+}
+
+int ApproximateMatcher::classOf(QChar ch) const {
+    ushort code = ch.unicode();
+    return code < 256 ? latin1Class[code] : otherClass.value(code, -1);
+}
+
+// ============================================================
+// Row updates
+// ============================================================
+
+// For every byte of a state set and each of its 256 values, the union of
+// the moves of the states it contains; table[v] = table[v without its lowest bit] | move(lowest)
+void ApproximateMatcher::buildByteTables() {
+    byteTables.clear();
+    int bytes = words * 8;
+    qint64 size = qint64(classCount + 1) * bytes * 256 * words;
+    if (stateCount == 0 || size * qint64(sizeof(quint64)) > MaxByteTableBytes) {
+        return;
+    }
+
+    byteTables.fill(0, size);
+    for (int table = 0; table <= classCount; ++table) {
+        for (int b = 0; b < bytes; ++b) {
+            quint64* values = byteTables.data() + (qint64(table) * bytes + b) * 256 * words;
+            for (int v = 1; v < 256; ++v) {
+                int low = qCountTrailingZeroBits(quint32(v));
+                int state = b * 8 + low;
+                quint64* entry = values + v * words;
+                const quint64* rest = values + (v & (v - 1)) * words;
+                for (int w = 0; w < words; ++w) entry[w] = rest[w];
+                if (state >= stateCount) continue;
+
+                const int* first;
+                const int* last;
+                if (table < classCount) {
+                    moveOf(state, table, &first, &last);
+                } else {
+                    successorsOf(state, &first, &last);
+                }
+                for (const int* t = first; t != last; ++t) entry[*t / 64] |= quint64(1) << (*t % 64);
+            }
+        }
+    }
+}
+
+void ApproximateMatcher::orTable(const quint64* set, int table, quint64* out) const {
+    const quint64* base = byteTables.constData() + qint64(table) * words * 8 * 256 * words;
+    for (int w = 0; w < words; ++w) {
+        for (quint64 bits = set[w]; bits; ) {
+            int shift = qCountTrailingZeroBits(bits) & ~7;
+            int b = w * 8 + shift / 8;
+            const quint64* entry = base + (qint64(b) * 256 + ((bits >> shift) & 0xFF)) * words;
+            for (int v = 0; v < words; ++v) out[v] |= entry[v];
+            bits &= ~(quint64(0xFF) << shift);
+        }
+    }
+}
+
+void ApproximateMatcher::orMove(const quint64* set, int symbolClass, quint64* out) const {
+    if (!byteTables.isEmpty()) {
+        orTable(set, symbolClass, out);
+        return;
+    }
+    for (int w = 0; w < words; ++w) {
+        for (quint64 bits = set[w]; bits; bits &= bits - 1) {
+            const int* first;
+            const int* last;
+            moveOf(w * 64 + qCountTrailingZeroBits(bits), symbolClass, &first, &last);
+            for (const int* t = first; t != last; ++t) out[*t / 64] |= quint64(1) << (*t % 64);
+        }
+    }
+}
+
+void ApproximateMatcher::orSuccessors(const quint64* set, quint64* out) const {
+    if (!byteTables.isEmpty()) {
+        orTable(set, classCount, out);
+        return;
+    }
+    for (int w = 0; w < words; ++w) {
+        for (quint64 bits = set[w]; bits; bits &= bits - 1) {
+            const int* first;
+            const int* last;
+            successorsOf(w * 64 + qCountTrailingZeroBits(bits), &first, &last);
+            for (const int* t = first; t != last; ++t) out[*t / 64] |= quint64(1) << (*t % 64);
+        }
+    }
+}
+
+// Before any input, errors can only be symbols skipped in the automaton
+void ApproximateMatcher::initialRows(quint64* rows, int rowCount) const {
+    std::copy(initialSet.constBegin(), initialSet.constEnd(), rows);
+    for (int i = 1; i < rowCount; ++i) {
+        quint64* row = rows + i * words;
+        const quint64* previous = row - words;
+        std::copy(previous, previous + words, row);
+        orSuccessors(previous, row);
+    }
+}
+
+// Row i after one character: match from row i, or from row i - 1 an
+// insertion (stay), a substitution (any consuming edge) or a deletion
+// (any consuming edge out of the updated row i - 1)
+void ApproximateMatcher::step(const quint64* rows, int rowCount, int symbolClass, quint64* next,
+                              quint64* scratch) const {
+    for (int i = 0; i < rowCount; ++i) {
+        quint64* out = next + i * words;
+        std::fill(out, out + words, 0);
+        if (symbolClass >= 0) {
+            orMove(rows + i * words, symbolClass, out);
+        }
+        if (i == 0) continue;
+
+        const quint64* previous = rows + (i - 1) * words;
+        const quint64* updated = next + (i - 1) * words;
+        for (int w = 0; w < words; ++w) {
+            out[w] |= previous[w];
+            scratch[w] = previous[w] | updated[w];
+        }
+        orSuccessors(scratch, out);
+    }
+}
+
+int ApproximateMatcher::acceptingRow(const quint64* rows, int rowCount) const {
+    for (int i = 0; i < rowCount; ++i) {
+        for (int w = 0; w < words; ++w) {
+            if (rows[i * words + w] & finalSet[w]) return i;
+        }
+    }
+    return -1;
+}
+
+// ============================================================
+// Matching
+// ============================================================
+
+int ApproximateMatcher::distance(const QString& input, int maxErrors) const {
+    if (stateCount == 0 || maxErrors < 0) {
+        return -1;
+    }
+
+    int rowCount = qMin(maxErrors, MaxErrors) + 1;
+    QVector<quint64> current(rowCount * words);
+    QVector<quint64> next(rowCount * words);
+    QVector<quint64> scratch(words);
+    initialRows(current.data(), rowCount);
+
+    for (QChar ch : input) {
+        step(current.constData(), rowCount, classOf(ch), next.data(), scratch.data());
+        current.swap(next);
+
+        // Rows only grow with i, so an empty last row means every row is empty
+        const quint64* lastRow = current.constData() + (rowCount - 1) * words;
+        if (std::all_of(lastRow, lastRow + words, [](quint64 w) { return w == 0; })) {
+            return -1;
+        }
+    }
+
+    return acceptingRow(current.constData(), rowCount);
+}
+
+ApproximateMatch ApproximateMatcher::match(const QString& input, int maxErrors, bool withAlignment) const {
+    ApproximateMatch result;
+    result.distance = distance(input, maxErrors);
+    if (result.distance < 0 || !withAlignment) {
+        return result;
+    }
+
+    // Second pass with just enough rows, keeping every step for the traceback
+    int rowCount = result.distance + 1;
+    qint64 stepWords = qint64(rowCount) * words;
+    if (stepWords * (input.size() + 1) > MaxAlignmentWords) {
+        return result;
+    }
+
+    QVector<quint64> history(stepWords * (input.size() + 1));
+    QVector<quint64> scratch(words);
+    initialRows(history.data(), rowCount);
+    for (int j = 0; j < input.size(); ++j) {
+        step(history.constData() + j * stepWords, rowCount, classOf(input[j]),
+             history.data() + (j + 1) * stepWords, scratch.data());
+    }
+
+    result.alignment = traceback(input, history, rowCount, result.distance);
+    return result;
+}
+
+// Walks back from an accepting state, at each position preferring a match
+// over an error, and drops to a lower row whenever the state is already
+// reachable with fewer errors
+QVector<EditOperation> ApproximateMatcher::traceback(const QString& input, const QVector<quint64>& history,
+                                                     int rowCount, int errors) const {
+    auto rowAt = [&](int j, int i) {
+        return history.constData() + (qint64(j) * rowCount + i) * words;
+    };
+    auto inMove = [&](int s, int c, int target) {
+        const int* first;
+        const int* last;
+        moveOf(s, c, &first, &last);
+        return std::binary_search(first, last, target);
+    };
+    auto inSuccessors = [&](int s, int target) {
+        const int* first;
+        const int* last;
+        successorsOf(s, &first, &last);
+        return std::binary_search(first, last, target);
+    };
+    auto symbolBetween = [&](int from, int to) {
+        for (int c = 0; c < classCount; ++c) {
+            if (consuming[c] && inMove(from, c, to)) return classChars[c];
+        }
+        return QChar();
+    };
+
+    int j = input.size();
+    int i = errors;
+    int q = -1;
+    for (int s = 0; s < stateCount && q < 0; ++s) {
+        if (contains(rowAt(j, i), s) && contains(finalSet.constData(), s)) q = s;
+    }
+
+    QVector<EditOperation> reversed;
+    while (q >= 0) {
+        while (i > 0 && contains(rowAt(j, i - 1), q)) {
+            --i;
+        }
+        if (j == 0 && i == 0) {
+            break;
+        }
+
+        EditOperation op;
+        op.stateId = stateIds[q];
+        int from = -1;
+
+        int c = j > 0 ? classOf(input[j - 1]) : -1;
+        if (c >= 0) {
+            for (int p = 0; p < stateCount && from < 0; ++p) {
+                if (contains(rowAt(j - 1, i), p) && inMove(p, c, q)) from = p;
+            }
+            if (from >= 0) {
+                op.kind = EditOperation::Match;
+                op.input = op.symbol = input[j - 1];
+                --j;
+            }
+        }
+        if (from < 0 && i > 0 && j > 0 && contains(rowAt(j - 1, i - 1), q)) {
+            from = q;
+            op.kind = EditOperation::Insert;
+            op.input = input[j - 1];
+            --j;
+            --i;
+        }
+        if (from < 0 && i > 0 && j > 0) {
+            for (int p = 0; p < stateCount && from < 0; ++p) {
+                if (contains(rowAt(j - 1, i - 1), p) && inSuccessors(p, q)) from = p;
+            }
+            if (from >= 0) {
+                op.kind = EditOperation::Substitute;
+                op.input = input[j - 1];
+                op.symbol = symbolBetween(from, q);
+                --j;
+                --i;
+            }
+        }
+        if (from < 0 && i > 0) {
+            for (int p = 0; p < stateCount && from < 0; ++p) {
+                if (contains(rowAt(j, i - 1), p) && inSuccessors(p, q)) from = p;
+            }
+            if (from >= 0) {
+                op.kind = EditOperation::Delete;
+                op.symbol = symbolBetween(from, q);
+                --i;
+            }
+        }
+        if (from < 0) {
+            break;  // unreachable: every state in a row has a predecessor
+        }
+
+        reversed.append(op);
+        q = from;
+    }
+
+    std::reverse(reversed.begin(), reversed.end());
+    return reversed;
+}
+
+QString ApproximateMatch::formatAlignment() const {
+    QString text;
+    for (const EditOperation& op : alignment) {
+        switch (op.kind) {
+        case EditOperation::Match:
+            text += op.input;
+            break;
+        case EditOperation::Substitute:
+            text += QString("[%1>%2]").arg(op.input).arg(op.symbol);
+            break;
+        case EditOperation::Insert:
+            text += QString("[+%1]").arg(op.input);
+            break;
+        case EditOperation::Delete:
+            text += QString("[-%1]").arg(op.symbol);
+            break;
+        }
+    }
+    return text;
+}
+
+// ============================================================
+// Benchmark
+// ============================================================
+
+QVector<ApproximateBenchmarkResult> ApproximateMatcher::runBenchmark(int inputCount, int inputLength,
+                                                                     int maxErrors, quint32 seed) const {
+    QVector<ApproximateBenchmarkResult> results;
+
+    QVector<QChar> alphabet;
+    for (int c = 0; c < classCount; ++c) {
+        if (consuming[c]) alphabet.append(classChars[c]);
+    }
+    if (alphabet.isEmpty() || inputCount <= 0 || inputLength <= 0) {
+        return results;
+    }
+
+    Xorshift32 random(seed);
+
+    // Random walks along consuming edges, then a few random edits, so that
+    // the rows stay populated instead of dying after a handful of symbols
+    int initial = -1;
+    for (int s = 0; s < stateCount && initial < 0; ++s) {
+        if (contains(initialSet.constData(), s)) initial = s;
+    }
+
+    QVector<QString> inputs;
+    for (int n = 0; n < inputCount; ++n) {
+        QString input;
+        input.reserve(inputLength);
+        int state = initial;
+        while (state >= 0 && input.size() < inputLength) {
+            QVector<QPair<int, int>> choices;   // (class, target)
+            for (int c = 0; c < classCount; ++c) {
+                if (!consuming[c]) continue;
+                const int* first;
+                const int* last;
+                moveOf(state, c, &first, &last);
+                for (const int* t = first; t != last; ++t) choices.append(qMakePair(c, *t));
+            }
+            if (choices.isEmpty()) break;
+            const QPair<int, int>& choice = choices[random.next() % choices.size()];
+            input.append(classChars[choice.first]);
+            state = choice.second;
+        }
+        while (input.size() < inputLength) {
+            input.append(alphabet[random.next() % alphabet.size()]);
+        }
+
+        int edits = random.next() % (maxErrors + 2);
+        for (int e = 0; e < edits; ++e) {
+            int at = random.next() % input.size();
+            input[at] = alphabet[random.next() % alphabet.size()];
+        }
+        inputs.append(input);
+    }
+
+    for (int k = 0; k <= qMin(maxErrors, MaxErrors); ++k) {
+        ApproximateBenchmarkResult result;
+        result.maxErrors = k;
+        result.symbols = quint64(inputCount) * inputLength;
+        result.matched = 0;
+        result.inputs = inputCount;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (const QString& input : inputs) {
+            if (distance(input, k) >= 0) ++result.matched;
+        }
+        result.nanoseconds = timer.nsecsElapsed();
+        results.append(result);
+    }
+    return results;
+}
+
+QString ApproximateMatcher::formatBenchmark(const QVector<ApproximateBenchmarkResult>& results) {
+    if (results.isEmpty()) {
+        return "No benchmark results.";
+    }
+
+    QStringList lines;
+    for (const auto& r : results) {
+        lines << QString("k = %1: %2 M symbols/s, %3 of %4 inputs within k")
+                     .arg(r.maxErrors, 2)
+                     .arg(r.megaSymbolsPerSecond(), 0, 'f', 2)
+                     .arg(r.matched)
+                     .arg(r.inputs);
+    }
+    return lines.join("\n");
+}
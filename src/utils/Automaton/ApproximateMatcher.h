@@ -0,0 +1,101 @@
+#ifndef APPROXIMATEMATCHER_H
+#define APPROXIMATEMATCHER_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+// One step of an alignment between the input and a word of the language
+struct EditOperation {
+    enum Kind { Match, Substitute, Insert, Delete };
+
+    Kind kind;
+    QChar input;        // input character; unused for Delete
+    QChar symbol;       // automaton symbol; unused for Insert
+    QString stateId;    // state reached after the step
+};
+
+struct ApproximateMatch {
+    int distance;                       // -1 if more than the allowed errors
+    QVector<EditOperation> alignment;   // empty when not requested or too large to record
+
+    ApproximateMatch() : distance(-1) {}
+    QString formatAlignment() const;    // "ab[x>c]d[+y][-z]": substitution, extra input, missing symbol
+};
+
+struct ApproximateBenchmarkResult {
+    int maxErrors;
+    qint64 nanoseconds;
+    quint64 symbols;
+    int matched;        // inputs within maxErrors of the language
+    int inputs;
+
+    double megaSymbolsPerSecond() const { return nanoseconds ? symbols * 1000.0 / nanoseconds : 0.0; }
+};
+
+// Edit distance from a string to the language of an automaton, allowing
+// insertions, deletions and substitutions. Keeps one state bitset per
+// error count (Wu-Manber rows generalised to arbitrary NFAs): row i holds
+// the states reachable with at most i errors, and each input character
+// updates all rows from precomputed epsilon-closed moves, kept as sorted
+// state lists per state and class, or looked up one byte of the state set
+// at a time when the byte tables fit.
+// With no errors allowed it agrees with Automaton::accepts().
+class ApproximateMatcher {
+public:
+    static const int MaxErrors = 32;
+    static const qint64 MaxAlignmentWords = 16 * 1024 * 1024;   // history kept for the traceback
+    static const qint64 MaxByteTableBytes = 4 * 1024 * 1024;    // above this, moves are ORed state by state
+
+    explicit ApproximateMatcher(const Automaton* automaton);
+
+    // Smallest number of edits that makes input accepted, -1 if above maxErrors
+    int distance(const QString& input, int maxErrors) const;
+    ApproximateMatch match(const QString& input, int maxErrors, bool withAlignment = true) const;
+
+    // Random inputs over the automaton's alphabet, timed for every error bound up to maxErrors
+    QVector<ApproximateBenchmarkResult> runBenchmark(int inputCount, int inputLength, int maxErrors,
+                                                     quint32 seed = 12345) const;
+    static QString formatBenchmark(const QVector<ApproximateBenchmarkResult>& results);
+
+private:
+    int stateCount;
+    int words;                          // 64-bit words per state set
+    int classCount;
+    QVector<QString> stateIds;
+    QVector<QChar> classChars;
+    QVector<bool> consuming;            // false for the 'E'/'ε' classes that follow epsilon edges
+    QVector<int> latin1Class;           // character -> class, -1 = not in the alphabet
+    QHash<ushort, int> otherClass;
+    QVector<int> moveBegin;             // state * classCount + class -> its first state in moveStates
+    QVector<int> moveStates;            // closure of the move's targets, sorted
+    QVector<int> successorBegin;        // state -> its first state in successorStates
+    QVector<int> successorStates;       // closure of all consuming targets, sorted
+    QVector<quint64> byteTables;        // ((table * words * 8 + byte) * 256 + value) * words; table classCount = successors
+    QVector<quint64> initialSet;
+    QVector<quint64> finalSet;
+
+    int classOf(QChar ch) const;
+    bool contains(const quint64* set, int state) const { return set[state / 64] & (quint64(1) << (state % 64)); }
+    void moveOf(int state, int symbolClass, const int** first, const int** last) const {
+        const int* begin = moveBegin.constData() + qint64(state) * classCount + symbolClass;
+        *first = moveStates.constData() + begin[0];
+        *last = moveStates.constData() + begin[1];
+    }
+    void successorsOf(int state, const int** first, const int** last) const {
+        *first = successorStates.constData() + successorBegin[state];
+        *last = successorStates.constData() + successorBegin[state + 1];
+    }
+    void buildByteTables();
+    void orTable(const quint64* set, int table, quint64* out) const;
+    void orMove(const quint64* set, int symbolClass, quint64* out) const;
+    void orSuccessors(const quint64* set, quint64* out) const;
+    void initialRows(quint64* rows, int rowCount) const;
+    void step(const quint64* rows, int rowCount, int symbolClass, quint64* next, quint64* scratch) const;
+    int acceptingRow(const quint64* rows, int rowCount) const;
+    QVector<EditOperation> traceback(const QString& input, const QVector<quint64>& history,
+                                     int rowCount, int errors) const;
+};
+
+#endif // APPROXIMATEMATCHER_H
@@ -0,0 +1,195 @@
+#include "AutomatonRegistry.h"
+#include "NFAtoDFA.h"
+#include "DFAMinimizer.h"
+#include "DFACanonicalizer.h"
+#include <QCryptographicHash>
+
+AutomatonRegistry::AutomatonRegistry()
+    : cacheHits(0), cacheMisses(0) {}
+
+AutomatonRegistry::~AutomatonRegistry() {
+    clear();
+}
+
+void AutomatonRegistry::clear() {
+    qDeleteAll(compiledByHash);
+    qDeleteAll(conversionByFingerprint);
+    qDeleteAll(minimizationByFingerprint);
+    compiledByHash.clear();
+    conversionByFingerprint.clear();
+    minimizationByFingerprint.clear();
+    canonicalHashByFingerprint.clear();
+    resultOrder.clear();
+    cacheHits = 0;
+    cacheMisses = 0;
+}
+
+void AutomatonRegistry::evict(const QString& fingerprint) {
+    delete conversionByFingerprint.take(fingerprint);
+    delete minimizationByFingerprint.take(fingerprint);
+    resultOrder.removeOne(fingerprint);
+
+    QString hash = canonicalHashByFingerprint.take(fingerprint);
+    if (!hash.isEmpty() && !canonicalHashByFingerprint.values().contains(hash)) {
+        delete compiledByHash.take(hash);
+    }
+}
+
+void AutomatonRegistry::touchResult(const QString& fingerprint) {
+    resultOrder.removeOne(fingerprint);
+    resultOrder.append(fingerprint);
+
+    // Shared tables stay, since AutomatonManager points into them
+    while (resultOrder.size() > MaxCachedResults) {
+        QString oldest = resultOrder.takeFirst();
+        delete conversionByFingerprint.take(oldest);
+        delete minimizationByFingerprint.take(oldest);
+    }
+}
+
+QString AutomatonRegistry::fingerprint(const Automaton* automaton) {
+    if (!automaton) {
+        return QString();
+    }
+
+    // Control characters cannot clash with ids typed on the canvas
+    const QString unitSeparator = QString(QChar(0x1F));
+    const QString recordSeparator = QString(QChar(0x1E));
+
+    QStringList states;
+    for (const auto& state : automaton->getStates()) {
+        states << state.getId() + (state.getIsFinal() ? "!" : "");
+    }
+    states.sort();
+
+    QStringList transitions;
+    for (const auto& t : automaton->getTransitions()) {
+        QStringList symbols = t.getSymbols().values();
+        symbols.sort();
+        transitions << t.getFromStateId() + ">" + t.getToStateId() + ":" + symbols.join(unitSeparator);
+    }
+    transitions.sort();
+
+    QStringList alphabet = automaton->getAlphabet().values();
+    alphabet.sort();
+
+    QString text = QString("%1|%2|%3|%4|%5")
+                       .arg(automaton->isDFA() ? "DFA" : "NFA")
+                       .arg(automaton->getInitialStateId())
+                       .arg(states.join(recordSeparator))
+                       .arg(transitions.join(recordSeparator))
+                       .arg(alphabet.join(recordSeparator));
+    return QString::fromLatin1(QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+const Automaton* AutomatonRegistry::deterministicSource(const Automaton* automaton) {
+    if (!automaton->isNFA()) {
+        return automaton;
+    }
+
+    // Reuse the cached conversion instead of determinizing again
+    QString key = fingerprint(automaton);
+    Automaton* cached = conversionByFingerprint.value(key, nullptr);
+    if (!cached) {
+        NFAtoDFA converter;
+        cached = converter.convert(automaton);
+        if (cached) {
+            conversionByFingerprint.insert(key, cached);
+        }
+    }
+    if (cached) {
+        touchResult(key);
+    }
+    return cached;
+}
+
+QString AutomatonRegistry::canonicalHash(const Automaton* automaton) {
+    if (!automaton || !automaton->isValid()) {
+        return QString();
+    }
+
+    QString key = fingerprint(automaton);
+    auto it = canonicalHashByFingerprint.constFind(key);
+    if (it != canonicalHashByFingerprint.constEnd()) {
+        return it.value();
+    }
+
+    const Automaton* source = deterministicSource(automaton);
+    CompiledDFA compiledSource;
+    if (!source || !compiledSource.compile(source)) {
+        return QString();
+    }
+
+    DFACanonicalizer canonicalizer;
+    CompiledDFA canonical = canonicalizer.canonicalize(compiledSource);
+    QByteArray digest = QCryptographicHash::hash(canonicalizer.serialize(canonical).toUtf8(),
+                                                 QCryptographicHash::Sha1);
+    QString hash = QString::fromLatin1(digest.toHex());
+
+    canonicalHashByFingerprint.insert(key, hash);
+    if (!compiledByHash.contains(hash)) {
+        compiledByHash.insert(hash, new CompiledDFA(canonical));
+    }
+    return hash;
+}
+
+const CompiledDFA* AutomatonRegistry::compiled(const Automaton* automaton) {
+    QString hash = canonicalHash(automaton);
+    return hash.isEmpty() ? nullptr : compiledByHash.value(hash, nullptr);
+}
+
+Automaton* AutomatonRegistry::convertToDFA(const Automaton* nfa, bool* fromCache) {
+    if (fromCache) *fromCache = false;
+    if (!nfa || !nfa->isValid()) {
+        return nullptr;
+    }
+
+    QString key = fingerprint(nfa);
+    Automaton* cached = conversionByFingerprint.value(key, nullptr);
+    if (cached) {
+        ++cacheHits;
+        if (fromCache) *fromCache = true;
+        touchResult(key);
+        return new Automaton(*cached);
+    }
+
+    ++cacheMisses;
+    NFAtoDFA converter;
+    Automaton* dfa = converter.convert(nfa);
+    if (!dfa) {
+        return nullptr;
+    }
+    conversionByFingerprint.insert(key, new Automaton(*dfa));
+    touchResult(key);
+    return dfa;
+}
+
+Automaton* AutomatonRegistry::minimize(const Automaton* dfa, bool* fromCache) {
+    if (fromCache) *fromCache = false;
+    if (!dfa || !dfa->isValid() || !dfa->isDFA()) {
+        return nullptr;
+    }
+
+    // Only a structurally identical DFA yields the same state ids and
+    // alphabet; the fingerprint ignores names, so take the caller's
+    QString key = fingerprint(dfa);
+    Automaton* cached = minimizationByFingerprint.value(key, nullptr);
+    if (cached) {
+        ++cacheHits;
+        if (fromCache) *fromCache = true;
+        touchResult(key);
+        Automaton* minimized = new Automaton(*cached);
+        minimized->setName(dfa->getName() + " (Minimized)");
+        return minimized;
+    }
+
+    ++cacheMisses;
+    DFAMinimizer minimizer;
+    Automaton* minimized = minimizer.minimize(dfa);
+    if (!minimized) {
+        return nullptr;
+    }
+    minimizationByFingerprint.insert(key, new Automaton(*minimized));
+    touchResult(key);
+    return minimized;
+}
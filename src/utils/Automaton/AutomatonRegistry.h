@@ -0,0 +1,63 @@
+#ifndef AUTOMATONREGISTRY_H
+#define AUTOMATONREGISTRY_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "CompiledDFA.h"
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+// Deduplicates work across structurally identical or language-equivalent
+// automata. Sources are keyed by a structural fingerprint (layout and
+// names excluded); conversions and minimizations are cached per
+// fingerprint, and only compiled tables are shared per canonical DFA hash,
+// since equivalent machines differ in state ids and alphabet. Cached
+// automata stay owned by the registry; callers receive copies. Only the
+// MaxCachedResults most recently used conversions and minimizations are
+// kept, as editor results are never evicted by their owner.
+class AutomatonRegistry {
+public:
+    static const int MaxCachedResults = 32;
+
+private:
+    QHash<QString, QString> canonicalHashByFingerprint;
+    QHash<QString, CompiledDFA*> compiledByHash;
+    QHash<QString, Automaton*> conversionByFingerprint;
+    QHash<QString, Automaton*> minimizationByFingerprint;
+    QStringList resultOrder;    // fingerprints with a cached result, least recently used first
+    int cacheHits;
+    int cacheMisses;
+
+public:
+    AutomatonRegistry();
+    ~AutomatonRegistry();
+
+    // Structural fingerprint of an automaton as edited (ignores positions)
+    static QString fingerprint(const Automaton* automaton);
+
+    // Canonical language hash, empty if the automaton cannot be compiled
+    QString canonicalHash(const Automaton* automaton);
+
+    // Shared execution table for the automaton's language
+    const CompiledDFA* compiled(const Automaton* automaton);
+
+    // Cached NFA -> DFA conversion and DFA minimization; the caller owns
+    // the returned copy. fromCache reports whether work was skipped.
+    Automaton* convertToDFA(const Automaton* nfa, bool* fromCache = nullptr);
+    Automaton* minimize(const Automaton* dfa, bool* fromCache = nullptr);
+
+    int getCacheHits() const { return cacheHits; }
+    int getCacheMisses() const { return cacheMisses; }
+    int getSharedTableCount() const { return compiledByHash.size(); }
+    void clear();
+
+    // Drops everything cached for one fingerprint; the shared table goes
+    // too once no other cached fingerprint has its language
+    void evict(const QString& fingerprint);
+
+private:
+    const Automaton* deterministicSource(const Automaton* automaton);
+    void touchResult(const QString& fingerprint);
+};
+
+#endif // AUTOMATONREGISTRY_H
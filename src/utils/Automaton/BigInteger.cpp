@@ -0,0 +1,123 @@
+#include "BigInteger.h"
+
+BigInteger::BigInteger() {}
+
+BigInteger::BigInteger(quint64 value) {
+    while (value > 0) {
+        limbs.append(static_cast<quint32>(value % BASE));
+        value /= BASE;
+    }
+}
+
+void BigInteger::trim() {
+    while (!limbs.isEmpty() && limbs.last() == 0) {
+        limbs.removeLast();
+    }
+}
+
+BigInteger& BigInteger::operator+=(const BigInteger& other) {
+    if (limbs.size() < other.limbs.size()) {
+        limbs.resize(other.limbs.size());
+    }
+
+    quint32 carry = 0;
+    for (int i = 0; i < limbs.size(); ++i) {
+        quint32 sum = limbs[i] + carry + (i < other.limbs.size() ? other.limbs[i] : 0);
+        carry = sum >= BASE ? 1 : 0;
+        limbs[i] = carry ? sum - BASE : sum;
+        if (!carry && i >= other.limbs.size()) {
+            break;
+        }
+    }
+    if (carry) {
+        limbs.append(carry);
+    }
+    return *this;
+}
+
+BigInteger BigInteger::operator+(const BigInteger& other) const {
+    BigInteger result = *this;
+    result += other;
+    return result;
+}
+
+BigInteger BigInteger::operator*(const BigInteger& other) const {
+    BigInteger result;
+    if (isZero() || other.isZero()) {
+        return result;
+    }
+
+    QVector<quint64> acc(limbs.size() + other.limbs.size(), 0);
+    for (int i = 0; i < limbs.size(); ++i) {
+        quint64 carry = 0;
+        for (int j = 0; j < other.limbs.size(); ++j) {
+            quint64 cur = acc[i + j] + static_cast<quint64>(limbs[i]) * other.limbs[j] + carry;
+            acc[i + j] = cur % BASE;
+            carry = cur / BASE;
+        }
+        int k = i + other.limbs.size();
+        while (carry) {
+            quint64 cur = acc[k] + carry;
+            acc[k] = cur % BASE;
+            carry = cur / BASE;
+            ++k;
+        }
+    }
+
+    result.limbs.resize(acc.size());
+    for (int i = 0; i < acc.size(); ++i) {
+        result.limbs[i] = static_cast<quint32>(acc[i]);
+    }
+    result.trim();
+    return result;
+}
+
+BigInteger& BigInteger::multiplySmall(quint32 factor) {
+    if (factor == 0) {
+        limbs.clear();
+        return *this;
+    }
+
+    quint64 carry = 0;
+    for (int i = 0; i < limbs.size(); ++i) {
+        quint64 cur = static_cast<quint64>(limbs[i]) * factor + carry;
+        limbs[i] = static_cast<quint32>(cur % BASE);
+        carry = cur / BASE;
+    }
+    while (carry) {
+        limbs.append(static_cast<quint32>(carry % BASE));
+        carry /= BASE;
+    }
+    return *this;
+}
+
+bool BigInteger::operator<(const BigInteger& other) const {
+    if (limbs.size() != other.limbs.size()) {
+        return limbs.size() < other.limbs.size();
+    }
+    for (int i = limbs.size() - 1; i >= 0; --i) {
+        if (limbs[i] != other.limbs[i]) {
+            return limbs[i] < other.limbs[i];
+        }
+    }
+    return false;
+}
+
+QString BigInteger::toString() const {
+    if (isZero()) {
+        return "0";
+    }
+
+    QString result = QString::number(limbs.last());
+    for (int i = limbs.size() - 2; i >= 0; --i) {
+        result += QString("%1").arg(limbs[i], 9, 10, QChar('0'));
+    }
+    return result;
+}
+
+int BigInteger::digitCount() const {
+    if (isZero()) {
+        return 1;
+    }
+    return (limbs.size() - 1) * 9 + QString::number(limbs.last()).size();
+}
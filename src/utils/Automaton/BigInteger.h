@@ -0,0 +1,35 @@
+#ifndef BIGINTEGER_H
+#define BIGINTEGER_H
+
+#include <QVector>
+#include <QString>
+#include <QtGlobal>
+
+// Non-negative arbitrary precision integer used for language counting.
+// Stored little-endian in base 10^9 limbs so printing stays cheap.
+class BigInteger {
+private:
+    static const quint32 BASE = 1000000000u;
+    QVector<quint32> limbs;
+
+    void trim();
+
+public:
+    BigInteger();
+    BigInteger(quint64 value);
+
+    bool isZero() const { return limbs.isEmpty(); }
+    QString toString() const;
+    int digitCount() const;
+
+    BigInteger& operator+=(const BigInteger& other);
+    BigInteger operator+(const BigInteger& other) const;
+    BigInteger operator*(const BigInteger& other) const;
+    BigInteger& multiplySmall(quint32 factor);
+
+    bool operator==(const BigInteger& other) const { return limbs == other.limbs; }
+    bool operator!=(const BigInteger& other) const { return limbs != other.limbs; }
+    bool operator<(const BigInteger& other) const;
+};
+
+#endif // BIGINTEGER_H
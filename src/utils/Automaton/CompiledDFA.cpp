@@ -0,0 +1,308 @@
+#include "CompiledDFA.h"
+#include "NFAtoDFA.h"
+#include "StateLayout.h"
+#include <QMap>
+#include <QStringList>
+
+// Tables below this size always stay dense
+static const qint64 AUTO_COMPRESS_THRESHOLD = 256 * 1024;
+
+CompiledDFA::CompiledDFA()
+    : stateCount(0), symbolCount(0), initialState(-1),
+    encoding(TableEncoding::Auto), compressed(false) {}
+
+void CompiledDFA::clear() {
+    stateCount = 0;
+    symbolCount = 0;
+    initialState = -1;
+    symbols.clear();
+    symbolIndex.clear();
+    asciiClass.clear();
+    table.clear();
+    packedTable.clear();
+    shuffleTable.clear();
+    compressed = false;
+    finalStates.clear();
+    stateIds.clear();
+}
+
+void CompiledDFA::indexSymbols(const QVector<QString>& classSymbols) {
+    symbols = classSymbols;
+    symbolCount = symbols.size();
+    symbolIndex.clear();
+    asciiClass.fill(-1, 128);
+    for (int i = 0; i < symbolCount; ++i) {
+        const QString& sym = symbols[i];
+        symbolIndex.insert(sym, i);
+        if (sym.size() == 1 && sym[0].unicode() < 128) {
+            asciiClass[sym[0].unicode()] = i;
+        }
+    }
+}
+
+bool CompiledDFA::compile(const Automaton* automaton, QString* errorMsg, StateOrder order) {
+    clear();
+
+    if (!automaton || !automaton->isValid()) {
+        if (errorMsg) *errorMsg = "Automaton is not valid (missing states or initial state).";
+        return false;
+    }
+
+    const Automaton* dfa = automaton;
+    Automaton* converted = nullptr;
+    if (automaton->isNFA()) {
+        NFAtoDFA converter;
+        converted = converter.convert(automaton);
+        if (!converted) {
+            if (errorMsg) *errorMsg = "NFA to DFA conversion failed.";
+            return false;
+        }
+        dfa = converted;
+    }
+
+    // Symbol classes in sorted order so enumeration follows lexicographic order
+    QSet<QString> symbolSet = dfa->getAlphabet();
+    for (const auto& t : dfa->getTransitions()) {
+        for (const auto& sym : t.getSymbols()) {
+            symbolSet.insert(sym);
+        }
+    }
+
+    // Epsilon spellings only mean epsilon in an NFA; in a DFA, 'E' is a real letter
+    bool epsilonSymbols = automaton->isNFA();
+    QStringList sortedSymbols;
+    for (const auto& sym : symbolSet) {
+        if (sym.isEmpty() || (epsilonSymbols && Transition::isEpsilonSymbol(sym))) {
+            continue;
+        }
+        sortedSymbols.append(sym);
+    }
+    sortedSymbols.sort();
+    indexSymbols(sortedSymbols.toVector());
+
+    QHash<QString, int> stateIndex;
+    for (const auto& state : dfa->getStates()) {
+        stateIndex.insert(state.getId(), stateIds.size());
+        stateIds.append(state.getId());
+        finalStates.append(state.getIsFinal());
+    }
+    stateCount = stateIds.size();
+    initialState = stateIndex.value(dfa->getInitialStateId(), -1);
+
+    table.fill(-1, stateCount * symbolCount);
+    for (const auto& t : dfa->getTransitions()) {
+        int from = stateIndex.value(t.getFromStateId(), -1);
+        int to = stateIndex.value(t.getToStateId(), -1);
+        if (from < 0 || to < 0) {
+            continue;
+        }
+        for (const auto& sym : t.getSymbols()) {
+            int symbol = symbolIndex.value(sym, -1);
+            // First transition wins, matching Automaton::acceptsDFA
+            if (symbol >= 0 && table[from * symbolCount + symbol] < 0) {
+                table[from * symbolCount + symbol] = to;
+            }
+        }
+    }
+
+    delete converted;
+
+    if (initialState < 0) {
+        if (errorMsg) *errorMsg = "Initial state not found.";
+        clear();
+        return false;
+    }
+
+    // Creation order scatters rows; renumber so neighbouring states share cache lines
+    if (order == StateOrder::BreadthFirst) {
+        renumber(StateLayout::breadthFirstOrder(*this));
+    } else if (order == StateOrder::DepthFirst) {
+        renumber(StateLayout::depthFirstOrder(*this));
+    } else {
+        applyEncoding();
+    }
+
+    return true;
+}
+
+bool CompiledDFA::buildFromTable(int states, const QVector<QString>& classSymbols,
+                                 const QVector<int>& transitions, const QVector<bool>& finals,
+                                 int initial, QString* errorMsg) {
+    clear();
+
+    if (states <= 0 || initial < 0 || initial >= states) {
+        if (errorMsg) *errorMsg = "Table has no states or an invalid initial state.";
+        return false;
+    }
+    if (transitions.size() != states * classSymbols.size() || finals.size() != states) {
+        if (errorMsg) *errorMsg = "Table dimensions do not match the state and symbol counts.";
+        return false;
+    }
+
+    indexSymbols(classSymbols);
+    stateCount = states;
+    initialState = initial;
+    table = transitions;
+    finalStates = finals;
+    for (int s = 0; s < states; ++s) {
+        stateIds.append(QString("q%1").arg(s));
+    }
+    applyEncoding();
+    return true;
+}
+
+void CompiledDFA::renumber(const QVector<int>& order) {
+    if (order.size() != stateCount) {
+        return;
+    }
+
+    if (compressed) {
+        table = packedTable.toDense();
+        packedTable.clear();
+        compressed = false;
+    }
+
+    QVector<int> newIndex(stateCount, -1);
+    for (int i = 0; i < stateCount; ++i) {
+        newIndex[order[i]] = i;
+    }
+
+    QVector<int> newTable(table.size(), -1);
+    QVector<bool> newFinals(stateCount, false);
+    QVector<QString> newIds(stateCount);
+    for (int i = 0; i < stateCount; ++i) {
+        int old = order[i];
+        newFinals[i] = finalStates[old];
+        newIds[i] = stateIds[old];
+        for (int c = 0; c < symbolCount; ++c) {
+            int target = table[old * symbolCount + c];
+            newTable[i * symbolCount + c] = target < 0 ? -1 : newIndex[target];
+        }
+    }
+
+    table = newTable;
+    finalStates = newFinals;
+    stateIds = newIds;
+    initialState = newIndex[initialState];
+    applyEncoding();
+}
+
+void CompiledDFA::setEncoding(TableEncoding tableEncoding) {
+    encoding = tableEncoding;
+    if (compressed) {
+        table = packedTable.toDense();
+        packedTable.clear();
+        compressed = false;
+    }
+    applyEncoding();
+}
+
+void CompiledDFA::applyEncoding() {
+    // Small DFAs run on the shuffle kernel whatever the table storage
+    shuffleTable.clear();
+    if (stateCount > 0 && stateCount <= ShuffleTable::MaxStates) {
+        shuffleTable.build(denseTable(), stateCount, symbolCount, symbols);
+    }
+
+    if (compressed || stateCount == 0 || symbolCount == 0 || encoding == TableEncoding::Dense) {
+        return;
+    }
+
+    qint64 denseBytes = CompressedTable::denseMemoryBytes(stateCount, symbolCount);
+    if (encoding == TableEncoding::Auto && denseBytes < AUTO_COMPRESS_THRESHOLD) {
+        return;
+    }
+
+    packedTable.build(table, stateCount, symbolCount);
+
+    // Auto only keeps the packed form when it at least halves the footprint
+    if (encoding == TableEncoding::Auto && packedTable.memoryBytes() * 2 > denseBytes) {
+        packedTable.clear();
+        return;
+    }
+
+    table.clear();
+    table.squeeze();
+    compressed = true;
+}
+
+qint64 CompiledDFA::tableMemoryBytes() const {
+    return compressed ? packedTable.memoryBytes()
+                      : CompressedTable::denseMemoryBytes(stateCount, symbolCount);
+}
+
+QVector<int> CompiledDFA::denseTable() const {
+    return compressed ? packedTable.toDense() : table;
+}
+
+Automaton* CompiledDFA::toAutomaton(const QString& id, const QString& name) const {
+    if (isEmpty()) {
+        return nullptr;
+    }
+
+    // Built as an NFA so addTransition skips the per-edge DFA checks. The
+    // editor's model reads 'E' and 'ε' as epsilon, so those letters are left
+    // out, as a DFA's addTransition would reject them; every edge left is a
+    // real letter and the DFA label below holds.
+    Automaton* automaton = new Automaton(id, name, AutomatonType::NFA);
+    for (int s = 0; s < stateCount; ++s) {
+        State state(stateIds[s]);
+        state.setIsFinal(finalStates[s]);
+        automaton->addState(state);
+    }
+    automaton->setInitialState(stateIds[initialState]);
+
+    for (int s = 0; s < stateCount; ++s) {
+        QMap<int, Transition> byTarget;
+        for (int c = 0; c < symbolCount; ++c) {
+            int t = next(s, c);
+            if (t < 0 || Transition::isEpsilonSymbol(symbols[c])) continue;
+            if (byTarget.contains(t)) {
+                byTarget[t].addSymbol(symbols[c]);
+            } else {
+                byTarget.insert(t, Transition(stateIds[s], stateIds[t], symbols[c]));
+            }
+        }
+        for (const Transition& trans : byTarget) {
+            automaton->addTransition(trans);
+        }
+    }
+
+    automaton->setType(AutomatonType::DFA);
+    return automaton;
+}
+
+int CompiledDFA::indexOfState(const QString& stateId) const {
+    return stateIds.indexOf(stateId);
+}
+
+int CompiledDFA::classOf(QChar ch) const {
+    if (ch.unicode() < 128) {
+        return asciiClass.isEmpty() ? -1 : asciiClass[ch.unicode()];
+    }
+    return symbolIndex.value(QString(ch), -1);
+}
+
+int CompiledDFA::run(const QString& input) const {
+    if (!shuffleTable.isEmpty()) {
+        return shuffleTable.run(initialState, input);
+    }
+
+    int state = initialState;
+    for (const QChar& ch : input) {
+        if (state < 0) {
+            break;
+        }
+        int symbol = classOf(ch);
+        state = symbol < 0 ? -1 : next(state, symbol);
+    }
+    return state;
+}
+
+bool CompiledDFA::accepts(const QString& input) const {
+    if (isEmpty()) {
+        return false;
+    }
+    int state = run(input);
+    return state >= 0 && finalStates[state];
+}
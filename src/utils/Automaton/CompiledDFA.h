@@ -0,0 +1,90 @@
+#ifndef COMPILEDDFA_H
+#define COMPILEDDFA_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "CompressedTable.h"
+#include "ShuffleTable.h"
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+// State numbering applied when compiling for execution
+enum class StateOrder {
+    Creation,       // order of Automaton::getStates()
+    BreadthFirst,   // BFS from the initial state, symbols in class order
+    DepthFirst      // DFS preorder from the initial state
+};
+
+// Storage of the transition table
+enum class TableEncoding {
+    Auto,           // dense unless the table is large and compresses well
+    Dense,
+    Compressed      // row displacement, see CompressedTable
+};
+
+// Execution form of a DFA: integer state ids, symbol classes in sorted
+// order and a dense states x classes transition table (-1 = dead).
+class CompiledDFA {
+private:
+    int stateCount;
+    int symbolCount;
+    int initialState;
+    QVector<QString> symbols;          // class index -> symbol, sorted
+    QHash<QString, int> symbolIndex;   // symbol -> class index
+    QVector<int> asciiClass;           // fast class lookup for ASCII input
+    QVector<int> table;                // row-major, stateCount * symbolCount
+    CompressedTable packedTable;       // replaces table when compressed
+    ShuffleTable shuffleTable;         // byte-shuffle kernel, built for DFAs of up to 16 states
+    TableEncoding encoding;
+    bool compressed;
+    QVector<bool> finalStates;
+    QVector<QString> stateIds;         // compiled index -> original state id
+
+public:
+    CompiledDFA();
+
+    // Compile an automaton; NFAs are determinized first
+    bool compile(const Automaton* automaton, QString* errorMsg = nullptr,
+                 StateOrder order = StateOrder::BreadthFirst);
+    // Adopt an already built table (symbols in class order, -1 = dead)
+    bool buildFromTable(int states, const QVector<QString>& classSymbols,
+                        const QVector<int>& transitions, const QVector<bool>& finals,
+                        int initial, QString* errorMsg = nullptr);
+    // Permute state numbers; order[newIndex] = oldIndex
+    void renumber(const QVector<int>& order);
+    // Editable copy of the table, one transition per (state, target) pair
+    Automaton* toAutomaton(const QString& id, const QString& name) const;
+    void clear();
+
+    bool isEmpty() const { return stateCount == 0; }
+    int getStateCount() const { return stateCount; }
+    int getSymbolCount() const { return symbolCount; }
+    int getInitialState() const { return initialState; }
+    bool isFinal(int state) const { return finalStates[state]; }
+    const QString& getSymbol(int symbol) const { return symbols[symbol]; }
+    const QString& getStateId(int state) const { return stateIds[state]; }
+    int indexOfState(const QString& stateId) const;
+
+    int next(int state, int symbol) const {
+        return compressed ? packedTable.lookup(state, symbol) : table[state * symbolCount + symbol];
+    }
+
+    // Table storage; Auto re-evaluates after every compile/renumber
+    void setEncoding(TableEncoding tableEncoding);
+    TableEncoding getEncoding() const { return encoding; }
+    bool isCompressed() const { return compressed; }
+    qint64 tableMemoryBytes() const;
+    QVector<int> denseTable() const;
+    int classOf(QChar ch) const;
+    bool usesShuffleKernel() const { return !shuffleTable.isEmpty(); }
+
+    // Simulation
+    bool accepts(const QString& input) const;
+    int run(const QString& input) const;
+
+private:
+    void indexSymbols(const QVector<QString>& classSymbols);
+    void applyEncoding();
+};
+
+#endif // COMPILEDDFA_H
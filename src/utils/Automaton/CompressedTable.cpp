@@ -0,0 +1,124 @@
+#include "CompressedTable.h"
+#include <QHash>
+#include <algorithm>
+
+CompressedTable::CompressedTable()
+    : rowCount(0), columnCount(0) {}
+
+void CompressedTable::clear() {
+    rowCount = 0;
+    columnCount = 0;
+    defaults.clear();
+    base.clear();
+    values.clear();
+    check.clear();
+}
+
+void CompressedTable::build(const QVector<int>& dense, int rows, int columns) {
+    clear();
+    if (rows <= 0 || columns <= 0 || dense.size() != rows * columns) {
+        return;
+    }
+
+    rowCount = rows;
+    columnCount = columns;
+    defaults.fill(-1, rows);
+    base.fill(0, rows);
+
+    // Default per row is its most frequent value; only the rest gets packed
+    QVector<QVector<int>> packedColumns(rows);
+    QHash<int, int> frequency;
+    for (int r = 0; r < rows; ++r) {
+        frequency.clear();
+        int best = dense[r * columns];
+        int bestCount = 0;
+        for (int c = 0; c < columns; ++c) {
+            int value = dense[r * columns + c];
+            int count = ++frequency[value];
+            if (count > bestCount) {
+                best = value;
+                bestCount = count;
+            }
+        }
+        defaults[r] = best;
+        for (int c = 0; c < columns; ++c) {
+            if (dense[r * columns + c] != best) {
+                packedColumns[r].append(c);
+            }
+        }
+    }
+
+    // Densest rows first: they are hardest to fit later
+    QVector<int> order(rows);
+    for (int r = 0; r < rows; ++r) {
+        order[r] = r;
+    }
+    std::stable_sort(order.begin(), order.end(), [&packedColumns](int a, int b) {
+        return packedColumns[a].size() > packedColumns[b].size();
+    });
+
+    // First-fit placement; lowestFree skips the fully packed prefix
+    int lowestFree = 0;
+    int searchWindow = qMax(columns * 4, 256);
+    for (int r : order) {
+        const QVector<int>& cols = packedColumns[r];
+        if (cols.isEmpty()) {
+            continue;
+        }
+
+        // Only the recent tail of the vector is searched, so packing stays
+        // linear; older holes that nothing fitted are left behind
+        int windowStart = qMax(lowestFree, check.size() - searchWindow);
+        int candidate = qMax(0, windowStart - cols.first());
+        int lastCandidate = qMax(0, check.size() - cols.first());
+        while (candidate < lastCandidate) {
+            bool fits = true;
+            for (int c : cols) {
+                int index = candidate + c;
+                if (index < check.size() && check[index] != -1) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) break;
+            ++candidate;
+        }
+
+        base[r] = candidate;
+        int needed = candidate + cols.last() + 1;
+        if (needed > check.size()) {
+            int oldSize = check.size();
+            check.resize(needed);
+            values.resize(needed);
+            for (int i = oldSize; i < needed; ++i) {
+                check[i] = -1;
+            }
+        }
+        for (int c : cols) {
+            check[candidate + c] = r;
+            values[candidate + c] = dense[r * columns + c];
+        }
+
+        while (lowestFree < check.size() && check[lowestFree] != -1) {
+            ++lowestFree;
+        }
+    }
+}
+
+QVector<int> CompressedTable::toDense() const {
+    QVector<int> dense(rowCount * columnCount);
+    for (int r = 0; r < rowCount; ++r) {
+        for (int c = 0; c < columnCount; ++c) {
+            dense[r * columnCount + c] = lookup(r, c);
+        }
+    }
+    return dense;
+}
+
+qint64 CompressedTable::memoryBytes() const {
+    return qint64(defaults.size() + base.size() + values.size() + check.size()) * qint64(sizeof(int));
+}
+
+qint64 CompressedTable::denseMemoryBytes(int rows, int columns) {
+    return qint64(rows) * columns * qint64(sizeof(int));
+}
@@ -0,0 +1,41 @@
+#ifndef COMPRESSEDTABLE_H
+#define COMPRESSEDTABLE_H
+
+#include <QVector>
+
+// Row-displacement ("comb vector") encoding of a sparse rows x columns
+// int table, as used by yacc/flex. Each row keeps a default value (its
+// most frequent entry); the remaining entries are packed into a shared
+// value vector at base[row] + column, and check[] records the owning row
+// so lookups stay O(1).
+class CompressedTable {
+private:
+    int rowCount;
+    int columnCount;
+    QVector<int> defaults;   // per row
+    QVector<int> base;       // per row offset into values/check
+    QVector<int> values;
+    QVector<int> check;      // owning row of each slot, -1 = free
+
+public:
+    CompressedTable();
+
+    void build(const QVector<int>& dense, int rows, int columns);
+    void clear();
+
+    int lookup(int row, int column) const {
+        int index = base[row] + column;
+        return (index < check.size() && check[index] == row) ? values[index] : defaults[row];
+    }
+
+    QVector<int> toDense() const;
+
+    bool isEmpty() const { return rowCount == 0; }
+    int getRowCount() const { return rowCount; }
+    int getColumnCount() const { return columnCount; }
+    int getPackedSize() const { return values.size(); }
+    qint64 memoryBytes() const;
+    static qint64 denseMemoryBytes(int rows, int columns);
+};
+
+#endif // COMPRESSEDTABLE_H
@@ -0,0 +1,229 @@
+#include "DFABenchmark.h"
+#include "StateLayout.h"
+#include <QElapsedTimer>
+#include <QStringList>
+#include <algorithm>
+
+DFABenchmark::DFABenchmark(quint32 seed)
+    : random(seed), stepsDone(0) {}
+
+bool DFABenchmark::stepDone() {
+    ++stepsDone;
+    return !progressCallback || progressCallback(stepsDone);
+}
+
+CompiledDFA DFABenchmark::generateDFA(int states, int symbolCount, double density) {
+    CompiledDFA dfa;
+    if (states <= 0 || symbolCount <= 0 || symbolCount > 94) {
+        return dfa;
+    }
+
+    // Logical layout: edges mostly jump a short distance forward, the rest
+    // fall back into a small hot core near the start
+    int hotStates = qMax(1, states / 100);
+    QVector<int> logical(states * symbolCount);
+    for (int s = 0; s < states; ++s) {
+        for (int c = 0; c < symbolCount; ++c) {
+            int target;
+            if (random.next() % 1000 >= density * 1000) {
+                target = -1;
+            } else if (random.next() % 10 < 8) {
+                target = (s + 1 + random.next() % 8) % states;
+            } else {
+                target = random.next() % hotStates;
+            }
+            logical[s * symbolCount + c] = target;
+        }
+    }
+
+    // Scatter the numbering the way creation order would
+    QVector<int> permutation(states);
+    for (int s = 0; s < states; ++s) {
+        permutation[s] = s;
+    }
+    for (int s = states - 1; s > 0; --s) {
+        std::swap(permutation[s], permutation[random.next() % (s + 1)]);
+    }
+
+    QVector<int> table(states * symbolCount);
+    QVector<bool> finals(states, false);
+    for (int s = 0; s < states; ++s) {
+        for (int c = 0; c < symbolCount; ++c) {
+            int target = logical[s * symbolCount + c];
+            table[permutation[s] * symbolCount + c] = target < 0 ? -1 : permutation[target];
+        }
+        finals[permutation[s]] = random.next() % 4 == 0;
+    }
+
+    QVector<QString> symbols;
+    for (int c = 0; c < symbolCount; ++c) {
+        symbols.append(QString(QChar('!' + c)));
+    }
+
+    dfa.buildFromTable(states, symbols, table, finals, permutation[0]);
+    return dfa;
+}
+
+QVector<QString> DFABenchmark::generateInputs(const CompiledDFA& dfa, int count, int length) {
+    QVector<QString> inputs;
+    if (dfa.isEmpty() || dfa.getSymbolCount() == 0) {
+        return inputs;
+    }
+
+    // Random walks that only take defined transitions, so sparse DFAs
+    // still produce full-length inputs where possible
+    int symbolCount = dfa.getSymbolCount();
+    inputs.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QString input;
+        input.reserve(length);
+        int state = dfa.getInitialState();
+        for (int j = 0; j < length; ++j) {
+            int start = random.next() % symbolCount;
+            int symbol = -1;
+            for (int k = 0; k < symbolCount; ++k) {
+                int candidate = (start + k) % symbolCount;
+                if (dfa.next(state, candidate) >= 0) {
+                    symbol = candidate;
+                    break;
+                }
+            }
+            if (symbol < 0) {
+                break;
+            }
+            input += dfa.getSymbol(symbol);
+            state = dfa.next(state, symbol);
+        }
+        inputs.append(input);
+    }
+    return inputs;
+}
+
+LayoutBenchmarkResult DFABenchmark::measure(const QString& label, const CompiledDFA& dfa,
+                                            const QVector<QString>& inputs) {
+    LayoutBenchmarkResult result;
+    result.layout = label;
+    result.symbols = 0;
+    result.simulatedMisses = 0;
+    result.tableBytes = dfa.tableMemoryBytes();
+    result.compressed = dfa.isCompressed();
+
+    // Simulated cache pass over dense row addresses, kept out of the timed loop
+    const int cacheLines = 512;
+    const int lineBytes = 64;
+    QVector<qint64> tags(cacheLines, -1);
+    for (const auto& input : inputs) {
+        int state = dfa.getInitialState();
+        for (const QChar& ch : input) {
+            int symbol = dfa.classOf(ch);
+            qint64 line = (qint64(state) * dfa.getSymbolCount() + symbol) * qint64(sizeof(int)) / lineBytes;
+            qint64& tag = tags[line % cacheLines];
+            if (tag != line) {
+                tag = line;
+                result.simulatedMisses++;
+            }
+            state = dfa.next(state, symbol);
+            if (state < 0) break;
+        }
+        result.symbols += input.size();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int accepted = 0;
+    for (const auto& input : inputs) {
+        accepted += dfa.accepts(input) ? 1 : 0;
+    }
+    result.nanoseconds = timer.nsecsElapsed();
+
+    // Keep the timed loop observable
+    if (accepted < 0) {
+        result.layout += "*";
+    }
+    return result;
+}
+
+QVector<LayoutBenchmarkResult> DFABenchmark::runLayoutBenchmark(int states, int symbolCount,
+                                                                int inputCount, int inputLength) {
+    QVector<LayoutBenchmarkResult> results;
+
+    CompiledDFA scattered = generateDFA(states, symbolCount);
+    if (scattered.isEmpty()) {
+        return results;
+    }
+
+    QVector<QString> training = generateInputs(scattered, qMax(1, inputCount / 4), inputLength);
+    QVector<QString> inputs = generateInputs(scattered, inputCount, inputLength);
+    if (!stepDone()) return results;
+
+    results.append(measure("Creation", scattered, inputs));
+    if (!stepDone()) return results;
+
+    CompiledDFA bfs = scattered;
+    bfs.renumber(StateLayout::breadthFirstOrder(bfs));
+    results.append(measure("Breadth-first", bfs, inputs));
+    if (!stepDone()) return results;
+
+    CompiledDFA dfs = scattered;
+    dfs.renumber(StateLayout::depthFirstOrder(dfs));
+    results.append(measure("Depth-first", dfs, inputs));
+    if (!stepDone()) return results;
+
+    CompiledDFA profiled = scattered;
+    profiled.renumber(StateLayout::profileOrder(profiled,
+                                                StateLayout::collectProfile(profiled, training)));
+    results.append(measure("Profile-guided", profiled, inputs));
+    stepDone();
+
+    return results;
+}
+
+QVector<LayoutBenchmarkResult> DFABenchmark::runEncodingBenchmark(int states, int symbolCount, double density,
+                                                                  int inputCount, int inputLength) {
+    QVector<LayoutBenchmarkResult> results;
+
+    CompiledDFA dense = generateDFA(states, symbolCount, density);
+    if (dense.isEmpty()) {
+        return results;
+    }
+    dense.setEncoding(TableEncoding::Dense);
+    dense.renumber(StateLayout::breadthFirstOrder(dense));
+
+    QVector<QString> inputs = generateInputs(dense, inputCount, inputLength);
+    if (!stepDone()) return results;
+    results.append(measure("Dense", dense, inputs));
+    if (!stepDone()) return results;
+
+    CompiledDFA packed = dense;
+    packed.setEncoding(TableEncoding::Compressed);
+    results.append(measure("Compressed", packed, inputs));
+    stepDone();
+
+    return results;
+}
+
+QString DFABenchmark::formatResults(const QVector<LayoutBenchmarkResult>& results) {
+    if (results.isEmpty()) {
+        return "No benchmark results.";
+    }
+
+    QStringList lines;
+    quint64 baseline = qMax<quint64>(results.first().simulatedMisses, 1);
+    for (const auto& r : results) {
+        if (r.compressed) {
+            lines << QString("%1: %2 ns/symbol, table %3 KiB")
+                         .arg(r.layout, -15)
+                         .arg(r.nsPerSymbol(), 0, 'f', 2)
+                         .arg(r.tableBytes / 1024);
+            continue;
+        }
+        lines << QString("%1: %2 ns/symbol, %3 simulated misses (%4% of %5), table %6 KiB")
+                     .arg(r.layout, -15)
+                     .arg(r.nsPerSymbol(), 0, 'f', 2)
+                     .arg(r.simulatedMisses)
+                     .arg(100.0 * r.simulatedMisses / baseline, 0, 'f', 1)
+                     .arg(results.first().layout)
+                     .arg(r.tableBytes / 1024);
+    }
+    return lines.join("\n");
+}
@@ -0,0 +1,57 @@
+#ifndef DFABENCHMARK_H
+#define DFABENCHMARK_H
+
+#include "CompiledDFA.h"
+#include "./src/utils/Xorshift32.h"
+#include <QVector>
+#include <QString>
+#include <functional>
+
+struct LayoutBenchmarkResult {
+    QString layout;
+    qint64 nanoseconds;
+    quint64 symbols;
+    quint64 simulatedMisses;   // dense row addresses in a 32 KiB direct-mapped cache
+    qint64 tableBytes;
+    bool compressed;
+
+    double nsPerSymbol() const { return symbols ? double(nanoseconds) / symbols : 0.0; }
+};
+
+// Synthetic benchmark comparing state layouts on large DFAs.
+// States are generated with mostly local edges plus a hot core, then
+// shuffled to mimic the scattered creation order of converted DFAs.
+class DFABenchmark {
+private:
+    Xorshift32 random;
+    int stepsDone;
+    std::function<bool(int)> progressCallback;
+
+public:
+    // Steps reported by each run: the generated DFA, then one per layout
+    static const int LayoutSteps = 5;
+    static const int EncodingSteps = 3;
+
+    explicit DFABenchmark(quint32 seed = 12345);
+
+    // Called with the steps done so far by this benchmark, on the measuring
+    // thread; returning false cancels and the run returns what it has
+    void setProgressCallback(std::function<bool(int)> callback) { progressCallback = std::move(callback); }
+
+    // density: probability that a transition is defined (rest are dead)
+    CompiledDFA generateDFA(int states, int symbolCount, double density = 1.0);
+    QVector<QString> generateInputs(const CompiledDFA& dfa, int count, int length);
+    QVector<LayoutBenchmarkResult> runLayoutBenchmark(int states, int symbolCount,
+                                                      int inputCount, int inputLength);
+    QVector<LayoutBenchmarkResult> runEncodingBenchmark(int states, int symbolCount, double density,
+                                                        int inputCount, int inputLength);
+
+    static QString formatResults(const QVector<LayoutBenchmarkResult>& results);
+
+private:
+    LayoutBenchmarkResult measure(const QString& label, const CompiledDFA& dfa,
+                                  const QVector<QString>& inputs);
+    bool stepDone();
+};
+
+#endif // DFABENCHMARK_H
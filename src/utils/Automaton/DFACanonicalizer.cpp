@@ -0,0 +1,196 @@
+#include "DFACanonicalizer.h"
+#include <QQueue>
+#include <QMap>
+#include <QStringList>
+#include <QCryptographicHash>
+
+DFACanonicalizer::DFACanonicalizer() {}
+
+QVector<bool> DFACanonicalizer::usefulStates(const CompiledDFA& dfa) const {
+    int n = dfa.getStateCount();
+    int k = dfa.getSymbolCount();
+
+    QVector<bool> reachable(n, false);
+    QVector<QVector<int>> reverse(n);
+    QQueue<int> queue;
+    reachable[dfa.getInitialState()] = true;
+    queue.enqueue(dfa.getInitialState());
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        for (int c = 0; c < k; ++c) {
+            int t = dfa.next(s, c);
+            if (t < 0) continue;
+            reverse[t].append(s);
+            if (!reachable[t]) {
+                reachable[t] = true;
+                queue.enqueue(t);
+            }
+        }
+    }
+
+    QVector<bool> useful(n, false);
+    for (int s = 0; s < n; ++s) {
+        if (reachable[s] && dfa.isFinal(s)) {
+            useful[s] = true;
+            queue.enqueue(s);
+        }
+    }
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        for (int p : reverse[s]) {
+            if (!useful[p]) {
+                useful[p] = true;
+                queue.enqueue(p);
+            }
+        }
+    }
+    return useful;
+}
+
+QVector<int> DFACanonicalizer::refinePartition(const CompiledDFA& dfa, const QVector<bool>& useful,
+                                               int* classCount) const {
+    int n = dfa.getStateCount();
+    int k = dfa.getSymbolCount();
+
+    // Start from final / non-final; trimmed states stay at -1 (the dead class)
+    QVector<int> block(n, -1);
+    int count = 0;
+    bool hasFinal = false, hasNonFinal = false;
+    for (int s = 0; s < n; ++s) {
+        if (!useful[s]) continue;
+        block[s] = dfa.isFinal(s) ? 1 : 0;
+        hasFinal = hasFinal || dfa.isFinal(s);
+        hasNonFinal = hasNonFinal || !dfa.isFinal(s);
+    }
+    count = (hasFinal ? 1 : 0) + (hasNonFinal ? 1 : 0);
+
+    // Split blocks by their successor signature until the count is stable
+    while (true) {
+        QMap<QVector<int>, int> signatures;
+        QVector<int> refined(n, -1);
+        QVector<int> signature(k + 1);
+        for (int s = 0; s < n; ++s) {
+            if (!useful[s]) continue;
+            signature[0] = block[s];
+            for (int c = 0; c < k; ++c) {
+                int t = dfa.next(s, c);
+                signature[c + 1] = (t >= 0 && useful[t]) ? block[t] : -1;
+            }
+            auto it = signatures.find(signature);
+            if (it == signatures.end()) {
+                it = signatures.insert(signature, signatures.size());
+            }
+            refined[s] = it.value();
+        }
+
+        block = refined;
+        if (signatures.size() == count) {
+            break;
+        }
+        count = signatures.size();
+    }
+
+    *classCount = count;
+    return block;
+}
+
+CompiledDFA DFACanonicalizer::canonicalize(const CompiledDFA& dfa) {
+    CompiledDFA canonical;
+    if (dfa.isEmpty()) {
+        return canonical;
+    }
+
+    QVector<bool> useful = usefulStates(dfa);
+    if (!useful[dfa.getInitialState()]) {
+        // Empty language: a single rejecting state over no symbols
+        canonical.buildFromTable(1, QVector<QString>(), QVector<int>(), QVector<bool>(1, false), 0);
+        return canonical;
+    }
+
+    int classCount = 0;
+    QVector<int> block = refinePartition(dfa, useful, &classCount);
+
+    // Representative state per block
+    QVector<int> representative(classCount, -1);
+    for (int s = 0; s < dfa.getStateCount(); ++s) {
+        if (block[s] >= 0 && representative[block[s]] < 0) {
+            representative[block[s]] = s;
+        }
+    }
+
+    // BFS numbering from the initial block, symbols in class order
+    int k = dfa.getSymbolCount();
+    QVector<int> number(classCount, -1);
+    QVector<int> order;
+    QVector<bool> symbolUsed(k, false);
+    QQueue<int> queue;
+    number[block[dfa.getInitialState()]] = 0;
+    order.append(block[dfa.getInitialState()]);
+    queue.enqueue(block[dfa.getInitialState()]);
+    while (!queue.isEmpty()) {
+        int b = queue.dequeue();
+        for (int c = 0; c < k; ++c) {
+            int t = dfa.next(representative[b], c);
+            if (t < 0 || block[t] < 0) continue;
+            symbolUsed[c] = true;
+            if (number[block[t]] < 0) {
+                number[block[t]] = order.size();
+                order.append(block[t]);
+                queue.enqueue(block[t]);
+            }
+        }
+    }
+
+    // Drop symbols no useful transition reads; they cannot change the language
+    QVector<int> columns;
+    QVector<QString> symbols;
+    for (int c = 0; c < k; ++c) {
+        if (symbolUsed[c]) {
+            columns.append(c);
+            symbols.append(dfa.getSymbol(c));
+        }
+    }
+
+    int states = order.size();
+    QVector<int> table(states * columns.size(), -1);
+    QVector<bool> finals(states, false);
+    for (int i = 0; i < states; ++i) {
+        int rep = representative[order[i]];
+        finals[i] = dfa.isFinal(rep);
+        for (int j = 0; j < columns.size(); ++j) {
+            int t = dfa.next(rep, columns[j]);
+            if (t >= 0 && block[t] >= 0) {
+                table[i * columns.size() + j] = number[block[t]];
+            }
+        }
+    }
+
+    canonical.setEncoding(dfa.getEncoding());
+    canonical.buildFromTable(states, symbols, table, finals, 0);
+    return canonical;
+}
+
+QString DFACanonicalizer::serialize(const CompiledDFA& canonical) const {
+    QStringList parts;
+    QStringList symbols;
+    for (int c = 0; c < canonical.getSymbolCount(); ++c) {
+        symbols << QString::number(canonical.getSymbol(c).size()) + ":" + canonical.getSymbol(c);
+    }
+    parts << symbols.join("");
+    parts << QString::number(canonical.getStateCount());
+
+    for (int s = 0; s < canonical.getStateCount(); ++s) {
+        QString row = canonical.isFinal(s) ? "F" : "N";
+        for (int c = 0; c < canonical.getSymbolCount(); ++c) {
+            row += "," + QString::number(canonical.next(s, c));
+        }
+        parts << row;
+    }
+    return parts.join(";");
+}
+
+QString DFACanonicalizer::hash(const CompiledDFA& dfa) {
+    QByteArray digest = QCryptographicHash::hash(serialize(canonicalize(dfa)).toUtf8(),
+                                                 QCryptographicHash::Sha1);
+    return QString::fromLatin1(digest.toHex());
+}
@@ -0,0 +1,25 @@
+#ifndef DFACANONICALIZER_H
+#define DFACANONICALIZER_H
+
+#include "CompiledDFA.h"
+#include <QString>
+#include <QVector>
+
+// Canonical form of a DFA language: trimmed, minimized (Moore partition
+// refinement) and numbered in BFS order with symbols in class order.
+// Two DFAs accept the same language iff their canonical forms match.
+class DFACanonicalizer {
+public:
+    DFACanonicalizer();
+
+    CompiledDFA canonicalize(const CompiledDFA& dfa);
+    QString serialize(const CompiledDFA& canonical) const;
+    // Hex SHA-1 of the canonical serialization
+    QString hash(const CompiledDFA& dfa);
+
+private:
+    QVector<bool> usefulStates(const CompiledDFA& dfa) const;
+    QVector<int> refinePartition(const CompiledDFA& dfa, const QVector<bool>& useful, int* classCount) const;
+};
+
+#endif // DFACANONICALIZER_H
@@ -51,15 +51,15 @@ void DFAMinimizer::removeUnreachableStates(Automaton* dfa) {
     QSet<QString> reachable = getReachableStates(dfa);
 
     // Remove unreachable states
-    QVector<State> statesToRemove;
+    QVector<QString> statesToRemove;
     for (const auto& state : dfa->getStates()) {
         if (!reachable.contains(state.getId())) {
-            statesToRemove.push_back(state);
+            statesToRemove.push_back(state.getId());
         }
     }
 
-    for (const auto& state : statesToRemove) {
-        dfa->removeState(state.getId());
+    for (const auto& stateId : statesToRemove) {
+        dfa->removeState(stateId);
     }
 }
 
@@ -249,7 +249,7 @@ Automaton* DFAMinimizer::buildMinimizedDFA(
             }
         }
 
-        State newState(newStateId, newStateId, QPointF(0, 0));
+        State newState(newStateId);
         newState.setIsInitial(isInitial);
         newState.setIsFinal(isFinal);
         minimized->addState(newState);
@@ -0,0 +1,351 @@
+#include "ExecutionTrace.h"
+#include <QtAlgorithms>
+#include <algorithm>
+
+namespace {
+
+struct Edge {
+    int from;
+    int symbolClass;
+    int to;
+};
+
+}
+
+ExecutionTrace::ExecutionTrace(const Automaton* automaton, int checkpointInterval)
+    : interval(qMax(1, checkpointInterval)),
+    deterministic(automaton->getType() == AutomatonType::DFA),
+    stateCount(automaton->getStates().size()), words((stateCount + 63) / 64), classCount(0),
+    initialState(automaton->indexOfState(automaton->getInitialStateId())),
+    valid(automaton->isValid()), latin1Class(256, -1), accepted(false), deadStep(-1) {
+    compile(automaton);
+}
+
+// ============================================================
+// Tables
+// ============================================================
+
+int ExecutionTrace::classOf(QChar ch) const {
+    ushort code = ch.unicode();
+    return code < 256 ? latin1Class[code] : otherClass.value(code, -1);
+}
+
+// Every single-character symbol gets a class. "E" and "ε" also stand for
+// epsilon transitions, because Transition::hasSymbol treats them that way.
+void ExecutionTrace::compile(const Automaton* automaton) {
+    const QVector<State>& states = automaton->getStates();
+    const QVector<Transition>& transitions = automaton->getTransitions();
+
+    QVector<QChar> classChars;
+    auto addClass = [&](QChar ch) {
+        if (classOf(ch) >= 0) return;
+        ushort code = ch.unicode();
+        if (code < 256) latin1Class[code] = classChars.size();
+        else otherClass.insert(code, classChars.size());
+        classChars.append(ch);
+    };
+
+    const QChar epsilonChars[] = { QChar('E'), QChar(0x03B5) };
+    for (const Transition& t : transitions) {
+        if (t.isEpsilonTransition()) {
+            for (QChar ch : epsilonChars) addClass(ch);
+        }
+        for (const QString& symbol : t.getSymbols()) {
+            if (symbol.size() == 1) addClass(symbol[0]);
+        }
+    }
+    classCount = classChars.size();
+
+    // Consuming edges in transition order, then grouped by state and class;
+    // the stable sort keeps transition order inside a group
+    QVector<Edge> edges;
+    QVector<QVector<int>> epsilon(stateCount);
+    for (const Transition& t : transitions) {
+        int from = automaton->indexOfState(t.getFromStateId());
+        int to = automaton->indexOfState(t.getToStateId());
+        if (from < 0 || to < 0) continue;
+
+        if (t.isEpsilonTransition()) {
+            epsilon[from].append(to);
+            for (QChar ch : epsilonChars) edges.append({from, classOf(ch), to});
+        }
+        for (const QString& symbol : t.getSymbols()) {
+            if (symbol.size() == 1 && !Transition::isEpsilonSymbol(symbol)) {
+                edges.append({from, classOf(symbol[0]), to});
+            }
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return a.from != b.from ? a.from < b.from : a.symbolClass < b.symbolClass;
+    });
+
+    finals.resize(stateCount);
+    stateIds.resize(stateCount);
+    for (int s = 0; s < stateCount; ++s) {
+        finals[s] = states[s].getIsFinal();
+        stateIds[s] = states[s].getId();
+    }
+
+    if (deterministic) {
+        // acceptsDFA takes the first matching transition and ignores epsilon
+        dfaNext.fill(-1, stateCount * classCount);
+        for (const Edge& edge : edges) {
+            int& next = dfaNext[qint64(edge.from) * classCount + edge.symbolClass];
+            if (next < 0) next = edge.to;
+        }
+        initialSet = StateSet(words, 0);
+        if (initialState >= 0) initialSet[initialState / 64] |= quint64(1) << (initialState % 64);
+        return;
+    }
+
+    // Epsilon closure of every state, depth-first; seen[t] == s marks t as reached from s
+    QVector<int> closureBegin;
+    QVector<int> closureStates;
+    QVector<int> seen(stateCount, -1);
+    QVector<int> stack;
+    closureBegin.reserve(stateCount + 1);
+    for (int s = 0; s < stateCount; ++s) {
+        closureBegin.append(closureStates.size());
+        seen[s] = s;
+        stack.append(s);
+        while (!stack.isEmpty()) {
+            int u = stack.takeLast();
+            closureStates.append(u);
+            for (int t : epsilon[u]) {
+                if (seen[t] != s) {
+                    seen[t] = s;
+                    stack.append(t);
+                }
+            }
+        }
+    }
+    closureBegin.append(closureStates.size());
+
+    // The move of a state on a class is the closures of its targets, without
+    // repeats. Edges are sorted by move, so the moves are filled in order.
+    seen.fill(-1);
+    qint64 moveCount = qint64(stateCount) * classCount;
+    moveStateBegin.fill(0, moveCount + 1);
+    int group = -1;
+    for (int i = 0; i < edges.size(); ++i) {
+        const Edge& edge = edges[i];
+        if (i == 0 || edge.from != edges[i - 1].from || edge.symbolClass != edges[i - 1].symbolClass) {
+            ++group;
+        }
+        qint64 move = qint64(edge.from) * classCount + edge.symbolClass;
+        for (int k = closureBegin[edge.to]; k < closureBegin[edge.to + 1]; ++k) {
+            int s = closureStates[k];
+            if (seen[s] != group) {
+                seen[s] = group;
+                moveStates.append(s);
+                moveStateBegin[move + 1]++;
+            }
+        }
+    }
+    for (qint64 m = 0; m < moveCount; ++m) {
+        moveStateBegin[m + 1] += moveStateBegin[m];
+    }
+
+    initialSet = StateSet(words, 0);
+    if (initialState >= 0) {
+        for (int k = closureBegin[initialState]; k < closureBegin[initialState + 1]; ++k) {
+            int s = closureStates[k];
+            initialSet[s / 64] |= quint64(1) << (s % 64);
+        }
+    }
+}
+
+// ============================================================
+// Simulation
+// ============================================================
+
+void ExecutionTrace::stepDFA(int& state, int from, int to) const {
+    const QChar* text = input.constData();
+    for (int i = from; i < to && state >= 0; ++i) {
+        int c = classOf(text[i]);
+        state = c < 0 ? -1 : dfaNext[qint64(state) * classCount + c];
+    }
+}
+
+void ExecutionTrace::stepNFA(StateSet& set, int from, int to) const {
+    const QChar* text = input.constData();
+    const int* stateBegin = moveStateBegin.constData();
+    const int* states = moveStates.constData();
+    StateSet next(words, 0);
+    for (int i = from; i < to; ++i) {
+        int c = classOf(text[i]);
+        next.fill(0);
+        quint64* out = next.data();
+        bool any = false;
+        if (c >= 0) {
+            for (int w = 0; w < words; ++w) {
+                for (quint64 bits = set[w]; bits; bits &= bits - 1) {
+                    int s = w * 64 + qCountTrailingZeroBits(bits);
+                    const int* move = stateBegin + qint64(s) * classCount + c;
+                    for (int k = move[0]; k < move[1]; ++k) {
+                        out[states[k] / 64] |= quint64(1) << (states[k] % 64);
+                    }
+                }
+            }
+            for (int w = 0; w < words && !any; ++w) any = out[w] != 0;
+        }
+        set.swap(next);
+        if (!any) return;
+    }
+}
+
+void ExecutionTrace::run(const QString& text) {
+    input = text;
+    checkpointData.clear();
+    checkpointOffsets.clear();
+    deadStep = -1;
+    accepted = false;
+
+    int dfaState = initialState;
+    StateSet set = initialSet;
+    int step = 0;
+
+    while (true) {
+        saveCheckpoint(dfaState, set);
+        if (isDead(dfaState, set) || step >= input.size()) {
+            break;
+        }
+        int end = qMin(step + interval, input.size());
+        if (deterministic) stepDFA(dfaState, step, end);
+        else stepNFA(set, step, end);
+        step = end;
+    }
+
+    if (isDead(dfaState, set)) {
+        // The run died inside the last interval; replay it one symbol at a time
+        int from = qMax(0, (checkpointOffsets.size() - 2) * interval);
+        int index = from / interval;
+        loadCheckpoint(index, dfaState, set);
+        deadStep = from;
+        while (!isDead(dfaState, set)) {
+            if (deterministic) stepDFA(dfaState, deadStep, deadStep + 1);
+            else stepNFA(set, deadStep, deadStep + 1);
+            ++deadStep;
+        }
+        return;
+    }
+
+    if (!valid) {
+        return;
+    }
+    if (deterministic) {
+        accepted = finals[dfaState];
+        return;
+    }
+    for (int w = 0; w < words && !accepted; ++w) {
+        for (quint64 bits = set[w]; bits; bits &= bits - 1) {
+            if (finals[w * 64 + qCountTrailingZeroBits(bits)]) {
+                accepted = true;
+                break;
+            }
+        }
+    }
+}
+
+bool ExecutionTrace::isDead(int dfaState, const StateSet& set) const {
+    if (deterministic) {
+        return dfaState < 0;
+    }
+    for (quint64 w : set) {
+        if (w) return false;
+    }
+    return true;
+}
+
+// ============================================================
+// Checkpoints
+// ============================================================
+
+// Layout: DFA -> [state + 1]; NFA -> [count, sorted indices...] or
+// [0x80000000 | words, low, high, ...] when the raw bitset is smaller
+void ExecutionTrace::saveCheckpoint(int dfaState, const StateSet& set) {
+    checkpointOffsets.append(checkpointData.size());
+    if (deterministic) {
+        checkpointData.append(quint32(dfaState + 1));
+        return;
+    }
+
+    int count = 0;
+    for (quint64 w : set) count += qPopulationCount(w);
+
+    if (count <= 2 * words) {
+        checkpointData.append(quint32(count));
+        for (int w = 0; w < words; ++w) {
+            for (quint64 bits = set[w]; bits; bits &= bits - 1) {
+                checkpointData.append(quint32(w * 64 + qCountTrailingZeroBits(bits)));
+            }
+        }
+    } else {
+        checkpointData.append(0x80000000u | quint32(words));
+        for (quint64 w : set) {
+            checkpointData.append(quint32(w));
+            checkpointData.append(quint32(w >> 32));
+        }
+    }
+}
+
+void ExecutionTrace::loadCheckpoint(int index, int& dfaState, StateSet& set) const {
+    const quint32* data = checkpointData.constData() + checkpointOffsets[index];
+    if (deterministic) {
+        dfaState = int(data[0]) - 1;
+        return;
+    }
+
+    set = StateSet(words, 0);
+    if (data[0] & 0x80000000u) {
+        for (int w = 0; w < words; ++w) {
+            set[w] = quint64(data[1 + 2 * w]) | (quint64(data[2 + 2 * w]) << 32);
+        }
+    } else {
+        for (quint32 i = 0; i < data[0]; ++i) {
+            int s = int(data[1 + i]);
+            set[s / 64] |= quint64(1) << (s % 64);
+        }
+    }
+}
+
+qint64 ExecutionTrace::getCheckpointBytes() const {
+    return qint64(checkpointData.size()) * sizeof(quint32) + qint64(checkpointOffsets.size()) * sizeof(int);
+}
+
+QVector<int> ExecutionTrace::activeStateIndicesAt(int step) const {
+    QVector<int> result;
+    if (step < 0 || step > input.size() || checkpointOffsets.isEmpty()) {
+        return result;
+    }
+    if (deadStep >= 0 && step >= deadStep) {
+        return result;
+    }
+
+    int index = qMin(step / interval, checkpointOffsets.size() - 1);
+    int dfaState = -1;
+    StateSet set;
+    loadCheckpoint(index, dfaState, set);
+
+    if (deterministic) {
+        stepDFA(dfaState, index * interval, step);
+        if (dfaState >= 0) result.append(dfaState);
+        return result;
+    }
+
+    stepNFA(set, index * interval, step);
+    for (int w = 0; w < words; ++w) {
+        for (quint64 bits = set[w]; bits; bits &= bits - 1) {
+            result.append(w * 64 + qCountTrailingZeroBits(bits));
+        }
+    }
+    return result;
+}
+
+QSet<QString> ExecutionTrace::activeStatesAt(int step) const {
+    QSet<QString> ids;
+    for (int s : activeStateIndicesAt(step)) {
+        ids.insert(stateIds[s]);
+    }
+    return ids;
+}
@@ -0,0 +1,72 @@
+#ifndef EXECUTIONTRACE_H
+#define EXECUTIONTRACE_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+// A run of an automaton over a (possibly very long) input that can report
+// the active states after any number of steps. Only every K-th configuration
+// is stored: the DFA state, or the NFA state set as a bitset or sorted index
+// list, whichever is smaller. Step k is rebuilt by re-simulating at most K-1
+// symbols from the checkpoint before it, so the trace takes O(n/K) memory and
+// a lookup is O(K). An NFA move lists the epsilon closure of its targets, so
+// the compiled automaton takes an offset per state and class plus the closures,
+// not a bitset of all states per state and class. Acceptance matches Automaton::accepts(). The
+// automaton is compiled in the constructor and not referenced afterwards.
+class ExecutionTrace {
+public:
+    explicit ExecutionTrace(const Automaton* automaton, int checkpointInterval = 4096);
+
+    void run(const QString& input);
+
+    int getStepCount() const { return input.size(); }       // step k = after k symbols
+    QChar symbolAt(int step) const { return input.at(step); } // symbol consumed by step k + 1
+    bool isAccepted() const { return accepted; }
+    int getDeadStep() const { return deadStep; }            // first step with no active state, -1 if none
+    int getCheckpointInterval() const { return interval; }
+    int getCheckpointCount() const { return checkpointOffsets.size(); }
+    qint64 getCheckpointBytes() const;
+
+    QVector<int> activeStateIndicesAt(int step) const;       // indices into Automaton::getStates()
+    QSet<QString> activeStatesAt(int step) const;
+
+private:
+    typedef QVector<quint64> StateSet;
+
+    int interval;
+    bool deterministic;                 // simulated like Automaton::acceptsDFA
+    int stateCount;
+    int words;                          // 64-bit words per state set
+    int classCount;
+    int initialState;                   // -1 if missing
+    bool valid;                         // Automaton::isValid() at compile time
+    QVector<QString> stateIds;
+
+    QVector<int> latin1Class;           // character -> symbol class, -1 = no transition
+    QHash<ushort, int> otherClass;
+    QVector<int> dfaNext;               // state * classCount + class -> state, -1 = dead
+    QVector<int> moveStateBegin;        // state * classCount + class -> its first state in moveStates
+    QVector<int> moveStates;            // closure of the move's targets
+    StateSet initialSet;
+    QVector<bool> finals;
+
+    QString input;
+    bool accepted;
+    int deadStep;
+    QVector<quint32> checkpointData;    // encoded configurations
+    QVector<int> checkpointOffsets;     // checkpoint i starts at checkpointData[checkpointOffsets[i]]
+
+    void compile(const Automaton* automaton);
+    int classOf(QChar ch) const;
+    void stepDFA(int& state, int from, int to) const;
+    void stepNFA(StateSet& set, int from, int to) const;
+    bool isDead(int dfaState, const StateSet& set) const;
+
+    void saveCheckpoint(int dfaState, const StateSet& set);
+    void loadCheckpoint(int index, int& dfaState, StateSet& set) const;
+};
+
+#endif // EXECUTIONTRACE_H
@@ -0,0 +1,900 @@
+#include "ExternalSubsetConstruction.h"
+#include <QDir>
+#include <QTemporaryDir>
+#include <QStringList>
+#include <QHash>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <queue>
+
+namespace {
+
+const int IoBufferSize = 1 << 20;
+const int MergeFanIn = 64;
+const qint64 MaxRunBytes = 1ll << 30;    // offsets into a run buffer stay within int
+const quint32 TableMagic = 0x41464458;   // "XDFA" as little endian bytes
+const quint32 TableVersion = 1;
+const int TableHeaderSize = 28;
+const int ProgressInterval = 4096;       // records between progress callbacks
+
+void appendVarint(QByteArray& out, quint64 value) {
+    while (value >= 0x80) {
+        out.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+bool readVarint(const QByteArray& data, int& offset, quint64& value) {
+    value = 0;
+    for (int shift = 0; offset < data.size() && shift < 64; shift += 7) {
+        quint8 byte = quint8(data[offset++]);
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void appendLittleEndian(QByteArray& out, quint64 value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.append(char((value >> (8 * i)) & 0xFF));
+    }
+}
+
+quint64 readLittleEndian(const char* data, int bytes) {
+    quint64 value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= quint64(quint8(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+// Big endian so that byte order equals numeric order in sort keys
+void writeBigEndian(char* out, quint64 value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        out[i] = char(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+quint64 readBigEndian(const char* data, int bytes) {
+    quint64 value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | quint8(data[i]);
+    }
+    return value;
+}
+
+int compareKeys(const char* a, int aSize, const char* b, int bSize) {
+    int common = qMin(aSize, bSize);
+    int result = common > 0 ? std::memcmp(a, b, common) : 0;
+    return result != 0 ? result : aSize - bSize;
+}
+
+int compareKeys(const QByteArray& a, const QByteArray& b) {
+    return compareKeys(a.constData(), a.size(), b.constData(), b.size());
+}
+
+// Buffered sequential writer of (key, payload) records and raw bytes
+class RecordWriter {
+private:
+    QFile file;
+    QByteArray buffer;
+    qint64* bytesWritten;
+    bool failed;
+
+public:
+    explicit RecordWriter(qint64* counter) : bytesWritten(counter), failed(false) {}
+    ~RecordWriter() { close(); }
+
+    bool open(const QString& path) {
+        file.setFileName(path);
+        buffer.reserve(IoBufferSize + 64);
+        buffer.resize(0);
+        failed = !file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        return !failed;
+    }
+
+    void writeRecord(const char* key, int keySize, const char* payload, int payloadSize) {
+        appendVarint(buffer, keySize);
+        buffer.append(key, keySize);
+        appendVarint(buffer, payloadSize);
+        buffer.append(payload, payloadSize);
+        if (buffer.size() >= IoBufferSize) flush();
+    }
+
+    void writeRecord(const QByteArray& key, const QByteArray& payload) {
+        writeRecord(key.constData(), key.size(), payload.constData(), payload.size());
+    }
+
+    void writeRaw(const QByteArray& data) {
+        buffer.append(data);
+        if (buffer.size() >= IoBufferSize) flush();
+    }
+
+    bool close() {
+        if (file.isOpen()) {
+            flush();
+            file.close();
+        }
+        return !failed;
+    }
+
+private:
+    void flush() {
+        if (buffer.isEmpty()) return;
+        if (file.write(buffer) != buffer.size()) {
+            failed = true;
+        }
+        *bytesWritten += buffer.size();
+        buffer.resize(0);
+    }
+};
+
+// Buffered sequential reader matching RecordWriter
+class RecordReader {
+private:
+    QFile file;
+    QByteArray buffer;
+    int offset;
+    bool failed;
+
+public:
+    RecordReader() : offset(0), failed(false) {}
+
+    bool open(const QString& path) {
+        file.setFileName(path);
+        buffer.clear();
+        offset = 0;
+        failed = !file.open(QIODevice::ReadOnly);
+        return !failed;
+    }
+
+    void close() { file.close(); }
+    bool hasFailed() const { return failed; }
+
+    // False at the end of the file; a truncated record also sets hasFailed()
+    bool readRecord(QByteArray& key, QByteArray& payload) {
+        quint64 keySize = 0;
+        quint64 payloadSize = 0;
+        if (!readVarint(keySize)) {
+            return false;
+        }
+        if (!readBytes(key, int(keySize)) || !readVarint(payloadSize) ||
+            !readBytes(payload, int(payloadSize))) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool readBytes(QByteArray& out, int size) {
+        out.resize(size);
+        int copied = 0;
+        while (copied < size) {
+            if (offset == buffer.size() && !refill()) {
+                return false;
+            }
+            int chunk = qMin(size - copied, buffer.size() - offset);
+            std::memcpy(out.data() + copied, buffer.constData() + offset, chunk);
+            copied += chunk;
+            offset += chunk;
+        }
+        return true;
+    }
+
+private:
+    bool readVarint(quint64& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (offset == buffer.size() && !refill()) {
+                failed = failed || shift > 0;
+                return false;
+            }
+            quint8 byte = quint8(buffer[offset++]);
+            value |= quint64(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        failed = true;
+        return false;
+    }
+
+    bool refill() {
+        buffer = file.read(IoBufferSize);
+        offset = 0;
+        return !buffer.isEmpty();
+    }
+};
+
+// Sorts records by key within a memory budget: full buffers are sorted and
+// spilled as runs, which are then merged MergeFanIn at a time.
+class ExternalSorter {
+private:
+    struct Entry {
+        int offset;
+        int keySize;
+        int payloadSize;
+    };
+
+    struct HeadGreater {
+        const QVector<QByteArray>* keys;
+        bool operator()(int a, int b) const {
+            int order = compareKeys((*keys)[a], (*keys)[b]);
+            return order != 0 ? order > 0 : a > b;
+        }
+    };
+
+    QString directory;
+    QString prefix;
+    qint64 budget;
+    ExternalConstructionStats* stats;
+    QByteArray arena;
+    QVector<Entry> entries;
+    QStringList runs;
+    int runCounter;
+    bool failed;
+
+    // Streaming state after finish()
+    bool streamFromMemory;
+    int memoryPosition;
+    QVector<RecordReader*> readers;
+    QVector<QByteArray> headKeys;
+    QVector<QByteArray> headPayloads;
+    std::priority_queue<int, std::vector<int>, HeadGreater>* heap;
+
+public:
+    ExternalSorter(const QString& directory, const QString& prefix, qint64 budget,
+                   ExternalConstructionStats* stats)
+        : directory(directory), prefix(prefix), budget(qMin(budget, MaxRunBytes)), stats(stats),
+        runCounter(0), failed(false), streamFromMemory(false), memoryPosition(0), heap(nullptr) {}
+
+    ~ExternalSorter() {
+        closeMerge();
+        for (const QString& run : runs) {
+            QFile::remove(run);
+        }
+    }
+
+    bool hasFailed() const { return failed; }
+
+    bool add(const char* key, int keySize, const char* payload, int payloadSize) {
+        Entry entry;
+        entry.offset = arena.size();
+        entry.keySize = keySize;
+        entry.payloadSize = payloadSize;
+        arena.append(key, keySize);
+        arena.append(payload, payloadSize);
+        entries.append(entry);
+
+        qint64 used = arena.size() + qint64(entries.size()) * qint64(sizeof(Entry));
+        if (used >= budget) {
+            return spill();
+        }
+        return true;
+    }
+
+    bool finish() {
+        if (runs.isEmpty()) {
+            sortEntries();
+            streamFromMemory = true;
+            memoryPosition = 0;
+            return true;
+        }
+        if (!entries.isEmpty() && !spill()) {
+            return false;
+        }
+
+        // Reduce to one final merge that the caller consumes directly
+        while (runs.size() > MergeFanIn) {
+            QStringList group = runs.mid(0, MergeFanIn);
+            runs = runs.mid(MergeFanIn);
+
+            QString merged = nextRunPath();
+            RecordWriter writer(&stats->bytesWritten);
+            if (!writer.open(merged) || !openMerge(group)) {
+                failed = true;
+                return false;
+            }
+            QByteArray key, payload;
+            while (nextMerged(key, payload)) {
+                writer.writeRecord(key, payload);
+            }
+            closeMerge();
+            for (const QString& run : group) {
+                QFile::remove(run);
+            }
+            if (!writer.close() || failed) {
+                failed = true;
+                return false;
+            }
+            runs.append(merged);
+        }
+
+        streamFromMemory = false;
+        if (!openMerge(runs)) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool next(QByteArray& key, QByteArray& payload) {
+        if (!streamFromMemory) {
+            return nextMerged(key, payload);
+        }
+        if (memoryPosition >= entries.size()) {
+            return false;
+        }
+        const Entry& entry = entries[memoryPosition++];
+        key = QByteArray(arena.constData() + entry.offset, entry.keySize);
+        payload = QByteArray(arena.constData() + entry.offset + entry.keySize, entry.payloadSize);
+        return true;
+    }
+
+private:
+    QString nextRunPath() {
+        return QDir(directory).filePath(QString("%1-run%2").arg(prefix).arg(runCounter++));
+    }
+
+    void sortEntries() {
+        const char* base = arena.constData();
+        std::sort(entries.begin(), entries.end(), [base](const Entry& a, const Entry& b) {
+            return compareKeys(base + a.offset, a.keySize, base + b.offset, b.keySize) < 0;
+        });
+    }
+
+    bool spill() {
+        sortEntries();
+        QString path = nextRunPath();
+        RecordWriter writer(&stats->bytesWritten);
+        if (!writer.open(path)) {
+            failed = true;
+            return false;
+        }
+        const char* base = arena.constData();
+        for (const Entry& entry : entries) {
+            writer.writeRecord(base + entry.offset, entry.keySize,
+                               base + entry.offset + entry.keySize, entry.payloadSize);
+        }
+        runs.append(path);
+        stats->spilledRuns++;
+
+        arena.resize(0);
+        entries.resize(0);
+        if (!writer.close()) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool openMerge(const QStringList& group) {
+        closeMerge();
+        headKeys.resize(group.size());
+        headPayloads.resize(group.size());
+        heap = new std::priority_queue<int, std::vector<int>, HeadGreater>(HeadGreater{&headKeys});
+        for (int i = 0; i < group.size(); ++i) {
+            RecordReader* reader = new RecordReader();
+            readers.append(reader);
+            if (!reader->open(group[i])) {
+                return false;
+            }
+            if (reader->readRecord(headKeys[i], headPayloads[i])) {
+                heap->push(i);
+            }
+        }
+        return true;
+    }
+
+    bool nextMerged(QByteArray& key, QByteArray& payload) {
+        if (!heap || heap->empty()) {
+            return false;
+        }
+        int run = heap->top();
+        heap->pop();
+        key = headKeys[run];
+        payload = headPayloads[run];
+        if (readers[run]->readRecord(headKeys[run], headPayloads[run])) {
+            heap->push(run);
+        } else if (readers[run]->hasFailed()) {
+            failed = true;
+        }
+        return true;
+    }
+
+    void closeMerge() {
+        delete heap;
+        heap = nullptr;
+        qDeleteAll(readers);
+        readers.clear();
+    }
+};
+
+} // namespace
+
+ExternalSubsetConstruction::ExternalSubsetConstruction()
+    : memoryBudget(DefaultMemoryBudget), maxStates(0) {}
+
+bool ExternalSubsetConstruction::convert(const Automaton* nfa, const QString& outputPath,
+                                         QString* errorMsg) {
+    stats = ExternalConstructionStats();
+    if (!nfa || !nfa->isValid()) {
+        if (errorMsg) *errorMsg = "Automaton is not valid. Please ensure it has an initial state.";
+        return false;
+    }
+
+    prepare(nfa);
+
+    // Intermediate files live in a private directory removed on return
+    QString base = workDirectory.isEmpty() ? QDir::tempPath() : workDirectory;
+    QTemporaryDir temp(QDir(base).filePath("xdfa-"));
+    if (!temp.isValid()) {
+        if (errorMsg) *errorMsg = QString("Cannot create a work directory in %1.").arg(base);
+        return false;
+    }
+    return run(temp.path(), outputPath, errorMsg);
+}
+
+void ExternalSubsetConstruction::prepare(const Automaton* nfa) {
+    QStringList alphabet = nfa->getAlphabet().values();
+    alphabet.sort();
+    symbols.clear();
+    QHash<QString, int> symbolIndex;
+    for (const QString& symbol : alphabet) {
+        symbolIndex.insert(symbol, symbols.size());
+        symbols.append(symbol);
+    }
+
+    const QVector<State>& states = nfa->getStates();
+    int n = states.size();
+    int k = symbols.size();
+
+    QVector<QVector<int>> epsilonEdges(n);
+    QVector<QVector<int>> symbolEdges(n * k);
+    for (const Transition& trans : nfa->getTransitions()) {
+        int from = nfa->indexOfState(trans.getFromStateId());
+        int to = nfa->indexOfState(trans.getToStateId());
+        if (from < 0 || to < 0) continue;
+        if (trans.isEpsilonTransition()) {
+            epsilonEdges[from].append(to);
+        }
+        for (const QString& symbol : trans.getSymbols()) {
+            int c = symbolIndex.value(symbol, -1);
+            if (c >= 0) {
+                symbolEdges[from * k + c].append(to);
+            }
+        }
+    }
+
+    // Closures are distributive over union, so folding them into each
+    // successor list makes a subset step a plain union of lists
+    QVector<QVector<int>> closures(n);
+    QVector<int> mark(n, -1);
+    for (int s = 0; s < n; ++s) {
+        QVector<int> stack = {s};
+        mark[s] = s;
+        while (!stack.isEmpty()) {
+            int current = stack.takeLast();
+            closures[s].append(current);
+            for (int next : epsilonEdges[current]) {
+                if (mark[next] != s) {
+                    mark[next] = s;
+                    stack.append(next);
+                }
+            }
+        }
+        std::sort(closures[s].begin(), closures[s].end());
+    }
+
+    successors.clear();
+    successors.resize(n * k);
+    for (int i = 0; i < n * k; ++i) {
+        QVector<int>& list = successors[i];
+        for (int target : symbolEdges[i]) {
+            list += closures[target];
+        }
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+
+    nfaFinal.resize(n);
+    for (int s = 0; s < n; ++s) {
+        nfaFinal[s] = states[s].getIsFinal();
+    }
+    initialSet = closures[nfa->indexOfState(nfa->getInitialStateId())];
+}
+
+bool ExternalSubsetConstruction::isFinalSet(const QVector<int>& set) const {
+    for (int s : set) {
+        if (nfaFinal[s]) return true;
+    }
+    return false;
+}
+
+void ExternalSubsetConstruction::step(const QVector<int>& set, int symbol, QVector<int>& target,
+                                      QVector<int>& mark, int& stamp) const {
+    target.resize(0);
+    ++stamp;
+    int k = symbols.size();
+    for (int s : set) {
+        for (int t : successors[s * k + symbol]) {
+            if (mark[t] != stamp) {
+                mark[t] = stamp;
+                target.append(t);
+            }
+        }
+    }
+    std::sort(target.begin(), target.end());
+}
+
+QByteArray ExternalSubsetConstruction::encodeSet(const QVector<int>& set) {
+    // Gaps between sorted members as varints: one byte each for dense sets
+    QByteArray key;
+    int previous = -1;
+    for (int s : set) {
+        appendVarint(key, quint64(s - previous - 1));
+        previous = s;
+    }
+    return key;
+}
+
+void ExternalSubsetConstruction::decodeSet(const QByteArray& key, QVector<int>& set) {
+    set.resize(0);
+    int offset = 0;
+    int previous = -1;
+    quint64 gap = 0;
+    while (offset < key.size() && readVarint(key, offset, gap)) {
+        previous += int(gap) + 1;
+        set.append(previous);
+    }
+}
+
+bool ExternalSubsetConstruction::run(const QString& directory, const QString& outputPath,
+                                     QString* errorMsg) {
+    QDir work(directory);
+    auto levelFile = [&work](const QString& kind, int level) {
+        return work.filePath(QString("%1-%2").arg(kind).arg(level));
+    };
+    auto fail = [errorMsg](const QString& message) {
+        if (errorMsg) *errorMsg = message;
+        return false;
+    };
+    int sinceProgress = 0;
+    auto cancelled = [this, &sinceProgress](int level, qint64 states) {
+        if (!progressCallback || ++sinceProgress < ProgressInterval) return false;
+        sinceProgress = 0;
+        return !progressCallback(level, states);
+    };
+
+    int k = symbols.size();
+    qint64 sortBudget = qMax<qint64>(memoryBudget / 2, 64 * 1024);
+
+    // Level 0 holds the closure of the initial state as state 0
+    QByteArray idPayload;
+    appendVarint(idPayload, 0);
+    {
+        RecordWriter visited(&stats.bytesWritten);
+        RecordWriter frontier(&stats.bytesWritten);
+        if (!visited.open(levelFile("visited", 0)) || !frontier.open(levelFile("frontier", 0))) {
+            return fail(QString("Cannot write to %1.").arg(directory));
+        }
+        visited.writeRecord(encodeSet(initialSet), idPayload);
+        frontier.writeRecord(encodeSet(initialSet), idPayload);
+        if (!visited.close() || !frontier.close()) {
+            return fail("Writing the initial frontier failed.");
+        }
+    }
+
+    // One byte per state in id order; ids only ever grow
+    RecordWriter finals(&stats.bytesWritten);
+    if (!finals.open(work.filePath("finals"))) {
+        return fail(QString("Cannot write to %1.").arg(directory));
+    }
+    finals.writeRaw(QByteArray(1, isFinalSet(initialSet) ? 1 : 0));
+    qint64 nextId = 1;
+
+    // Transition keys are (source, symbol) in big endian, so the sorted
+    // stream comes out in table row order
+    ExternalSorter transitions(directory, "transitions", sortBudget, &stats);
+
+    QVector<int> set, target;
+    QVector<int> mark(nfaFinal.size(), 0);
+    int stamp = 0;
+    QByteArray key, payload, candidatePayload, targetPayload;
+    char transitionKey[12];
+
+    int level = 0;
+    while (true) {
+        stats.levels = level + 1;
+
+        // Expand the frontier; successors may repeat and are sorted externally
+        ExternalSorter candidates(directory, QString("candidates-%1").arg(level), sortBudget, &stats);
+        RecordReader frontier;
+        if (!frontier.open(levelFile("frontier", level))) {
+            return fail("Cannot read the frontier file.");
+        }
+        while (frontier.readRecord(key, payload)) {
+            if (cancelled(level, nextId)) {
+                return fail("Determinization was cancelled.");
+            }
+            int offset = 0;
+            quint64 source = 0;
+            readVarint(payload, offset, source);
+            decodeSet(key, set);
+            for (int c = 0; c < k; ++c) {
+                step(set, c, target, mark, stamp);
+                if (target.isEmpty()) continue;
+                QByteArray targetKey = encodeSet(target);
+                candidatePayload.resize(0);
+                appendVarint(candidatePayload, source);
+                appendVarint(candidatePayload, quint64(c));
+                if (!candidates.add(targetKey.constData(), targetKey.size(),
+                                    candidatePayload.constData(), candidatePayload.size())) {
+                    return fail("Writing a sorted run failed.");
+                }
+            }
+        }
+        frontier.close();
+        QFile::remove(levelFile("frontier", level));
+        if (frontier.hasFailed() || !candidates.finish()) {
+            return fail("Sorting the successors of a level failed.");
+        }
+
+        // Merge-join the sorted successors with the sorted visited subsets;
+        // unseen subsets get fresh ids and form the next frontier
+        RecordReader visited;
+        RecordWriter nextVisited(&stats.bytesWritten);
+        RecordWriter nextFrontier(&stats.bytesWritten);
+        if (!visited.open(levelFile("visited", level)) ||
+            !nextVisited.open(levelFile("visited", level + 1)) ||
+            !nextFrontier.open(levelFile("frontier", level + 1))) {
+            return fail(QString("Cannot open level files in %1.").arg(directory));
+        }
+
+        QByteArray visitedKey, visitedPayload, groupKey;
+        bool hasVisited = visited.readRecord(visitedKey, visitedPayload);
+        bool hasGroup = false;
+        qint64 groupId = -1;
+        qint64 discovered = 0;
+
+        while (candidates.next(key, payload)) {
+            if (cancelled(level, nextId)) {
+                return fail("Determinization was cancelled.");
+            }
+            if (!hasGroup || compareKeys(key, groupKey) != 0) {
+                hasGroup = true;
+                groupKey = key;
+                while (hasVisited && compareKeys(visitedKey, key) < 0) {
+                    nextVisited.writeRecord(visitedKey, visitedPayload);
+                    hasVisited = visited.readRecord(visitedKey, visitedPayload);
+                }
+
+                if (hasVisited && compareKeys(visitedKey, key) == 0) {
+                    int offset = 0;
+                    quint64 id = 0;
+                    readVarint(visitedPayload, offset, id);
+                    groupId = qint64(id);
+                } else {
+                    if (maxStates > 0 && nextId >= maxStates) {
+                        return fail(QString("DFA exceeds %1 states.").arg(maxStates));
+                    }
+                    groupId = nextId++;
+                    idPayload.resize(0);
+                    appendVarint(idPayload, quint64(groupId));
+                    nextVisited.writeRecord(key, idPayload);
+                    nextFrontier.writeRecord(key, idPayload);
+                    decodeSet(key, set);
+                    finals.writeRaw(QByteArray(1, isFinalSet(set) ? 1 : 0));
+                    ++discovered;
+                }
+            }
+
+            int offset = 0;
+            quint64 source = 0;
+            quint64 symbol = 0;
+            readVarint(payload, offset, source);
+            readVarint(payload, offset, symbol);
+            writeBigEndian(transitionKey, source, 8);
+            writeBigEndian(transitionKey + 8, symbol, 4);
+            targetPayload.resize(0);
+            appendVarint(targetPayload, quint64(groupId));
+            if (!transitions.add(transitionKey, 12, targetPayload.constData(), targetPayload.size())) {
+                return fail("Writing a sorted run failed.");
+            }
+            stats.transitionCount++;
+        }
+        while (hasVisited) {
+            nextVisited.writeRecord(visitedKey, visitedPayload);
+            hasVisited = visited.readRecord(visitedKey, visitedPayload);
+        }
+
+        visited.close();
+        QFile::remove(levelFile("visited", level));
+        bool ok = !visited.hasFailed() && !candidates.hasFailed();
+        ok = nextVisited.close() && ok;
+        ok = nextFrontier.close() && ok;
+        if (!ok) {
+            return fail("Merging a level with the visited subsets failed.");
+        }
+
+        ++level;
+        if (discovered == 0) {
+            break;
+        }
+    }
+    QFile::remove(levelFile("visited", level));
+    QFile::remove(levelFile("frontier", level));
+
+    if (!finals.close() || !transitions.finish()) {
+        return fail("Sorting the transition table failed.");
+    }
+    stats.stateCount = nextId;
+
+    // Stream the table out row by row
+    RecordWriter output(&stats.bytesWritten);
+    RecordReader finalFlags;
+    if (!output.open(outputPath)) {
+        return fail(QString("Cannot write %1.").arg(outputPath));
+    }
+    if (!finalFlags.open(work.filePath("finals"))) {
+        return fail("Cannot read the final state flags.");
+    }
+
+    QByteArray header;
+    appendLittleEndian(header, TableMagic, 4);
+    appendLittleEndian(header, TableVersion, 4);
+    appendLittleEndian(header, quint64(nextId), 8);
+    appendLittleEndian(header, quint64(k), 4);
+    appendLittleEndian(header, 0, 8);
+    for (const QString& symbol : symbols) {
+        QByteArray utf8 = symbol.toUtf8();
+        appendLittleEndian(header, quint64(utf8.size()), 4);
+        header.append(utf8);
+    }
+    output.writeRaw(header);
+
+    QVector<qint64> targets(k);
+    QByteArray row, flag;
+    bool hasTransition = transitions.next(key, payload);
+    for (qint64 id = 0; id < nextId; ++id) {
+        if (cancelled(level, nextId)) {
+            output.close();
+            QFile::remove(outputPath);
+            return fail("Determinization was cancelled.");
+        }
+        targets.fill(-1);
+        while (hasTransition && qint64(readBigEndian(key.constData(), 8)) == id) {
+            int symbol = int(readBigEndian(key.constData() + 8, 4));
+            int offset = 0;
+            quint64 targetId = 0;
+            readVarint(payload, offset, targetId);
+            targets[symbol] = qint64(targetId);
+            hasTransition = transitions.next(key, payload);
+        }
+
+        if (!finalFlags.readBytes(flag, 1)) {
+            return fail("The final state flags are truncated.");
+        }
+        row.resize(0);
+        row.append(flag);
+        for (qint64 t : targets) {
+            appendLittleEndian(row, quint64(t), 8);
+        }
+        output.writeRaw(row);
+    }
+    finalFlags.close();
+
+    if (transitions.hasFailed() || !output.close()) {
+        return fail(QString("Writing %1 failed.").arg(outputPath));
+    }
+    return true;
+}
+
+ExternalDFAReader::ExternalDFAReader()
+    : stateCount(0), initialState(-1), nextRow(0), rowsOffset(0) {}
+
+bool ExternalDFAReader::open(const QString& path, QString* errorMsg) {
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMsg) *errorMsg = QString("Cannot open %1.").arg(path);
+        return false;
+    }
+
+    QByteArray header = file.read(TableHeaderSize);
+    if (header.size() != TableHeaderSize ||
+        readLittleEndian(header.constData(), 4) != TableMagic ||
+        readLittleEndian(header.constData() + 4, 4) != TableVersion) {
+        if (errorMsg) *errorMsg = QString("%1 is not a DFA table file.").arg(path);
+        close();
+        return false;
+    }
+    stateCount = qint64(readLittleEndian(header.constData() + 8, 8));
+    int symbolCount = int(readLittleEndian(header.constData() + 16, 4));
+    initialState = qint64(readLittleEndian(header.constData() + 20, 8));
+
+    for (int i = 0; i < symbolCount; ++i) {
+        QByteArray length = file.read(4);
+        if (length.size() != 4) {
+            if (errorMsg) *errorMsg = QString("%1 has a truncated symbol list.").arg(path);
+            close();
+            return false;
+        }
+        int size = int(readLittleEndian(length.constData(), 4));
+        QByteArray utf8 = file.read(size);
+        if (utf8.size() != size) {
+            if (errorMsg) *errorMsg = QString("%1 has a truncated symbol list.").arg(path);
+            close();
+            return false;
+        }
+        symbols.append(QString::fromUtf8(utf8));
+    }
+    rowsOffset = file.pos();
+    return true;
+}
+
+void ExternalDFAReader::close() {
+    file.close();
+    symbols.clear();
+    stateCount = 0;
+    initialState = -1;
+    nextRow = 0;
+}
+
+bool ExternalDFAReader::readRow(bool& isFinal, QVector<qint64>& targets) {
+    if (nextRow >= stateCount) {
+        return false;
+    }
+    int rowSize = 1 + 8 * symbols.size();
+    rowBuffer = file.read(rowSize);
+    if (rowBuffer.size() != rowSize) {
+        return false;
+    }
+
+    isFinal = rowBuffer[0] != 0;
+    targets.resize(symbols.size());
+    for (int c = 0; c < symbols.size(); ++c) {
+        targets[c] = qint64(readLittleEndian(rowBuffer.constData() + 1 + 8 * c, 8));
+    }
+    ++nextRow;
+    return true;
+}
+
+bool ExternalDFAReader::loadInto(CompiledDFA& dfa, QString* errorMsg) {
+    int k = qMax(1, symbols.size());
+    if (stateCount > std::numeric_limits<int>::max() / k) {
+        if (errorMsg) *errorMsg = QString("%1 states are too many to load into memory.").arg(stateCount);
+        return false;
+    }
+
+    if (!file.seek(rowsOffset)) {
+        if (errorMsg) *errorMsg = "Cannot rewind the DFA table.";
+        return false;
+    }
+    nextRow = 0;
+
+    int states = int(stateCount);
+    QVector<int> table;
+    QVector<bool> finals;
+    table.reserve(states * symbols.size());
+    finals.reserve(states);
+
+    bool isFinal = false;
+    QVector<qint64> targets;
+    for (int s = 0; s < states; ++s) {
+        if (!readRow(isFinal, targets)) {
+            if (errorMsg) *errorMsg = "The DFA table is truncated.";
+            return false;
+        }
+        finals.append(isFinal);
+        for (qint64 t : targets) {
+            table.append(int(t));
+        }
+    }
+    return dfa.buildFromTable(states, symbols, table, finals, int(initialState), errorMsg);
+}
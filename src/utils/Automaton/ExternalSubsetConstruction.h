@@ -0,0 +1,98 @@
+#ifndef EXTERNALSUBSETCONSTRUCTION_H
+#define EXTERNALSUBSETCONSTRUCTION_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "CompiledDFA.h"
+#include <QVector>
+#include <QString>
+#include <QFile>
+#include <functional>
+
+// Counters of the last external determinization
+struct ExternalConstructionStats {
+    qint64 stateCount = 0;
+    qint64 transitionCount = 0;
+    int levels = 0;
+    int spilledRuns = 0;        // sorted runs written to disk by the external sorts
+    qint64 bytesWritten = 0;    // intermediate files plus the output table
+};
+
+// Subset construction for DFAs that do not fit in memory. A level-synchronous
+// BFS keeps every frontier and the set of visited subsets in files sorted by
+// subset; successors of a level are sorted externally and merge-joined with
+// the visited file, so RAM is bounded by the memory budget plus the NFA.
+//
+// Output table, little endian:
+//   "XDFA", quint32 version, qint64 states, quint32 symbols, qint64 initial,
+//   per symbol (quint32 UTF-8 length, bytes),
+//   then per state in id order: quint8 final, symbols x qint64 target (-1 = dead)
+class ExternalSubsetConstruction {
+private:
+    QString workDirectory;
+    qint64 memoryBudget;
+    qint64 maxStates;
+    std::function<bool(int, qint64)> progressCallback;
+    ExternalConstructionStats stats;
+
+    // Integer form of the NFA; successor lists already include epsilon closures
+    QVector<QString> symbols;
+    QVector<QVector<int>> successors;   // state * symbolCount + symbol -> sorted states
+    QVector<bool> nfaFinal;
+    QVector<int> initialSet;
+
+public:
+    static const qint64 DefaultMemoryBudget = 64ll * 1024 * 1024;
+
+    ExternalSubsetConstruction();
+
+    void setWorkDirectory(const QString& path) { workDirectory = path; }   // system temp dir when empty
+    void setMemoryBudget(qint64 bytes) { memoryBudget = bytes; }
+    void setMaxStates(qint64 states) { maxStates = states; }              // 0 = unlimited
+    // Called with the BFS level and the states found so far, every few
+    // thousand records on the converting thread; returning false cancels
+    void setProgressCallback(std::function<bool(int, qint64)> callback) { progressCallback = std::move(callback); }
+
+    bool convert(const Automaton* nfa, const QString& outputPath, QString* errorMsg = nullptr);
+    const ExternalConstructionStats& getStats() const { return stats; }
+
+private:
+    void prepare(const Automaton* nfa);
+    bool run(const QString& directory, const QString& outputPath, QString* errorMsg);
+    bool isFinalSet(const QVector<int>& set) const;
+    void step(const QVector<int>& set, int symbol, QVector<int>& target,
+              QVector<int>& mark, int& stamp) const;
+
+    static QByteArray encodeSet(const QVector<int>& set);
+    static void decodeSet(const QByteArray& key, QVector<int>& set);
+};
+
+// Streams a table written by ExternalSubsetConstruction row by row
+class ExternalDFAReader {
+private:
+    QFile file;
+    QVector<QString> symbols;
+    qint64 stateCount;
+    qint64 initialState;
+    qint64 nextRow;
+    qint64 rowsOffset;          // file offset of the first row
+    QByteArray rowBuffer;
+
+public:
+    ExternalDFAReader();
+
+    bool open(const QString& path, QString* errorMsg = nullptr);
+    void close();
+
+    qint64 getStateCount() const { return stateCount; }
+    qint64 getInitialState() const { return initialState; }
+    const QVector<QString>& getSymbols() const { return symbols; }
+
+    // Next state in id order; false once all rows were read
+    bool readRow(bool& isFinal, QVector<qint64>& targets);
+
+    // Whole table into memory, for results small enough to edit or minimize;
+    // rewinds to the first row
+    bool loadInto(CompiledDFA& dfa, QString* errorMsg = nullptr);
+};
+
+#endif // EXTERNALSUBSETCONSTRUCTION_H
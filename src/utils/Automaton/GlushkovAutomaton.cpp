@@ -0,0 +1,430 @@
+#include "GlushkovAutomaton.h"
+#include <QMap>
+#include <QHash>
+#include <algorithm>
+
+GlushkovAutomaton::GlushkovAutomaton()
+    : deterministic(true) {}
+
+bool GlushkovAutomaton::build(const QString& pattern, QString* errorMsg) {
+    RegexTree tree;
+    RegexParser parser;
+    if (!parser.parse(pattern, tree, errorMsg)) {
+        return false;
+    }
+    build(tree);
+    return true;
+}
+
+void GlushkovAutomaton::build(const RegexTree& source) {
+    positionChars.clear();
+    follow.clear();
+    finalStates.clear();
+    deterministic = true;
+    if (source.isEmpty()) {
+        return;
+    }
+
+    // Star normal form keeps most follow pairs from being added twice; nested
+    // Plus can still repeat some, which the sort below removes
+    RegexTree tree = source;
+    QVector<int> nullableCache(tree.nodes.size(), -1);
+    tree.root = starNormalForm(tree, tree.root, nullableCache);
+
+    positionChars.append(QString());
+    follow.append(QVector<int>());
+    Sets root = collect(tree, tree.root);
+    follow[0] = root.first;
+
+    for (auto& successors : follow) {
+        std::sort(successors.begin(), successors.end());
+        successors.erase(std::unique(successors.begin(), successors.end()), successors.end());
+    }
+
+    finalStates.fill(false, follow.size());
+    finalStates[0] = root.nullable;
+    for (int p : root.last) {
+        finalStates[p] = true;
+    }
+
+    checkDeterminism();
+}
+
+bool GlushkovAutomaton::isNullable(const RegexTree& tree, int node, QVector<int>& nullableCache) {
+    while (nullableCache.size() < tree.nodes.size()) {
+        nullableCache.append(-1);
+    }
+    if (nullableCache[node] >= 0) {
+        return nullableCache[node];
+    }
+
+    const RegexNode& n = tree.nodes[node];
+    bool result = false;
+    switch (n.type) {
+    case RegexNode::Type::Empty:
+    case RegexNode::Type::Star:
+    case RegexNode::Type::Optional:
+        result = true;
+        break;
+    case RegexNode::Type::CharSet:
+        result = false;
+        break;
+    case RegexNode::Type::Plus:
+        result = isNullable(tree, n.children[0], nullableCache);
+        break;
+    case RegexNode::Type::Concat:
+        result = true;
+        for (int child : n.children) {
+            if (!isNullable(tree, child, nullableCache)) {
+                result = false;
+                break;
+            }
+        }
+        break;
+    case RegexNode::Type::Union:
+        for (int child : n.children) {
+            if (isNullable(tree, child, nullableCache)) {
+                result = true;
+                break;
+            }
+        }
+        break;
+    }
+
+    nullableCache[node] = result ? 1 : 0;
+    return result;
+}
+
+int GlushkovAutomaton::addNode(RegexTree& tree, RegexNode::Type type, const QVector<int>& children) {
+    RegexNode node;
+    node.type = type;
+    node.children = children;
+    tree.nodes.append(node);
+    return tree.nodes.size() - 1;
+}
+
+int GlushkovAutomaton::starNormalForm(RegexTree& tree, int node, QVector<int>& nullableCache) {
+    RegexNode::Type type = tree.nodes[node].type;
+    QVector<int> children = tree.nodes[node].children;
+    for (int& child : children) {
+        child = starNormalForm(tree, child, nullableCache);
+    }
+    tree.nodes[node].children = children;
+
+    if (type == RegexNode::Type::Star ||
+        (type == RegexNode::Type::Plus && isNullable(tree, children[0], nullableCache))) {
+        // (F)* == (F°)*, and a nullable F+ is just F*
+        int body = starBody(tree, children[0], nullableCache);
+        return addNode(tree, RegexNode::Type::Star, {body});
+    }
+    return node;
+}
+
+int GlushkovAutomaton::starBody(RegexTree& tree, int node, QVector<int>& nullableCache) {
+    // F° drops the stars and options that are redundant under an outer star
+    const RegexNode n = tree.nodes[node];
+    switch (n.type) {
+    case RegexNode::Type::Empty:
+    case RegexNode::Type::CharSet:
+        return node;
+    case RegexNode::Type::Optional:
+    case RegexNode::Type::Star:
+    case RegexNode::Type::Plus:
+        return starBody(tree, n.children[0], nullableCache);
+    case RegexNode::Type::Union: {
+        QVector<int> alternatives;
+        for (int child : n.children) {
+            alternatives.append(starBody(tree, child, nullableCache));
+        }
+        return addNode(tree, RegexNode::Type::Union, alternatives);
+    }
+    case RegexNode::Type::Concat:
+        if (isNullable(tree, node, nullableCache)) {
+            QVector<int> alternatives;
+            for (int child : n.children) {
+                alternatives.append(starBody(tree, child, nullableCache));
+            }
+            return addNode(tree, RegexNode::Type::Union, alternatives);
+        }
+        return node;
+    }
+    return node;
+}
+
+GlushkovAutomaton::Sets GlushkovAutomaton::collect(const RegexTree& tree, int node) {
+    const RegexNode& n = tree.nodes[node];
+    Sets result;
+    result.nullable = false;
+
+    switch (n.type) {
+    case RegexNode::Type::Empty:
+        result.nullable = true;
+        break;
+
+    case RegexNode::Type::CharSet: {
+        int position = positionChars.size();
+        positionChars.append(n.chars);
+        follow.append(QVector<int>());
+        result.first.append(position);
+        result.last.append(position);
+        break;
+    }
+
+    case RegexNode::Type::Concat: {
+        result.nullable = true;
+        for (int child : n.children) {
+            Sets part = collect(tree, child);
+            for (int p : result.last) {
+                follow[p] += part.first;
+            }
+            if (result.nullable) {
+                result.first += part.first;
+            }
+            if (part.nullable) {
+                result.last += part.last;
+            } else {
+                result.last = part.last;
+            }
+            result.nullable = result.nullable && part.nullable;
+        }
+        break;
+    }
+
+    case RegexNode::Type::Union:
+        for (int child : n.children) {
+            Sets part = collect(tree, child);
+            result.nullable = result.nullable || part.nullable;
+            result.first += part.first;
+            result.last += part.last;
+        }
+        break;
+
+    case RegexNode::Type::Star:
+    case RegexNode::Type::Plus:
+    case RegexNode::Type::Optional: {
+        result = collect(tree, n.children[0]);
+        if (n.type != RegexNode::Type::Optional) {
+            for (int p : result.last) {
+                follow[p] += result.first;
+            }
+        }
+        if (n.type != RegexNode::Type::Plus) {
+            result.nullable = true;
+        }
+        break;
+    }
+    }
+
+    return result;
+}
+
+void GlushkovAutomaton::checkDeterminism() {
+    deterministic = true;
+    QHash<QChar, int> claimedBy;
+    for (int s = 0; s < follow.size() && deterministic; ++s) {
+        claimedBy.clear();
+        for (int q : follow[s]) {
+            for (QChar c : positionChars[q]) {
+                if (claimedBy.contains(c)) {
+                    deterministic = false;
+                    break;
+                }
+                claimedBy.insert(c, q);
+            }
+            if (!deterministic) break;
+        }
+    }
+}
+
+QString GlushkovAutomaton::alphabet() const {
+    QVector<QChar> chars;
+    for (int p = 1; p < positionChars.size(); ++p) {
+        for (QChar c : positionChars[p]) {
+            chars.append(c);
+        }
+    }
+    std::sort(chars.begin(), chars.end());
+    chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+
+    QString result;
+    for (QChar c : chars) {
+        result += c;
+    }
+    return result;
+}
+
+bool GlushkovAutomaton::accepts(const QString& input) const {
+    if (follow.isEmpty()) {
+        return false;
+    }
+
+    // No closures: the active set is just the positions read last
+    QVector<int> current = {0};
+    QVector<int> stamp(follow.size(), -1);
+    for (int i = 0; i < input.size() && !current.isEmpty(); ++i) {
+        QVector<int> next;
+        for (int s : current) {
+            for (int q : follow[s]) {
+                if (stamp[q] != i && positionChars[q].contains(input[i])) {
+                    stamp[q] = i;
+                    next.append(q);
+                }
+            }
+        }
+        current = next;
+    }
+
+    for (int s : current) {
+        if (finalStates[s]) return true;
+    }
+    return false;
+}
+
+Automaton* GlushkovAutomaton::toAutomaton(const QString& id, const QString& name) const {
+    if (follow.isEmpty()) {
+        return nullptr;
+    }
+
+    // Built as an NFA so addTransition skips the per-edge DFA checks. 'E'
+    // and 'ε' would read as epsilon edges in the editor's model, so positions
+    // on those letters get no edge, as in CompiledDFA::toAutomaton.
+    Automaton* automaton = new Automaton(id, name, AutomatonType::NFA);
+    for (int s = 0; s < follow.size(); ++s) {
+        State state(QString("q%1").arg(s));
+        state.setIsFinal(finalStates[s]);
+        automaton->addState(state);
+    }
+    automaton->setInitialState("q0");
+
+    for (int s = 0; s < follow.size(); ++s) {
+        for (int q : follow[s]) {
+            const QString& chars = positionChars[q];
+            Transition trans(QString("q%1").arg(s), QString("q%1").arg(q), QString());
+            for (QChar ch : chars) {
+                if (!Transition::isEpsilonSymbol(QString(ch))) {
+                    trans.addSymbol(QString(ch));
+                }
+            }
+            if (!trans.getSymbols().isEmpty()) {
+                automaton->addTransition(trans);
+            }
+        }
+    }
+
+    automaton->setType(deterministic ? AutomatonType::DFA : AutomatonType::NFA);
+    return automaton;
+}
+
+bool GlushkovAutomaton::toDFA(CompiledDFA& dfa, QString* errorMsg, int maxStates) const {
+    if (follow.isEmpty()) {
+        if (errorMsg) *errorMsg = "No expression has been built.";
+        return false;
+    }
+
+    QString chars = alphabet();
+    QVector<QString> symbols;
+    QHash<QChar, int> column;
+    for (int i = 0; i < chars.size(); ++i) {
+        symbols.append(QString(chars[i]));
+        column.insert(chars[i], i);
+    }
+    int cols = symbols.size();
+
+    if (deterministic) {
+        // Usual case: the position automaton already is the DFA
+        int states = follow.size();
+        QVector<int> table(states * cols, -1);
+        for (int s = 0; s < states; ++s) {
+            for (int q : follow[s]) {
+                for (QChar c : positionChars[q]) {
+                    table[s * cols + column.value(c)] = q;
+                }
+            }
+        }
+        return dfa.buildFromTable(states, symbols, table, finalStates, 0, errorMsg);
+    }
+
+    // Characters read by exactly the same positions behave identically
+    QVector<QVector<int>> readers(cols);
+    for (int p = 1; p < positionChars.size(); ++p) {
+        for (QChar c : positionChars[p]) {
+            readers[column.value(c)].append(p);
+        }
+    }
+    QMap<QVector<int>, int> classBySignature;
+    QVector<int> classOfColumn(cols);
+    for (int c = 0; c < cols; ++c) {
+        auto it = classBySignature.find(readers[c]);
+        if (it == classBySignature.end()) {
+            it = classBySignature.insert(readers[c], classBySignature.size());
+        }
+        classOfColumn[c] = it.value();
+    }
+    int classCount = classBySignature.size();
+
+    QVector<QVector<int>> classesOfPosition(positionChars.size());
+    for (int c = 0; c < cols; ++c) {
+        for (int p : readers[c]) {
+            QVector<int>& classes = classesOfPosition[p];
+            if (!classes.contains(classOfColumn[c])) {
+                classes.append(classOfColumn[c]);
+            }
+        }
+    }
+
+    // Subset construction; a DFA state is a sorted set of Glushkov states
+    QVector<QVector<int>> subsets;
+    QMap<QVector<int>, int> subsetIndex;
+    QVector<int> classTable;
+    QVector<bool> finals;
+
+    subsets.append(QVector<int>{0});
+    subsetIndex.insert(subsets.first(), 0);
+
+    QVector<QVector<int>> buckets(classCount);
+    for (int d = 0; d < subsets.size(); ++d) {
+        const QVector<int> subset = subsets[d];
+
+        bool isFinal = false;
+        for (int s : subset) {
+            isFinal = isFinal || finalStates[s];
+            for (int q : follow[s]) {
+                for (int k : classesOfPosition[q]) {
+                    buckets[k].append(q);
+                }
+            }
+        }
+        finals.append(isFinal);
+
+        for (int k = 0; k < classCount; ++k) {
+            QVector<int>& target = buckets[k];
+            if (target.isEmpty()) {
+                classTable.append(-1);
+                continue;
+            }
+            std::sort(target.begin(), target.end());
+            target.erase(std::unique(target.begin(), target.end()), target.end());
+
+            auto it = subsetIndex.find(target);
+            if (it == subsetIndex.end()) {
+                if (subsets.size() >= maxStates) {
+                    if (errorMsg) *errorMsg = QString("DFA exceeds %1 states.").arg(maxStates);
+                    return false;
+                }
+                it = subsetIndex.insert(target, subsets.size());
+                subsets.append(target);
+            }
+            classTable.append(it.value());
+            target.clear();
+        }
+    }
+
+    int states = subsets.size();
+    QVector<int> table(states * cols, -1);
+    for (int d = 0; d < states; ++d) {
+        for (int c = 0; c < cols; ++c) {
+            table[d * cols + c] = classTable[d * classCount + classOfColumn[c]];
+        }
+    }
+    return dfa.buildFromTable(states, symbols, table, finals, 0, errorMsg);
+}
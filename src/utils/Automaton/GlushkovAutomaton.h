@@ -0,0 +1,62 @@
+#ifndef GLUSHKOVAUTOMATON_H
+#define GLUSHKOVAUTOMATON_H
+
+#include "RegexParser.h"
+#include "CompiledDFA.h"
+#include "./src/models/Automaton/Automaton.h"
+#include <QVector>
+#include <QString>
+
+// Epsilon-free position automaton of a regular expression. State 0 is the
+// initial state and state i (1..n) means "position i was just read", so
+// every edge into i carries the character set of position i.
+class GlushkovAutomaton {
+private:
+    struct Sets {
+        bool nullable;
+        QVector<int> first;
+        QVector<int> last;
+    };
+
+    QVector<QString> positionChars;     // state -> characters on its incoming edges
+    QVector<QVector<int>> follow;       // state -> successor positions (state 0: first set)
+    QVector<bool> finalStates;
+    bool deterministic;
+
+public:
+    static const int DefaultMaxDFAStates = 100000;
+
+    GlushkovAutomaton();
+
+    bool build(const QString& pattern, QString* errorMsg = nullptr);
+    void build(const RegexTree& tree);
+
+    int getStateCount() const { return follow.size(); }
+    int getPositionCount() const { return qMax(0, follow.size() - 1); }
+    bool isDeterministic() const { return deterministic; }
+    bool isFinal(int state) const { return finalStates[state]; }
+    const QVector<int>& successors(int state) const { return follow[state]; }
+    const QString& charsOf(int position) const { return positionChars[position]; }
+
+    bool accepts(const QString& input) const;
+    QString alphabet() const;   // sorted, one character per symbol
+
+    // Editable automaton with states q0..qn; typed DFA when already deterministic
+    Automaton* toAutomaton(const QString& id, const QString& name) const;
+
+    // Subset construction over position sets, no epsilon closures needed.
+    // A deterministic position automaton is copied into the table directly.
+    bool toDFA(CompiledDFA& dfa, QString* errorMsg = nullptr,
+               int maxStates = DefaultMaxDFAStates) const;
+
+private:
+    static int starNormalForm(RegexTree& tree, int node, QVector<int>& nullableCache);
+    static int starBody(RegexTree& tree, int node, QVector<int>& nullableCache);
+    static bool isNullable(const RegexTree& tree, int node, QVector<int>& nullableCache);
+    static int addNode(RegexTree& tree, RegexNode::Type type, const QVector<int>& children);
+
+    Sets collect(const RegexTree& tree, int node);
+    void checkDeterminism();
+};
+
+#endif // GLUSHKOVAUTOMATON_H
@@ -0,0 +1,249 @@
+#include "LanguageCounter.h"
+#include <QQueue>
+#include <QMap>
+#include <limits>
+
+LanguageCounter::LanguageCounter(const CompiledDFA* dfa)
+    : dfa(dfa), edgeCount(0) {
+    buildTrimmedGraph();
+}
+
+void LanguageCounter::buildTrimmedGraph() {
+    usefulStates.clear();
+    usefulIndex.clear();
+    edges.clear();
+    edgeCount = 0;
+
+    if (!dfa || dfa->isEmpty()) {
+        return;
+    }
+
+    int n = dfa->getStateCount();
+    int k = dfa->getSymbolCount();
+
+    // Forward reachability from the initial state
+    QVector<bool> reachable(n, false);
+    QVector<QVector<int>> reverse(n);
+    QQueue<int> queue;
+    reachable[dfa->getInitialState()] = true;
+    queue.enqueue(dfa->getInitialState());
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        for (int c = 0; c < k; ++c) {
+            int t = dfa->next(s, c);
+            if (t < 0) continue;
+            reverse[t].append(s);
+            if (!reachable[t]) {
+                reachable[t] = true;
+                queue.enqueue(t);
+            }
+        }
+    }
+
+    // Backward reachability from final states
+    QVector<bool> coReachable(n, false);
+    for (int s = 0; s < n; ++s) {
+        if (reachable[s] && dfa->isFinal(s)) {
+            coReachable[s] = true;
+            queue.enqueue(s);
+        }
+    }
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        for (int p : reverse[s]) {
+            if (!coReachable[p]) {
+                coReachable[p] = true;
+                queue.enqueue(p);
+            }
+        }
+    }
+
+    usefulIndex.fill(-1, n);
+    for (int s = 0; s < n; ++s) {
+        if (reachable[s] && coReachable[s]) {
+            usefulIndex[s] = usefulStates.size();
+            usefulStates.append(s);
+        }
+    }
+
+    // Collapse parallel symbols into one weighted edge
+    edges.resize(usefulStates.size());
+    for (int u = 0; u < usefulStates.size(); ++u) {
+        QMap<int, quint32> weights;
+        for (int c = 0; c < k; ++c) {
+            int t = dfa->next(usefulStates[u], c);
+            if (t >= 0 && usefulIndex[t] >= 0) {
+                weights[usefulIndex[t]]++;
+            }
+        }
+        for (auto it = weights.constBegin(); it != weights.constEnd(); ++it) {
+            edges[u].append(qMakePair(it.key(), it.value()));
+        }
+        edgeCount += weights.size();
+    }
+}
+
+BigInteger LanguageCounter::countWordsOfLength(quint64 length) const {
+    if (isLanguageEmpty()) {
+        return BigInteger();
+    }
+    if (preferMatrixPower(length)) {
+        return countByMatrixPower(length);
+    }
+    return countByDynamicProgramming(static_cast<int>(length));
+}
+
+bool LanguageCounter::preferMatrixPower(quint64 length) const {
+    if (length > static_cast<quint64>(std::numeric_limits<int>::max())) {
+        return true;
+    }
+
+    int bits = 0;
+    for (quint64 n = length; n > 0; n >>= 1) {
+        ++bits;
+    }
+
+    double size = usefulStates.size();
+    double dpCost = static_cast<double>(length) * qMax(edgeCount, 1);
+    double matrixCost = size * size * size * bits;
+    return matrixCost < dpCost;
+}
+
+BigInteger LanguageCounter::countByDynamicProgramming(int length) const {
+    if (length < 0 || isLanguageEmpty()) {
+        return BigInteger();
+    }
+
+    // Only the last length is wanted, so two rows of per-state counts suffice
+    int size = usefulStates.size();
+    QVector<BigInteger> current(size);
+    QVector<BigInteger> next(size);
+    current[usefulIndex[dfa->getInitialState()]] = BigInteger(1);
+    for (int step = 0; step < length; ++step) {
+        next.fill(BigInteger());
+        advance(current, next);
+        current.swap(next);
+    }
+    return acceptedCount(current);
+}
+
+BigInteger LanguageCounter::acceptedCount(const QVector<BigInteger>& counts) const {
+    BigInteger accepted;
+    for (int u = 0; u < counts.size(); ++u) {
+        if (dfa->isFinal(usefulStates[u])) {
+            accepted += counts[u];
+        }
+    }
+    return accepted;
+}
+
+void LanguageCounter::advance(const QVector<BigInteger>& current, QVector<BigInteger>& next) const {
+    for (int u = 0; u < current.size(); ++u) {
+        if (current[u].isZero()) continue;
+        for (const auto& edge : edges[u]) {
+            if (edge.second == 1) {
+                next[edge.first] += current[u];
+            } else {
+                BigInteger weighted = current[u];
+                next[edge.first] += weighted.multiplySmall(edge.second);
+            }
+        }
+    }
+}
+
+QVector<BigInteger> LanguageCounter::countWordsByLength(int maxLength) const {
+    QVector<BigInteger> result;
+    if (maxLength < 0) {
+        return result;
+    }
+    if (isLanguageEmpty()) {
+        result.fill(BigInteger(), maxLength + 1);
+        return result;
+    }
+
+    int size = usefulStates.size();
+    QVector<BigInteger> current(size);
+    QVector<BigInteger> next(size);
+    current[usefulIndex[dfa->getInitialState()]] = BigInteger(1);
+
+    for (int length = 0; length <= maxLength; ++length) {
+        result.append(acceptedCount(current));
+        if (length == maxLength) {
+            break;
+        }
+
+        next.fill(BigInteger());
+        advance(current, next);
+        current.swap(next);
+    }
+
+    return result;
+}
+
+BigInteger LanguageCounter::countWordsUpTo(int maxLength) const {
+    BigInteger total;
+    for (const auto& count : countWordsByLength(maxLength)) {
+        total += count;
+    }
+    return total;
+}
+
+BigInteger LanguageCounter::countByMatrixPower(quint64 length) const {
+    int size = usefulStates.size();
+
+    // Square matrix of path counts, row-major
+    QVector<BigInteger> power(size * size);
+    for (int u = 0; u < size; ++u) {
+        for (const auto& edge : edges[u]) {
+            power[u * size + edge.first] = BigInteger(edge.second);
+        }
+    }
+
+    QVector<BigInteger> vector(size);
+    vector[usefulIndex[dfa->getInitialState()]] = BigInteger(1);
+
+    quint64 remaining = length;
+    while (remaining > 0) {
+        if (remaining & 1) {
+            QVector<BigInteger> product(size);
+            for (int i = 0; i < size; ++i) {
+                if (vector[i].isZero()) continue;
+                for (int j = 0; j < size; ++j) {
+                    const BigInteger& entry = power[i * size + j];
+                    if (!entry.isZero()) {
+                        product[j] += vector[i] * entry;
+                    }
+                }
+            }
+            vector = product;
+        }
+
+        remaining >>= 1;
+        if (remaining == 0) {
+            break;
+        }
+
+        QVector<BigInteger> squared(size * size);
+        for (int i = 0; i < size; ++i) {
+            for (int m = 0; m < size; ++m) {
+                const BigInteger& left = power[i * size + m];
+                if (left.isZero()) continue;
+                for (int j = 0; j < size; ++j) {
+                    const BigInteger& right = power[m * size + j];
+                    if (!right.isZero()) {
+                        squared[i * size + j] += left * right;
+                    }
+                }
+            }
+        }
+        power = squared;
+    }
+
+    BigInteger accepted;
+    for (int u = 0; u < size; ++u) {
+        if (dfa->isFinal(usefulStates[u])) {
+            accepted += vector[u];
+        }
+    }
+    return accepted;
+}
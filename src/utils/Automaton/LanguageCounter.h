@@ -0,0 +1,38 @@
+#ifndef LANGUAGECOUNTER_H
+#define LANGUAGECOUNTER_H
+
+#include "CompiledDFA.h"
+#include "BigInteger.h"
+#include <QVector>
+#include <QPair>
+
+// Counts accepted words of a given length. Short lengths use a per-length
+// DP over the transition table; huge lengths use v * M^n by repeated squaring.
+class LanguageCounter {
+private:
+    const CompiledDFA* dfa;
+    QVector<int> usefulStates;                     // reachable and co-reachable
+    QVector<int> usefulIndex;                      // compiled state -> useful index, -1 if trimmed
+    QVector<QVector<QPair<int, quint32>>> edges;   // useful index -> (target, symbol multiplicity)
+    int edgeCount;
+
+public:
+    explicit LanguageCounter(const CompiledDFA* dfa);
+
+    BigInteger countWordsOfLength(quint64 length) const;
+    QVector<BigInteger> countWordsByLength(int maxLength) const;
+    BigInteger countWordsUpTo(int maxLength) const;
+
+    bool isLanguageEmpty() const { return usefulStates.isEmpty(); }
+
+private:
+    void buildTrimmedGraph();
+    BigInteger countByDynamicProgramming(int length) const;
+    BigInteger acceptedCount(const QVector<BigInteger>& counts) const;
+    // Adds the counts of words one symbol longer to next
+    void advance(const QVector<BigInteger>& current, QVector<BigInteger>& next) const;
+    BigInteger countByMatrixPower(quint64 length) const;
+    bool preferMatrixPower(quint64 length) const;
+};
+
+#endif // LANGUAGECOUNTER_H
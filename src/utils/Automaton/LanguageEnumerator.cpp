@@ -0,0 +1,315 @@
+#include "LanguageEnumerator.h"
+#include <QQueue>
+
+LanguageEnumerator::LanguageEnumerator(const CompiledDFA* dfa, int maxLength)
+    : dfa(dfa), maxLength(maxLength), longestWord(-1) {
+    computeDistances();
+    computeLongestWord();
+    reset();
+}
+
+void LanguageEnumerator::reset() {
+    currentLength = 0;
+    lengthStarted = false;
+    hasPending = false;
+    pendingPop = false;
+    stateStack.clear();
+    nextSymbolStack.clear();
+    wordSymbols.clear();
+
+    // Nothing to emit when the initial state cannot reach acceptance
+    finished = !dfa || dfa->isEmpty() || distanceToFinal[dfa->getInitialState()] < 0;
+}
+
+void LanguageEnumerator::computeDistances() {
+    distanceToFinal.clear();
+    if (!dfa || dfa->isEmpty()) {
+        return;
+    }
+
+    int n = dfa->getStateCount();
+    QVector<QVector<int>> reverse(n);
+    for (int s = 0; s < n; ++s) {
+        for (int c = 0; c < dfa->getSymbolCount(); ++c) {
+            int t = dfa->next(s, c);
+            if (t >= 0) {
+                reverse[t].append(s);
+            }
+        }
+    }
+
+    // Multi-source BFS backwards from all final states
+    distanceToFinal.fill(-1, n);
+    QQueue<int> queue;
+    for (int s = 0; s < n; ++s) {
+        if (dfa->isFinal(s)) {
+            distanceToFinal[s] = 0;
+            queue.enqueue(s);
+        }
+    }
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        for (int p : reverse[s]) {
+            if (distanceToFinal[p] < 0) {
+                distanceToFinal[p] = distanceToFinal[s] + 1;
+                queue.enqueue(p);
+            }
+        }
+    }
+}
+
+void LanguageEnumerator::computeLongestWord() {
+    longestWord = -1;
+    if (!dfa || dfa->isEmpty() || distanceToFinal[dfa->getInitialState()] < 0) {
+        return;
+    }
+
+    int n = dfa->getStateCount();
+    int k = dfa->getSymbolCount();
+
+    // Useful states: reachable from the initial state and not dead
+    QVector<bool> useful(n, false);
+    QQueue<int> queue;
+    useful[dfa->getInitialState()] = true;
+    queue.enqueue(dfa->getInitialState());
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        for (int c = 0; c < k; ++c) {
+            int t = dfa->next(s, c);
+            if (t >= 0 && !useful[t] && distanceToFinal[t] >= 0) {
+                useful[t] = true;
+                queue.enqueue(t);
+            }
+        }
+    }
+
+    // Kahn's algorithm: a cycle among useful states means an infinite language
+    QVector<int> inDegree(n, 0);
+    int usefulCount = 0;
+    for (int s = 0; s < n; ++s) {
+        if (!useful[s]) continue;
+        ++usefulCount;
+        for (int c = 0; c < k; ++c) {
+            int t = dfa->next(s, c);
+            if (t >= 0 && useful[t]) {
+                inDegree[t]++;
+            }
+        }
+    }
+
+    QVector<int> depth(n, -1);
+    depth[dfa->getInitialState()] = 0;
+    for (int s = 0; s < n; ++s) {
+        if (useful[s] && inDegree[s] == 0) {
+            queue.enqueue(s);
+        }
+    }
+
+    int visited = 0;
+    int longest = -1;
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        ++visited;
+        if (dfa->isFinal(s) && depth[s] >= 0) {
+            longest = qMax(longest, depth[s]);
+        }
+        for (int c = 0; c < k; ++c) {
+            int t = dfa->next(s, c);
+            if (t < 0 || !useful[t]) continue;
+            if (depth[s] >= 0) {
+                depth[t] = qMax(depth[t], depth[s] + 1);
+            }
+            if (--inDegree[t] == 0) {
+                queue.enqueue(t);
+            }
+        }
+    }
+
+    longestWord = visited == usefulCount ? longest : -1;
+}
+
+void LanguageEnumerator::ensureTable(int length) {
+    int n = dfa->getStateCount();
+    while (reachesFinalIn.size() <= length) {
+        QVector<bool> row(n, false);
+        if (reachesFinalIn.isEmpty()) {
+            for (int s = 0; s < n; ++s) {
+                row[s] = dfa->isFinal(s);
+            }
+        } else {
+            const QVector<bool>& previous = reachesFinalIn.last();
+            for (int s = 0; s < n; ++s) {
+                for (int c = 0; c < dfa->getSymbolCount(); ++c) {
+                    int t = dfa->next(s, c);
+                    if (t >= 0 && previous[t]) {
+                        row[s] = true;
+                        break;
+                    }
+                }
+            }
+        }
+        reachesFinalIn.append(row);
+    }
+}
+
+bool LanguageEnumerator::hasNext() {
+    if (!hasPending && !finished) {
+        hasPending = advance();
+    }
+    return hasPending;
+}
+
+QString LanguageEnumerator::next() {
+    if (!hasNext()) {
+        return QString();
+    }
+    hasPending = false;
+    return currentWord();
+}
+
+QVector<QString> LanguageEnumerator::take(int count) {
+    QVector<QString> words;
+    while (words.size() < count && hasNext()) {
+        words.append(next());
+    }
+    return words;
+}
+
+bool LanguageEnumerator::advance() {
+    if (pendingPop) {
+        stateStack.removeLast();
+        nextSymbolStack.removeLast();
+        if (!wordSymbols.isEmpty()) {
+            wordSymbols.removeLast();
+        }
+        pendingPop = false;
+    }
+
+    while (true) {
+        if (!lengthStarted) {
+            if ((maxLength >= 0 && currentLength > maxLength) ||
+                (longestWord >= 0 && currentLength > longestWord)) {
+                finished = true;
+                return false;
+            }
+
+            ensureTable(currentLength);
+            if (!reachesFinalIn[currentLength][dfa->getInitialState()]) {
+                ++currentLength;
+                continue;
+            }
+
+            stateStack.append(dfa->getInitialState());
+            nextSymbolStack.append(0);
+            lengthStarted = true;
+        }
+
+        if (stateStack.isEmpty()) {
+            lengthStarted = false;
+            ++currentLength;
+            continue;
+        }
+
+        int depth = stateStack.size() - 1;
+        if (depth == currentLength) {
+            // reachesFinalIn[0] guarantees this state is final
+            pendingPop = true;
+            return true;
+        }
+
+        int state = stateStack.last();
+        int remaining = currentLength - depth - 1;
+        bool descended = false;
+        while (nextSymbolStack.last() < dfa->getSymbolCount()) {
+            int symbol = nextSymbolStack.last()++;
+            int target = dfa->next(state, symbol);
+            if (target >= 0 && reachesFinalIn[remaining][target]) {
+                stateStack.append(target);
+                nextSymbolStack.append(0);
+                wordSymbols.append(symbol);
+                descended = true;
+                break;
+            }
+        }
+
+        if (!descended) {
+            stateStack.removeLast();
+            nextSymbolStack.removeLast();
+            if (!wordSymbols.isEmpty()) {
+                wordSymbols.removeLast();
+            }
+        }
+    }
+}
+
+QString LanguageEnumerator::currentWord() const {
+    QString word;
+    for (int symbol : wordSymbols) {
+        word += dfa->getSymbol(symbol);
+    }
+    return word;
+}
+
+bool LanguageEnumerator::canReachFinalWithin(int state, int steps) const {
+    if (state < 0 || state >= distanceToFinal.size()) {
+        return false;
+    }
+    return distanceToFinal[state] >= 0 && distanceToFinal[state] <= steps;
+}
+
+QString LanguageEnumerator::shortestWitness(int state, bool* found) const {
+    if (state < 0 || state >= distanceToFinal.size() || distanceToFinal[state] < 0) {
+        if (found) *found = false;
+        return QString();
+    }
+
+    // Greedy walk: the smallest symbol that keeps the distance shrinking by one
+    QString witness;
+    int current = state;
+    while (distanceToFinal[current] > 0) {
+        for (int c = 0; c < dfa->getSymbolCount(); ++c) {
+            int t = dfa->next(current, c);
+            if (t >= 0 && distanceToFinal[t] == distanceToFinal[current] - 1) {
+                witness += dfa->getSymbol(c);
+                current = t;
+                break;
+            }
+        }
+    }
+
+    if (found) *found = true;
+    return witness;
+}
+
+QMap<QString, QString> LanguageEnumerator::witnessesPerState() const {
+    QMap<QString, QString> witnesses;
+    if (!dfa || dfa->isEmpty()) {
+        return witnesses;
+    }
+
+    // BFS in symbol order gives the smallest shortest access word per state
+    int n = dfa->getStateCount();
+    QVector<QString> access(n);
+    QVector<bool> seen(n, false);
+    QQueue<int> queue;
+    seen[dfa->getInitialState()] = true;
+    queue.enqueue(dfa->getInitialState());
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        bool found = false;
+        QString suffix = shortestWitness(s, &found);
+        if (found) {
+            witnesses.insert(dfa->getStateId(s), access[s] + suffix);
+        }
+        for (int c = 0; c < dfa->getSymbolCount(); ++c) {
+            int t = dfa->next(s, c);
+            if (t >= 0 && !seen[t]) {
+                seen[t] = true;
+                access[t] = access[s] + dfa->getSymbol(c);
+                queue.enqueue(t);
+            }
+        }
+    }
+
+    return witnesses;
+}
@@ -0,0 +1,55 @@
+#ifndef LANGUAGEENUMERATOR_H
+#define LANGUAGEENUMERATOR_H
+
+#include "CompiledDFA.h"
+#include <QVector>
+#include <QMap>
+#include <QString>
+
+// Lazily enumerates accepted words in length-lexicographic order.
+// Branches are pruned with "reaches a final state in exactly k steps"
+// tables, so every explored prefix extends to an accepted word.
+class LanguageEnumerator {
+private:
+    const CompiledDFA* dfa;
+    int maxLength;                          // -1 = unbounded
+    int longestWord;                        // -1 = infinite or empty language
+    QVector<QVector<bool>> reachesFinalIn;  // [k][state], grown on demand
+    QVector<int> distanceToFinal;           // shortest suffix length, -1 = dead
+
+    // DFS cursor for the current length
+    int currentLength;
+    bool lengthStarted;
+    bool hasPending;
+    bool pendingPop;
+    bool finished;
+    QVector<int> stateStack;
+    QVector<int> nextSymbolStack;
+    QVector<int> wordSymbols;
+
+public:
+    explicit LanguageEnumerator(const CompiledDFA* dfa, int maxLength = -1);
+
+    bool hasNext();
+    QString next();
+    QVector<QString> take(int count);
+    void reset();
+
+    // Longest accepted word length, -1 if the language is infinite or empty
+    int getLongestWordLength() const { return longestWord; }
+    bool canReachFinalWithin(int state, int steps) const;
+
+    // Shortest (then lexicographically smallest) suffix from state to acceptance
+    QString shortestWitness(int state, bool* found = nullptr) const;
+    // One accepted word through every useful state, keyed by state id
+    QMap<QString, QString> witnessesPerState() const;
+
+private:
+    void computeDistances();
+    void computeLongestWord();
+    void ensureTable(int length);
+    bool advance();
+    QString currentWord() const;
+};
+
+#endif // LANGUAGEENUMERATOR_H
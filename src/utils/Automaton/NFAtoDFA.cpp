@@ -37,9 +37,7 @@ Automaton* NFAtoDFA::convert(const Automaton* nfa) {
         }
     }
 
-    State initialState(initialStateId, initialStateId, QPointF(100, 100));
-    initialState.setIsInitial(true);
-    initialState.setIsFinal(initialIsFinal);
+    State initialState(initialStateId, State::Initial | (initialIsFinal ? State::Final : 0));
     dfa->addState(initialState);
     dfa->setInitialState(initialStateId);
 
@@ -70,9 +68,7 @@ Automaton* NFAtoDFA::convert(const Automaton* nfa) {
                     }
                 }
 
-                State newState(nextId, nextId, QPointF(0, 0));
-                newState.setIsFinal(isFinal);
-                dfa->addState(newState);
+                dfa->addState(State(nextId, isFinal ? State::Final : 0));
             }
 
             Transition trans(currentId, nextId, symbol);
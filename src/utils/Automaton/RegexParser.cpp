@@ -0,0 +1,323 @@
+#include "RegexParser.h"
+#include <algorithm>
+
+RegexParser::RegexParser()
+    : pos(0), tree(nullptr) {}
+
+QString RegexParser::printableAlphabet() {
+    QString chars = "\t";
+    for (ushort c = 0x20; c <= 0x7E; ++c) {
+        chars += QChar(c);
+    }
+    return chars;
+}
+
+bool RegexParser::parse(const QString& regex, RegexTree& result, QString* errorMsg) {
+    pattern = regex;
+    pos = 0;
+    error.clear();
+    result = RegexTree();
+    tree = &result;
+
+    int root = parseUnion();
+    if (root >= 0 && !atEnd()) {
+        fail(peek() == ')' ? "Unmatched ')'" : QString("Unexpected '%1'").arg(peek()));
+        root = -1;
+    }
+
+    tree = nullptr;
+    if (root < 0) {
+        result = RegexTree();
+        if (errorMsg) *errorMsg = error;
+        return false;
+    }
+
+    result.root = root;
+    return true;
+}
+
+int RegexParser::parseUnion() {
+    QVector<int> alternatives;
+    int first = parseConcat();
+    if (first < 0) return -1;
+    alternatives.append(first);
+
+    while (!atEnd() && peek() == '|') {
+        ++pos;
+        int next = parseConcat();
+        if (next < 0) return -1;
+        alternatives.append(next);
+    }
+
+    return alternatives.size() == 1 ? first : addNode(RegexNode::Type::Union, QString(), alternatives);
+}
+
+int RegexParser::parseConcat() {
+    QVector<int> parts;
+    while (!atEnd() && peek() != '|' && peek() != ')') {
+        int part = parseRepeat();
+        if (part < 0) return -1;
+        parts.append(part);
+    }
+
+    if (parts.isEmpty()) {
+        return addNode(RegexNode::Type::Empty);
+    }
+    return parts.size() == 1 ? parts.first() : addNode(RegexNode::Type::Concat, QString(), parts);
+}
+
+int RegexParser::parseRepeat() {
+    int node = parseAtom();
+    if (node < 0) return -1;
+
+    while (!atEnd()) {
+        QChar c = peek();
+        if (c == '*') {
+            ++pos;
+            node = addNode(RegexNode::Type::Star, QString(), {node});
+        } else if (c == '+') {
+            ++pos;
+            node = addNode(RegexNode::Type::Plus, QString(), {node});
+        } else if (c == '?') {
+            ++pos;
+            node = addNode(RegexNode::Type::Optional, QString(), {node});
+        } else if (c == '{') {
+            int min = 0, max = 0;
+            if (!parseBounds(min, max)) return -1;
+            node = repeatNode(node, min, max);
+        } else {
+            break;
+        }
+    }
+    return node;
+}
+
+int RegexParser::parseAtom() {
+    QChar c = peek();
+
+    if (c == '(') {
+        ++pos;
+        int inner = parseUnion();
+        if (inner < 0) return -1;
+        if (atEnd() || peek() != ')') {
+            fail("Missing ')'");
+            return -1;
+        }
+        ++pos;
+        return inner;
+    }
+    if (c == '*' || c == '+' || c == '?' || c == '{') {
+        fail(QString("Nothing to repeat before '%1'").arg(c));
+        return -1;
+    }
+
+    QString chars;
+    if (c == '[') {
+        if (!parseClass(chars)) return -1;
+    } else if (c == '\\') {
+        if (!parseEscape(chars)) return -1;
+    } else if (c == '.') {
+        ++pos;
+        chars = printableAlphabet();
+    } else {
+        ++pos;
+        chars = c;
+    }
+    return addNode(RegexNode::Type::CharSet, normalizeSet(chars));
+}
+
+bool RegexParser::parseClass(QString& chars) {
+    ++pos; // '['
+    bool negated = false;
+    if (!atEnd() && peek() == '^') {
+        negated = true;
+        ++pos;
+    }
+
+    QString members;
+    while (!atEnd() && peek() != ']') {
+        QString item;
+        if (peek() == '\\') {
+            if (!parseEscape(item)) return false;
+        } else {
+            item = peek();
+            ++pos;
+        }
+
+        // Range a-z, only between two single characters
+        bool isRange = item.size() == 1 && pos + 1 < pattern.size() &&
+                       peek() == '-' && pattern[pos + 1] != ']';
+        if (isRange) {
+            ++pos;
+            QString upper;
+            if (peek() == '\\') {
+                if (!parseEscape(upper)) return false;
+            } else {
+                upper = peek();
+                ++pos;
+            }
+            if (upper.size() != 1 || upper[0] < item[0]) {
+                return fail("Invalid character range");
+            }
+            for (ushort u = item[0].unicode(); u <= upper[0].unicode(); ++u) {
+                members += QChar(u);
+            }
+        } else {
+            members += item;
+        }
+    }
+
+    if (atEnd()) {
+        return fail("Missing ']'");
+    }
+    ++pos; // ']'
+
+    chars = negated ? complementSet(normalizeSet(members)) : members;
+    if (chars.isEmpty()) {
+        return fail("Character class matches nothing");
+    }
+    return true;
+}
+
+bool RegexParser::parseEscape(QString& chars) {
+    ++pos; // '\'
+    if (atEnd()) {
+        return fail("Pattern ends with '\\'");
+    }
+
+    QChar c = peek();
+    ++pos;
+
+    QString digits = "0123456789";
+    QString word = digits + "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz_";
+    QString space = " \t\n\r";
+
+    switch (c.unicode()) {
+    case 'd': chars = digits; break;
+    case 'w': chars = word; break;
+    case 's': chars = space; break;
+    case 'D': chars = complementSet(digits); break;
+    case 'W': chars = complementSet(normalizeSet(word)); break;
+    case 'S': chars = complementSet(normalizeSet(space)); break;
+    case 'n': chars = "\n"; break;
+    case 't': chars = "\t"; break;
+    case 'r': chars = "\r"; break;
+    default:  chars = c; break;
+    }
+
+    return true;
+}
+
+bool RegexParser::parseBounds(int& min, int& max) {
+    int start = pos;
+    ++pos; // '{'
+
+    auto readNumber = [this](int& value) {
+        int begin = pos;
+        value = 0;
+        while (!atEnd() && peek().isDigit()) {
+            value = value * 10 + peek().digitValue();
+            if (value > MaxRepeat) return false;
+            ++pos;
+        }
+        return pos > begin;
+    };
+
+    if (!readNumber(min)) {
+        pos = start;
+        return fail(QString("Invalid repetition bound (at most %1)").arg(MaxRepeat));
+    }
+    max = min;
+    if (!atEnd() && peek() == ',') {
+        ++pos;
+        if (!atEnd() && peek() == '}') {
+            max = -1; // unbounded
+        } else if (!readNumber(max)) {
+            return fail(QString("Invalid repetition bound (at most %1)").arg(MaxRepeat));
+        }
+    }
+    if (atEnd() || peek() != '}') {
+        return fail("Missing '}'");
+    }
+    ++pos;
+
+    if (max >= 0 && max < min) {
+        return fail("Repetition {m,n} needs m <= n");
+    }
+    return true;
+}
+
+int RegexParser::addNode(RegexNode::Type type, const QString& chars, const QVector<int>& children) {
+    RegexNode node;
+    node.type = type;
+    node.chars = chars;
+    node.children = children;
+    tree->nodes.append(node);
+    return tree->nodes.size() - 1;
+}
+
+int RegexParser::cloneNode(int node) {
+    RegexNode copy = tree->nodes[node];
+    for (int& child : copy.children) {
+        child = cloneNode(child);
+    }
+    return addNode(copy.type, copy.chars, copy.children);
+}
+
+int RegexParser::repeatNode(int node, int min, int max) {
+    // e{m,n} = e^m (e (e ...)?)? -- nesting keeps the position automaton linear
+    QVector<int> parts;
+    for (int i = 0; i < min; ++i) {
+        parts.append(i == 0 ? node : cloneNode(node));
+    }
+
+    if (max < 0) {
+        int loop = min == 0 ? node : cloneNode(node);
+        parts.append(addNode(RegexNode::Type::Star, QString(), {loop}));
+    } else if (max > min) {
+        int tail = -1;
+        for (int i = max - min; i > 0; --i) {
+            int copy = (min == 0 && i == 1) ? node : cloneNode(node);
+            int body = tail < 0 ? copy : addNode(RegexNode::Type::Concat, QString(), {copy, tail});
+            tail = addNode(RegexNode::Type::Optional, QString(), {body});
+        }
+        parts.append(tail);
+    }
+
+    if (parts.isEmpty()) {
+        return addNode(RegexNode::Type::Empty);
+    }
+    return parts.size() == 1 ? parts.first() : addNode(RegexNode::Type::Concat, QString(), parts);
+}
+
+bool RegexParser::fail(const QString& message) {
+    if (error.isEmpty()) {
+        error = QString("%1 at position %2").arg(message).arg(pos);
+    }
+    return false;
+}
+
+QString RegexParser::normalizeSet(const QString& chars) {
+    QVector<QChar> sorted;
+    for (QChar c : chars) {
+        sorted.append(c);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    QString result;
+    for (QChar c : sorted) {
+        result += c;
+    }
+    return result;
+}
+
+QString RegexParser::complementSet(const QString& chars) {
+    QString result;
+    for (QChar c : printableAlphabet()) {
+        if (!chars.contains(c)) {
+            result += c;
+        }
+    }
+    return result;
+}
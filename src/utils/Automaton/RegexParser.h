@@ -0,0 +1,72 @@
+#ifndef REGEXPARSER_H
+#define REGEXPARSER_H
+
+#include <QString>
+#include <QVector>
+
+struct RegexNode {
+    enum class Type {
+        Empty,      // matches only the empty word
+        CharSet,    // one character out of chars
+        Concat,
+        Union,
+        Star,
+        Plus,
+        Optional
+    };
+
+    Type type;
+    QString chars;              // CharSet: sorted, no duplicates
+    QVector<int> children;      // indices into RegexTree::nodes
+};
+
+// Parsed expression stored as a flat node array; root indexes into nodes
+struct RegexTree {
+    QVector<RegexNode> nodes;
+    int root = -1;
+
+    bool isEmpty() const { return root < 0; }
+};
+
+// Recursive-descent parser for the usual regex syntax:
+//   a|b  ab  a*  a+  a?  a{m}  a{m,}  a{m,n}  (..)  .  [a-z_]  [^0-9]
+//   escapes \d \w \s \D \W \S \n \t \r and \<any char> for a literal.
+// '.' and negated classes range over printable ASCII plus tab.
+class RegexParser {
+public:
+    static const int MaxRepeat = 1000;
+
+    RegexParser();
+
+    bool parse(const QString& pattern, RegexTree& tree, QString* errorMsg = nullptr);
+
+    static QString printableAlphabet();
+
+private:
+    QString pattern;
+    int pos;
+    RegexTree* tree;
+    QString error;
+
+    int parseUnion();
+    int parseConcat();
+    int parseRepeat();
+    int parseAtom();
+    bool parseClass(QString& chars);
+    bool parseEscape(QString& chars);
+    bool parseBounds(int& min, int& max);
+
+    int addNode(RegexNode::Type type, const QString& chars = QString(),
+                const QVector<int>& children = QVector<int>());
+    int cloneNode(int node);
+    int repeatNode(int node, int min, int max);
+
+    bool atEnd() const { return pos >= pattern.size(); }
+    QChar peek() const { return pattern[pos]; }
+    bool fail(const QString& message);
+
+    static QString normalizeSet(const QString& chars);
+    static QString complementSet(const QString& chars);
+};
+
+#endif // REGEXPARSER_H
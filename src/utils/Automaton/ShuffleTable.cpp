@@ -0,0 +1,155 @@
+#include "ShuffleTable.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#define SHUFFLE_KERNEL __attribute__((target("ssse3")))
+#define HAVE_SHUFFLE_KERNEL
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <tmmintrin.h>
+#include <intrin.h>
+#define SHUFFLE_KERNEL
+#define HAVE_SHUFFLE_KERNEL
+#endif
+
+// Characters per block; each of the four segments composes a quarter of it
+static const int BLOCK_SIZE = 256;
+static const int SEGMENTS = 4;
+static const quint8 NO_CLASS = 0xFF;
+
+ShuffleTable::ShuffleTable()
+    : stateCount(0), deadLane(-1) {}
+
+void ShuffleTable::clear() {
+    stateCount = 0;
+    deadLane = -1;
+    functions.clear();
+    asciiClass.clear();
+    otherClass.clear();
+}
+
+bool ShuffleTable::isSupported() {
+#if defined(HAVE_SHUFFLE_KERNEL) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#elif defined(HAVE_SHUFFLE_KERNEL)
+    return __builtin_cpu_supports("ssse3");
+#else
+    return false;
+#endif
+}
+
+void ShuffleTable::build(const QVector<int>& dense, int rows, int columns,
+                         const QVector<QString>& symbols) {
+    clear();
+    if (rows <= 0 || rows > MaxStates || columns <= 0 || columns >= NO_CLASS || !isSupported()) {
+        return;
+    }
+
+    // Missing transitions need a lane of their own that maps to itself
+    int dead = dense.contains(-1) ? rows : -1;
+    if (dead >= MaxStates) {
+        return;
+    }
+
+    functions.fill(0, columns * 16);
+    for (int c = 0; c < columns; ++c) {
+        quint8* lanes = functions.data() + c * 16;
+        for (int lane = 0; lane < 16; ++lane) {
+            int target = lane < rows ? dense[lane * columns + c] : lane;
+            lanes[lane] = quint8(target < 0 ? dead : target);
+        }
+    }
+
+    asciiClass.fill(NO_CLASS, 128);
+    for (int c = 0; c < columns; ++c) {
+        if (symbols[c].size() != 1) continue;
+        ushort code = symbols[c][0].unicode();
+        if (code < 128) asciiClass[code] = quint8(c);
+        else otherClass.insert(code, quint8(c));
+    }
+
+    stateCount = rows;
+    deadLane = dead;
+}
+
+#ifdef HAVE_SHUFFLE_KERNEL
+
+SHUFFLE_KERNEL
+static int runShuffle(int state, int deadLane, const quint8* functions, const quint8* asciiClass,
+                      const QHash<ushort, quint8>& otherClass, const QChar* text, int length) {
+    const __m128i identity = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const int segmentSize = BLOCK_SIZE / SEGMENTS;
+
+    auto classOf = [&](QChar ch) -> quint8 {
+        ushort code = ch.unicode();
+        return code < 128 ? asciiClass[code] : otherClass.value(code, NO_CLASS);
+    };
+    auto functionOf = [&](quint8 c) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(functions + c * 16));
+    };
+    auto apply = [](const __m128i& f, int lane) {
+        alignas(16) quint8 lanes[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), f);
+        return int(lanes[lane]);
+    };
+
+    int i = 0;
+    for (; i + BLOCK_SIZE <= length; i += BLOCK_SIZE) {
+        const QChar* block = text + i;
+        __m128i f0 = identity, f1 = identity, f2 = identity, f3 = identity;
+        quint8 unknown = 0;
+
+        for (int k = 0; k < segmentSize; ++k) {
+            quint8 c0 = classOf(block[k]);
+            quint8 c1 = classOf(block[segmentSize + k]);
+            quint8 c2 = classOf(block[2 * segmentSize + k]);
+            quint8 c3 = classOf(block[3 * segmentSize + k]);
+            unknown |= quint8((c0 == NO_CLASS) | (c1 == NO_CLASS) | (c2 == NO_CLASS) | (c3 == NO_CLASS));
+            if (unknown) break;
+
+            // f <- T[c] . f, i.e. f[lane] = T[c][f[lane]]
+            f0 = _mm_shuffle_epi8(functionOf(c0), f0);
+            f1 = _mm_shuffle_epi8(functionOf(c1), f1);
+            f2 = _mm_shuffle_epi8(functionOf(c2), f2);
+            f3 = _mm_shuffle_epi8(functionOf(c3), f3);
+        }
+        if (unknown) {
+            return -1;
+        }
+
+        // Segment 0 is read first, so it is applied innermost
+        __m128i blockFunction = _mm_shuffle_epi8(f3, _mm_shuffle_epi8(f2, _mm_shuffle_epi8(f1, f0)));
+        state = apply(blockFunction, state);
+        if (state == deadLane) {
+            return -1;
+        }
+    }
+
+    // Tail shorter than a block: one chain
+    __m128i f = identity;
+    for (; i < length; ++i) {
+        quint8 c = classOf(text[i]);
+        if (c == NO_CLASS) {
+            return -1;
+        }
+        f = _mm_shuffle_epi8(functionOf(c), f);
+    }
+    state = apply(f, state);
+    return state == deadLane ? -1 : state;
+}
+
+#endif
+
+int ShuffleTable::run(int state, const QString& input) const {
+    if (isEmpty() || state < 0) {
+        return -1;
+    }
+#ifdef HAVE_SHUFFLE_KERNEL
+    return runShuffle(state, deadLane, functions.constData(), asciiClass.constData(), otherClass,
+                      input.constData(), input.size());
+#else
+    Q_UNUSED(input);
+    return -1;
+#endif
+}
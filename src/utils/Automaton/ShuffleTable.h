@@ -0,0 +1,40 @@
+#ifndef SHUFFLETABLE_H
+#define SHUFFLETABLE_H
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+// Byte-shuffle execution of DFAs with at most 16 states. Each symbol class
+// stores its transition function as 16 bytes (lane s = next state), so one
+// pshufb composes it onto the function of everything read so far. Because
+// composition is associative, a block of input is split into independent
+// segments whose functions are built side by side and then combined, which
+// keeps several shuffles in flight instead of one dependent table load per
+// character. Only built when the CPU supports SSSE3; otherwise isEmpty()
+// stays true and the caller keeps using its table.
+class ShuffleTable {
+private:
+    int stateCount;
+    int deadLane;                      // lane standing for "no transition", -1 if the table is complete
+    QVector<quint8> functions;         // 16 bytes per class
+    QVector<quint8> asciiClass;        // character -> class, 0xFF = not in the alphabet
+    QHash<ushort, quint8> otherClass;
+
+public:
+    static const int MaxStates = 16;
+
+    ShuffleTable();
+
+    // dense is row-major rows x columns (-1 = dead); symbols gives each column's symbol
+    void build(const QVector<int>& dense, int rows, int columns, const QVector<QString>& symbols);
+    void clear();
+
+    bool isEmpty() const { return stateCount == 0; }
+    static bool isSupported();
+
+    // Final state after reading input from state, -1 once the run dies
+    int run(int state, const QString& input) const;
+};
+
+#endif // SHUFFLETABLE_H
@@ -0,0 +1,117 @@
+#include "StateLayout.h"
+#include <QQueue>
+#include <QPair>
+#include <algorithm>
+
+QVector<int> StateLayout::creationOrder(const CompiledDFA& dfa) {
+    QVector<int> order(dfa.getStateCount());
+    for (int s = 0; s < order.size(); ++s) {
+        order[s] = s;
+    }
+    return order;
+}
+
+void StateLayout::appendUnvisited(QVector<int>& order, QVector<bool>& visited) {
+    for (int s = 0; s < visited.size(); ++s) {
+        if (!visited[s]) {
+            visited[s] = true;
+            order.append(s);
+        }
+    }
+}
+
+QVector<int> StateLayout::breadthFirstOrder(const CompiledDFA& dfa) {
+    QVector<int> order;
+    if (dfa.isEmpty()) {
+        return order;
+    }
+
+    int n = dfa.getStateCount();
+    order.reserve(n);
+    QVector<bool> visited(n, false);
+    QQueue<int> queue;
+    visited[dfa.getInitialState()] = true;
+    queue.enqueue(dfa.getInitialState());
+
+    while (!queue.isEmpty()) {
+        int s = queue.dequeue();
+        order.append(s);
+        for (int c = 0; c < dfa.getSymbolCount(); ++c) {
+            int t = dfa.next(s, c);
+            if (t >= 0 && !visited[t]) {
+                visited[t] = true;
+                queue.enqueue(t);
+            }
+        }
+    }
+
+    appendUnvisited(order, visited);
+    return order;
+}
+
+QVector<int> StateLayout::depthFirstOrder(const CompiledDFA& dfa) {
+    QVector<int> order;
+    if (dfa.isEmpty()) {
+        return order;
+    }
+
+    int n = dfa.getStateCount();
+    order.reserve(n);
+    QVector<bool> visited(n, false);
+
+    // Explicit stack of (state, next symbol) so deep DFAs cannot overflow
+    QVector<QPair<int, int>> stack;
+    visited[dfa.getInitialState()] = true;
+    order.append(dfa.getInitialState());
+    stack.append(qMakePair(dfa.getInitialState(), 0));
+
+    while (!stack.isEmpty()) {
+        QPair<int, int>& top = stack.last();
+        if (top.second >= dfa.getSymbolCount()) {
+            stack.removeLast();
+            continue;
+        }
+        int t = dfa.next(top.first, top.second++);
+        if (t >= 0 && !visited[t]) {
+            visited[t] = true;
+            order.append(t);
+            stack.append(qMakePair(t, 0));
+        }
+    }
+
+    appendUnvisited(order, visited);
+    return order;
+}
+
+QVector<quint64> StateLayout::collectProfile(const CompiledDFA& dfa, const QVector<QString>& samples) {
+    QVector<quint64> counts(dfa.getStateCount(), 0);
+    if (dfa.isEmpty()) {
+        return counts;
+    }
+
+    for (const auto& sample : samples) {
+        int state = dfa.getInitialState();
+        counts[state]++;
+        for (const QChar& ch : sample) {
+            int symbol = dfa.classOf(ch);
+            state = symbol < 0 ? -1 : dfa.next(state, symbol);
+            if (state < 0) {
+                break;
+            }
+            counts[state]++;
+        }
+    }
+    return counts;
+}
+
+QVector<int> StateLayout::profileOrder(const CompiledDFA& dfa, const QVector<quint64>& visitCounts) {
+    QVector<int> order = breadthFirstOrder(dfa);
+    if (visitCounts.size() != dfa.getStateCount()) {
+        return order;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&visitCounts](int a, int b) {
+        return visitCounts[a] > visitCounts[b];
+    });
+    return order;
+}
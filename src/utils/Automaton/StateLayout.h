@@ -0,0 +1,25 @@
+#ifndef STATELAYOUT_H
+#define STATELAYOUT_H
+
+#include "CompiledDFA.h"
+#include <QVector>
+#include <QString>
+
+// State orderings for CompiledDFA::renumber. Every order is a full
+// permutation: states unreachable from the initial state go last.
+class StateLayout {
+public:
+    static QVector<int> creationOrder(const CompiledDFA& dfa);
+    static QVector<int> breadthFirstOrder(const CompiledDFA& dfa);
+    static QVector<int> depthFirstOrder(const CompiledDFA& dfa);
+
+    // Profile-guided layout: count state visits over sample runs, then
+    // place hot states first (ties keep BFS order)
+    static QVector<quint64> collectProfile(const CompiledDFA& dfa, const QVector<QString>& samples);
+    static QVector<int> profileOrder(const CompiledDFA& dfa, const QVector<quint64>& visitCounts);
+
+private:
+    static void appendUnvisited(QVector<int>& order, QVector<bool>& visited);
+};
+
+#endif // STATELAYOUT_H
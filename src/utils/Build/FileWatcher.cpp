@@ -0,0 +1,132 @@
+#include "FileWatcher.h"
+#include <QFileInfo>
+#include <QThread>
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifdef Q_OS_LINUX
+
+FileWatcher::FileWatcher() : inotifyFd(inotify_init1(IN_CLOEXEC)) {
+}
+
+FileWatcher::~FileWatcher() {
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+}
+
+bool FileWatcher::isValid() const {
+    return inotifyFd >= 0;
+}
+
+bool FileWatcher::addPath(const QString& filePath, QString* errorMsg) {
+    if (!isValid()) {
+        if (errorMsg) *errorMsg = QString("inotify unavailable: %1").arg(strerror(errno));
+        return false;
+    }
+
+    QFileInfo info(filePath);
+    QString directory = info.absolutePath();
+    if (!watchedDirectories.contains(directory)) {
+        int wd = inotify_add_watch(inotifyFd, directory.toLocal8Bit().constData(),
+                                   IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+        if (wd < 0) {
+            if (errorMsg) *errorMsg = QString("Cannot watch %1: %2").arg(directory, strerror(errno));
+            return false;
+        }
+        directories.insert(wd, directory);
+        watchedDirectories.insert(directory);
+    }
+
+    files.insert(info.absoluteFilePath());
+    return true;
+}
+
+bool FileWatcher::readEvents(int timeoutMs, QSet<QString>& changed) {
+    pollfd pfd;
+    pfd.fd = inotifyFd;
+    pfd.events = POLLIN;
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) {
+        return false;
+    }
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+    if (length <= 0) {
+        return false;
+    }
+
+    for (char* p = buffer; p < buffer + length; ) {
+        const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+        p += sizeof(inotify_event) + event->len;
+        if (event->len == 0 || !directories.contains(event->wd)) {
+            continue;
+        }
+
+        QString path = directories.value(event->wd) + "/" + QString::fromLocal8Bit(event->name);
+        if (files.contains(path)) {
+            changed.insert(path);
+        }
+    }
+    return true;
+}
+
+QStringList FileWatcher::waitForChanges(int settleMs) {
+    QSet<QString> changed;
+    while (changed.isEmpty()) {
+        if (!readEvents(-1, changed) && errno != EINTR) {
+            return QStringList();
+        }
+    }
+    while (readEvents(settleMs, changed)) {
+    }
+
+    QStringList result = changed.values();
+    result.sort();
+    return result;
+}
+
+#else
+
+FileWatcher::FileWatcher() {
+}
+
+FileWatcher::~FileWatcher() {
+}
+
+bool FileWatcher::isValid() const {
+    return true;
+}
+
+bool FileWatcher::addPath(const QString& filePath, QString* errorMsg) {
+    Q_UNUSED(errorMsg);
+    QFileInfo info(filePath);
+    files.insert(info.absoluteFilePath());
+    modified.insert(info.absoluteFilePath(), info.lastModified());
+    return true;
+}
+
+QStringList FileWatcher::waitForChanges(int settleMs) {
+    QStringList result;
+    while (result.isEmpty()) {
+        QThread::msleep(qMax(settleMs, 50));
+        for (const QString& path : files) {
+            QDateTime time = QFileInfo(path).lastModified();
+            if (time != modified.value(path)) {
+                modified.insert(path, time);
+                result.append(path);
+            }
+        }
+    }
+    result.sort();
+    return result;
+}
+
+#endif
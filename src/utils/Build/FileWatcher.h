@@ -0,0 +1,41 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QHash>
+#include <QDateTime>
+#include <QtGlobal>
+
+// Blocking change notifications for a set of files. On Linux the containing
+// directories are watched with inotify, so editors that save by writing a
+// temporary file and renaming it are seen too; elsewhere modification times
+// are polled.
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    bool isValid() const;
+    bool addPath(const QString& filePath, QString* errorMsg = nullptr);
+
+    // Blocks until a watched file changes, then keeps collecting until the
+    // directory has been quiet for settleMs so one save is one batch
+    QStringList waitForChanges(int settleMs = 15);
+
+private:
+    QSet<QString> files;                    // absolute paths
+
+#ifdef Q_OS_LINUX
+    int inotifyFd;
+    QHash<int, QString> directories;        // watch descriptor -> directory
+    QSet<QString> watchedDirectories;
+
+    bool readEvents(int timeoutMs, QSet<QString>& changed);
+#else
+    QHash<QString, QDateTime> modified;
+#endif
+};
+
+#endif // FILEWATCHER_H
@@ -0,0 +1,337 @@
+#include "IncrementalBuilder.h"
+#include "./src/utils/Grammar/ParserGenerator.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+IncrementalBuilder::IncrementalBuilder()
+    : targetLanguage(TargetLanguage::PYTHON), outputDirectory("."), optimizationLevel(0),
+      tuneCore(CoreModel::SKYLAKE), profileGenerate(false), rulesVersion(0) {
+    automatonManager = new AutomatonManager();
+    lexer = new Lexer(automatonManager);
+    lexer->setSkipWhitespace(true);
+    lexer->setSkipComments(true);
+    codeGenerator = new CodeGenerator();
+}
+
+IncrementalBuilder::~IncrementalBuilder() {
+    qDeleteAll(sources);
+    delete codeGenerator;
+    delete lexer;
+    delete automatonManager;
+}
+
+void IncrementalBuilder::addRulesFile(const QString& path) {
+    QString absolute = QFileInfo(path).absoluteFilePath();
+    if (!rulesFiles.contains(absolute)) {
+        rulesFiles.append(absolute);
+    }
+}
+
+void IncrementalBuilder::addGrammarFile(const QString& path) {
+    QString absolute = QFileInfo(path).absoluteFilePath();
+    if (!grammarHashes.contains(absolute)) {
+        grammarHashes.insert(absolute, QByteArray());
+    }
+}
+
+void IncrementalBuilder::addSourceFile(const QString& path) {
+    QString absolute = QFileInfo(path).absoluteFilePath();
+    if (!sources.contains(absolute)) {
+        sources.insert(absolute, new SourceState());
+    }
+}
+
+QStringList IncrementalBuilder::getInputs() const {
+    QStringList inputs = rulesFiles;
+    inputs += grammarHashes.keys();
+    inputs += sources.keys();
+    return inputs;
+}
+
+QString IncrementalBuilder::extensionFor(TargetLanguage lang) {
+    switch (lang) {
+    case TargetLanguage::PYTHON: return "py";
+    case TargetLanguage::JAVA: return "java";
+    case TargetLanguage::JAVASCRIPT: return "js";
+    case TargetLanguage::ASSEMBLY: return "s";
+    }
+    return "txt";
+}
+
+// ============================================================
+// Builds
+// ============================================================
+
+BuildReport IncrementalBuilder::buildAll() {
+    BuildReport report;
+    refreshRules(QStringList(), true, report);
+    for (const QString& path : grammarHashes.keys()) {
+        buildGrammar(path, true, report);
+    }
+    for (auto it = sources.begin(); it != sources.end(); ++it) {
+        buildSource(it.key(), it.value(), true, report);
+    }
+    return report;
+}
+
+BuildReport IncrementalBuilder::build(const QStringList& changedPaths) {
+    BuildReport report;
+
+    // A rule change can touch every token stream, but sources whose tokens
+    // come out the same are cut off after lexing
+    bool rulesChanged = refreshRules(changedPaths, false, report);
+
+    for (const QString& path : changedPaths) {
+        if (grammarHashes.contains(path)) {
+            buildGrammar(path, false, report);
+        }
+    }
+
+    for (auto it = sources.begin(); it != sources.end(); ++it) {
+        if (rulesChanged || changedPaths.contains(it.key())) {
+            buildSource(it.key(), it.value(), false, report);
+        }
+    }
+    return report;
+}
+
+// Reloads the token automata when a rules file's contents changed.
+// Returns true when the rule set (and so rulesVersion) changed.
+bool IncrementalBuilder::refreshRules(const QStringList& changedPaths, bool force, BuildReport& report) {
+    bool changed = force;
+    for (const QString& path : rulesFiles) {
+        if (!force && !changedPaths.contains(path)) {
+            continue;
+        }
+        QString text;
+        QByteArray hash;
+        readText(path, &text, &hash);
+        if (hash != rulesHashes.value(path)) {
+            rulesHashes.insert(path, hash);
+            changed = true;
+        }
+    }
+    if (!changed) {
+        return false;
+    }
+
+    automatonManager->clear();
+    automatonManager->createDefaultAutomatons();
+    for (const QString& path : rulesFiles) {
+        QString text;
+        if (!readText(path, &text, nullptr)) {
+            addDiagnostic(report, path, 0, "error", "cannot read rules file");
+            continue;
+        }
+
+        QStringList lines = text.split('\n');
+        for (int i = 0; i < lines.size(); ++i) {
+            QString line = lines[i].trimmed();
+            if (line.isEmpty() || line.startsWith("#")) {
+                continue;
+            }
+
+            int split = line.indexOf(' ');
+            if (split < 0) {
+                addDiagnostic(report, path, i + 1, "error", "expected '<automaton id> <regex>'");
+                continue;
+            }
+            QString id = line.left(split);
+            QString pattern = line.mid(split + 1).trimmed();
+
+            QString error;
+            if (automatonManager->exists(id)) {
+                automatonManager->removeAutomaton(id);
+            }
+            if (!automatonManager->addRegexAutomaton(id, id, pattern, &error)) {
+                addDiagnostic(report, path, i + 1, "error", error);
+            }
+        }
+    }
+
+    rulesVersion++;
+    return true;
+}
+
+void IncrementalBuilder::buildGrammar(const QString& path, bool force, BuildReport& report) {
+    QString text;
+    QByteArray hash;
+    if (!readText(path, &text, &hash)) {
+        addDiagnostic(report, path, 0, "error", "cannot read grammar");
+        return;
+    }
+    if (!force && hash == grammarHashes.value(path)) {
+        return;
+    }
+    grammarHashes.insert(path, hash);
+    report.grammars++;
+
+    Grammar grammar;
+    QString error;
+    QString className = QFileInfo(path).completeBaseName() + "Parser";
+    if (!ParserGenerator::parseGrammarText(text, grammar, &error)) {
+        addDiagnostic(report, path, 0, "error", error);
+        return;
+    }
+
+    ParserGenerator generator(grammar, className);
+    if (!generator.validate(&error)) {
+        addDiagnostic(report, path, 0, "error", error);
+        return;
+    }
+
+    writeIfChanged(outputPath(path, className + ".h"), generator.generateHeader(), report);
+    writeIfChanged(outputPath(path, className + ".cpp"), generator.generateSource(className + ".h"), report);
+}
+
+void IncrementalBuilder::buildSource(const QString& path, SourceState* state, bool force, BuildReport& report) {
+    QString text;
+    QByteArray textHash;
+    if (!readText(path, &text, &textHash)) {
+        addDiagnostic(report, path, 0, "error", "cannot read source");
+        return;
+    }
+    if (!force && textHash == state->textHash && state->rulesVersion == rulesVersion) {
+        return;
+    }
+
+    // Stage 1: lexing
+    state->text = text;
+    state->textHash = textHash;
+    state->rulesVersion = rulesVersion;
+    report.lexed++;
+
+    lexer->reset();
+    if (!lexer->tokenize(text)) {
+        for (const LexerError& error : lexer->getErrors()) {
+            addDiagnostic(report, path, error.line, "error", error.message);
+        }
+        state->tokensHash.clear();
+        return;
+    }
+
+    QVector<Token> tokens = lexer->getTokens();
+    QByteArray tokensHash = hashTokens(tokens);
+    if (!force && tokensHash == state->tokensHash && state->hasOutput) {
+        return;     // same token stream: analysis and output are still current
+    }
+    state->tokens = tokens;
+    state->tokensHash = tokensHash;
+
+    // Stage 2: semantic analysis
+    report.analyzed++;
+    state->analyzer.setTokens(tokens);
+    state->analyzer.analyzeProgram();
+    for (const SemanticError& error : state->analyzer.getErrors()) {
+        addDiagnostic(report, path, error.line, "error", error.message);
+    }
+    for (const SemanticError& warning : state->analyzer.getWarnings()) {
+        addDiagnostic(report, path, warning.line, "warning", warning.message);
+    }
+    if (state->analyzer.hasErrors()) {
+        state->hasOutput = false;
+        return;
+    }
+
+    // Stage 3: code generation
+    report.generated++;
+    QString baseName = QFileInfo(path).completeBaseName();
+    codeGenerator->reset();
+    codeGenerator->setTokens(tokens);
+    codeGenerator->setSymbolTable(state->analyzer.getSymbolTable());
+    codeGenerator->setTargetLanguage(targetLanguage);
+    codeGenerator->setOptimizationLevel(optimizationLevel);
+    codeGenerator->setTuneCore(tuneCore);
+    codeGenerator->setProfileInstrumentation(profileGenerate, QFileInfo(outputPath(path, baseName + ".prof")).absoluteFilePath());
+    codeGenerator->setProfiles(profiles);
+    codeGenerator->setSourceCode(text);
+    writeIfChanged(outputPath(path, baseName + "." + extensionFor(targetLanguage)), codeGenerator->generate(), report);
+    if (targetLanguage == TargetLanguage::ASSEMBLY && !profiles.isEmpty() && !profileGenerate &&
+        !codeGenerator->getProfileApplied()) {
+        addDiagnostic(report, path, 0, "warning", "no profile was recorded for this source; generated without one");
+    }
+    state->hasOutput = true;
+}
+
+// ============================================================
+// Helpers
+// ============================================================
+
+QString IncrementalBuilder::outputPath(const QString& inputPath, const QString& fileName) const {
+    // Directories are mirrored, so same-named inputs in different places get separate outputs
+    QString directory = QDir(inputRoot()).relativeFilePath(QFileInfo(inputPath).absolutePath());
+    QString relative = directory.isEmpty() || directory == "." ? fileName : directory + "/" + fileName;
+    return QDir::cleanPath(QDir(outputDirectory).filePath(relative));
+}
+
+QString IncrementalBuilder::inputRoot() const {
+    // Deepest directory holding every grammar and source, i.e. the one a
+    // single input or a flat file list is in
+    QString root;
+    for (const QString& path : grammarHashes.keys() + sources.keys()) {
+        QString directory = QFileInfo(path).absolutePath();
+        if (root.isNull()) {
+            root = directory;
+            continue;
+        }
+        while (directory != root && !directory.startsWith(root.endsWith('/') ? root : root + '/')) {
+            root = QFileInfo(root).absolutePath();
+        }
+    }
+    return root.isNull() ? QDir::currentPath() : root;
+}
+
+bool IncrementalBuilder::writeIfChanged(const QString& path, const QString& contents, BuildReport& report) {
+    QByteArray data = contents.toUtf8();
+
+    QFile existing(path);
+    if (existing.open(QIODevice::ReadOnly) && existing.readAll() == data) {
+        return true;
+    }
+    existing.close();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile output(path);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        addDiagnostic(report, path, 0, "error", "cannot write output");
+        return false;
+    }
+    output.write(data);
+    report.written++;
+    return true;
+}
+
+bool IncrementalBuilder::readText(const QString& path, QString* text, QByteArray* hash) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (hash) *hash = QByteArray();
+        return false;
+    }
+    QByteArray data = file.readAll();
+    if (hash) *hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    if (text) *text = QString::fromUtf8(data);
+    return true;
+}
+
+QByteArray IncrementalBuilder::hashTokens(const QVector<Token>& tokens) {
+    QByteArray data;
+    for (const Token& token : tokens) {
+        data.append(QByteArray::number(static_cast<int>(token.getType())));
+        data.append(' ');
+        data.append(QByteArray::number(token.getLine()));
+        data.append(' ');
+        data.append(token.getLexeme().toUtf8());
+        data.append('\n');
+    }
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+void IncrementalBuilder::addDiagnostic(BuildReport& report, const QString& path, int line,
+                                       const QString& kind, const QString& message) {
+    if (kind == "error") {
+        report.errors++;
+    }
+    report.diagnostics.append(QString("%1:%2: %3: %4").arg(path).arg(line).arg(kind, message));
+}
@@ -0,0 +1,100 @@
+#ifndef INCREMENTALBUILDER_H
+#define INCREMENTALBUILDER_H
+
+#include "./src/models/LexicalAnalysis/Token.h"
+#include "./src/utils/LexicalAnalysis/AutomatonManager.h"
+#include "./src/utils/LexicalAnalysis/Lexer.h"
+#include "./src/utils/Semantic/SemanticAnalyzer.h"
+#include "./src/utils/Semantic/CodeGenerator.h"
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QMap>
+
+// What one build did; stage counters only count stages that actually ran
+struct BuildReport {
+    int lexed = 0;
+    int analyzed = 0;
+    int generated = 0;
+    int grammars = 0;
+    int written = 0;                // output files whose contents changed
+    int errors = 0;
+    QStringList diagnostics;        // "file:line: error: message"
+};
+
+// Headless pipeline (lexer -> semantic analysis -> code generation for
+// sources, parser generation for grammars) that stays in memory between
+// builds. Every input is fingerprinted by content. A source is re-lexed when
+// its text or the token rules change; analysis and generation only re-run
+// when the resulting token stream differs, and outputs are only rewritten
+// when their contents change. Rule files feed every source's lexer; a
+// grammar only feeds its own generated parser.
+class IncrementalBuilder {
+public:
+    IncrementalBuilder();
+    ~IncrementalBuilder();
+
+    void setTargetLanguage(TargetLanguage lang) { targetLanguage = lang; }
+    void setOutputDirectory(const QString& dir) { outputDirectory = dir; }
+    void setOptimizationLevel(int level) { optimizationLevel = level; }
+    void setTuneCore(CoreModel core) { tuneCore = core; }
+    // Assembly output counts branches and loop trips into <output dir>/<name>.prof
+    void setProfileGenerate(bool enabled) { profileGenerate = enabled; }
+    // Each source uses the profiles recorded for its own token stream
+    void addProfile(const ProgramProfile& profile) { profiles.append(profile); }
+
+    // .rules: "<automaton id> <regex>" per line, e.g. "IDENTIFIER [a-z_][a-z0-9_]*"
+    void addRulesFile(const QString& path);
+    void addGrammarFile(const QString& path);
+    void addSourceFile(const QString& path);
+    QStringList getInputs() const;
+
+    BuildReport buildAll();
+    // Rebuilds only what depends on changedPaths (absolute paths)
+    BuildReport build(const QStringList& changedPaths);
+
+    static QString extensionFor(TargetLanguage lang);
+
+private:
+    struct SourceState {
+        QByteArray textHash;            // text the tokens were lexed from
+        int rulesVersion = -1;          // rule set the tokens were lexed with
+        QByteArray tokensHash;          // input of analysis and generation
+        QString text;
+        QVector<Token> tokens;
+        SemanticAnalyzer analyzer;      // kept for its symbol table
+        bool hasOutput = false;
+    };
+
+    TargetLanguage targetLanguage;
+    QString outputDirectory;
+    int optimizationLevel;
+    CoreModel tuneCore;
+    bool profileGenerate;
+    QVector<ProgramProfile> profiles;
+
+    QStringList rulesFiles;                     // in command-line order
+    QMap<QString, QByteArray> rulesHashes;
+    QMap<QString, QByteArray> grammarHashes;
+    QMap<QString, SourceState*> sources;
+    int rulesVersion;
+
+    AutomatonManager* automatonManager;
+    Lexer* lexer;
+    CodeGenerator* codeGenerator;
+
+    bool refreshRules(const QStringList& changedPaths, bool force, BuildReport& report);
+    void buildGrammar(const QString& path, bool force, BuildReport& report);
+    void buildSource(const QString& path, SourceState* state, bool force, BuildReport& report);
+
+    // <output dir>/<input's directory below inputRoot()>/<fileName>
+    QString outputPath(const QString& inputPath, const QString& fileName) const;
+    QString inputRoot() const;
+    bool writeIfChanged(const QString& path, const QString& contents, BuildReport& report);
+    static bool readText(const QString& path, QString* text, QByteArray* hash);
+    static QByteArray hashTokens(const QVector<Token>& tokens);
+    static void addDiagnostic(BuildReport& report, const QString& path, int line,
+                              const QString& kind, const QString& message);
+};
+
+#endif // INCREMENTALBUILDER_H
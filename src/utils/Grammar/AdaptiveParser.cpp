@@ -0,0 +1,657 @@
+#include "AdaptiveParser.h"
+#include "GrammarAnalyzer.h"
+#include <QMutex>
+#include <QStringList>
+#include <algorithm>
+#include <functional>
+
+// ============================================================
+//  SHARED MODEL
+// ============================================================
+
+struct AdaptiveParser::Model {
+    QString error;
+    int startRule = -1;
+    TerminalBinding binding;
+    int eofColumn = 0;                        // lookahead column of end of input
+
+    // Rules: the grammar's non-terminals, then one loop rule per left-recursive one
+    QVector<QString> ruleNames;
+    QVector<QVector<int>> alternatives;       // rule -> productions, in grammar order
+    QVector<int> loopRule;                    // rule -> its loop rule, -1 if none
+
+    // Productions: terminal index, or ~rule
+    QVector<int> owner;
+    QVector<QVector<int>> bodies;
+    QVector<bool> epsilon;                    // written as ε in the grammar
+
+    // ATN: one state per production position, plus the accept state
+    QVector<int> stateBase;                   // production -> state before its first symbol
+    QVector<int> stateProduction;
+    int acceptState = 0;
+    QVector<QVector<int>> followStates;       // rule -> states right after each use
+
+    struct DFAState {
+        QVector<Config> configs;
+        int prediction;                       // alternative, or -1
+        bool conflict;                        // SLL cannot decide; retry with full context
+        QVector<int> edges;                   // column -> DFA state, -1 unknown, -2 error
+    };
+    struct Decision {
+        int start = -1;
+        QVector<DFAState> states;
+        QHash<QByteArray, int> index;
+    };
+
+    // Guards decisions and stackNodes; everything above is fixed after build().
+    // Readers may look up stack nodes but only writers add them.
+    QReadWriteLock lock;
+    QVector<Decision> decisions;
+    QVector<QPair<int, int>> stackNodes;      // (return state, parent), node 0 is the empty stack
+    QHash<qint64, int> stackIndex;
+
+    void build(const Grammar& grammar);
+    int addProduction(int rule, const QVector<int>& body, bool isEpsilon);
+    bool isEndState(int state) const;
+    void checkLeftRecursion();
+};
+
+namespace {
+
+QMutex modelRegistryMutex;
+QHash<QString, std::weak_ptr<AdaptiveParser::Model>> modelRegistry;
+
+}
+
+int AdaptiveParser::Model::addProduction(int rule, const QVector<int>& body, bool isEpsilon) {
+    owner.append(rule);
+    bodies.append(body);
+    epsilon.append(isEpsilon);
+    alternatives[rule].append(owner.size() - 1);
+    return owner.size() - 1;
+}
+
+bool AdaptiveParser::Model::isEndState(int state) const {
+    int production = stateProduction[state];
+    return state - stateBase[production] == bodies[production].size();
+}
+
+void AdaptiveParser::Model::build(const Grammar& grammar) {
+    GrammarAnalyzer analyzer(grammar);
+    binding = TerminalBinding(analyzer.getTerminals());
+    eofColumn = binding.terminalCount();
+
+    QHash<QString, int> ruleIndex;
+    for (const QString& nonTerminal : analyzer.getNonTerminals()) {
+        ruleIndex.insert(nonTerminal, ruleNames.size());
+        ruleNames.append(nonTerminal);
+    }
+    if (!ruleIndex.contains(analyzer.getStartSymbol())) {
+        error = QString("Start symbol '%1' has no productions").arg(analyzer.getStartSymbol());
+        return;
+    }
+    startRule = ruleIndex.value(analyzer.getStartSymbol());
+    alternatives.resize(ruleNames.size());
+    loopRule.fill(-1, ruleNames.size());
+
+    int ruleCount = ruleNames.size();
+    for (int rule = 0; rule < ruleCount; ++rule) {
+        QVector<QVector<int>> bases, tails;
+        QVector<bool> baseEpsilon;
+        for (const Production& prod : analyzer.getProductions()) {
+            if (prod.getNonTerminal() != ruleNames[rule]) continue;
+
+            QVector<int> body;
+            for (const QString& symbol : GrammarAnalyzer::bodyOf(prod)) {
+                body.append(ruleIndex.contains(symbol) ? ~ruleIndex.value(symbol) : binding.indexOf(symbol));
+            }
+            if (!body.isEmpty() && body.first() == ~rule) {
+                if (body.size() == 1) {
+                    error = QString("%1 -> %1 is a cycle").arg(ruleNames[rule]);
+                    return;
+                }
+                tails.append(body.mid(1));
+            } else {
+                bases.append(body);
+                baseEpsilon.append(body.isEmpty());
+            }
+        }
+
+        if (tails.isEmpty()) {
+            for (int i = 0; i < bases.size(); ++i) addProduction(rule, bases[i], baseEpsilon[i]);
+            continue;
+        }
+        if (bases.isEmpty()) {
+            error = QString("Every alternative of %1 is left-recursive").arg(ruleNames[rule]);
+            return;
+        }
+
+        // A -> A a | b  becomes  A -> b A_loop,  A_loop -> a A_loop | (nothing)
+        int loop = ruleNames.size();
+        ruleNames.append(ruleNames[rule] + "_loop");
+        alternatives.append(QVector<int>());
+        loopRule[rule] = loop;
+        loopRule.append(-1);
+        for (int i = 0; i < bases.size(); ++i) addProduction(rule, bases[i] << ~loop, baseEpsilon[i]);
+        for (const QVector<int>& tail : tails) addProduction(loop, QVector<int>(tail) << ~loop, false);
+        addProduction(loop, QVector<int>(), false);
+    }
+
+    followStates.resize(ruleNames.size());
+    for (int p = 0; p < bodies.size(); ++p) {
+        stateBase.append(stateProduction.size());
+        for (int dot = 0; dot <= bodies[p].size(); ++dot) {
+            stateProduction.append(p);
+            if (dot > 0 && bodies[p][dot - 1] < 0) {
+                followStates[~bodies[p][dot - 1]].append(stateProduction.size() - 1);
+            }
+        }
+    }
+    acceptState = stateProduction.size();
+
+    checkLeftRecursion();
+    decisions.resize(ruleNames.size());
+    stackNodes.append(qMakePair(-1, -1));
+}
+
+void AdaptiveParser::Model::checkLeftRecursion() {
+    // Prediction closure would not terminate on indirect or hidden left recursion
+    QVector<bool> nullable(ruleNames.size(), false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int p = 0; p < bodies.size(); ++p) {
+            if (nullable[owner[p]]) continue;
+            bool all = true;
+            for (int symbol : bodies[p]) {
+                if (symbol >= 0 || !nullable[~symbol]) { all = false; break; }
+            }
+            if (all) {
+                nullable[owner[p]] = true;
+                changed = true;
+            }
+        }
+    }
+
+    QVector<QVector<int>> leftCorners(ruleNames.size());
+    for (int p = 0; p < bodies.size(); ++p) {
+        for (int symbol : bodies[p]) {
+            if (symbol >= 0) break;
+            leftCorners[owner[p]].append(~symbol);
+            if (!nullable[~symbol]) break;
+        }
+    }
+
+    // 0 = unvisited, 1 = on the DFS path, 2 = done
+    QVector<int> mark(ruleNames.size(), 0);
+    std::function<bool(int)> visit = [&](int rule) {
+        mark[rule] = 1;
+        for (int next : leftCorners[rule]) {
+            if (mark[next] == 1) {
+                error = QString("Left recursion through %1 is only supported in the direct form A -> A ...")
+                            .arg(ruleNames[next]);
+                return false;
+            }
+            if (mark[next] == 0 && !visit(next)) return false;
+        }
+        mark[rule] = 2;
+        return true;
+    };
+    for (int rule = 0; rule < ruleNames.size() && error.isEmpty(); ++rule) {
+        if (mark[rule] == 0) visit(rule);
+    }
+}
+
+AdaptiveParser::AdaptiveParser(const Grammar& grammar)
+    : grammarName(grammar.getName()), tokens(nullptr), position(0), end(0), localStackBase(0),
+      dfaHits(0), fullContextPredictions(0) {
+    QString key = grammar.getStartSymbol();
+    for (const Production& prod : grammar.getProductions()) {
+        key += "\n" + prod.toString();
+    }
+
+    QMutexLocker locker(&modelRegistryMutex);
+    model = modelRegistry.value(key).lock();
+    if (!model) {
+        // Grammars no parser uses any more leave expired entries behind
+        for (auto it = modelRegistry.begin(); it != modelRegistry.end();) {
+            if (it.value().expired()) {
+                it = modelRegistry.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        model = std::make_shared<Model>();
+        model->build(grammar);
+        modelRegistry.insert(key, model);
+    }
+}
+
+bool AdaptiveParser::isValid() const {
+    return model->error.isEmpty();
+}
+
+QString AdaptiveParser::getGrammarError() const {
+    return model->error;
+}
+
+int AdaptiveParser::getDFAStateCount() const {
+    model->lock.lockForRead();
+    int count = 0;
+    for (const auto& decision : model->decisions) {
+        count += decision.states.size();
+    }
+    model->lock.unlock();
+    return count;
+}
+
+// ============================================================
+//  PARSING
+// ============================================================
+
+ParseTree AdaptiveParser::parse(const QVector<Token>& input) {
+    tokens = &input;
+    position = 0;
+    end = Token::inputLength(input);
+    callStack.clear();
+    errors.clear();
+    dfaHits = 0;
+    fullContextPredictions = 0;
+
+    ParseTree tree(grammarName);
+    if (!isValid()) {
+        errors.append(ParseError(model->error, 0, "", ""));
+        return tree;
+    }
+    if (input.isEmpty()) {
+        addError("Empty token stream", "tokens");
+        return tree;
+    }
+
+    lookahead = model->binding.bindTokens(input);
+    tree.setRoot(parseRule(model->startRule));
+    if (position < end) {
+        addError("Unexpected input after " + model->ruleNames[model->startRule], "EOF");
+    }
+    return tree;
+}
+
+std::shared_ptr<ParseTreeNode> AdaptiveParser::parseRule(int rule) {
+    const QVector<int>& alts = model->alternatives[rule];
+    auto node = std::make_shared<ParseTreeNode>(model->ruleNames[rule], false);
+
+    int alt = alts.size() == 1 ? 0 : predict(rule);
+    if (alt < 0) {
+        QStringList expected = expectedTerminals(rule);
+        addError("Expected one of: " + expected.join(" "), expected.join(" | "));
+        return node;
+    }
+
+    int loop = model->loopRule[rule];
+    parseBody(alts[alt], node, loop >= 0);
+    if (loop < 0) {
+        return node;
+    }
+
+    // Each pass through the loop rule wraps the tree so far: E -> E + T
+    while (true) {
+        int next = predict(loop);
+        if (next < 0) break;
+        int production = model->alternatives[loop][next];
+        if (model->bodies[production].isEmpty()) break;
+
+        auto wrapper = std::make_shared<ParseTreeNode>(model->ruleNames[rule], false);
+        wrapper->addChild(node);
+        parseBody(production, wrapper, true);
+        node = wrapper;
+    }
+    return node;
+}
+
+void AdaptiveParser::parseBody(int production, const std::shared_ptr<ParseTreeNode>& node, bool stopAtTail) {
+    const QVector<int>& body = model->bodies[production];
+    if (model->epsilon[production]) {
+        node->addChild(std::make_shared<ParseTreeNode>("ε", true));
+    }
+
+    int count = stopAtTail ? body.size() - 1 : body.size();
+    for (int i = 0; i < count; ++i) {
+        int symbol = body[i];
+        if (symbol >= 0) {
+            QString terminal = model->binding.terminalAt(symbol);
+            if (column(position) != symbol) {
+                addError(QString("Expected '%1'").arg(terminal), terminal);
+                continue;
+            }
+            node->addChild(std::make_shared<ParseTreeNode>(terminal, (*tokens)[position++].getLexeme(), true));
+            continue;
+        }
+
+        // Returning to the end of a production is a tail call and is not recorded
+        int returnState = model->stateBase[production] + i + 1;
+        bool push = i + 1 < body.size();
+        if (push) callStack.append(returnState);
+        node->addChild(parseRule(~symbol));
+        if (push) callStack.removeLast();
+    }
+}
+
+int AdaptiveParser::column(int index) const {
+    return index < end ? lookahead[index] : model->eofColumn;
+}
+
+// ============================================================
+//  PREDICTION
+// ============================================================
+
+int AdaptiveParser::predict(int rule) {
+    Model& m = *model;
+    m.lock.lockForRead();
+    if (m.decisions[rule].start < 0) {
+        m.lock.unlock();
+        m.lock.lockForWrite();
+        if (m.decisions[rule].start < 0) {
+            int start = addDFAState(rule, startConfigs(rule, 0, false));
+            m.decisions[rule].start = start;
+        }
+        m.lock.unlock();
+        m.lock.lockForRead();
+    }
+
+    int result = -1;
+    bool fullContext = false;
+    int state = m.decisions[rule].start;
+    for (int index = position; ; ++index) {
+        const Model::DFAState& current = m.decisions[rule].states[state];
+        if (current.prediction >= 0) {
+            result = current.prediction;
+            break;
+        }
+        if (current.conflict) {
+            fullContext = true;
+            break;
+        }
+
+        int col = column(index);
+        if (col < 0) break;
+
+        int target = current.edges[col];
+        if (target == -1) {
+            // Cache miss: extend the decision's DFA under the write lock
+            m.lock.unlock();
+            m.lock.lockForWrite();
+            target = m.decisions[rule].states[state].edges[col];
+            if (target == -1) {
+                QVector<Config> next = move(m.decisions[rule].states[state].configs, col, false);
+                target = next.isEmpty() ? -2 : addDFAState(rule, next);
+                m.decisions[rule].states[state].edges[col] = target;
+            }
+            m.lock.unlock();
+            m.lock.lockForRead();
+        } else {
+            ++dfaHits;
+        }
+        if (target == -2) break;
+        state = target;
+    }
+    m.lock.unlock();
+
+    return fullContext ? predictFullContext(rule) : result;
+}
+
+int AdaptiveParser::predictFullContext(int rule) {
+    // Full-context results depend on the call stack and are not cached, so
+    // nothing is published and a read lock suffices
+    ++fullContextPredictions;
+    Model& m = *model;
+    m.lock.lockForRead();
+    localStackBase = m.stackNodes.size();
+
+    int stack = 0;
+    for (int returnState : callStack) {
+        stack = pushStack(returnState, stack, true);
+    }
+
+    int result = -1;
+    QVector<Config> configs = startConfigs(rule, stack, true);
+    for (int index = position; !configs.isEmpty(); ++index) {
+        int alt = uniqueAlt(configs);
+        if (alt >= 0) {
+            result = alt;
+            break;
+        }
+        if (isConflicted(configs)) {
+            // A true ambiguity: the first alternative wins
+            result = minAlt(configs);
+            break;
+        }
+
+        int col = column(index);
+        if (col < 0) break;
+        configs = move(configs, col, true);
+        if (col == m.eofColumn) {
+            result = minAlt(configs);
+            break;
+        }
+    }
+    m.lock.unlock();
+
+    // Shared ids past localStackBase may be handed out once the lock is released
+    localStackNodes.clear();
+    localStackIndex.clear();
+    return result;
+}
+
+int AdaptiveParser::addDFAState(int rule, QVector<Config> configs) {
+    Model::Decision& decision = model->decisions[rule];
+    QByteArray key = keyOf(configs);
+    auto it = decision.index.constFind(key);
+    if (it != decision.index.constEnd()) {
+        return it.value();
+    }
+
+    Model::DFAState state;
+    state.configs = configs;
+    state.prediction = uniqueAlt(configs);
+    state.conflict = state.prediction < 0 && isConflicted(configs);
+    state.edges.fill(-1, model->eofColumn + 1);
+
+    decision.states.append(state);
+    decision.index.insert(key, decision.states.size() - 1);
+    return decision.states.size() - 1;
+}
+
+QVector<AdaptiveParser::Config> AdaptiveParser::startConfigs(int rule, int stack, bool fullContext) {
+    QVector<Config> configs;
+    QSet<QByteArray> busy;
+    const QVector<int>& alts = model->alternatives[rule];
+    for (int alt = 0; alt < alts.size(); ++alt) {
+        closure({model->stateBase[alts[alt]], alt, stack}, fullContext, configs, busy);
+    }
+    keyOf(configs);
+    return configs;
+}
+
+QVector<AdaptiveParser::Config> AdaptiveParser::move(const QVector<Config>& configs, int terminal, bool fullContext) {
+    QVector<Config> next;
+    QSet<QByteArray> busy;
+    for (const Config& config : configs) {
+        if (config.state == model->acceptState) {
+            if (terminal == model->eofColumn) next.append(config);
+            continue;
+        }
+        int production = model->stateProduction[config.state];
+        int dot = config.state - model->stateBase[production];
+        if (dot < model->bodies[production].size() && model->bodies[production][dot] == terminal) {
+            closure({config.state + 1, config.alt, config.stack}, fullContext, next, busy);
+        }
+    }
+    keyOf(next);
+    return next;
+}
+
+void AdaptiveParser::closure(const Config& config, bool fullContext, QVector<Config>& out, QSet<QByteArray>& busy) {
+    QByteArray key = keyOf(config);
+    if (busy.contains(key)) return;
+    busy.insert(key);
+
+    const Model& m = *model;
+    if (config.state == m.acceptState) {
+        out.append(config);
+        return;
+    }
+
+    int production = m.stateProduction[config.state];
+    const QVector<int>& body = m.bodies[production];
+    int dot = config.state - m.stateBase[production];
+
+    if (dot == body.size()) {
+        if (config.stack != 0) {
+            QPair<int, int> frame = stackFrame(config.stack);
+            closure({frame.first, config.alt, frame.second}, fullContext, out, busy);
+        } else if (fullContext) {
+            // Returned past the start rule
+            closure({m.acceptState, config.alt, 0}, fullContext, out, busy);
+        } else {
+            // SLL: the calling context is unknown, so continue after every use of the rule
+            int rule = m.owner[production];
+            for (int follow : m.followStates[rule]) {
+                closure({follow, config.alt, 0}, fullContext, out, busy);
+            }
+            if (rule == m.startRule) {
+                closure({m.acceptState, config.alt, 0}, fullContext, out, busy);
+            }
+        }
+        return;
+    }
+
+    int symbol = body[dot];
+    if (symbol >= 0) {
+        out.append(config);
+        return;
+    }
+
+    int returnState = config.state + 1;
+    int stack = m.isEndState(returnState) ? config.stack : pushStack(returnState, config.stack, fullContext);
+    for (int alternative : m.alternatives[~symbol]) {
+        closure({m.stateBase[alternative], config.alt, stack}, fullContext, out, busy);
+    }
+}
+
+int AdaptiveParser::pushStack(int returnState, int parent, bool fullContext) {
+    qint64 key = (static_cast<qint64>(returnState) << 32) | static_cast<quint32>(parent);
+    auto it = model->stackIndex.constFind(key);
+    if (it != model->stackIndex.constEnd()) {
+        return it.value();
+    }
+    if (!fullContext) {
+        model->stackNodes.append(qMakePair(returnState, parent));
+        model->stackIndex.insert(key, model->stackNodes.size() - 1);
+        return model->stackNodes.size() - 1;
+    }
+
+    // Only the read lock is held, so new frames stay with this parser
+    it = localStackIndex.constFind(key);
+    if (it != localStackIndex.constEnd()) {
+        return it.value();
+    }
+    localStackNodes.append(qMakePair(returnState, parent));
+    localStackIndex.insert(key, localStackBase + localStackNodes.size() - 1);
+    return localStackBase + localStackNodes.size() - 1;
+}
+
+QPair<int, int> AdaptiveParser::stackFrame(int stack) const {
+    return stack < localStackBase || localStackNodes.isEmpty() ? model->stackNodes[stack]
+                                                               : localStackNodes[stack - localStackBase];
+}
+
+// ============================================================
+//  CONFIGURATION SETS
+// ============================================================
+
+QByteArray AdaptiveParser::keyOf(const Config& config) {
+    return QByteArray(reinterpret_cast<const char*>(&config), sizeof(Config));
+}
+
+QByteArray AdaptiveParser::keyOf(QVector<Config>& configs) {
+    // Sorted so equal sets map to the same DFA state
+    std::sort(configs.begin(), configs.end(), [](const Config& a, const Config& b) {
+        if (a.state != b.state) return a.state < b.state;
+        if (a.alt != b.alt) return a.alt < b.alt;
+        return a.stack < b.stack;
+    });
+    QByteArray key;
+    key.reserve(static_cast<int>(configs.size() * sizeof(Config)));
+    for (const Config& config : configs) {
+        key.append(reinterpret_cast<const char*>(&config), sizeof(Config));
+    }
+    return key;
+}
+
+int AdaptiveParser::uniqueAlt(const QVector<Config>& configs) {
+    if (configs.isEmpty()) return -1;
+    for (const Config& config : configs) {
+        if (config.alt != configs.first().alt) return -1;
+    }
+    return configs.first().alt;
+}
+
+int AdaptiveParser::minAlt(const QVector<Config>& configs) {
+    int alt = -1;
+    for (const Config& config : configs) {
+        if (alt < 0 || config.alt < alt) alt = config.alt;
+    }
+    return alt;
+}
+
+bool AdaptiveParser::isConflicted(const QVector<Config>& configs) {
+    // Every (state, stack) pair is reached by several alternatives, so no
+    // further lookahead can separate them
+    if (configs.isEmpty()) return false;
+    QHash<qint64, int> altsPerPosition;
+    QHash<qint64, int> firstAlt;
+    for (const Config& config : configs) {
+        qint64 key = (static_cast<qint64>(config.state) << 32) | static_cast<quint32>(config.stack);
+        if (!firstAlt.contains(key)) {
+            firstAlt.insert(key, config.alt);
+            altsPerPosition.insert(key, 1);
+        } else if (firstAlt.value(key) != config.alt) {
+            altsPerPosition[key] = 2;
+        }
+    }
+    for (int count : altsPerPosition) {
+        if (count < 2) return false;
+    }
+    return true;
+}
+
+// ============================================================
+//  ERRORS
+// ============================================================
+
+QStringList AdaptiveParser::expectedTerminals(int rule) {
+    model->lock.lockForWrite();
+    QVector<Config> configs = startConfigs(rule, 0, false);
+    model->lock.unlock();
+
+    QStringList expected;
+    for (const Config& config : configs) {
+        QString name;
+        if (config.state == model->acceptState) {
+            name = "EOF";
+        } else {
+            int production = model->stateProduction[config.state];
+            name = model->binding.terminalAt(model->bodies[production][config.state - model->stateBase[production]]);
+        }
+        if (!expected.contains(name)) expected << name;
+    }
+    std::sort(expected.begin(), expected.end());
+    return expected;
+}
+
+void AdaptiveParser::addError(const QString& message, const QString& expected) {
+    QString found = position < end
+        ? QString("%1 ('%2')").arg((*tokens)[position].getTypeString()).arg((*tokens)[position].getLexeme())
+        : QString("EOF");
+    errors.append(ParseError(message, position, expected, found));
+}
@@ -0,0 +1,95 @@
+#ifndef ADAPTIVEPARSER_H
+#define ADAPTIVEPARSER_H
+
+#include "./src/models/Grammar/Grammar.h"
+#include "./src/models/Grammar/ParseTree.h"
+#include "./src/models/LexicalAnalysis/Token.h"
+#include "Parser.h"
+#include "TerminalBinding.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
+#include <QReadWriteLock>
+#include <memory>
+
+// Adaptive LL(*) parser in the style of ANTLR 4's ALL(*).
+// Each non-terminal with several alternatives is a decision. A decision is
+// predicted by simulating the grammar's ATN over as much lookahead as it
+// takes: first with SLL (any calling context), and on an SLL conflict again
+// with the parser's real call stack. SLL results are cached as one lookahead
+// DFA per decision, shared by every parser built from the same grammar text
+// and safe to use from several threads, so warmed-up parsing mostly walks
+// DFA edges. Direct left recursion (E -> E + T) is rewritten into a loop and
+// the tree is folded back into the original left-recursive shape.
+class AdaptiveParser {
+public:
+    // ATN, decision DFAs and call-stack table shared by all parsers of a grammar
+    struct Model;
+
+    explicit AdaptiveParser(const Grammar& grammar);
+
+    // False when the grammar has indirect left recursion or no start rule
+    bool isValid() const;
+    QString getGrammarError() const;
+
+    ParseTree parse(const QVector<Token>& tokens);
+
+    QVector<ParseError> getErrors() const { return errors; }
+    bool hasErrors() const { return !errors.isEmpty(); }
+
+    // Cache behaviour of the last parse
+    int getDFAHits() const { return dfaHits; }
+    int getFullContextPredictions() const { return fullContextPredictions; }
+    int getDFAStateCount() const;
+
+private:
+    struct Config {
+        int state;          // ATN state, i.e. production position
+        int alt;            // alternative of the decision being predicted
+        int stack;          // interned return stack, 0 = empty
+    };
+
+    std::shared_ptr<Model> model;
+    QString grammarName;
+
+    const QVector<Token>* tokens;
+    QVector<int> lookahead;           // bound terminal per token
+    int position;
+    int end;                          // input length, less the lexer's END_OF_FILE token
+    QVector<int> callStack;           // return states of the rules being parsed
+    // Full-context stacks are not shared; their ids continue after the model's
+    int localStackBase;
+    QVector<QPair<int, int>> localStackNodes;
+    QHash<qint64, int> localStackIndex;
+    QVector<ParseError> errors;
+    int dfaHits;
+    int fullContextPredictions;
+
+    std::shared_ptr<ParseTreeNode> parseRule(int rule);
+    void parseBody(int production, const std::shared_ptr<ParseTreeNode>& node, bool stopAtTail);
+
+    int column(int index) const;
+    int predict(int rule);
+    int predictFullContext(int rule);
+    int addDFAState(int rule, QVector<Config> configs);
+
+    QVector<Config> startConfigs(int rule, int stack, bool fullContext);
+    QVector<Config> move(const QVector<Config>& configs, int terminal, bool fullContext);
+    void closure(const Config& config, bool fullContext, QVector<Config>& out, QSet<QByteArray>& busy);
+    int pushStack(int returnState, int parent, bool fullContext);
+    QPair<int, int> stackFrame(int stack) const;
+
+    static QByteArray keyOf(QVector<Config>& configs);     // sorts configs
+    static QByteArray keyOf(const Config& config);
+    static int uniqueAlt(const QVector<Config>& configs);
+    static int minAlt(const QVector<Config>& configs);
+    static bool isConflicted(const QVector<Config>& configs);
+
+    void addError(const QString& message, const QString& expected);
+    QStringList expectedTerminals(int rule);
+};
+
+#endif // ADAPTIVEPARSER_H
@@ -0,0 +1,151 @@
+#include "GrammarAnalyzer.h"
+#include <algorithm>
+
+const QString GrammarAnalyzer::EndMarker = "$";
+
+GrammarAnalyzer::GrammarAnalyzer(const Grammar& grammar)
+    : productions(grammar.getProductions()), startSymbol(grammar.getStartSymbol()) {
+    for (const auto& prod : productions) {
+        if (!nonTerminals.contains(prod.getNonTerminal())) {
+            nonTerminals.insert(prod.getNonTerminal());
+            nonTerminalOrder.append(prod.getNonTerminal());
+        }
+    }
+
+    computeNullable();
+    computeFirst();
+    computeFollow();
+    computePredict();
+}
+
+QVector<QString> GrammarAnalyzer::bodyOf(const Production& production) {
+    // An epsilon production has an empty body
+    if (production.isEmpty() || production.isEpsilon()) {
+        return QVector<QString>();
+    }
+    return production.getSymbols();
+}
+
+QVector<QString> GrammarAnalyzer::getTerminals() const {
+    QVector<QString> terminals;
+    for (const auto& prod : productions) {
+        for (const QString& symbol : bodyOf(prod)) {
+            if (!nonTerminals.contains(symbol) && !terminals.contains(symbol)) {
+                terminals.append(symbol);
+            }
+        }
+    }
+    return terminals;
+}
+
+void GrammarAnalyzer::computeNullable() {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& prod : productions) {
+            if (nullable.contains(prod.getNonTerminal())) continue;
+
+            bool allNullable = true;
+            for (const QString& symbol : bodyOf(prod)) {
+                if (!nullable.contains(symbol)) {
+                    allNullable = false;
+                    break;
+                }
+            }
+            if (allNullable) {
+                nullable.insert(prod.getNonTerminal());
+                changed = true;
+            }
+        }
+    }
+}
+
+QSet<QString> GrammarAnalyzer::firstOfSequence(const QVector<QString>& symbols, bool* sequenceNullable) const {
+    QSet<QString> result;
+    for (const QString& symbol : symbols) {
+        if (!nonTerminals.contains(symbol)) {
+            result.insert(symbol);
+            if (sequenceNullable) *sequenceNullable = false;
+            return result;
+        }
+        result.unite(first.value(symbol));
+        if (!nullable.contains(symbol)) {
+            if (sequenceNullable) *sequenceNullable = false;
+            return result;
+        }
+    }
+    if (sequenceNullable) *sequenceNullable = true;
+    return result;
+}
+
+void GrammarAnalyzer::computeFirst() {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& prod : productions) {
+            QSet<QString>& target = first[prod.getNonTerminal()];
+            int before = target.size();
+            target.unite(firstOfSequence(bodyOf(prod)));
+            changed |= target.size() != before;
+        }
+    }
+}
+
+void GrammarAnalyzer::computeFollow() {
+    if (nonTerminals.contains(startSymbol)) {
+        follow[startSymbol].insert(EndMarker);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& prod : productions) {
+            QVector<QString> body = bodyOf(prod);
+            for (int i = 0; i < body.size(); ++i) {
+                if (!nonTerminals.contains(body[i])) continue;
+
+                bool restNullable = false;
+                QSet<QString> rest = firstOfSequence(body.mid(i + 1), &restNullable);
+                if (restNullable) {
+                    rest.unite(follow.value(prod.getNonTerminal()));
+                }
+
+                QSet<QString>& target = follow[body[i]];
+                int before = target.size();
+                target.unite(rest);
+                changed |= target.size() != before;
+            }
+        }
+    }
+}
+
+void GrammarAnalyzer::computePredict() {
+    predict.clear();
+    conflicts.clear();
+
+    for (const auto& prod : productions) {
+        bool bodyNullable = false;
+        QSet<QString> set = firstOfSequence(bodyOf(prod), &bodyNullable);
+        if (bodyNullable) {
+            set.unite(follow.value(prod.getNonTerminal()));
+        }
+        predict.append(set);
+    }
+
+    for (int a = 0; a < productions.size(); ++a) {
+        for (int b = a + 1; b < productions.size(); ++b) {
+            if (productions[a].getNonTerminal() != productions[b].getNonTerminal()) continue;
+
+            QSet<QString> overlap = predict[a];
+            overlap.intersect(predict[b]);
+            if (overlap.isEmpty()) continue;
+
+            QStringList symbols(overlap.begin(), overlap.end());
+            std::sort(symbols.begin(), symbols.end());
+            conflicts.append(QString("%1 and %2 both predict %3")
+                                 .arg(productions[a].toString())
+                                 .arg(productions[b].toString())
+                                 .arg(symbols.join(", ")));
+        }
+    }
+}
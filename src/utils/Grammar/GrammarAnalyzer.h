@@ -0,0 +1,56 @@
+#ifndef GRAMMARANALYZER_H
+#define GRAMMARANALYZER_H
+
+#include "./src/models/Grammar/Grammar.h"
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QMap>
+
+// Nullable, FIRST, FOLLOW and LL(1) predict sets of a grammar.
+// A symbol is a non-terminal exactly when it has a production; everything
+// else on a right-hand side is a terminal.
+class GrammarAnalyzer {
+private:
+    QVector<Production> productions;
+    QString startSymbol;
+    QVector<QString> nonTerminalOrder;        // in order of first definition
+    QSet<QString> nonTerminals;
+    QSet<QString> nullable;
+    QMap<QString, QSet<QString>> first;
+    QMap<QString, QSet<QString>> follow;
+    QVector<QSet<QString>> predict;           // per production index
+    QVector<QString> conflicts;
+
+public:
+    static const QString EndMarker;           // "$", the end of input in FOLLOW/predict sets
+
+    explicit GrammarAnalyzer(const Grammar& grammar);
+
+    QString getStartSymbol() const { return startSymbol; }
+    QVector<Production> getProductions() const { return productions; }
+    QVector<QString> getNonTerminals() const { return nonTerminalOrder; }
+    QVector<QString> getTerminals() const;
+
+    bool isNonTerminal(const QString& symbol) const { return nonTerminals.contains(symbol); }
+    bool isNullable(const QString& nonTerminal) const { return nullable.contains(nonTerminal); }
+
+    QSet<QString> getFirst(const QString& nonTerminal) const { return first.value(nonTerminal); }
+    QSet<QString> getFollow(const QString& nonTerminal) const { return follow.value(nonTerminal); }
+    QSet<QString> firstOfSequence(const QVector<QString>& symbols, bool* sequenceNullable = nullptr) const;
+    QSet<QString> getPredictSet(int productionIndex) const { return predict.value(productionIndex); }
+
+    // One message per pair of productions whose predict sets overlap
+    QVector<QString> getConflicts() const { return conflicts; }
+    bool isLL1() const { return conflicts.isEmpty(); }
+
+    static QVector<QString> bodyOf(const Production& production);
+
+private:
+    void computeNullable();
+    void computeFirst();
+    void computeFollow();
+    void computePredict();
+};
+
+#endif // GRAMMARANALYZER_H
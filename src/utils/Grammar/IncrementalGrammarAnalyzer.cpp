@@ -0,0 +1,404 @@
+#include "IncrementalGrammarAnalyzer.h"
+#include "GrammarAnalyzer.h"
+#include <QStringList>
+#include <QMap>
+#include <QPair>
+#include <algorithm>
+
+IncrementalGrammarAnalyzer::IncrementalGrammarAnalyzer(const Grammar& grammar)
+    : nextId(0), conflictCells(0), lastUpdateSize(0) {
+    reset(grammar);
+}
+
+void IncrementalGrammarAnalyzer::reset(const Grammar& grammar) {
+    startSymbol = grammar.getStartSymbol();
+    rules.clear();
+    order.clear();
+    rulesOf.clear();
+    usedIn.clear();
+    nullable.clear();
+    first.clear();
+    follow.clear();
+    table.clear();
+    conflictCells = 0;
+
+    // Register everything first, then solve once with every non-terminal seeded
+    for (const Production& production : grammar.getProductions()) {
+        int id = nextId++;
+        Rule rule;
+        rule.lhs = production.getNonTerminal();
+        rule.body = GrammarAnalyzer::bodyOf(production);
+        rules.insert(id, rule);
+        order.append(id);
+        rulesOf[rule.lhs].append(id);
+        for (const QString& symbol : rule.body) {
+            usedIn[symbol].insert(id);
+        }
+    }
+
+    QSet<QString> all;
+    for (auto it = rulesOf.constBegin(); it != rulesOf.constEnd(); ++it) {
+        all.insert(it.key());
+    }
+    update(all, all, -1);
+}
+
+// ============================================================
+// Edits
+// ============================================================
+
+void IncrementalGrammarAnalyzer::addProduction(const Production& production) {
+    int id = nextId++;
+    Rule rule;
+    rule.lhs = production.getNonTerminal();
+    rule.body = GrammarAnalyzer::bodyOf(production);
+    rules.insert(id, rule);
+    order.append(id);
+
+    bool becameNonTerminal = !rulesOf.contains(rule.lhs);
+    rulesOf[rule.lhs].append(id);
+    for (const QString& symbol : rule.body) {
+        usedIn[symbol].insert(id);
+    }
+
+    // The new body adds FOLLOW contributions; a symbol that stops being a
+    // terminal gets a FOLLOW set of its own
+    QSet<QString> followSeeds;
+    for (const QString& symbol : rule.body) {
+        if (isNonTerminal(symbol)) followSeeds.insert(symbol);
+    }
+    if (becameNonTerminal) {
+        followSeeds.insert(rule.lhs);
+    }
+
+    update(QSet<QString>() << rule.lhs, followSeeds, id);
+}
+
+bool IncrementalGrammarAnalyzer::removeProduction(int index) {
+    if (index < 0 || index >= order.size()) {
+        return false;
+    }
+
+    int id = order.takeAt(index);
+    setPredict(id, QSet<QString>());
+    Rule rule = rules.take(id);
+
+    QVector<int>& lhsRules = rulesOf[rule.lhs];
+    lhsRules.removeOne(id);
+    bool becameTerminal = lhsRules.isEmpty();
+    if (becameTerminal) {
+        rulesOf.remove(rule.lhs);
+        nullable.remove(rule.lhs);
+        first.remove(rule.lhs);
+        follow.remove(rule.lhs);
+        table.remove(rule.lhs);
+    }
+
+    for (const QString& symbol : rule.body) {
+        auto it = usedIn.find(symbol);
+        if (it == usedIn.end()) continue;
+        it->remove(id);
+        if (it->isEmpty()) usedIn.erase(it);
+    }
+
+    QSet<QString> followSeeds;
+    for (const QString& symbol : rule.body) {
+        if (isNonTerminal(symbol)) followSeeds.insert(symbol);
+    }
+
+    update(QSet<QString>() << rule.lhs, followSeeds, -1);
+    return true;
+}
+
+// ============================================================
+// Regions
+// ============================================================
+
+QSet<QString> IncrementalGrammarAnalyzer::firstOfSequence(const QVector<QString>& symbols, int from,
+                                                          bool* sequenceNullable) const {
+    QSet<QString> result;
+    for (int i = from; i < symbols.size(); ++i) {
+        const QString& symbol = symbols[i];
+        if (!isNonTerminal(symbol)) {
+            result.insert(symbol);
+            if (sequenceNullable) *sequenceNullable = false;
+            return result;
+        }
+        result.unite(first.value(symbol));
+        if (!nullable.contains(symbol)) {
+            if (sequenceNullable) *sequenceNullable = false;
+            return result;
+        }
+    }
+    if (sequenceNullable) *sequenceNullable = true;
+    return result;
+}
+
+// Left-hand sides whose nullable/FIRST can change: A joins when a member
+// occurs in A's body behind symbols that are nullable or themselves changing
+QSet<QString> IncrementalGrammarAnalyzer::firstRegion(const QSet<QString>& seeds) const {
+    QSet<QString> region = seeds;
+    QVector<QString> work;
+    for (const QString& s : seeds) work.append(s);
+
+    while (!work.isEmpty()) {
+        QString symbol = work.takeLast();
+        for (int id : usedIn.value(symbol)) {
+            const Rule& rule = rules[id];
+            if (region.contains(rule.lhs)) continue;
+
+            for (const QString& s : rule.body) {
+                if (s == symbol) {
+                    region.insert(rule.lhs);
+                    work.append(rule.lhs);
+                    break;
+                }
+                if (!nullable.contains(s) && !region.contains(s)) break;
+            }
+        }
+    }
+    return region;
+}
+
+// Non-terminals whose FOLLOW can change: the seeds, every symbol right
+// before an occurrence of a changed FIRST (through nullable gaps), and
+// then whatever their FOLLOW flows into at the end of a body
+QSet<QString> IncrementalGrammarAnalyzer::followRegion(QSet<QString> seeds, const QSet<QString>& changedFirst,
+                                                       const QSet<QString>& oldNullable) const {
+    auto maybeNullable = [&](const QString& s) {
+        return nullable.contains(s) || oldNullable.contains(s);
+    };
+
+    for (const QString& symbol : changedFirst) {
+        for (int id : usedIn.value(symbol)) {
+            const QVector<QString>& body = rules[id].body;
+            for (int i = 0; i < body.size(); ++i) {
+                if (body[i] != symbol) continue;
+                for (int j = i - 1; j >= 0; --j) {
+                    if (isNonTerminal(body[j])) seeds.insert(body[j]);
+                    if (!maybeNullable(body[j])) break;
+                }
+            }
+        }
+    }
+
+    QSet<QString> region;
+    QVector<QString> work;
+    for (const QString& s : seeds) {
+        if (isNonTerminal(s)) {
+            region.insert(s);
+            work.append(s);
+        }
+    }
+
+    while (!work.isEmpty()) {
+        QString lhs = work.takeLast();
+        for (int id : rulesOf.value(lhs)) {
+            const QVector<QString>& body = rules[id].body;
+            for (int i = body.size() - 1; i >= 0; --i) {
+                const QString& symbol = body[i];
+                if (isNonTerminal(symbol) && !region.contains(symbol)) {
+                    region.insert(symbol);
+                    work.append(symbol);
+                }
+                if (!maybeNullable(symbol)) break;
+            }
+        }
+    }
+    return region;
+}
+
+// ============================================================
+// Solving
+// ============================================================
+
+// Everything outside the region is already final, so a local fixpoint suffices
+void IncrementalGrammarAnalyzer::solveFirst(const QSet<QString>& region) {
+    QVector<QString> nonTerminals;
+    for (const QString& symbol : region) {
+        if (!isNonTerminal(symbol)) continue;
+        nonTerminals.append(symbol);
+        nullable.remove(symbol);
+        first[symbol].clear();
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const QString& nt : nonTerminals) {
+            if (nullable.contains(nt)) continue;
+            for (int id : rulesOf.value(nt)) {
+                bool allNullable = true;
+                for (const QString& symbol : rules[id].body) {
+                    if (!nullable.contains(symbol)) {
+                        allNullable = false;
+                        break;
+                    }
+                }
+                if (allNullable) {
+                    nullable.insert(nt);
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    changed = true;
+    while (changed) {
+        changed = false;
+        for (const QString& nt : nonTerminals) {
+            QSet<QString>& target = first[nt];
+            int before = target.size();
+            for (int id : rulesOf.value(nt)) {
+                target.unite(firstOfSequence(rules[id].body, 0, nullptr));
+            }
+            changed |= target.size() != before;
+        }
+    }
+}
+
+void IncrementalGrammarAnalyzer::solveFollow(const QSet<QString>& region) {
+    for (const QString& nt : region) {
+        follow[nt].clear();
+        if (nt == startSymbol) {
+            follow[nt].insert(GrammarAnalyzer::EndMarker);
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const QString& nt : region) {
+            QSet<QString>& target = follow[nt];
+            int before = target.size();
+            for (int id : usedIn.value(nt)) {
+                const Rule& rule = rules[id];
+                for (int i = 0; i < rule.body.size(); ++i) {
+                    if (rule.body[i] != nt) continue;
+                    bool restNullable = false;
+                    target.unite(firstOfSequence(rule.body, i + 1, &restNullable));
+                    if (restNullable) {
+                        target.unite(follow.value(rule.lhs));
+                    }
+                }
+            }
+            changed |= target.size() != before;
+        }
+    }
+}
+
+void IncrementalGrammarAnalyzer::update(const QSet<QString>& seeds, QSet<QString> followSeeds, int addedRule) {
+    QSet<QString> oldNullable = nullable;
+
+    QSet<QString> changedFirst = firstRegion(seeds);
+    solveFirst(changedFirst);
+
+    QSet<QString> changedFollow = followRegion(followSeeds, changedFirst, oldNullable);
+    solveFollow(changedFollow);
+
+    // Predict sets depend on FIRST/nullable of the body and FOLLOW of the
+    // left-hand side; a changed body FIRST always puts the lhs in changedFirst
+    QSet<QString> affected = changedFirst;
+    affected.unite(changedFollow);
+    QSet<int> refresh;
+    for (const QString& nt : affected) {
+        for (int id : rulesOf.value(nt)) refresh.insert(id);
+    }
+    if (addedRule >= 0) {
+        refresh.insert(addedRule);
+    }
+
+    for (int id : refresh) {
+        const Rule& rule = rules[id];
+        bool bodyNullable = false;
+        QSet<QString> predict = firstOfSequence(rule.body, 0, &bodyNullable);
+        if (bodyNullable) {
+            predict.unite(follow.value(rule.lhs));
+        }
+        setPredict(id, predict);
+    }
+
+    lastUpdateSize = affected.size();
+}
+
+// Moves a rule's LL(1) table entries from its old predict set to the new one
+void IncrementalGrammarAnalyzer::setPredict(int id, const QSet<QString>& predict) {
+    Rule& rule = rules[id];
+    if (rule.predict == predict) {
+        return;
+    }
+
+    QHash<QString, QVector<int>>& row = table[rule.lhs];
+    for (const QString& lookahead : rule.predict) {
+        if (predict.contains(lookahead)) continue;
+        QVector<int>& cell = row[lookahead];
+        if (cell.size() == 2) --conflictCells;
+        cell.removeOne(id);
+        if (cell.isEmpty()) row.remove(lookahead);
+    }
+    for (const QString& lookahead : predict) {
+        if (rule.predict.contains(lookahead)) continue;
+        QVector<int>& cell = row[lookahead];
+        cell.append(id);
+        if (cell.size() == 2) ++conflictCells;
+    }
+    if (row.isEmpty()) {
+        table.remove(rule.lhs);
+    }
+
+    rule.predict = predict;
+}
+
+// ============================================================
+// Queries
+// ============================================================
+
+QSet<QString> IncrementalGrammarAnalyzer::getPredictSet(int productionIndex) const {
+    if (productionIndex < 0 || productionIndex >= order.size()) {
+        return QSet<QString>();
+    }
+    return rules[order[productionIndex]].predict;
+}
+
+QVector<QString> IncrementalGrammarAnalyzer::getConflicts(int limit) const {
+    QVector<QString> messages;
+    if (conflictCells == 0) {
+        return messages;
+    }
+
+    QHash<int, int> position;
+    for (int i = 0; i < order.size(); ++i) {
+        position.insert(order[i], i);
+    }
+
+    // Overlapping lookaheads per pair of productions, in production order
+    QMap<QPair<int, int>, QStringList> overlaps;
+    for (auto row = table.constBegin(); row != table.constEnd(); ++row) {
+        for (auto cell = row->constBegin(); cell != row->constEnd(); ++cell) {
+            if (cell->size() < 2) continue;
+            QVector<int> positions;
+            for (int id : *cell) positions.append(position.value(id));
+            std::sort(positions.begin(), positions.end());
+            for (int a = 0; a < positions.size(); ++a) {
+                for (int b = a + 1; b < positions.size(); ++b) {
+                    overlaps[qMakePair(positions[a], positions[b])].append(cell.key());
+                }
+            }
+        }
+    }
+
+    for (auto it = overlaps.begin(); it != overlaps.end(); ++it) {
+        if (limit >= 0 && messages.size() >= limit) break;
+        QStringList& symbols = it.value();
+        std::sort(symbols.begin(), symbols.end());
+
+        const Rule& a = rules[order[it.key().first]];
+        const Rule& b = rules[order[it.key().second]];
+        messages.append(QString("%1 and %2 both predict %3")
+                            .arg(Production(a.lhs, a.body).toString())
+                            .arg(Production(b.lhs, b.body).toString())
+                            .arg(symbols.join(", ")));
+    }
+    return messages;
+}
@@ -0,0 +1,70 @@
+#ifndef INCREMENTALGRAMMARANALYZER_H
+#define INCREMENTALGRAMMARANALYZER_H
+
+#include "./src/models/Grammar/Grammar.h"
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+
+// GrammarAnalyzer kept up to date across single production edits. An edit
+// resets and re-solves only the non-terminals it can affect: for nullable
+// and FIRST, the left-hand sides reached backwards through occurrences
+// behind a (possibly) nullable prefix; for FOLLOW, the symbols before those
+// occurrences and everything FOLLOW flows into from them. LL(1) table cells
+// of the affected productions are refreshed, so conflicts are always current.
+// Results match a GrammarAnalyzer built from the same production list.
+class IncrementalGrammarAnalyzer {
+private:
+    struct Rule {
+        QString lhs;
+        QVector<QString> body;
+        QSet<QString> predict;
+    };
+
+    QString startSymbol;
+    QHash<int, Rule> rules;                    // by stable id
+    QVector<int> order;                        // production index -> rule id
+    int nextId;
+    QHash<QString, QVector<int>> rulesOf;      // non-terminal -> its rule ids, in grammar order
+    QHash<QString, QSet<int>> usedIn;          // symbol -> ids of rules whose body contains it
+    QSet<QString> nullable;
+    QHash<QString, QSet<QString>> first;
+    QHash<QString, QSet<QString>> follow;
+    QHash<QString, QHash<QString, QVector<int>>> table;   // non-terminal -> lookahead -> rule ids
+    int conflictCells;                         // table cells holding more than one rule
+    int lastUpdateSize;
+
+public:
+    explicit IncrementalGrammarAnalyzer(const Grammar& grammar);
+
+    void reset(const Grammar& grammar);
+    void addProduction(const Production& production);     // appended, as in Grammar::addProduction
+    bool removeProduction(int index);
+
+    int getProductionCount() const { return order.size(); }
+    bool isNonTerminal(const QString& symbol) const { return rulesOf.contains(symbol); }
+    bool isNullable(const QString& nonTerminal) const { return nullable.contains(nonTerminal); }
+    QSet<QString> getFirst(const QString& nonTerminal) const { return first.value(nonTerminal); }
+    QSet<QString> getFollow(const QString& nonTerminal) const { return follow.value(nonTerminal); }
+    QSet<QString> getPredictSet(int productionIndex) const;
+
+    // Same messages and order as GrammarAnalyzer::getConflicts(); limit < 0 = all
+    QVector<QString> getConflicts(int limit = -1) const;
+    int getConflictCellCount() const { return conflictCells; }
+    bool isLL1() const { return conflictCells == 0; }
+
+    int getLastUpdateSize() const { return lastUpdateSize; }   // non-terminals re-solved by the last edit
+
+private:
+    QSet<QString> firstOfSequence(const QVector<QString>& symbols, int from, bool* sequenceNullable) const;
+    void update(const QSet<QString>& seeds, QSet<QString> followSeeds, int addedRule);
+    QSet<QString> firstRegion(const QSet<QString>& seeds) const;
+    QSet<QString> followRegion(QSet<QString> seeds, const QSet<QString>& changedFirst,
+                               const QSet<QString>& oldNullable) const;
+    void solveFirst(const QSet<QString>& region);
+    void solveFollow(const QSet<QString>& region);
+    void setPredict(int id, const QSet<QString>& predict);
+};
+
+#endif // INCREMENTALGRAMMARANALYZER_H
@@ -1,9 +1,15 @@
 #include "Parser.h"
+#include "ExpressionParser.h"
+#include "GrammarAnalyzer.h"
+#include "AdaptiveParser.h"
+#include "./src/utils/Semantic/ParallelFrontEnd.h"
 #include <QDebug>
+#include <QStringList>
+#include <algorithm>
 
-Parser::Parser() : grammar(nullptr), currentPosition(0) {}
+Parser::Parser() : grammar(nullptr), currentPosition(0), predictive(false), startIndex(-1) {}
 
-Parser::Parser(Grammar* g) : grammar(g), currentPosition(0) {}
+Parser::Parser(Grammar* g) : grammar(g), currentPosition(0), predictive(false), startIndex(-1) {}
 
 Parser::~Parser() {}
 
@@ -29,186 +35,175 @@ ParseTree Parser::parse() {
         return ParseTree();
     }
 
-    return parseExpression();
-}
-
-ParseTree Parser::parseExpression() {
-    ParseTree tree(grammar->getName());
-
-    if (tokens.isEmpty()) {
-        addError("Empty token stream", "tokens");
-        return tree;
+    if (isExpressionGrammar()) {
+        return parseExpression();
     }
 
-    // Start parsing from the start symbol
-    auto root = parseE();
-    tree.setRoot(root);
-
-    return tree;
-}
-
-std::shared_ptr<ParseTreeNode> Parser::parseE() {
-    // E → T E'
-    auto node = std::make_shared<ParseTreeNode>("E", false);
-
-    auto tNode = parseT();
-    if (tNode) {
-        node->addChild(tNode);
+    prepare();
+    if (predictive) {
+        // Large programs are parsed per declaration on all cores when the
+        // start rule is a list; any declaration that does not parse on its
+        // own sends the whole input through the sequential parse
+        ParseTree tree;
+        if (tokens.size() >= ParallelParseTokens && ParallelFrontEnd().parse(tokens, *grammar, &tree)) {
+            return tree;
+        }
+        return parsePredictive();
     }
-
-    auto ePrimeNode = parseEPrime();
-    if (ePrimeNode) {
-        node->addChild(ePrimeNode);
+    if (adaptive && adaptive->isValid()) {
+        ParseTree tree = adaptive->parse(tokens);
+        errors += adaptive->getErrors();
+        return tree;
     }
 
-    return node;
+    // Indirect left recursion is out of reach of both engines
+    return parseExpression();
 }
 
-std::shared_ptr<ParseTreeNode> Parser::parseEPrime() {
-    // E' → + T E' | ε
-    auto node = std::make_shared<ParseTreeNode>("E'", false);
-
-    if (check("+") || check("PLUS")) {
-        advance();
-        auto plusNode = std::make_shared<ParseTreeNode>("+", true);
-        node->addChild(plusNode);
-
-        auto tNode = parseT();
-        if (tNode) {
-            node->addChild(tNode);
-        }
-
-        auto ePrimeNode = parseEPrime();
-        if (ePrimeNode) {
-            node->addChild(ePrimeNode);
-        }
-    } else {
-        // ε production
-        auto epsilonNode = std::make_shared<ParseTreeNode>("ε", true);
-        node->addChild(epsilonNode);
-    }
+ParseTree Parser::parseExpression() {
+    // The recursive-descent code is generated from grammars/Expression.grammar
+    ExpressionParser generated(tokens);
+    ParseTree tree = generated.parse();
+    tree.setGrammarName(grammar->getName());
+    errors += generated.getErrors();
 
-    return node;
+    return tree;
 }
 
-std::shared_ptr<ParseTreeNode> Parser::parseT() {
-    // T → F T'
-    auto node = std::make_shared<ParseTreeNode>("T", false);
-
-    auto fNode = parseF();
-    if (fNode) {
-        node->addChild(fNode);
+bool Parser::isExpressionGrammar() const {
+    QVector<Production> expected = Grammar::createExpressionGrammar().getProductions();
+    QVector<Production> actual = grammar->getProductions();
+    if (expected.size() != actual.size()) return false;
+    for (int i = 0; i < expected.size(); ++i) {
+        if (expected[i].toString() != actual[i].toString()) return false;
+    }
+    return true;
+}
+
+void Parser::prepare() {
+    QString text = grammar->getStartSymbol() + "\n" + grammar->toString();
+    if (text == preparedGrammar) return;
+    preparedGrammar = text;
+
+    GrammarAnalyzer analyzer(*grammar);
+    predictive = analyzer.isLL1() && analyzer.isNonTerminal(analyzer.getStartSymbol());
+    binding = TerminalBinding(analyzer.getTerminals());
+    nonTerminalNames = analyzer.getNonTerminals();
+    bodies.clear();
+    table.clear();
+    nullableProduction.clear();
+    adaptive.reset();
+    if (!predictive) {
+        adaptive = std::make_shared<AdaptiveParser>(*grammar);
+        return;
     }
 
-    auto tPrimeNode = parseTPrime();
-    if (tPrimeNode) {
-        node->addChild(tPrimeNode);
+    QHash<QString, int> nonTerminalIndex;
+    for (int i = 0; i < nonTerminalNames.size(); ++i) {
+        nonTerminalIndex.insert(nonTerminalNames[i], i);
     }
+    startIndex = nonTerminalIndex.value(analyzer.getStartSymbol());
 
-    return node;
-}
+    // Column terminalCount() is the end of input
+    int columns = binding.terminalCount() + 1;
+    table.fill(-1, nonTerminalNames.size() * columns);
+    nullableProduction.fill(-1, nonTerminalNames.size());
 
-std::shared_ptr<ParseTreeNode> Parser::parseTPrime() {
-    // T' → * F T' | ε
-    auto node = std::make_shared<ParseTreeNode>("T'", false);
+    QVector<Production> productions = analyzer.getProductions();
+    for (int i = 0; i < productions.size(); ++i) {
+        int owner = nonTerminalIndex.value(productions[i].getNonTerminal());
 
-    if (check("*") || check("MULTIPLY")) {
-        advance();
-        auto mulNode = std::make_shared<ParseTreeNode>("*", true);
-        node->addChild(mulNode);
+        QVector<int> body;
+        for (const QString& symbol : GrammarAnalyzer::bodyOf(productions[i])) {
+            body.append(analyzer.isNonTerminal(symbol) ? ~nonTerminalIndex.value(symbol) : binding.indexOf(symbol));
+        }
+        bodies.append(body);
 
-        auto fNode = parseF();
-        if (fNode) {
-            node->addChild(fNode);
+        bool bodyNullable = false;
+        analyzer.firstOfSequence(GrammarAnalyzer::bodyOf(productions[i]), &bodyNullable);
+        if (bodyNullable && nullableProduction[owner] < 0) {
+            nullableProduction[owner] = i;
         }
 
-        auto tPrimeNode = parseTPrime();
-        if (tPrimeNode) {
-            node->addChild(tPrimeNode);
+        for (const QString& terminal : analyzer.getPredictSet(i)) {
+            int column = terminal == GrammarAnalyzer::EndMarker ? columns - 1 : binding.indexOf(terminal);
+            table[owner * columns + column] = i;
         }
-    } else {
-        // ε production
-        auto epsilonNode = std::make_shared<ParseTreeNode>("ε", true);
-        node->addChild(epsilonNode);
     }
-
-    return node;
 }
 
-std::shared_ptr<ParseTreeNode> Parser::parseF() {
-    // F → ( E ) | id | num
-    auto node = std::make_shared<ParseTreeNode>("F", false);
-
-    if (check("(") || check("LPAREN")) {
-        advance();
-        auto lparenNode = std::make_shared<ParseTreeNode>("(", true);
-        node->addChild(lparenNode);
+ParseTree Parser::parsePredictive() {
+    ParseTree tree(grammar->getName());
+    if (tokens.isEmpty()) {
+        addError("Empty token stream", "tokens");
+        return tree;
+    }
 
-        auto eNode = parseE();
-        if (eNode) {
-            node->addChild(eNode);
+    // Terminals are resolved once per token; the loop below only compares integers
+    QVector<int> lookahead = binding.bindTokens(tokens);
+    int columns = binding.terminalCount() + 1;
+    int end = Token::inputLength(tokens);
+    auto column = [&]() {
+        return currentPosition < end ? lookahead[currentPosition] : columns - 1;
+    };
+
+    struct Frame {
+        int symbol;                                 // terminal index, or ~non-terminal
+        std::shared_ptr<ParseTreeNode> parent;
+    };
+    QVector<Frame> stack;
+    stack.append({~startIndex, nullptr});
+
+    while (!stack.isEmpty()) {
+        Frame frame = stack.takeLast();
+
+        if (frame.symbol >= 0) {
+            QString terminal = binding.terminalAt(frame.symbol);
+            if (column() != frame.symbol) {
+                addError(QString("Expected '%1'").arg(terminal), terminal);
+                continue;
+            }
+            frame.parent->addChild(std::make_shared<ParseTreeNode>(terminal, tokens[currentPosition++].getLexeme(), true));
+            continue;
         }
 
-        if (check(")") || check("RPAREN")) {
-            advance();
-            auto rparenNode = std::make_shared<ParseTreeNode>(")", true);
-            node->addChild(rparenNode);
+        int nonTerminal = ~frame.symbol;
+        auto node = std::make_shared<ParseTreeNode>(nonTerminalNames[nonTerminal], false);
+        if (frame.parent) {
+            frame.parent->addChild(node);
         } else {
-            addError("Expected ')'", ")");
+            tree.setRoot(node);
         }
-    } else if (check("IDENTIFIER") || check("id")) {
-        Token tok = advance();
-        auto idNode = std::make_shared<ParseTreeNode>("id", tok.getLexeme(), true);
-        node->addChild(idNode);
-    } else if (check("INTEGER") || check("num") || check("INTEGER_LITERAL")) {
-        Token tok = advance();
-        auto numNode = std::make_shared<ParseTreeNode>("num", tok.getLexeme(), true);
-        node->addChild(numNode);
-    } else {
-        addError("Expected '(', identifier, or number", "id | num | (");
-    }
 
-    return node;
-}
-
-Token Parser::peek() const {
-    if (currentPosition >= tokens.size()) {
-        return Token(TokenType::END_OF_FILE, "", 0, 0);
-    }
-    return tokens[currentPosition];
-}
+        // Like the generated parsers, a nullable alternative absorbs any unclaimed lookahead
+        int current = column();
+        int production = current >= 0 ? table[nonTerminal * columns + current] : -1;
+        if (production < 0) {
+            production = nullableProduction[nonTerminal];
+        }
+        if (production < 0) {
+            QStringList expected;
+            for (int t = 0; t < columns - 1; ++t) {
+                if (table[nonTerminal * columns + t] >= 0) expected << binding.terminalAt(t);
+            }
+            std::sort(expected.begin(), expected.end());
+            addError("Expected one of: " + expected.join(" "), expected.join(" | "));
+            continue;
+        }
 
-Token Parser::advance() {
-    if (currentPosition >= tokens.size()) {
-        return Token(TokenType::END_OF_FILE, "", 0, 0);
+        const QVector<int>& body = bodies[production];
+        if (body.isEmpty()) {
+            node->addChild(std::make_shared<ParseTreeNode>("ε", true));
+        }
+        for (int i = body.size() - 1; i >= 0; --i) {
+            stack.append({body[i], node});
+        }
     }
-    return tokens[currentPosition++];
-}
 
-bool Parser::match(const QString& expected) {
-    if (check(expected)) {
-        advance();
-        return true;
+    if (currentPosition < end) {
+        addError("Unexpected input after " + nonTerminalNames[startIndex], "EOF");
     }
-    return false;
-}
-
-bool Parser::check(const QString& expected) const {
-    if (currentPosition >= tokens.size()) return false;
-
-    Token tok = peek();
-
-    // Check by token type string
-    if (tok.getTypeString() == expected) return true;
-
-    // Check by lexeme
-    if (tok.getLexeme() == expected) return true;
-
-    return false;
-}
-
-bool Parser::isAtEnd() const {
-    return currentPosition >= tokens.size();
+    return tree;
 }
 
 void Parser::addError(const QString& message, const QString& expected) {
@@ -216,9 +211,9 @@ void Parser::addError(const QString& message, const QString& expected) {
 }
 
 QString Parser::getCurrentTokenString() const {
-    if (currentPosition >= tokens.size()) {
+    if (currentPosition >= Token::inputLength(tokens)) {
         return "EOF";
     }
-    Token tok = tokens[currentPosition];
+    const Token& tok = tokens[currentPosition];
     return QString("%1 ('%2')").arg(tok.getTypeString()).arg(tok.getLexeme());
 }
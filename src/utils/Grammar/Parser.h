@@ -4,8 +4,12 @@
 #include "./src/models/Grammar/Grammar.h"
 #include "./src/models/Grammar/ParseTree.h"
 #include "./src/models/LexicalAnalysis/Token.h"
+#include "TerminalBinding.h"
 #include <QVector>
 #include <QString>
+#include <memory>
+
+class AdaptiveParser;
 
 struct ParseError {
     QString message;
@@ -30,7 +34,20 @@ private:
     QVector<ParseError> errors;
     std::shared_ptr<ParseTreeNode> currentNode;
 
+    // LL(1) table of the current grammar, rebuilt when the grammar text changes
+    QString preparedGrammar;
+    bool predictive;
+    TerminalBinding binding;
+    QVector<QString> nonTerminalNames;
+    QVector<QVector<int>> bodies;             // per production: terminal index, or ~non-terminal
+    QVector<int> table;                       // non-terminal * (terminals + 1) + lookahead -> production
+    QVector<int> nullableProduction;          // per non-terminal, -1 if none
+    int startIndex;
+    std::shared_ptr<AdaptiveParser> adaptive;  // ALL(*) parser for grammars that are not LL(1)
+
 public:
+    static const int ParallelParseTokens = 20000;  // Larger inputs go through ParallelFrontEnd::parse
+
     Parser();
     Parser(Grammar* g);
     ~Parser();
@@ -47,19 +64,9 @@ public:
     void reset();
 
 private:
-    // Recursive descent parsing functions
-    std::shared_ptr<ParseTreeNode> parseE();      // Expression
-    std::shared_ptr<ParseTreeNode> parseEPrime(); // E'
-    std::shared_ptr<ParseTreeNode> parseT();      // Term
-    std::shared_ptr<ParseTreeNode> parseTPrime(); // T'
-    std::shared_ptr<ParseTreeNode> parseF();      // Factor
-
-    // Helper functions
-    Token peek() const;
-    Token advance();
-    bool match(const QString& expected);
-    bool check(const QString& expected) const;
-    bool isAtEnd() const;
+    void prepare();
+    bool isExpressionGrammar() const;
+    ParseTree parsePredictive();
 
     void addError(const QString& message, const QString& expected);
     QString getCurrentTokenString() const;
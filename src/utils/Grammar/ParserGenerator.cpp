@@ -0,0 +1,376 @@
+#include "ParserGenerator.h"
+#include "TerminalBinding.h"
+#include <QFile>
+#include <QStringList>
+#include <algorithm>
+
+ParserGenerator::ParserGenerator(const Grammar& grammar, const QString& className)
+    : grammar(grammar), analyzer(grammar), className(className) {
+
+    // parseE, parseEPrime, ... made unique if two names collapse to the same identifier
+    QSet<QString> used;
+    for (const QString& nonTerminal : analyzer.getNonTerminals()) {
+        QString name = "parse";
+        bool upper = true;
+        for (QChar c : nonTerminal) {
+            if (c == '\'') {
+                name += "Prime";
+                upper = true;
+            } else if (c.isLetterOrNumber() && c.unicode() < 128) {
+                name += upper ? c.toUpper() : c;
+                upper = false;
+            } else {
+                name += "_";
+                upper = true;
+            }
+        }
+        QString unique = name;
+        for (int suffix = 2; used.contains(unique); ++suffix) {
+            unique = name + QString::number(suffix);
+        }
+        used.insert(unique);
+        functionNames.insert(nonTerminal, unique);
+    }
+}
+
+bool ParserGenerator::validate(QString* errorMsg) const {
+    if (analyzer.getProductions().isEmpty()) {
+        if (errorMsg) *errorMsg = "Grammar has no productions";
+        return false;
+    }
+    if (!analyzer.isNonTerminal(analyzer.getStartSymbol())) {
+        if (errorMsg) *errorMsg = QString("Start symbol '%1' has no productions").arg(analyzer.getStartSymbol());
+        return false;
+    }
+    if (!analyzer.isLL1()) {
+        if (errorMsg) {
+            QVector<QString> conflicts = analyzer.getConflicts();
+            *errorMsg = "Grammar is not LL(1):\n  " + QStringList(conflicts.begin(), conflicts.end()).join("\n  ");
+        }
+        return false;
+    }
+    return true;
+}
+
+// ============================================================
+//  GRAMMAR FILES
+// ============================================================
+
+bool ParserGenerator::readGrammarFile(const QString& path, Grammar& grammar, QString* errorMsg) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMsg) *errorMsg = QString("Cannot open %1").arg(path);
+        return false;
+    }
+    return parseGrammarText(QString::fromUtf8(file.readAll()), grammar, errorMsg);
+}
+
+bool ParserGenerator::parseGrammarText(const QString& text, Grammar& grammar, QString* errorMsg) {
+    grammar.clear();
+    grammar.setName("Untitled");
+
+    QString start;
+    QStringList lines = text.split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        QString line = lines[i].trimmed();
+        if (line.isEmpty() || line.startsWith("#")) {
+            continue;
+        }
+
+        if (line.startsWith("%name ")) {
+            grammar.setName(line.mid(6).trimmed());
+            continue;
+        }
+        if (line.startsWith("%start ")) {
+            start = line.mid(7).trimmed();
+            continue;
+        }
+
+        Production prod = Production::fromString(line);
+        if (prod.getNonTerminal().isEmpty()) {
+            if (errorMsg) *errorMsg = QString("line %1: expected 'A -> B c', got '%2'").arg(i + 1).arg(line);
+            return false;
+        }
+        if (start.isEmpty() && grammar.getProductions().isEmpty()) {
+            start = prod.getNonTerminal();
+        }
+        grammar.addProduction(prod);
+    }
+
+    grammar.setStartSymbol(start);
+    return true;
+}
+
+// ============================================================
+//  CODE EMISSION
+// ============================================================
+
+QString ParserGenerator::cppString(const QString& text) {
+    QString escaped;
+    for (QChar c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return "\"" + escaped + "\"";
+}
+
+QString ParserGenerator::headerGuard() const {
+    return className.toUpper() + "_H";
+}
+
+QString ParserGenerator::tokenTypeFor(const QString& terminal) const {
+    TokenType type;
+    if (TerminalBinding::resolveTokenType(terminal, &type)) {
+        return Token::enumeratorName(type);
+    }
+    return QString();
+}
+
+QVector<QString> ParserGenerator::lexemeTerminals() const {
+    QVector<QString> lexemes;
+    for (const QString& terminal : analyzer.getTerminals()) {
+        if (tokenTypeFor(terminal).isEmpty()) lexemes.append(terminal);
+    }
+    return lexemes;
+}
+
+QString ParserGenerator::matchCondition(const QString& terminal) const {
+    QString type = tokenTypeFor(terminal);
+    if (!type.isEmpty()) {
+        return "peekType() == TokenType::" + type;
+    }
+    return QString("peekLexemeId() == %1").arg(lexemeTerminals().indexOf(terminal));
+}
+
+QString ParserGenerator::emitBody(const Production& production, const QString& indent) const {
+    QVector<QString> body = GrammarAnalyzer::bodyOf(production);
+    if (body.isEmpty()) {
+        return indent + "node->addChild(std::make_shared<ParseTreeNode>(\"ε\", true));\n";
+    }
+
+    QString code;
+    for (const QString& symbol : body) {
+        if (analyzer.isNonTerminal(symbol)) {
+            code += indent + QString("node->addChild(%1());\n").arg(functionNames.value(symbol));
+        } else {
+            code += indent + QString("shift(node, %1, %2);\n").arg(cppString(symbol)).arg(matchCondition(symbol));
+        }
+    }
+    return code;
+}
+
+QString ParserGenerator::emitFunction(const QString& nonTerminal) const {
+    QVector<Production> productions = analyzer.getProductions();
+    QVector<int> alternatives;
+    QStringList shapes;
+    for (int i = 0; i < productions.size(); ++i) {
+        if (productions[i].getNonTerminal() == nonTerminal) {
+            alternatives.append(i);
+            QVector<QString> body = GrammarAnalyzer::bodyOf(productions[i]);
+            shapes << (body.isEmpty() ? QString("ε") : QStringList(body.begin(), body.end()).join(" "));
+        }
+    }
+
+    QString code = QString("std::shared_ptr<ParseTreeNode> %1::%2() {\n")
+                       .arg(className).arg(functionNames.value(nonTerminal));
+    code += QString("    // %1 → %2\n").arg(nonTerminal).arg(shapes.join(" | "));
+    code += QString("    auto node = std::make_shared<ParseTreeNode>(%1, false);\n\n").arg(cppString(nonTerminal));
+
+    // A nullable alternative is taken on any lookahead no other alternative claims
+    int fallback = -1;
+    QStringList expected;
+    QMap<QString, int> byType;          // TokenType enumerator -> production
+    QVector<QPair<QString, int>> byLexeme;
+    for (int index : alternatives) {
+        bool bodyNullable = false;
+        analyzer.firstOfSequence(GrammarAnalyzer::bodyOf(productions[index]), &bodyNullable);
+        if (bodyNullable && fallback < 0) {
+            fallback = index;
+            continue;
+        }
+
+        QStringList terminals;
+        for (const QString& terminal : analyzer.getPredictSet(index)) {
+            if (terminal != GrammarAnalyzer::EndMarker) terminals << terminal;
+        }
+        std::sort(terminals.begin(), terminals.end());
+        for (const QString& terminal : terminals) {
+            expected << terminal;
+            QString type = tokenTypeFor(terminal);
+            if (type.isEmpty()) {
+                byLexeme.append(qMakePair(terminal, index));
+            } else if (!byType.contains(type)) {
+                byType.insert(type, index);
+            }
+        }
+    }
+
+    std::sort(expected.begin(), expected.end());
+    auto defaultBody = [&](const QString& indent) {
+        if (fallback >= 0) {
+            return emitBody(productions[fallback], indent);
+        }
+        return indent + QString("addError(%1, %2);\n")
+                            .arg(cppString("Expected one of: " + expected.join(" ")))
+                            .arg(cppString(expected.join(" | ")));
+    };
+
+    // Keywords and other lexeme-only terminals are tested before the type switch
+    QString indent = "    ";
+    for (int i = 0; i < byLexeme.size(); ++i) {
+        code += indent + (i == 0 ? "if (" : "} else if (") + matchCondition(byLexeme[i].first) + ") {\n";
+        code += emitBody(productions[byLexeme[i].second], indent + "    ");
+    }
+    if (!byLexeme.isEmpty()) {
+        code += indent + "} else {\n";
+        indent += "    ";
+    }
+
+    if (byType.isEmpty()) {
+        code += defaultBody(indent);
+    } else {
+        code += indent + "switch (peekType()) {\n";
+        // Alternatives sharing a body get stacked case labels
+        for (int index : alternatives) {
+            QStringList labels;
+            for (auto it = byType.constBegin(); it != byType.constEnd(); ++it) {
+                if (it.value() == index) labels << it.key();
+            }
+            if (labels.isEmpty()) continue;
+            for (const QString& label : labels) {
+                code += indent + QString("case TokenType::%1:\n").arg(label);
+            }
+            code += emitBody(productions[index], indent + "    ");
+            code += indent + "    break;\n";
+        }
+        code += indent + "default:\n";
+        code += defaultBody(indent + "    ");
+        code += indent + "    break;\n";
+        code += indent + "}\n";
+    }
+
+    if (!byLexeme.isEmpty()) {
+        code += "    }\n";
+    }
+
+    code += "\n    return node;\n}\n";
+    return code;
+}
+
+QString ParserGenerator::generateHeader() const {
+    QString code;
+    code += QString("// Generated by grammar2cpp from the \"%1\" grammar. Do not edit.\n").arg(grammar.getName());
+    code += QString("#ifndef %1\n#define %1\n\n").arg(headerGuard());
+    code += "#include \"./src/utils/Grammar/Parser.h\"\n";
+    code += "#include \"./src/models/Grammar/ParseTree.h\"\n";
+    code += "#include \"./src/models/LexicalAnalysis/Token.h\"\n";
+    code += "#include <QVector>\n";
+    code += "#include <memory>\n\n";
+
+    bool interned = !lexemeTerminals().isEmpty();
+
+    code += QString("class %1 {\n").arg(className);
+    code += "private:\n";
+    code += "    const QVector<Token>& tokens;\n";
+    code += "    int position;\n";
+    code += "    int end;                    // Token::inputLength(tokens)\n";
+    code += "    QVector<ParseError> errors;\n";
+    if (interned) {
+        code += "    QVector<int> lexemeIds;     // keyword terminal of each token, -1 for none\n";
+    }
+    code += "\npublic:\n";
+    code += QString("    explicit %1(const QVector<Token>& tokens);\n\n").arg(className);
+    code += "    ParseTree parse();\n\n";
+    code += "    QVector<ParseError> getErrors() const { return errors; }\n";
+    code += "    bool hasErrors() const { return !errors.isEmpty(); }\n\n";
+    code += "private:\n";
+    for (const QString& nonTerminal : analyzer.getNonTerminals()) {
+        code += QString("    std::shared_ptr<ParseTreeNode> %1(); // %2\n")
+                    .arg(functionNames.value(nonTerminal)).arg(nonTerminal);
+    }
+    code += "\n";
+    code += "    TokenType peekType() const;\n";
+    if (interned) {
+        code += "    int peekLexemeId() const;\n";
+    }
+    code += "    void shift(const std::shared_ptr<ParseTreeNode>& node, const QString& symbol, bool matches);\n";
+    code += "    void addError(const QString& message, const QString& expected);\n";
+    code += "};\n\n";
+    code += QString("#endif // %1\n").arg(headerGuard());
+    return code;
+}
+
+QString ParserGenerator::generateSource(const QString& headerFileName) const {
+    QString start = analyzer.getStartSymbol();
+    QVector<QString> keywords = lexemeTerminals();
+
+    QString code;
+    code += QString("// Generated by grammar2cpp from the \"%1\" grammar. Do not edit.\n").arg(grammar.getName());
+    code += QString("#include \"%1\"\n").arg(headerFileName);
+    code += keywords.isEmpty() ? "\n" : "#include <QHash>\n\n";
+
+    // Keyword terminals are interned once per token stream; parse functions compare ids
+    code += QString("%1::%1(const QVector<Token>& tokens)\n").arg(className);
+    if (keywords.isEmpty()) {
+        code += "    : tokens(tokens), position(0), end(Token::inputLength(tokens)) {}\n\n";
+    } else {
+        QStringList entries;
+        for (int i = 0; i < keywords.size(); ++i) {
+            entries << QString("{%1, %2}").arg(cppString(keywords[i])).arg(i);
+        }
+        code += "    : tokens(tokens), position(0), end(Token::inputLength(tokens)) {\n";
+        code += QString("    static const QHash<QString, int> keywords = {%1};\n").arg(entries.join(", "));
+        code += "    lexemeIds.reserve(tokens.size());\n";
+        code += "    for (const Token& token : tokens) {\n";
+        code += "        lexemeIds.append(keywords.value(token.getLexeme(), -1));\n";
+        code += "    }\n";
+        code += "}\n\n";
+    }
+
+    code += QString("ParseTree %1::parse() {\n").arg(className);
+    code += "    position = 0;\n";
+    code += "    errors.clear();\n\n";
+    code += QString("    ParseTree tree(%1);\n").arg(cppString(grammar.getName()));
+    code += "    if (tokens.isEmpty()) {\n";
+    code += "        addError(\"Empty token stream\", \"tokens\");\n";
+    code += "        return tree;\n";
+    code += "    }\n\n";
+    code += QString("    tree.setRoot(%1());\n").arg(functionNames.value(start));
+    code += "    if (position < end) {\n";
+    code += QString("        addError(%1, \"EOF\");\n").arg(cppString("Unexpected input after " + start));
+    code += "    }\n";
+    code += "    return tree;\n";
+    code += "}\n\n";
+
+    for (const QString& nonTerminal : analyzer.getNonTerminals()) {
+        code += emitFunction(nonTerminal) + "\n";
+    }
+
+    code += QString("TokenType %1::peekType() const {\n").arg(className);
+    code += "    return position < end ? tokens[position].getType() : TokenType::END_OF_FILE;\n";
+    code += "}\n\n";
+
+    if (!keywords.isEmpty()) {
+        code += QString("int %1::peekLexemeId() const {\n").arg(className);
+        code += "    return position < end ? lexemeIds[position] : -1;\n";
+        code += "}\n\n";
+    }
+
+    code += QString("void %1::shift(const std::shared_ptr<ParseTreeNode>& node, const QString& symbol, bool matches) {\n").arg(className);
+    code += "    if (!matches) {\n";
+    code += "        addError(QString(\"Expected '%1'\").arg(symbol), symbol);\n";
+    code += "        return;\n";
+    code += "    }\n";
+    code += "    node->addChild(std::make_shared<ParseTreeNode>(symbol, tokens[position++].getLexeme(), true));\n";
+    code += "}\n\n";
+
+    code += QString("void %1::addError(const QString& message, const QString& expected) {\n").arg(className);
+    code += "    QString found = position < end\n";
+    code += "        ? QString(\"%1 ('%2')\").arg(tokens[position].getTypeString()).arg(tokens[position].getLexeme())\n";
+    code += "        : QString(\"EOF\");\n";
+    code += "    errors.append(ParseError(message, position, expected, found));\n";
+    code += "}\n";
+    return code;
+}
@@ -0,0 +1,48 @@
+#ifndef PARSERGENERATOR_H
+#define PARSERGENERATOR_H
+
+#include "./src/models/Grammar/Grammar.h"
+#include "GrammarAnalyzer.h"
+#include <QString>
+#include <QMap>
+
+// Emits a direct-coded recursive-descent parser for an LL(1) grammar.
+// Each non-terminal becomes one function that switches on the lookahead
+// token type, so the generated parser needs no tables and no Grammar object
+// at runtime. The output builds the same ParseTree/ParseError values as Parser.
+class ParserGenerator {
+private:
+    Grammar grammar;
+    GrammarAnalyzer analyzer;
+    QString className;
+    QMap<QString, QString> functionNames;   // non-terminal -> parse function name
+
+public:
+    ParserGenerator(const Grammar& grammar, const QString& className);
+
+    bool validate(QString* errorMsg = nullptr) const;
+
+    QString generateHeader() const;
+    QString generateSource(const QString& headerFileName) const;
+
+    /**
+     * Reads a grammar file: one production per line in the form accepted by
+     * the parser tab ("A -> B c" or "A → B c"), '#' comments, and optional
+     * "%name <text>" / "%start <symbol>" directives. Without %start the
+     * first left-hand side is the start symbol.
+     */
+    static bool readGrammarFile(const QString& path, Grammar& grammar, QString* errorMsg = nullptr);
+    static bool parseGrammarText(const QString& text, Grammar& grammar, QString* errorMsg = nullptr);
+
+private:
+    QString headerGuard() const;
+    QString tokenTypeFor(const QString& terminal) const;
+    QVector<QString> lexemeTerminals() const;
+    QString matchCondition(const QString& terminal) const;
+    QString emitFunction(const QString& nonTerminal) const;
+    QString emitBody(const Production& production, const QString& indent) const;
+
+    static QString cppString(const QString& text);
+};
+
+#endif // PARSERGENERATOR_H
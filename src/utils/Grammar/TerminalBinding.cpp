@@ -0,0 +1,68 @@
+#include "TerminalBinding.h"
+
+TerminalBinding::TerminalBinding(const QVector<QString>& terminals)
+    : terminals(terminals), typeTerminals(Token::typeCount(), NoTerminal) {
+    for (int i = 0; i < terminals.size(); ++i) {
+        const QString& terminal = terminals[i];
+        terminalIndex.insert(terminal, i);
+
+        Matcher matcher;
+        if (resolveTokenType(terminal, &matcher.type)) {
+            matcher.lexemeId = -1;
+            int& slot = typeTerminals[static_cast<int>(matcher.type)];
+            if (slot == NoTerminal) slot = i;
+        } else {
+            matcher.type = TokenType::UNKNOWN;
+            matcher.lexemeId = i;
+            lexemeTerminals.insert(terminal, i);
+        }
+        matchers.append(matcher);
+    }
+}
+
+int TerminalBinding::bindToken(const Token& token) const {
+    // Keyword spellings win over the type, so "if" is not taken for an id
+    if (!lexemeTerminals.isEmpty()) {
+        auto it = lexemeTerminals.constFind(token.getLexeme());
+        if (it != lexemeTerminals.constEnd()) {
+            return it.value();
+        }
+    }
+    return typeTerminals.value(static_cast<int>(token.getType()), NoTerminal);
+}
+
+QVector<int> TerminalBinding::bindTokens(const QVector<Token>& tokens) const {
+    QVector<int> bound;
+    bound.reserve(tokens.size());
+    for (const Token& token : tokens) {
+        bound.append(bindToken(token));
+    }
+    return bound;
+}
+
+bool TerminalBinding::resolveTokenType(const QString& terminal, TokenType* type) {
+    if (terminal == "id") {
+        *type = TokenType::IDENTIFIER;
+        return true;
+    }
+    if (terminal == "num") {
+        *type = TokenType::INTEGER_LITERAL;
+        return true;
+    }
+
+    for (int i = 0; i < Token::typeCount(); ++i) {
+        TokenType candidate = static_cast<TokenType>(i);
+        if (terminal == Token::enumeratorName(candidate) || terminal == Token::tokenTypeToString(candidate)) {
+            *type = candidate;
+            return true;
+        }
+    }
+
+    TokenType op = Token::getOperatorType(terminal);
+    if (op != TokenType::UNKNOWN) {
+        *type = op;
+        return true;
+    }
+    return false;
+}
+
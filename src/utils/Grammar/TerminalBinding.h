@@ -0,0 +1,49 @@
+#ifndef TERMINALBINDING_H
+#define TERMINALBINDING_H
+
+#include "./src/models/LexicalAnalysis/Token.h"
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+// Resolves every grammar terminal once to a TokenType or, for keywords and
+// other spellings without a type of their own, to an interned lexeme.
+// A token stream is then bound to terminal indices in one pass, so parsing
+// engines match terminals with integer compares instead of string tests.
+class TerminalBinding {
+public:
+    static constexpr int NoTerminal = -1;
+
+    struct Matcher {
+        TokenType type;         // token type to match when lexemeId < 0
+        int lexemeId;           // interned lexeme, or -1
+    };
+
+    TerminalBinding() {}
+    explicit TerminalBinding(const QVector<QString>& terminals);
+
+    int terminalCount() const { return terminals.size(); }
+    QString terminalAt(int index) const { return terminals.value(index); }
+    int indexOf(const QString& terminal) const { return terminalIndex.value(terminal, NoTerminal); }
+    Matcher matcherAt(int index) const { return matchers.value(index); }
+
+    // Terminal index of each token, NoTerminal where no terminal matches
+    QVector<int> bindTokens(const QVector<Token>& tokens) const;
+    int bindToken(const Token& token) const;
+
+    /**
+     * The spellings a terminal may use for a token type: the aliases "id"
+     * and "num", enumerator names ("PLUS"), display names ("INTEGER"), and
+     * operator or punctuation lexemes ("+", "(").
+     */
+    static bool resolveTokenType(const QString& terminal, TokenType* type);
+
+private:
+    QVector<QString> terminals;
+    QHash<QString, int> terminalIndex;
+    QVector<Matcher> matchers;
+    QHash<QString, int> lexemeTerminals;    // interned lexeme -> terminal index
+    QVector<int> typeTerminals;             // TokenType -> terminal index
+};
+
+#endif // TERMINALBINDING_H
@@ -1,12 +1,15 @@
 #include "AutomatonManager.h"
+#include "./src/utils/Automaton/GlushkovAutomaton.h"
 #include <QDebug>
 
-AutomatonManager::AutomatonManager() {
+AutomatonManager::AutomatonManager()
+    : registry(new AutomatonRegistry()) {
     createDefaultAutomatons();
 }
 
 AutomatonManager::~AutomatonManager() {
     clear();
+    delete registry;
 }
 
 bool AutomatonManager::addAutomaton(const Automaton& automaton) {
@@ -24,6 +27,7 @@ bool AutomatonManager::removeAutomaton(const QString& id) {
 
     automatons.removeAt(index);
     idToIndex.clear();
+    dropCompiled(id);
 
     for (int i = 0; i < automatons.size(); ++i) {
         idToIndex[automatons[i].getId()] = i;
@@ -31,9 +35,13 @@ bool AutomatonManager::removeAutomaton(const QString& id) {
     return true;
 }
 
-Automaton* AutomatonManager::getAutomaton(const QString& id) {
-    int index = getAutomatonIndex(id);
-    return (index != -1) ? &automatons[index] : nullptr;
+bool AutomatonManager::updateAutomaton(const Automaton& automaton) {
+    int index = getAutomatonIndex(automaton.getId());
+    if (index == -1) return false;
+
+    automatons[index] = automaton;
+    dropCompiled(automaton.getId());
+    return true;
 }
 
 const Automaton* AutomatonManager::getAutomaton(const QString& id) const {
@@ -60,11 +68,43 @@ bool AutomatonManager::exists(const QString& id) const {
 void AutomatonManager::clear() {
     automatons.clear();
     idToIndex.clear();
+    dropAllCompiled();
+}
+
+void AutomatonManager::dropCompiled(const QString& id) {
+    compiledById.remove(id);
+    QString key = fingerprintById.take(id);
+
+    // Structurally identical automata still use the registry's entries
+    if (!key.isEmpty() && !fingerprintById.values().contains(key)) {
+        registry->evict(key);
+    }
+}
+
+void AutomatonManager::dropAllCompiled() {
+    for (const QString& key : fingerprintById.values()) {
+        registry->evict(key);
+    }
+    compiledById.clear();
+    fingerprintById.clear();
+}
+
+const CompiledDFA* AutomatonManager::compiledFor(const Automaton& automaton) const {
+    auto it = compiledById.constFind(automaton.getId());
+    if (it != compiledById.constEnd()) {
+        return it.value();
+    }
+
+    const CompiledDFA* compiled = registry->compiled(&automaton);
+    compiledById.insert(automaton.getId(), compiled);
+    fingerprintById.insert(automaton.getId(), AutomatonRegistry::fingerprint(&automaton));
+    return compiled;
 }
 
 QString AutomatonManager::findMatchingAutomaton(const QString& input) const {
     for (const auto& automaton : automatons) {
-        if (automaton.accepts(input)) {
+        const CompiledDFA* compiled = compiledFor(automaton);
+        if (compiled ? compiled->accepts(input) : automaton.accepts(input)) {
             return automaton.getId();
         }
     }
@@ -73,8 +113,20 @@ QString AutomatonManager::findMatchingAutomaton(const QString& input) const {
 
 QVector<QString> AutomatonManager::findAllMatchingAutomatons(const QString& input) const {
     QVector<QString> matches;
+    // Duplicate rules share one table, so each language is run once
+    QHash<const CompiledDFA*, bool> verdicts;
     for (const auto& automaton : automatons) {
-        if (automaton.accepts(input)) {
+        const CompiledDFA* compiled = compiledFor(automaton);
+        bool accepted;
+        if (!compiled) {
+            accepted = automaton.accepts(input);
+        } else if (verdicts.contains(compiled)) {
+            accepted = verdicts.value(compiled);
+        } else {
+            accepted = compiled->accepts(input);
+            verdicts.insert(compiled, accepted);
+        }
+        if (accepted) {
             matches.push_back(automaton.getId());
         }
     }
@@ -88,76 +140,31 @@ void AutomatonManager::createDefaultAutomatons() {
 }
 
 void AutomatonManager::createIdentifierAutomaton() {
-    Automaton automaton("IDENTIFIER", "Identifier", AutomatonType::DFA);
-
-    State s0("q0", "q0", QPointF(100, 100));
-    s0.setIsInitial(true);
-    State s1("q1", "q1", QPointF(200, 100));
-    s1.setIsFinal(true);
-
-    automaton.addState(s0);
-    automaton.addState(s1);
-
-    for (char c = 'a'; c <= 'z'; ++c) {
-        automaton.addTransition(Transition("q0", "q1", QString(c)));
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-    }
-    for (char c = 'A'; c <= 'Z'; ++c) {
-        automaton.addTransition(Transition("q0", "q1", QString(c)));
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-    }
-    automaton.addTransition(Transition("q0", "q1", "_"));
-    automaton.addTransition(Transition("q1", "q1", "_"));
-
-    for (char c = '0'; c <= '9'; ++c) {
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-    }
-
-    addAutomaton(automaton);
+    addRegexAutomaton("IDENTIFIER", "Identifier", "[A-Za-z_][A-Za-z0-9_]*");
 }
 
 void AutomatonManager::createIntegerAutomaton() {
-    Automaton automaton("INTEGER", "Integer", AutomatonType::DFA);
-
-    State s0("q0", "q0", QPointF(100, 200));
-    s0.setIsInitial(true);
-    State s1("q1", "q1", QPointF(200, 200));
-    s1.setIsFinal(true);
-
-    automaton.addState(s0);
-    automaton.addState(s1);
-
-    for (char c = '0'; c <= '9'; ++c) {
-        automaton.addTransition(Transition("q0", "q1", QString(c)));
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-    }
-
-    addAutomaton(automaton);
+    addRegexAutomaton("INTEGER", "Integer", "[0-9]+");
 }
 
 void AutomatonManager::createFloatAutomaton() {
-    Automaton automaton("FLOAT", "Float", AutomatonType::DFA);
-
-    State s0("q0", "q0", QPointF(100, 300));
-    s0.setIsInitial(true);
-    State s1("q1", "q1", QPointF(200, 300));
-    State s2("q2", "q2", QPointF(300, 300));
-    State s3("q3", "q3", QPointF(400, 300));
-    s3.setIsFinal(true);
-
-    automaton.addState(s0);
-    automaton.addState(s1);
-    automaton.addState(s2);
-    automaton.addState(s3);
-
-    for (char c = '0'; c <= '9'; ++c) {
-        automaton.addTransition(Transition("q0", "q1", QString(c)));
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-        automaton.addTransition(Transition("q2", "q3", QString(c)));
-        automaton.addTransition(Transition("q3", "q3", QString(c)));
-    }
+    addRegexAutomaton("FLOAT", "Float", "[0-9]+\\.[0-9]+");
+}
 
-    automaton.addTransition(Transition("q1", "q2", "."));
+bool AutomatonManager::addRegexAutomaton(const QString& id, const QString& name,
+                                         const QString& pattern, QString* errorMsg) {
+    GlushkovAutomaton positions;
+    CompiledDFA dfa;
+    if (!positions.build(pattern, errorMsg) || !positions.toDFA(dfa, errorMsg)) {
+        return false;
+    }
 
-    addAutomaton(automaton);
+    Automaton* automaton = dfa.toAutomaton(id, name);
+    automaton->getLayout().arrangeInGrid(automaton->getStates());
+    bool added = addAutomaton(*automaton);
+    delete automaton;
+    if (!added && errorMsg) {
+        *errorMsg = QString("Automaton '%1' already exists.").arg(id);
+    }
+    return added;
 }
@@ -2,25 +2,34 @@
 #define AUTOMATONMANAGER_H
 
 #include "./src/models/Automaton/Automaton.h"
+#include "./src/utils/Automaton/AutomatonRegistry.h"
 #include <QVector>
 #include <QMap>
+#include <QHash>
 
 class AutomatonManager {
 private:
     QVector<Automaton> automatons;
     QMap<QString, int> idToIndex;
+    AutomatonRegistry* registry;                                // shared tables for equivalent automata
+    mutable QHash<QString, const CompiledDFA*> compiledById;    // dropped when an automaton is replaced or removed
+    mutable QHash<QString, QString> fingerprintById;            // registry key each table was looked up by
 
 public:
     AutomatonManager();
     ~AutomatonManager();
 
+    // Owns its registry, whose tables compiledById points into
+    AutomatonManager(const AutomatonManager&) = delete;
+    AutomatonManager& operator=(const AutomatonManager&) = delete;
+
     bool addAutomaton(const Automaton& automaton);
     bool removeAutomaton(const QString& id);
-    Automaton* getAutomaton(const QString& id);
+    // Edits go through a replacement, so lookups never invalidate the tables
+    bool updateAutomaton(const Automaton& automaton);
     const Automaton* getAutomaton(const QString& id) const;
     int getAutomatonIndex(const QString& id) const;
 
-    QVector<Automaton>& getAutomatons() { return automatons; }
     const QVector<Automaton>& getAutomatons() const { return automatons; }
     int getCount() const { return automatons.size(); }
     void clear();
@@ -31,10 +40,21 @@ public:
     QString findMatchingAutomaton(const QString& input) const;
     QVector<QString> findAllMatchingAutomatons(const QString& input) const;
 
+    AutomatonRegistry* getRegistry() { return registry; }
+
     void createDefaultAutomatons();
     void createIdentifierAutomaton();
     void createIntegerAutomaton();
     void createFloatAutomaton();
+
+    // Compiles a regex straight to a DFA via its position automaton
+    bool addRegexAutomaton(const QString& id, const QString& name,
+                           const QString& pattern, QString* errorMsg = nullptr);
+
+private:
+    const CompiledDFA* compiledFor(const Automaton& automaton) const;
+    void dropCompiled(const QString& id);
+    void dropAllCompiled();
 };
 
 #endif // AUTOMATONMANAGER_H
@@ -22,6 +22,8 @@ bool Lexer::tokenize(const QString& sourceCode) {
     while (!isAtEnd()) {
         Token token = scanToken();
 
+        // Trailing whitespace leaves scanToken at the end; one EOF is added below
+        if (token.getType() == TokenType::END_OF_FILE) break;
         if (token.getType() == TokenType::WHITESPACE && skipWhitespace) continue;
         if (token.getType() == TokenType::COMMENT && skipComments) continue;
         if (token.getType() != TokenType::UNKNOWN) {
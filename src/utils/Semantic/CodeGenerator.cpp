@@ -7,7 +7,9 @@
 #include <QCoreApplication>
 
 CodeGenerator::CodeGenerator()
-    : symbolTable(nullptr), targetLanguage(TargetLanguage::PYTHON),
+    : symbolTable(nullptr), targetLanguage(TargetLanguage::PYTHON), vectorISA(VectorISA::SSE2),
+    optimizationLevel(0), tuneCore(CoreModel::SKYLAKE), instrumentProfile(false),
+    profileOutputPath("default.prof"), profileApplied(false), probeCounter(0), lastStatementExits(false),
     indentLevel(0), currentPosition(0), labelCounter(0), inGlobalScope(true) {}
 
 CodeGenerator::~CodeGenerator() {}
@@ -26,6 +28,23 @@ void CodeGenerator::setTargetLanguage(TargetLanguage lang) {
     targetLanguage = lang;
 }
 
+void CodeGenerator::setVectorISA(VectorISA isa) {
+    vectorISA = isa;
+}
+
+void CodeGenerator::setOptimizationLevel(int level) {
+    optimizationLevel = qBound(0, level, 2);
+}
+
+void CodeGenerator::setTuneCore(CoreModel core) {
+    tuneCore = core;
+}
+
+void CodeGenerator::setProfileInstrumentation(bool enabled, const QString& outputPath) {
+    instrumentProfile = enabled;
+    profileOutputPath = outputPath.isEmpty() ? QString("default.prof") : outputPath;
+}
+
 
 
 
@@ -39,6 +58,11 @@ void CodeGenerator::reset() {
     currentPosition = 0;
     labelCounter = 0;
     inGlobalScope = true;
+    scheduleStats = ScheduleStats();
+    probeCounter = 0;
+    coldSection.clear();
+    profileApplied = false;
+    lastStatementExits = false;
 }
 
 QString CodeGenerator::generate() {
@@ -176,9 +200,13 @@ QString CodeGenerator::translateToAssembly() {
     QString bss_section = "section .bss\n";
     QString text_section = "section .text\n    global _start\n\n_start:\n";
 
+    // Arrays get their full size reserved; the symbol table only records the name
+    QMap<QString, int> intArrays = findIntArrays();
+
     if (symbolTable) {
         for(const auto& sym : symbolTable->getDiscoveredSymbols()) {
-            bool isExpression = !sym.value.isEmpty() && (sym.value.contains('+') || sym.value.contains('-') || sym.value.contains('*') || sym.value.contains('/'));
+            if (intArrays.contains(sym.name)) continue;
+            bool isExpression = !sym.value.isEmpty() && (sym.value.contains('+') || sym.value.contains('-') || sym.value.contains('*') || sym.value.contains('/') || sym.value.contains('%'));
             
             if (!sym.value.isEmpty() && !isExpression) {
                 QString val = sym.value;
@@ -199,60 +227,372 @@ QString CodeGenerator::translateToAssembly() {
         }
     }
 
+    for (auto it = intArrays.constBegin(); it != intArrays.constEnd(); ++it) {
+        bss_section += QString("    %1 resd %2\n").arg(it.key()).arg(it.value());
+    }
+
+    LoopVectorizer vectorizer;
+    vectorizer.setISA(vectorISA);
+    vectorizer.setIntArrays(intArrays);
+
+    // Probes are numbered in source order in every mode, so a profile taken
+    // from the instrumented build lines up with this one
+    quint32 programHash = ProgramProfile::hashTokens(tokens);
+    activeProfile = instrumentProfile ? ProgramProfile() : ProgramProfile::mergeMatching(profiles, programHash);
+    profileApplied = !activeProfile.isEmpty();
+
     currentPosition = 0;
     while(!isAtEnd()) {
-        Token tok = peek();
-        if (tok.getType() == TokenType::KEYWORD && isTypeKeyword(tok.getLexeme())) {
-            advance(); 
-            QString varName = advance().getLexeme();
-
-            if (match(TokenType::ASSIGN)) {
-                Token lhs = advance();
-                if(check(TokenType::SEMICOLON)) { 
-                    text_section += QString("    ; %1 = %2\n").arg(varName).arg(lhs.getLexeme());
-                    QString lhs_operand = lhs.getType() == TokenType::IDENTIFIER ? QString("[%1]").arg(lhs.getLexeme()) : lhs.getLexeme();
-                    text_section += QString("    mov eax, %1\n").arg(lhs_operand);
-                    text_section += QString("    mov [%1], eax\n\n").arg(varName);
-                    match(TokenType::SEMICOLON);
-                    continue;
-                }
-                Token op = advance();
-                Token rhs = advance();
-                
-                QString lhs_operand = lhs.getType() == TokenType::IDENTIFIER ? QString("[%1]").arg(lhs.getLexeme()) : lhs.getLexeme();
-                QString rhs_operand = rhs.getType() == TokenType::IDENTIFIER ? QString("[%1]").arg(rhs.getLexeme()) : rhs.getLexeme();
-
-                text_section += QString("    ; %1 = %2 %3 %4\n").arg(varName).arg(lhs.getLexeme()).arg(op.getLexeme()).arg(rhs.getLexeme());
-                text_section += QString("    mov eax, %1\n").arg(lhs_operand);
-
-                if (op.getLexeme() == "+") {
-                    text_section += QString("    add eax, %1\n").arg(rhs_operand);
-                } else if (op.getLexeme() == "-") {
-                    text_section += QString("    sub eax, %1\n").arg(rhs_operand);
-                }
-                text_section += QString("    mov [%1], eax\n\n").arg(varName);
-            }
-            match(TokenType::SEMICOLON);
+        emitAssemblyStatement(text_section, vectorizer);
+    }
+
+    if (!lastStatementExits) {
+        text_section += emitAssemblyExit("0");
+    }
+    text_section += coldSection;
+
+    if (instrumentProfile) {
+        data_section += QString("    __prof db 'CPRF'\n"
+                                "    dd %1, 0x%2, %3\n"
+                                "    __prof_counts times %3 dd 0\n"
+                                "    __prof_size equ $ - __prof\n"
+                                "    __prof_path db \"%4\", 0\n")
+                            .arg(ProgramProfile::Version)
+                            .arg(programHash, 8, 16, QChar('0'))
+                            .arg(probeCounter)
+                            .arg(profileOutputPath);
+    }
+
+    QString program = data_section + bss_section + text_section;
+    if (optimizationLevel == 0) {
+        return program;
+    }
+
+    InstructionScheduler scheduler;
+    scheduler.setCoreModel(tuneCore);
+    scheduler.setRenaming(optimizationLevel >= 2);
+    return scheduler.schedule(program, &scheduleStats);
+}
+
+// ============================================================
+// Assembly statements
+// ============================================================
+
+namespace {
+
+// A branch side or loop body taken on fewer than 1 in ColdShare executions
+// is moved out of line
+const quint64 ColdShare = 10;
+// Unrolled loop bodies stay below this many lines of assembly
+const int MaxUnrolledLines = 64;
+
+QString assemblyOperand(const Token& token) {
+    return token.getType() == TokenType::IDENTIFIER ? QString("[%1]").arg(token.getLexeme()) : token.getLexeme();
+}
+
+bool isCold(quint64 count, quint64 total) {
+    return count * ColdShare < total;
+}
+
+} // namespace
+
+void CodeGenerator::emitAssemblyStatement(QString& text, LoopVectorizer& vectorizer) {
+    Token tok = peek();
+    lastStatementExits = false;
+
+    if (tok.getType() == TokenType::KEYWORD && tok.getLexeme() == "for") {
+        // Counted array loops are vectorized; anything else is skipped as before
+        int consumed = 0;
+        if (vectorizer.translate(tokens, currentPosition, generateLabel(), text, &consumed)) {
+            currentPosition += consumed;
+        } else {
+            advance();
         }
-        else if (tok.getType() == TokenType::KEYWORD && tok.getLexeme() == "return") {
-            advance(); 
-            Token retVal = advance(); 
-            match(TokenType::SEMICOLON);
-            text_section += "    ; return " + retVal.getLexeme() + "\n";
-            text_section += "    mov eax, 1\n";
-            text_section += "    mov ebx, " + retVal.getLexeme() + "\n";
-            text_section += "    int 0x80\n\n";
+    }
+    else if (tok.getType() == TokenType::KEYWORD && isTypeKeyword(tok.getLexeme())) {
+        advance();
+        QString varName = advance().getLexeme();
+        if (match(TokenType::ASSIGN)) {
+            emitAssemblyValue(text, varName);
         }
-        else {
-            advance(); 
+        match(TokenType::SEMICOLON);
+    }
+    else if (tok.getType() == TokenType::IDENTIFIER && peekAhead(1).getType() == TokenType::ASSIGN) {
+        QString varName = advance().getLexeme();
+        advance();
+        emitAssemblyValue(text, varName);
+        match(TokenType::SEMICOLON);
+    }
+    else if (tok.getType() == TokenType::KEYWORD && tok.getLexeme() == "if") {
+        emitAssemblyIf(text, vectorizer);
+    }
+    else if (tok.getType() == TokenType::KEYWORD && tok.getLexeme() == "while") {
+        emitAssemblyWhile(text, vectorizer);
+    }
+    else if (tok.getType() == TokenType::KEYWORD && tok.getLexeme() == "return") {
+        advance();
+        Token retVal = check(TokenType::SEMICOLON) ? Token(TokenType::INTEGER_LITERAL, "0") : advance();
+        match(TokenType::SEMICOLON);
+        text += "    ; return " + retVal.getLexeme() + "\n";
+        text += emitAssemblyExit(assemblyOperand(retVal)) + "\n";
+        lastStatementExits = true;
+    }
+    else if (tok.getType() == TokenType::LBRACE) {
+        text += emitAssemblyBody(vectorizer);
+    }
+    else {
+        advance();
+    }
+}
+
+// Emits "varName = lhs [op rhs]" with the cursor just past '='
+void CodeGenerator::emitAssemblyValue(QString& text, const QString& varName) {
+    Token lhs = advance();
+    QString lhs_operand = assemblyOperand(lhs);
+    if (check(TokenType::SEMICOLON)) {
+        text += QString("    ; %1 = %2\n").arg(varName).arg(lhs.getLexeme());
+        text += QString("    mov eax, %1\n").arg(lhs_operand);
+        text += QString("    mov [%1], eax\n\n").arg(varName);
+        return;
+    }
+    Token op = advance();
+    Token rhs = advance();
+    QString rhs_operand = assemblyOperand(rhs);
+
+    text += QString("    ; %1 = %2 %3 %4\n").arg(varName).arg(lhs.getLexeme()).arg(op.getLexeme()).arg(rhs.getLexeme());
+    text += QString("    mov eax, %1\n").arg(lhs_operand);
+
+    // idiv leaves the quotient in eax and the remainder in edx
+    QString result = "eax";
+    if (op.getLexeme() == "+") {
+        text += QString("    add eax, %1\n").arg(rhs_operand);
+    } else if (op.getLexeme() == "-") {
+        text += QString("    sub eax, %1\n").arg(rhs_operand);
+    } else if (op.getLexeme() == "*") {
+        if (rhs.getType() == TokenType::IDENTIFIER) {
+            text += QString("    imul eax, dword %1\n").arg(rhs_operand);
+        } else {
+            text += QString("    imul eax, eax, %1\n").arg(rhs_operand);
+        }
+    } else if (op.getLexeme() == "/" || op.getLexeme() == "%") {
+        QString divisor = QString("dword %1").arg(rhs_operand);
+        if (rhs.getType() != TokenType::IDENTIFIER) {
+            text += QString("    mov ecx, %1\n").arg(rhs_operand);
+            divisor = "ecx";
         }
+        text += "    cdq\n";
+        text += QString("    idiv %1\n").arg(divisor);
+        if (op.getLexeme() == "%") result = "edx";
     }
+    text += QString("    mov [%1], %2\n\n").arg(varName).arg(result);
+}
 
-    if (!text_section.contains("int 0x80")) {
-        text_section += "    mov eax, 1\n    mov ebx, 0\n    int 0x80\n";
+// Emits a braced block or a single statement into its own buffer, so the
+// caller can place it
+QString CodeGenerator::emitAssemblyBody(LoopVectorizer& vectorizer) {
+    QString body;
+    if (match(TokenType::LBRACE)) {
+        while (!isAtEnd() && !check(TokenType::RBRACE)) {
+            emitAssemblyStatement(body, vectorizer);
+        }
+        match(TokenType::RBRACE);
+    } else if (!isAtEnd()) {
+        emitAssemblyStatement(body, vectorizer);
+    }
+    return body;
+}
+
+// Recognizes "( a relop b )" over identifiers and integer literals and
+// emits the compare; the caller picks which of the two jumps to use
+bool CodeGenerator::emitAssemblyCondition(QString& test, QString* source,
+                                          QString* jumpIfTrue, QString* jumpIfFalse) {
+    static const struct { TokenType type; const char* ifTrue; const char* ifFalse; } relations[] = {
+        { TokenType::LESS_THAN, "jl", "jge" },
+        { TokenType::LESS_EQUAL, "jle", "jg" },
+        { TokenType::GREATER_THAN, "jg", "jle" },
+        { TokenType::GREATER_EQUAL, "jge", "jl" },
+        { TokenType::EQUAL, "je", "jne" },
+        { TokenType::NOT_EQUAL, "jne", "je" },
+    };
+
+    Token left = peekAhead(1);
+    Token relop = peekAhead(2);
+    Token right = peekAhead(3);
+    auto isOperand = [](const Token& t) {
+        return t.getType() == TokenType::IDENTIFIER || t.getType() == TokenType::INTEGER_LITERAL;
+    };
+    if (!check(TokenType::LPAREN) || peekAhead(4).getType() != TokenType::RPAREN ||
+        !isOperand(left) || !isOperand(right)) {
+        return false;
     }
 
-    return data_section + bss_section + text_section;
+    for (const auto& relation : relations) {
+        if (relation.type == relop.getType()) {
+            test = QString("    mov eax, %1\n    cmp eax, %2\n").arg(assemblyOperand(left)).arg(assemblyOperand(right));
+            *source = QString("%1 %2 %3").arg(left.getLexeme()).arg(relop.getLexeme()).arg(right.getLexeme());
+            *jumpIfTrue = relation.ifTrue;
+            *jumpIfFalse = relation.ifFalse;
+            currentPosition += 5;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CodeGenerator::emitAssemblyIf(QString& text, LoopVectorizer& vectorizer) {
+    advance(); // 'if'
+    QString test, condition, jumpIfTrue, jumpIfFalse;
+    if (!emitAssemblyCondition(test, &condition, &jumpIfTrue, &jumpIfFalse)) {
+        return;     // other conditions are flattened as before
+    }
+
+    QString label = generateLabel();
+    int thenProbe = probeCounter++;
+    int elseProbe = probeCounter++;
+    QString thenBody = emitAssemblyBody(vectorizer);
+    QString elseBody;
+    bool hasElse = false;
+    if (check(TokenType::KEYWORD) && peek().getLexeme() == "else") {
+        advance();
+        elseBody = emitAssemblyBody(vectorizer);
+        hasElse = true;
+    }
+    lastStatementExits = false;
+
+    QString thenLabel = QString(".%1_then").arg(label);
+    QString elseLabel = QString(".%1_else").arg(label);
+    QString endLabel = QString(".%1_end").arg(label);
+    QString jumpToEnd = QString("    jmp %1\n").arg(endLabel);
+
+    text += QString("    ; if (%1)\n").arg(condition) + test;
+    if (instrumentProfile) {
+        // One counter per edge; a missing else still gets its block
+        thenBody.prepend(emitProbe(thenProbe));
+        elseBody.prepend(emitProbe(elseProbe));
+        hasElse = true;
+    }
+
+    quint64 thenCount = activeProfile.count(thenProbe);
+    quint64 elseCount = activeProfile.count(elseProbe);
+    quint64 total = thenCount + elseCount;
+    bool thenCold = total > 0 && isCold(thenCount, total);
+    bool elseCold = total > 0 && isCold(elseCount, total);
+
+    if (thenCount < elseCount && (hasElse || thenCold)) {
+        // Inverted: the hotter else side falls through
+        text += QString("    %1 %2\n").arg(jumpIfTrue).arg(thenLabel);
+        text += elseBody;
+        if (thenCold) {
+            coldSection += QString("%1:\n").arg(thenLabel) + thenBody + jumpToEnd;
+        } else {
+            text += jumpToEnd + QString("%1:\n").arg(thenLabel) + thenBody;
+        }
+    } else if (!hasElse) {
+        text += QString("    %1 %2\n").arg(jumpIfFalse).arg(endLabel);
+        text += thenBody;
+    } else {
+        text += QString("    %1 %2\n").arg(jumpIfFalse).arg(elseLabel);
+        text += thenBody;
+        if (elseCold) {
+            coldSection += QString("%1:\n").arg(elseLabel) + elseBody + jumpToEnd;
+        } else {
+            text += jumpToEnd + QString("%1:\n").arg(elseLabel) + elseBody;
+        }
+    }
+    text += QString("%1:\n").arg(endLabel);
+}
+
+void CodeGenerator::emitAssemblyWhile(QString& text, LoopVectorizer& vectorizer) {
+    advance(); // 'while'
+    QString test, condition, jumpIfTrue, jumpIfFalse;
+    if (!emitAssemblyCondition(test, &condition, &jumpIfTrue, &jumpIfFalse)) {
+        return;
+    }
+
+    QString label = generateLabel();
+    int entryProbe = probeCounter++;
+    int bodyProbe = probeCounter++;
+    QString body = emitAssemblyBody(vectorizer);
+    lastStatementExits = false;
+
+    QString topLabel = QString(".%1_top").arg(label);
+    QString bodyLabel = QString(".%1_body").arg(label);
+    QString endLabel = QString(".%1_end").arg(label);
+    QString exitTest = test + QString("    %1 %2\n").arg(jumpIfFalse).arg(endLabel);
+    QString backTest = test + QString("    %1 %2\n").arg(jumpIfTrue).arg(bodyLabel);
+
+    text += QString("    ; while (%1)\n").arg(condition);
+
+    quint64 entries = activeProfile.count(entryProbe);
+    quint64 iterations = activeProfile.count(bodyProbe);
+    if (instrumentProfile || entries == 0) {
+        if (instrumentProfile) {
+            text += emitProbe(entryProbe);
+            body.prepend(emitProbe(bodyProbe));
+        }
+        text += QString("%1:\n").arg(topLabel) + exitTest + body;
+        text += QString("    jmp %1\n%2:\n").arg(topLabel).arg(endLabel);
+        return;
+    }
+
+    if (isCold(iterations, entries)) {
+        // The body rarely runs: only the entry test stays inline
+        text += test + QString("    %1 %2\n").arg(jumpIfTrue).arg(bodyLabel);
+        text += QString("%1:\n").arg(endLabel);
+        coldSection += QString("%1:\n").arg(bodyLabel) + body + backTest + QString("    jmp %1\n").arg(endLabel);
+        return;
+    }
+
+    // Rotated: one test on entry and a bottom test that jumps back. Long
+    // running loops repeat straight-line bodies, testing between copies.
+    quint64 trips = iterations / entries;
+    int factor = trips >= 16 ? 4 : trips >= 4 ? 2 : 1;
+    bool straightLine = true;
+    for (const QString& line : body.split('\n')) {
+        if (line.trimmed().endsWith(':')) {
+            straightLine = false;   // labels cannot be duplicated
+        }
+    }
+    while (factor > 1 && (!straightLine || body.count('\n') * factor > MaxUnrolledLines)) {
+        factor /= 2;
+    }
+
+    text += exitTest + QString("%1:\n").arg(bodyLabel) + body;
+    for (int copy = 1; copy < factor; ++copy) {
+        text += exitTest + body;
+    }
+    text += backTest + QString("%1:\n").arg(endLabel);
+}
+
+QString CodeGenerator::emitProbe(int probe) const {
+    return QString("    inc dword [__prof_counts + %1]\n").arg(4 * probe);
+}
+
+QString CodeGenerator::emitAssemblyExit(const QString& status) const {
+    QString code;
+    if (instrumentProfile) {
+        // open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644), write the counters, close
+        code += "    mov eax, 5\n    mov ebx, __prof_path\n    mov ecx, 0x241\n    mov edx, 420\n    int 0x80\n";
+        code += "    mov ebx, eax\n    mov eax, 4\n    mov ecx, __prof\n    mov edx, __prof_size\n    int 0x80\n";
+        code += "    mov eax, 6\n    int 0x80\n";
+    }
+    code += QString("    mov eax, 1\n    mov ebx, %1\n    int 0x80\n").arg(status);
+    return code;
+}
+
+QMap<QString, int> CodeGenerator::findIntArrays() const {
+    // Pattern: int name [ size ]
+    QMap<QString, int> arrays;
+    for (int i = 0; i + 4 < tokens.size(); ++i) {
+        if (tokens[i].getLexeme() == "int" &&
+            tokens[i + 1].getType() == TokenType::IDENTIFIER &&
+            tokens[i + 2].getType() == TokenType::LBRACKET &&
+            tokens[i + 3].getType() == TokenType::INTEGER_LITERAL &&
+            tokens[i + 4].getType() == TokenType::RBRACKET) {
+            arrays.insert(tokens[i + 1].getLexeme(), tokens[i + 3].getLexeme().toInt());
+        }
+    }
+    return arrays;
 }
 
 // ============================================================
@@ -3,6 +3,9 @@
 
 #include "./models/LexicalAnalysis/Token.h"
 #include "./models/Semantic/SymbolTable.h"
+#include "LoopVectorizer.h"
+#include "InstructionScheduler.h"
+#include "ProgramProfile.h"
 #include <QString>
 #include <QVector>
 #include <QProcess>
@@ -19,6 +22,20 @@ private:
     QVector<Token> tokens;
     SymbolTable* symbolTable;
     TargetLanguage targetLanguage;
+    VectorISA vectorISA;              // packed instruction set for the assembly backend
+    int optimizationLevel;            // assembly backend: 0 as emitted, 1 scheduled, 2 scheduled with renaming
+    CoreModel tuneCore;               // latency model the scheduler targets
+    ScheduleStats scheduleStats;      // of the last assembly generation
+
+    // Profile-guided assembly generation
+    bool instrumentProfile;           // count branch edges and loop trips, written on exit
+    QString profileOutputPath;        // file the instrumented program writes
+    QVector<ProgramProfile> profiles; // training runs; those recorded for this program are used
+    ProgramProfile activeProfile;
+    bool profileApplied;
+    int probeCounter;
+    QString coldSection;              // rarely run blocks, placed after the program's exit
+    bool lastStatementExits;
     QString generatedCode;
     QString m_sourceCode;
 
@@ -35,6 +52,15 @@ public:
     void setTokens(const QVector<Token>& toks);
     void setSymbolTable(SymbolTable* table);
     void setTargetLanguage(TargetLanguage lang);
+    void setVectorISA(VectorISA isa);
+    void setOptimizationLevel(int level);
+    int getOptimizationLevel() const { return optimizationLevel; }
+    void setTuneCore(CoreModel core);
+    ScheduleStats getScheduleStats() const { return scheduleStats; }
+    void setProfileInstrumentation(bool enabled, const QString& outputPath = QString());
+    void setProfiles(const QVector<ProgramProfile>& training) { profiles = training; }
+    // Whether the last assembly generation found a profile for its program
+    bool getProfileApplied() const { return profileApplied; }
 
     void setSourceCode(const QString& source);
 
@@ -48,6 +74,17 @@ private:
     QString translateToJava();
     QString translateToJavaScript();
     QString translateToAssembly();
+    QMap<QString, int> findIntArrays() const;
+
+    // --- Assembly statements ---
+    void emitAssemblyStatement(QString& text, LoopVectorizer& vectorizer);
+    void emitAssemblyValue(QString& text, const QString& varName);
+    QString emitAssemblyBody(LoopVectorizer& vectorizer);
+    bool emitAssemblyCondition(QString& test, QString* source, QString* jumpIfTrue, QString* jumpIfFalse);
+    void emitAssemblyIf(QString& text, LoopVectorizer& vectorizer);
+    void emitAssemblyWhile(QString& text, LoopVectorizer& vectorizer);
+    QString emitProbe(int probe) const;
+    QString emitAssemblyExit(const QString& status) const;
 
 
 
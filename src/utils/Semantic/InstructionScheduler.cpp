@@ -0,0 +1,1079 @@
+#include "InstructionScheduler.h"
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+
+namespace {
+
+const quint64 ALL_REGS = ~quint64(0);
+const int EAX = 0, ECX = 1, EDX = 2, EBX = 3;
+const int RENAMABLE[] = {EAX, ECX, EDX, EBX, 6, 7};   // esp and ebp are never touched
+
+const char* const GPR32[] = {"eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi",
+                             "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d"};
+const char* const GPR64[] = {"rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+                             "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"};
+const char* const PARTIAL[] = {"al", "ah", "ax", "cl", "ch", "cx", "dl", "dh", "dx", "bl", "bh", "bx",
+                               "sp", "spl", "bp", "bpl", "si", "sil", "di", "dil"};
+
+quint64 bit(int reg) {
+    return quint64(1) << reg;
+}
+
+bool isRenamableName(const QString& name) {
+    QString lower = name.toLower();
+    for (int reg : RENAMABLE) {
+        if (lower == GPR32[reg]) return true;
+    }
+    return false;
+}
+
+bool isIdentifierStart(QChar c) {
+    return c.isLetter() || c == '_' || c == '.' || c == '$' || c == '?';
+}
+
+bool isIdentifierChar(QChar c) {
+    return c.isLetterOrNumber() || c == '_' || c == '.' || c == '$' || c == '?' || c == '@' || c == '#' || c == '~';
+}
+
+// (start, length) of every identifier that is not the tail of a number
+QVector<QPair<int, int>> identifiers(const QString& text) {
+    QVector<QPair<int, int>> result;
+    int i = 0;
+    while (i < text.size()) {
+        if (isIdentifierChar(text[i]) && !isIdentifierStart(text[i])) {
+            while (i < text.size() && isIdentifierChar(text[i])) ++i;
+            continue;
+        }
+        if (isIdentifierStart(text[i])) {
+            int start = i;
+            while (i < text.size() && isIdentifierChar(text[i])) ++i;
+            result.append(qMakePair(start, i - start));
+            continue;
+        }
+        ++i;
+    }
+    return result;
+}
+
+// First ';' that is not inside a character or string literal
+int commentStart(const QString& line) {
+    QChar quote;
+    for (int i = 0; i < line.size(); ++i) {
+        QChar c = line[i];
+        if (!quote.isNull()) {
+            if (c == quote) quote = QChar();
+        } else if (c == '\'' || c == '"' || c == '`') {
+            quote = c;
+        } else if (c == ';') {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QStringList splitOperands(const QString& text) {
+    QStringList parts;
+    QString current;
+    QChar quote;
+    int depth = 0;
+    for (QChar c : text) {
+        if (!quote.isNull()) {
+            if (c == quote) quote = QChar();
+        } else if (c == '\'' || c == '"' || c == '`') {
+            quote = c;
+        } else if (c == '[') {
+            ++depth;
+        } else if (c == ']') {
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            parts.append(current.trimmed());
+            current.clear();
+            continue;
+        }
+        current += c;
+    }
+    if (!current.trimmed().isEmpty()) {
+        parts.append(current.trimmed());
+    }
+    return parts;
+}
+
+bool isConditionalJump(const QString& mnemonic) {
+    static const QSet<QString> jumps = {
+        "ja", "jae", "jb", "jbe", "jc", "je", "jg", "jge", "jl", "jle", "jna", "jnae", "jnb", "jnbe",
+        "jnc", "jne", "jng", "jnge", "jnl", "jnle", "jno", "jnp", "jns", "jnz", "jo", "jp", "jpe",
+        "jpo", "js", "jz"
+    };
+    return jumps.contains(mnemonic);
+}
+
+} // namespace
+
+MachineModel MachineModel::forCore(CoreModel core) {
+    MachineModel m;
+    if (core == CoreModel::ZEN2) {
+        m.name = "Zen 2";
+        m.issueWidth = 5;
+        int units[UnitCount] = {4, 2, 1, 1, 1, 4, 2, 2};
+        std::copy(units, units + UnitCount, m.units);
+        m.aluLatency = 1;
+        m.loadLatency = 4;
+        m.vectorLoadLatency = 7;
+        m.storeForwardLatency = 7;
+        m.mulLatency = 3;
+        m.divLatency = 25;
+        m.divBusy = 14;
+        m.vectorLatency = 1;
+        m.vectorMulLatency = 4;
+        m.widenMulLatency = 3;
+        m.shuffleLatency = 1;
+    } else {
+        m.name = "Skylake";
+        m.issueWidth = 4;
+        int units[UnitCount] = {4, 2, 1, 1, 1, 3, 2, 1};
+        std::copy(units, units + UnitCount, m.units);
+        m.aluLatency = 1;
+        m.loadLatency = 5;
+        m.vectorLoadLatency = 6;
+        m.storeForwardLatency = 5;
+        m.mulLatency = 3;
+        m.divLatency = 26;
+        m.divBusy = 6;
+        m.vectorLatency = 1;
+        m.vectorMulLatency = 10;
+        m.widenMulLatency = 5;
+        m.shuffleLatency = 1;
+    }
+    return m;
+}
+
+InstructionScheduler::InstructionScheduler()
+    : core(CoreModel::SKYLAKE), model(MachineModel::forCore(CoreModel::SKYLAKE)), renaming(true) {}
+
+void InstructionScheduler::setCoreModel(CoreModel target) {
+    core = target;
+    model = MachineModel::forCore(target);
+}
+
+QString InstructionScheduler::coreName(CoreModel target) {
+    return MachineModel::forCore(target).name;
+}
+
+// ============================================================
+// Parsing
+// ============================================================
+
+int InstructionScheduler::registerNumber(const QString& name) {
+    QString lower = name.toLower();
+    for (int r = 0; r < 16; ++r) {
+        if (lower == GPR32[r] || lower == GPR64[r]) return r;
+    }
+    if ((lower.startsWith("xmm") || lower.startsWith("ymm")) && lower.size() > 3) {
+        bool ok = false;
+        int index = lower.mid(3).toInt(&ok);
+        if (ok && index >= 0 && index < 16) return 16 + index;
+    }
+    for (const char* partial : PARTIAL) {
+        if (lower == partial) return -2;
+    }
+    if (lower.size() > 2 && lower[0] == 'r' && lower[1].isDigit() &&
+        (lower.endsWith('b') || lower.endsWith('w'))) {
+        return -2;
+    }
+    return -1;
+}
+
+bool InstructionScheduler::parseOperand(const QString& text, Operand& operand) const {
+    operand.text = text;
+    operand.reg = -1;
+    operand.role = 0;
+    operand.symbol.clear();
+    operand.addressRegs.clear();
+
+    QString t = text.trimmed();
+    int open = t.indexOf('[');
+    if (open >= 0) {
+        if (!t.endsWith(']')) return false;
+        operand.kind = Operand::MEMORY;
+        QString inner = t.mid(open + 1, t.size() - open - 2);
+        for (const auto& id : identifiers(inner)) {
+            QString word = inner.mid(id.first, id.second);
+            int reg = registerNumber(word);
+            if (reg == -2 || reg >= 16) return false;
+            if (reg >= 0) {
+                if (!operand.addressRegs.contains(reg)) operand.addressRegs.append(reg);
+            } else if (word.toLower() != "rel" && word.toLower() != "abs" && operand.symbol.isEmpty()) {
+                operand.symbol = word;
+            }
+        }
+        return true;
+    }
+
+    int reg = registerNumber(t);
+    if (reg == -2) return false;
+    if (reg >= 0) {
+        operand.kind = Operand::REGISTER;
+        operand.reg = reg;
+        return true;
+    }
+    operand.kind = Operand::IMMEDIATE;
+    return true;
+}
+
+QVector<InstructionScheduler::Instruction> InstructionScheduler::parse(const QStringList& lines) const {
+    static const QSet<QString> directives = {
+        "section", "segment", "global", "extern", "bits", "default", "align", "alignb", "cpu", "org"
+    };
+
+    QVector<Instruction> program;
+    bool inText = false;
+    int prefixStart = -1;
+
+    for (int i = 0; i < lines.size(); ++i) {
+        QString code = lines[i];
+        int comment = commentStart(code);
+        if (comment >= 0) code.truncate(comment);
+        code = code.trimmed();
+
+        QString first = code.section(' ', 0, 0).section('\t', 0, 0).toLower();
+        if (first == "section" || first == "segment") {
+            inText = code.contains(".text");
+        } else if (!inText) {
+            continue;
+        }
+
+        if (code.isEmpty()) {
+            if (prefixStart < 0) prefixStart = i;
+            continue;
+        }
+
+        Instruction ins;
+        ins.line = i;
+        ins.prefixStart = prefixStart < 0 ? i : prefixStart;
+        prefixStart = -1;
+        ins.schedulable = false;
+        ins.jump = false;
+        ins.conditional = false;
+        ins.uses = 0;
+        ins.defs = 0;
+        ins.implicitRegs = 0;
+        ins.memory = -1;
+        ins.loads = false;
+        ins.stores = false;
+        ins.latency = 0;
+
+        if (code.endsWith(':')) {
+            ins.kind = Instruction::LABEL;
+            ins.label = code.left(code.size() - 1).trimmed();
+        } else if (directives.contains(first)) {
+            ins.kind = Instruction::DIRECTIVE;
+        } else {
+            ins.kind = Instruction::OPERATION;
+            ins.mnemonic = first;
+            bool ok = true;
+            for (const QString& text : splitOperands(code.mid(first.size()))) {
+                Operand operand;
+                if (!parseOperand(text, operand)) {
+                    ok = false;
+                    break;
+                }
+                ins.operands.append(operand);
+            }
+            if (!ok || !describe(ins)) {
+                // Unknown: pinned in place, and everything is assumed live across it
+                ins.schedulable = false;
+                ins.jump = false;
+                ins.uses = ALL_REGS;
+                ins.defs = 0;
+            }
+        }
+        program.append(ins);
+    }
+    return program;
+}
+
+// Fills in registers, memory, units and latency; false when not understood
+bool InstructionScheduler::describe(Instruction& ins) const {
+    const QString& m = ins.mnemonic;
+    QVector<Operand>& ops = ins.operands;
+    int n = ops.size();
+
+    auto isReg = [&](int k) { return ops[k].kind == Operand::REGISTER; };
+    auto isMem = [&](int k) { return ops[k].kind == Operand::MEMORY; };
+    auto isImm = [&](int k) { return ops[k].kind == Operand::IMMEDIATE; };
+    auto isGpr = [&](int k) { return isReg(k) && ops[k].reg < 16; };
+    auto isVec = [&](int k) { return isReg(k) && ops[k].reg >= 16; };
+
+    if (m == "jmp" && n == 1) {
+        ins.jump = true;
+        ins.label = ops[0].text.section(' ', -1).trimmed();
+        return true;
+    }
+    if (isConditionalJump(m) && n == 1) {
+        ins.jump = true;
+        ins.conditional = true;
+        ins.label = ops[0].text.section(' ', -1).trimmed();
+        ins.uses = bit(FlagsReg);
+        return true;
+    }
+    if (m == "int") {
+        // Linux system call: arguments in eax..ebx, result in eax
+        ins.uses = bit(EAX) | bit(ECX) | bit(EDX) | bit(EBX);
+        ins.defs = bit(EAX);
+        return true;
+    }
+
+    int memOps = 0;
+    for (int k = 0; k < n; ++k) {
+        if (isMem(k)) {
+            ins.memory = k;
+            ++memOps;
+        }
+    }
+    if (memOps > 1) return false;
+
+    bool writesFlags = false;
+    bool vectorLoad = false;
+    int unit = -1;
+    int latency = 0;
+
+    static const QSet<QString> aluOps = {"add", "sub", "and", "or", "xor"};
+    static const QSet<QString> unaryOps = {"inc", "dec", "neg", "not"};
+    static const QSet<QString> shiftOps = {"shl", "shr", "sar", "sal"};
+    static const QSet<QString> vectorMoves = {"movdqa", "movdqu", "vmovdqa", "vmovdqu", "movd", "vmovd",
+                                              "movq", "vmovq", "movaps", "movups", "vmovaps", "vmovups"};
+    static const QSet<QString> sseOps = {"paddd", "psubd", "paddq", "psubq", "pand", "por", "pxor", "pandn",
+                                         "punpckldq", "pmulld", "pmuludq"};
+    static const QSet<QString> avxOps = {"vpaddd", "vpsubd", "vpaddq", "vpsubq", "vpand", "vpor", "vpxor",
+                                         "vpandn", "vpunpckldq", "vpmulld", "vpmuludq"};
+
+    if (m == "mov" && n == 2 && !isImm(0)) {
+        ops[0].role = WRITE;
+        ops[1].role = READ;
+        if (isMem(0)) {
+            ins.stores = true;
+            unit = MachineModel::STORE;
+            latency = 1;
+        } else if (isMem(1)) {
+            ins.loads = true;
+            unit = MachineModel::LOAD;
+            latency = model.loadLatency;
+        } else {
+            unit = MachineModel::ALU;
+            latency = model.aluLatency;
+        }
+    } else if (m == "lea" && n == 2 && isGpr(0) && isMem(1)) {
+        // Address arithmetic only, no memory access
+        ops[0].role = WRITE;
+        ins.memory = -1;
+        unit = MachineModel::ALU;
+        latency = model.aluLatency;
+    } else if (aluOps.contains(m) && n == 2 && !isImm(0)) {
+        if ((m == "xor" || m == "sub") && isGpr(0) && isGpr(1) && ops[0].reg == ops[1].reg) {
+            ops[0].role = WRITE;   // zeroing idiom, no input dependence
+        } else {
+            ops[0].role = READ_WRITE;
+            ops[1].role = READ;
+        }
+        writesFlags = true;
+        unit = MachineModel::ALU;
+        latency = model.aluLatency;
+    } else if ((m == "cmp" || m == "test") && n == 2 && !isImm(0)) {
+        ops[0].role = READ;
+        ops[1].role = READ;
+        writesFlags = true;
+        unit = MachineModel::ALU;
+        latency = model.aluLatency;
+    } else if (unaryOps.contains(m) && n == 1 && !isImm(0)) {
+        ops[0].role = READ_WRITE;
+        writesFlags = m != "not";
+        unit = MachineModel::ALU;
+        latency = model.aluLatency;
+    } else if (shiftOps.contains(m) && n == 2 && !isImm(0) && isImm(1)) {
+        ops[0].role = READ_WRITE;
+        writesFlags = true;
+        unit = MachineModel::ALU;
+        latency = model.aluLatency;
+    } else if (m == "imul" && n == 2 && isGpr(0)) {
+        ops[0].role = READ_WRITE;
+        ops[1].role = READ;
+        writesFlags = true;
+        unit = MachineModel::MUL;
+        latency = model.mulLatency;
+    } else if (m == "imul" && n == 3 && isGpr(0) && !isImm(1) && isImm(2)) {
+        ops[0].role = WRITE;
+        ops[1].role = READ;
+        writesFlags = true;
+        unit = MachineModel::MUL;
+        latency = model.mulLatency;
+    } else if (m == "cdq" && n == 0) {
+        ins.uses |= bit(EAX);
+        ins.defs |= bit(EDX);
+        ins.implicitRegs = bit(EAX) | bit(EDX);
+        unit = MachineModel::ALU;
+        latency = model.aluLatency;
+    } else if ((m == "idiv" || m == "div") && n == 1 && !isImm(0)) {
+        ops[0].role = READ;
+        ins.uses |= bit(EAX) | bit(EDX);
+        ins.defs |= bit(EAX) | bit(EDX);
+        ins.implicitRegs = bit(EAX) | bit(EDX);
+        writesFlags = true;
+        unit = MachineModel::DIV;
+        latency = model.divLatency;
+    } else if (m == "nop" && n == 0) {
+        unit = MachineModel::ALU;
+        latency = model.aluLatency;
+    } else if (vectorMoves.contains(m) && n == 2 && !isImm(0) && !isImm(1)) {
+        ops[0].role = WRITE;
+        ops[1].role = READ;
+        if (isMem(0)) {
+            ins.stores = true;
+            unit = MachineModel::STORE;
+            latency = 1;
+        } else if (isMem(1)) {
+            ins.loads = true;
+            unit = MachineModel::LOAD;
+            latency = model.vectorLoadLatency;
+        } else if (isGpr(0) || isGpr(1)) {
+            unit = MachineModel::SHUFFLE;
+            latency = model.shuffleLatency + 1;
+        } else {
+            unit = MachineModel::VECTOR;
+            latency = model.vectorLatency;
+        }
+    } else if ((m == "pshufd" || m == "vpshufd") && n == 3 && isVec(0) && isImm(2)) {
+        ops[0].role = WRITE;
+        ops[1].role = READ;
+        vectorLoad = isMem(1);
+        unit = MachineModel::SHUFFLE;
+        latency = model.shuffleLatency;
+    } else if (m == "vpbroadcastd" && n == 2 && isVec(0)) {
+        ops[0].role = WRITE;
+        ops[1].role = READ;
+        vectorLoad = isMem(1);
+        unit = MachineModel::SHUFFLE;
+        latency = model.shuffleLatency + 2;
+    } else if ((sseOps.contains(m) && n == 2 && isVec(0)) || (avxOps.contains(m) && n == 3 && isVec(0))) {
+        QString base = m.startsWith("vp") ? m.mid(1) : m;
+        if (n == 2) {
+            if ((base == "pxor" || base == "psubd") && isVec(1) && ops[0].reg == ops[1].reg) {
+                ops[0].role = WRITE;
+            } else {
+                ops[0].role = READ_WRITE;
+                ops[1].role = READ;
+            }
+        } else {
+            ops[0].role = WRITE;
+            ops[1].role = READ;
+            ops[2].role = READ;
+        }
+        vectorLoad = ins.memory >= 0;
+        if (base == "pmulld") {
+            unit = MachineModel::VECTOR_MUL;
+            latency = model.vectorMulLatency;
+        } else if (base == "pmuludq") {
+            unit = MachineModel::VECTOR_MUL;
+            latency = model.widenMulLatency;
+        } else if (base == "punpckldq") {
+            unit = MachineModel::SHUFFLE;
+            latency = model.shuffleLatency;
+        } else {
+            unit = MachineModel::VECTOR;
+            latency = model.vectorLatency;
+        }
+    } else {
+        return false;
+    }
+
+    // Memory operands of arithmetic: a fused load, plus a store when it is the destination
+    if (ins.memory >= 0 && unit != MachineModel::LOAD && unit != MachineModel::STORE) {
+        ins.loads = true;
+        ins.units.append(MachineModel::LOAD);
+        latency += vectorLoad ? model.vectorLoadLatency : model.loadLatency;
+        if (ops[ins.memory].role & WRITE) {
+            ins.stores = true;
+            ins.units.append(MachineModel::STORE);
+        }
+    }
+    ins.units.append(unit);
+    ins.latency = latency;
+
+    for (const Operand& operand : ops) {
+        if (operand.kind == Operand::REGISTER) {
+            if (operand.role & READ) ins.uses |= bit(operand.reg);
+            if (operand.role & WRITE) ins.defs |= bit(operand.reg);
+        } else if (operand.kind == Operand::MEMORY) {
+            for (int reg : operand.addressRegs) ins.uses |= bit(reg);
+        }
+    }
+    if (writesFlags) {
+        ins.defs |= bit(FlagsReg);
+    }
+    ins.schedulable = true;
+    return true;
+}
+
+QVector<InstructionScheduler::Access> InstructionScheduler::accessesOf(const Instruction& ins) const {
+    QVector<Access> accesses;
+    for (int k = 0; k < ins.operands.size(); ++k) {
+        const Operand& operand = ins.operands[k];
+        if (operand.kind == Operand::REGISTER && operand.reg < 16 && operand.role != 0) {
+            accesses.append({k, 0, operand.reg, operand.role});
+        } else if (operand.kind == Operand::MEMORY) {
+            for (int slot = 0; slot < operand.addressRegs.size(); ++slot) {
+                accesses.append({k, slot, operand.addressRegs[slot], READ});
+            }
+        }
+    }
+    return accesses;
+}
+
+// ============================================================
+// Analysis
+// ============================================================
+
+// Registers live after each program entry, over the control flow graph
+// formed by fall-through and jumps to local labels
+QVector<quint64> InstructionScheduler::liveOut(const QVector<Instruction>& program) const {
+    int n = program.size();
+    QHash<QString, int> labels;
+    for (int i = 0; i < n; ++i) {
+        if (program[i].kind == Instruction::LABEL) labels.insert(program[i].label, i);
+    }
+
+    QVector<QVector<int>> successors(n);
+    QVector<bool> unknownTarget(n, false);
+    for (int i = 0; i < n; ++i) {
+        const Instruction& ins = program[i];
+        bool fallsThrough = !(ins.kind == Instruction::OPERATION && ins.jump && !ins.conditional);
+        if (ins.kind == Instruction::OPERATION && ins.jump) {
+            int target = labels.value(ins.label, -1);
+            if (target < 0) unknownTarget[i] = true;
+            else successors[i].append(target);
+        }
+        if (fallsThrough && i + 1 < n) successors[i].append(i + 1);
+    }
+
+    QVector<quint64> out(n, 0);
+    QVector<quint64> in(n, 0);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = n - 1; i >= 0; --i) {
+            quint64 live = unknownTarget[i] ? ALL_REGS : 0;
+            for (int s : successors[i]) live |= in[s];
+            quint64 liveIn = program[i].uses | (live & ~program[i].defs);
+            if (live != out[i] || liveIn != in[i]) {
+                out[i] = live;
+                in[i] = liveIn;
+                changed = true;
+            }
+        }
+    }
+    return out;
+}
+
+// [start, end) of every straight-line run of schedulable instructions
+QVector<QPair<int, int>> InstructionScheduler::runs(const QVector<Instruction>& program) const {
+    QVector<QPair<int, int>> result;
+    int i = 0;
+    while (i < program.size()) {
+        if (program[i].kind != Instruction::OPERATION || !program[i].schedulable) {
+            ++i;
+            continue;
+        }
+        int start = i;
+        while (i < program.size() && program[i].kind == Instruction::OPERATION && program[i].schedulable &&
+               i - start < MaxRunLength) {
+            ++i;
+        }
+        if (i - start >= 2) result.append(qMakePair(start, i));
+    }
+    return result;
+}
+
+// ============================================================
+// Scheduling
+// ============================================================
+
+// Splits the run's GPR accesses into webs. Returns false when nothing can be
+// renamed; *pool receives the registers free across the whole run.
+bool InstructionScheduler::buildWebs(const QVector<Instruction>& run, quint64 liveIn, quint64 liveOut,
+                                     QVector<Web>& webs, QVector<QVector<int>>& accessWebs,
+                                     quint64* pool) const {
+    webs.clear();
+    accessWebs.clear();
+    QVector<int> current(16, -1);
+    quint64 busy = liveIn | liveOut;
+
+    auto newWeb = [&](int reg, bool fixed, int pos) {
+        webs.append({reg, fixed, reg});
+        return webs.size() - 1;
+    };
+
+    for (int pos = 0; pos < run.size(); ++pos) {
+        const Instruction& ins = run[pos];
+        QVector<Access> accesses = accessesOf(ins);
+        QVector<int> ids(accesses.size(), -1);
+
+        for (int a = 0; a < accesses.size(); ++a) {
+            if (!(accesses[a].role & READ)) continue;
+            int reg = accesses[a].reg;
+            if (current[reg] < 0) current[reg] = newWeb(reg, true, pos);   // live on entry
+            ids[a] = current[reg];
+        }
+        for (int reg = 0; reg < 16; ++reg) {
+            if (!(ins.implicitRegs & ins.uses & bit(reg))) continue;
+            if (current[reg] < 0) current[reg] = newWeb(reg, true, pos);
+            webs[current[reg]].fixed = true;
+        }
+        for (int a = 0; a < accesses.size(); ++a) {
+            if (accesses[a].role != WRITE) continue;
+            current[accesses[a].reg] = newWeb(accesses[a].reg, false, pos);
+            ids[a] = current[accesses[a].reg];
+        }
+        for (int reg = 0; reg < 16; ++reg) {
+            if (ins.implicitRegs & ins.defs & bit(reg)) current[reg] = newWeb(reg, true, pos);
+        }
+
+        // Only the plain 32-bit registers of the allocatable set move
+        for (int a = 0; a < accesses.size(); ++a) {
+            const Operand& operand = ins.operands[accesses[a].operand];
+            QString name = operand.kind == Operand::REGISTER ? operand.text.trimmed() : QString();
+            if (operand.kind == Operand::MEMORY) {
+                for (const auto& id : identifiers(operand.text)) {
+                    QString word = operand.text.mid(id.first, id.second);
+                    if (registerNumber(word) == accesses[a].reg) name = word;
+                }
+            }
+            if (!isRenamableName(name)) webs[ids[a]].fixed = true;
+        }
+
+        busy |= ins.implicitRegs;
+        accessWebs.append(ids);
+    }
+
+    for (int reg = 0; reg < 16; ++reg) {
+        if (current[reg] >= 0 && (liveOut & bit(reg))) webs[current[reg]].fixed = true;
+    }
+
+    int renamable = 0;
+    for (const Web& web : webs) {
+        if (web.fixed) busy |= bit(web.reg);
+        else ++renamable;
+    }
+
+    *pool = 0;
+    for (int reg : RENAMABLE) {
+        if (!(busy & bit(reg))) *pool |= bit(reg);
+    }
+    return renamable > 0 && *pool != 0;
+}
+
+// Dependence edges in program order. Without webs every register is its own
+// resource; with webs a renamable chain only orders its own accesses.
+InstructionScheduler::Graph InstructionScheduler::buildGraph(const QVector<Instruction>& run,
+                                                             const QVector<Web>* webs,
+                                                             const QVector<QVector<int>>* accessWebs,
+                                                             quint64 liveOut) const {
+    const qint64 WebKey = 1000;
+    const qint64 MemoryKey = 1000000;
+
+    Graph graph(run.size());
+    QHash<qint64, int> lastWriter;
+    QHash<qint64, QVector<int>> readers;
+    QHash<QString, int> symbols;
+    int memoryLatency = qMax(1, model.storeForwardLatency - model.loadLatency);
+
+    for (int pos = 0; pos < run.size(); ++pos) {
+        const Instruction& ins = run[pos];
+        QVector<qint64> reads;
+        QVector<qint64> writes;
+        quint64 explicitRegs = 0;
+
+        if (webs) {
+            QVector<Access> accesses = accessesOf(ins);
+            for (int a = 0; a < accesses.size(); ++a) {
+                int id = (*accessWebs)[pos][a];
+                qint64 key = (*webs)[id].fixed ? accesses[a].reg : WebKey + id;
+                if (accesses[a].role & READ) reads.append(key);
+                if (accesses[a].role & WRITE) writes.append(key);
+                explicitRegs |= bit(accesses[a].reg);
+            }
+        }
+        for (int reg = 0; reg < FlagsReg; ++reg) {
+            if (explicitRegs & bit(reg) & ~ins.implicitRegs) continue;
+            if (ins.uses & bit(reg)) reads.append(reg);
+            if (ins.defs & bit(reg)) writes.append(reg);
+        }
+        if (ins.memory >= 0) {
+            const QString& symbol = ins.operands[ins.memory].symbol;
+            if (!symbols.contains(symbol)) symbols.insert(symbol, symbols.size());
+            qint64 key = MemoryKey + symbols.value(symbol);
+            if (ins.loads) reads.append(key);
+            if (ins.stores) writes.append(key);
+        }
+
+        for (qint64 key : reads) {
+            auto writer = lastWriter.constFind(key);
+            if (writer != lastWriter.constEnd() && writer.value() != pos) {
+                int latency = key >= MemoryKey ? memoryLatency : run[writer.value()].latency;
+                graph[writer.value()].append(qMakePair(pos, latency));
+            }
+            readers[key].append(pos);
+        }
+        for (qint64 key : writes) {
+            auto writer = lastWriter.constFind(key);
+            if (writer != lastWriter.constEnd() && writer.value() != pos) {
+                graph[writer.value()].append(qMakePair(pos, 0));
+            }
+            for (int reader : readers.value(key)) {
+                if (reader != pos) graph[reader].append(qMakePair(pos, 0));
+            }
+            lastWriter.insert(key, pos);
+            readers.remove(key);
+        }
+    }
+
+    // Flags only matter when the instruction after the run reads them:
+    // their producer must stay the last flag writer
+    if (liveOut & bit(FlagsReg)) {
+        int producer = -1;
+        for (int pos = run.size() - 1; pos >= 0 && producer < 0; --pos) {
+            if (run[pos].defs & bit(FlagsReg)) producer = pos;
+        }
+        for (int pos = 0; pos < producer; ++pos) {
+            if (run[pos].defs & bit(FlagsReg)) graph[pos].append(qMakePair(producer, 0));
+        }
+    }
+    return graph;
+}
+
+// Cycle-by-cycle list scheduling: each cycle issues the ready instructions
+// with the longest latency path to the end of the run, up to the issue
+// width and unit counts. With webs, an instruction starting a value needs a
+// free register; when one or none is left, instructions that do not start
+// values go first. Returns false if register pressure deadlocks the run.
+bool InstructionScheduler::listSchedule(const QVector<Instruction>& run, const Graph& graph,
+                                        QVector<Web>* webs, const QVector<QVector<int>>* accessWebs,
+                                        quint64 pool, QVector<int>& order) const {
+    int n = run.size();
+    order.clear();
+
+    QVector<int> height(n, 0);
+    QVector<int> predecessors(n, 0);
+    for (int i = n - 1; i >= 0; --i) {
+        height[i] = run[i].latency;
+        for (const auto& edge : graph[i]) {
+            height[i] = qMax(height[i], edge.second + height[edge.first]);
+            predecessors[edge.first]++;
+        }
+    }
+
+    // Values each instruction starts and touches; a register is released
+    // once every instruction touching its value has issued, whatever the order
+    QVector<QVector<int>> opens(n);
+    QVector<QVector<int>> touches(n);
+    QVector<int> remaining(webs ? webs->size() : 0, 0);
+    if (webs) {
+        for (int pos = 0; pos < n; ++pos) {
+            QVector<Access> accesses = accessesOf(run[pos]);
+            for (int a = 0; a < accesses.size(); ++a) {
+                int id = (*accessWebs)[pos][a];
+                if ((*webs)[id].fixed) continue;
+                if (accesses[a].role == WRITE) opens[pos].append(id);
+                if (!touches[pos].contains(id)) {
+                    touches[pos].append(id);
+                    remaining[id]++;
+                }
+            }
+        }
+    }
+
+    QVector<int> earliest(n, 0);
+    QVector<int> ready;
+    for (int i = 0; i < n; ++i) {
+        if (predecessors[i] == 0) ready.append(i);
+    }
+
+    quint64 freeRegs = pool;
+    int cycle = 0;
+    int lastIssue = 0;
+    int divFree = 0;
+    int stallLimit = model.divLatency + model.divBusy + model.vectorMulLatency + 8;
+
+    while (order.size() < n) {
+        bool tight = webs && qPopulationCount(freeRegs) <= 1;
+        QVector<int> candidates;
+        for (int i : ready) {
+            if (earliest[i] <= cycle) candidates.append(i);
+        }
+        std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+            bool deferA = tight && !opens[a].isEmpty();
+            bool deferB = tight && !opens[b].isEmpty();
+            if (deferA != deferB) return !deferA;
+            if (height[a] != height[b]) return height[a] > height[b];
+            return a < b;
+        });
+
+        int used[MachineModel::UnitCount] = {};
+        int issued = 0;
+        for (int c : candidates) {
+            if (issued >= model.issueWidth) break;
+
+            bool fits = true;
+            for (int unit : run[c].units) {
+                if (used[unit] >= model.units[unit]) fits = false;
+                if (unit == MachineModel::DIV && divFree > cycle) fits = false;
+            }
+            if (!fits) continue;
+
+            if (webs && !opens[c].isEmpty()) {
+                int available = qPopulationCount(freeRegs);
+                for (int id : touches[c]) {
+                    if (!opens[c].contains(id) && remaining[id] == 1) ++available;
+                }
+                if (available < opens[c].size()) continue;
+            }
+
+            // Issue
+            for (int unit : run[c].units) {
+                used[unit]++;
+                if (unit == MachineModel::DIV) divFree = cycle + model.divBusy;
+            }
+            if (webs) {
+                for (int id : touches[c]) {
+                    if (!opens[c].contains(id) && remaining[id] == 1) freeRegs |= bit((*webs)[id].physical);
+                }
+                for (int id : opens[c]) {
+                    Web& web = (*webs)[id];
+                    int chosen = -1;
+                    if (freeRegs & bit(web.reg)) {
+                        chosen = web.reg;
+                    } else {
+                        for (int reg : RENAMABLE) {
+                            if (freeRegs & bit(reg)) {
+                                chosen = reg;
+                                break;
+                            }
+                        }
+                    }
+                    web.physical = chosen;
+                    freeRegs &= ~bit(chosen);
+                    if (remaining[id] == 1) freeRegs |= bit(chosen);   // value never read
+                }
+                for (int id : touches[c]) {
+                    remaining[id]--;
+                }
+            }
+
+            order.append(c);
+            ready.removeOne(c);
+            issued++;
+            for (const auto& edge : graph[c]) {
+                earliest[edge.first] = qMax(earliest[edge.first], cycle + edge.second);
+                if (--predecessors[edge.first] == 0) ready.append(edge.first);
+            }
+        }
+
+        if (issued > 0) {
+            lastIssue = cycle;
+        } else if (cycle - lastIssue > stallLimit) {
+            return false;
+        }
+        ++cycle;
+    }
+    return true;
+}
+
+// Cycles to finish the run when issued strictly in the given order
+int InstructionScheduler::simulate(const QVector<Instruction>& run, const Graph& graph,
+                                   const QVector<int>& order) const {
+    QVector<int> earliest(run.size(), 0);
+    int cycle = 0;
+    int issued = 0;
+    int used[MachineModel::UnitCount] = {};
+    int divFree = 0;
+    int finish = 0;
+
+    for (int i : order) {
+        int start = qMax(cycle, earliest[i]);
+        for (;;) {
+            if (start > cycle) {
+                cycle = start;
+                issued = 0;
+                std::fill(used, used + MachineModel::UnitCount, 0);
+            }
+            bool fits = issued < model.issueWidth;
+            for (int unit : run[i].units) {
+                if (used[unit] >= model.units[unit]) fits = false;
+                if (unit == MachineModel::DIV && divFree > cycle) fits = false;
+            }
+            if (fits) break;
+            ++start;
+        }
+
+        issued++;
+        for (int unit : run[i].units) {
+            used[unit]++;
+            if (unit == MachineModel::DIV) divFree = cycle + model.divBusy;
+        }
+        finish = qMax(finish, cycle + run[i].latency);
+        for (const auto& edge : graph[i]) {
+            earliest[edge.first] = qMax(earliest[edge.first], cycle + edge.second);
+        }
+    }
+    return finish;
+}
+
+QString InstructionScheduler::render(const Instruction& ins, const QString& original,
+                                     const QVector<Web>& webs, const QVector<int>& accessWebs) const {
+    QVector<Access> accesses = accessesOf(ins);
+    QStringList operands;
+    bool changed = false;
+
+    for (int k = 0; k < ins.operands.size(); ++k) {
+        const Operand& operand = ins.operands[k];
+        QString text = operand.text.trimmed();
+        if (k > 0 && operand.kind == Operand::REGISTER && operand.role == 0 && operand.reg == ins.operands[0].reg) {
+            operands.append(operands[0]);   // second half of a zeroing idiom
+            continue;
+        }
+
+        // Substitute right to left so earlier positions stay valid
+        QVector<QPair<int, int>> ids = identifiers(text);
+        for (int j = ids.size() - 1; j >= 0; --j) {
+            int reg = registerNumber(text.mid(ids[j].first, ids[j].second));
+            if (reg < 0) continue;
+            for (int a = 0; a < accesses.size(); ++a) {
+                if (accesses[a].operand != k || accesses[a].reg != reg) continue;
+                const Web& web = webs[accessWebs[a]];
+                if (!web.fixed && web.physical != web.reg) {
+                    text.replace(ids[j].first, ids[j].second, GPR32[web.physical]);
+                    changed = true;
+                }
+                break;
+            }
+        }
+        operands.append(text);
+    }
+    if (!changed) {
+        return original;
+    }
+
+    int indent = 0;
+    while (indent < original.size() && original[indent].isSpace()) ++indent;
+    QString code = original.mid(indent);
+    QString comment;
+    int semicolon = commentStart(code);
+    if (semicolon >= 0) {
+        comment = " " + code.mid(semicolon);
+        code.truncate(semicolon);
+    }
+    QString mnemonic = code.trimmed().section(' ', 0, 0).section('\t', 0, 0);
+    return original.left(indent) + mnemonic + " " + operands.join(", ") + comment;
+}
+
+// ============================================================
+// Entry points
+// ============================================================
+
+QString InstructionScheduler::schedule(const QString& assembly, ScheduleStats* stats) const {
+    QStringList lines = assembly.split('\n');
+    QVector<Instruction> program = parse(lines);
+    QVector<quint64> live = liveOut(program);
+    ScheduleStats local;
+
+    QStringList out;
+    int nextLine = 0;
+    for (const auto& span : runs(program)) {
+        QVector<Instruction> run = program.mid(span.first, span.second - span.first);
+        const Instruction& head = program[span.first];
+        quint64 runLiveIn = head.uses | (live[span.first] & ~head.defs);
+        quint64 runLiveOut = live[span.second - 1];
+        int n = run.size();
+
+        QVector<int> identity(n);
+        for (int i = 0; i < n; ++i) identity[i] = i;
+        Graph original = buildGraph(run, nullptr, nullptr, runLiveOut);
+        int before = simulate(run, original, identity);
+
+        QVector<int> best = identity;
+        int bestCycles = before;
+        bool renamed = false;
+        QVector<Web> webs;
+        QVector<QVector<int>> accessWebs;
+        quint64 pool = 0;
+
+        if (renaming && buildWebs(run, runLiveIn, runLiveOut, webs, accessWebs, &pool)) {
+            Graph graph = buildGraph(run, &webs, &accessWebs, runLiveOut);
+            QVector<int> order;
+            if (listSchedule(run, graph, &webs, &accessWebs, pool, order)) {
+                int cycles = simulate(run, graph, order);
+                if (cycles < bestCycles) {
+                    best = order;
+                    bestCycles = cycles;
+                    renamed = true;
+                }
+            } else {
+                local.pressureFallbacks++;
+            }
+        }
+        if (!renamed) {
+            QVector<int> order;
+            listSchedule(run, original, nullptr, nullptr, 0, order);
+            int cycles = simulate(run, original, order);
+            if (cycles < bestCycles) {
+                best = order;
+                bestCycles = cycles;
+            }
+        }
+
+        local.regions++;
+        local.instructions += n;
+        local.cyclesBefore += before;
+        local.cyclesAfter += bestCycles;
+        if (bestCycles == before) {
+            continue;
+        }
+
+        local.reordered += best != identity ? 1 : 0;
+        if (renamed) {
+            for (const Web& web : webs) {
+                if (!web.fixed && web.physical != web.reg) local.renamedValues++;
+            }
+        }
+
+        for (int line = nextLine; line < run.first().prefixStart; ++line) {
+            out.append(lines[line]);
+        }
+        for (int i : best) {
+            for (int line = run[i].prefixStart; line < run[i].line; ++line) {
+                out.append(lines[line]);
+            }
+            out.append(renamed ? render(run[i], lines[run[i].line], webs, accessWebs[i]) : lines[run[i].line]);
+        }
+        nextLine = run.last().line + 1;
+    }
+    for (int line = nextLine; line < lines.size(); ++line) {
+        out.append(lines[line]);
+    }
+
+    if (stats) *stats = local;
+    return out.join("\n");
+}
+
+int InstructionScheduler::estimateCycles(const QString& assembly) const {
+    QVector<Instruction> program = parse(assembly.split('\n'));
+    QVector<quint64> live = liveOut(program);
+
+    int cycles = 0;
+    for (const auto& span : runs(program)) {
+        QVector<Instruction> run = program.mid(span.first, span.second - span.first);
+        QVector<int> identity(run.size());
+        for (int i = 0; i < run.size(); ++i) identity[i] = i;
+        cycles += simulate(run, buildGraph(run, nullptr, nullptr, live[span.second - 1]), identity);
+    }
+    return cycles;
+}
@@ -0,0 +1,158 @@
+#ifndef INSTRUCTIONSCHEDULER_H
+#define INSTRUCTIONSCHEDULER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+
+enum class CoreModel {
+    SKYLAKE,
+    ZEN2
+};
+
+// Issue width, execution units and latencies of one x86-64 core, rounded
+// from published instruction tables. Throughput is modelled by how many
+// units of each kind accept an instruction per cycle; the divider is not
+// pipelined and stays busy for divBusy cycles.
+struct MachineModel {
+    enum Unit { ALU, LOAD, STORE, MUL, DIV, VECTOR, VECTOR_MUL, SHUFFLE, UnitCount };
+
+    QString name;
+    int issueWidth;
+    int units[UnitCount];
+    int aluLatency;
+    int loadLatency;             // load-to-use of a GPR load
+    int vectorLoadLatency;
+    int storeForwardLatency;     // store data to the result of a load of the same address
+    int mulLatency;
+    int divLatency;
+    int divBusy;
+    int vectorLatency;
+    int vectorMulLatency;        // pmulld
+    int widenMulLatency;         // pmuludq
+    int shuffleLatency;
+
+    static MachineModel forCore(CoreModel core);
+};
+
+struct ScheduleStats {
+    int regions = 0;             // straight-line runs considered
+    int instructions = 0;        // instructions in those runs
+    int reordered = 0;           // runs whose order changed
+    int renamedValues = 0;       // register values moved to another register
+    int pressureFallbacks = 0;   // runs that fell back to the original registers
+    int cyclesBefore = 0;        // in-order model estimate over all runs
+    int cyclesAfter = 0;
+};
+
+// List scheduler for the NASM the assembly backend emits. The text section
+// is cut at labels, control transfers and anything not understood; each
+// straight-line run gets a dependence DAG over registers, flags and memory
+// (distinct symbols never alias) and is reordered critical-path first
+// against a machine model. With renaming on, register values that are dead
+// on entry and exit of the run move to registers that are free there, and
+// a new value may only start while a register is free, so the schedule
+// never needs more registers than the allocation had. A run keeps its
+// original order unless the model says the new one is faster.
+class InstructionScheduler {
+private:
+    enum Role { READ = 1, WRITE = 2, READ_WRITE = 3 };
+
+    struct Operand {
+        enum Kind { REGISTER, MEMORY, IMMEDIATE };
+        Kind kind;
+        QString text;
+        int reg;                     // REGISTER
+        int role;                    // REGISTER: Role
+        QString symbol;              // MEMORY: base symbol, empty if addressed by registers alone
+        QVector<int> addressRegs;    // MEMORY
+    };
+
+    struct Instruction {
+        enum Kind { OPERATION, LABEL, DIRECTIVE };
+        Kind kind;
+        int line;                    // index of the instruction's line
+        int prefixStart;             // first of the comment/blank lines in front of it
+        QString mnemonic;
+        QVector<Operand> operands;
+        QString label;               // LABEL: its name; jumps: the target
+        bool schedulable;
+        bool jump;
+        bool conditional;
+        quint64 uses;                // registers read, FlagsReg for flags
+        quint64 defs;
+        quint64 implicitRegs;        // registers the encoding fixes (cdq, idiv)
+        int memory;                  // operand index of the memory access, -1 if none
+        bool loads;
+        bool stores;
+        int latency;
+        QVector<int> units;
+    };
+
+    // One register value chain inside a run; read-modify-write operands
+    // keep extending the chain that fed them
+    struct Web {
+        int reg;
+        bool fixed;                  // must stay in its original register
+        int physical;
+    };
+
+    // Explicit GPR reads and writes of one instruction, in operand order
+    struct Access {
+        int operand;
+        int slot;                    // address register index for MEMORY operands
+        int reg;
+        int role;
+    };
+
+    typedef QVector<QVector<QPair<int, int>>> Graph;   // position -> (successor, latency)
+
+    CoreModel core;
+    MachineModel model;
+    bool renaming;
+
+public:
+    static const int FlagsReg = 32;
+    static const int MaxRunLength = 256;
+
+    InstructionScheduler();
+
+    void setCoreModel(CoreModel target);
+    CoreModel getCoreModel() const { return core; }
+    void setRenaming(bool enabled) { renaming = enabled; }
+    bool getRenaming() const { return renaming; }
+
+    // Returns the reordered program; lines outside scheduled runs are kept verbatim
+    QString schedule(const QString& assembly, ScheduleStats* stats = nullptr) const;
+
+    // Cycles of the program's straight-line runs issued in program order
+    int estimateCycles(const QString& assembly) const;
+
+    static QString coreName(CoreModel target);
+
+private:
+    // --- Parsing ---
+    QVector<Instruction> parse(const QStringList& lines) const;
+    bool parseOperand(const QString& text, Operand& operand) const;
+    bool describe(Instruction& instruction) const;
+    QVector<Access> accessesOf(const Instruction& instruction) const;
+    static int registerNumber(const QString& name);
+
+    // --- Analysis ---
+    QVector<quint64> liveOut(const QVector<Instruction>& program) const;
+    QVector<QPair<int, int>> runs(const QVector<Instruction>& program) const;
+
+    // --- Scheduling ---
+    bool buildWebs(const QVector<Instruction>& run, quint64 liveIn, quint64 liveOut,
+                   QVector<Web>& webs, QVector<QVector<int>>& accessWebs, quint64* pool) const;
+    Graph buildGraph(const QVector<Instruction>& run, const QVector<Web>* webs,
+                     const QVector<QVector<int>>* accessWebs, quint64 liveOut) const;
+    bool listSchedule(const QVector<Instruction>& run, const Graph& graph, QVector<Web>* webs,
+                      const QVector<QVector<int>>* accessWebs, quint64 pool, QVector<int>& order) const;
+    int simulate(const QVector<Instruction>& run, const Graph& graph, const QVector<int>& order) const;
+    QString render(const Instruction& instruction, const QString& original,
+                   const QVector<Web>& webs, const QVector<int>& accessWebs) const;
+};
+
+#endif // INSTRUCTIONSCHEDULER_H
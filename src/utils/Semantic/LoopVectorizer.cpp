@@ -0,0 +1,608 @@
+#include "LoopVectorizer.h"
+
+LoopVectorizer::LoopVectorizer()
+    : isa(VectorISA::SSE2), position(0), declaresInduction(false), inclusiveBound(false) {}
+
+int LoopVectorizer::laneCount() const {
+    switch (isa) {
+    case VectorISA::SSE2:
+        return 4;
+    case VectorISA::AVX2:
+        return 8;
+    default:
+        return 1;
+    }
+}
+
+bool LoopVectorizer::translate(const QVector<Token>& tokens, int start, const QString& label,
+                               QString& code, int* consumed, bool* vectorized, QString* reason) {
+    // Copy just the loop: the header, then a braced body or a single statement.
+    // Comments may sit anywhere in it; drop them but remember where each token came from
+    loopTokens.clear();
+    QVector<int> origin;
+    int parens = 0;
+    int braces = 0;
+    bool headerDone = false;
+    for (int i = start; i < tokens.size(); ++i) {
+        TokenType type = tokens[i].getType();
+        if (type == TokenType::COMMENT || type == TokenType::WHITESPACE || type == TokenType::NEWLINE) {
+            continue;
+        }
+        loopTokens.append(tokens[i]);
+        origin.append(i);
+
+        if (!headerDone) {
+            if (type == TokenType::LPAREN) ++parens;
+            if (type == TokenType::RPAREN && --parens == 0) headerDone = true;
+            continue;
+        }
+        if (type == TokenType::LBRACE) ++braces;
+        if (type == TokenType::RBRACE) --braces;
+        if (braces <= 0 && (type == TokenType::RBRACE || type == TokenType::SEMICOLON)) {
+            break;
+        }
+    }
+
+    position = 0;
+    nodes.clear();
+    stores.clear();
+    inductionVar.clear();
+    declaresInduction = false;
+    inclusiveBound = false;
+    failure.clear();
+
+    if (!parseLoop()) {
+        if (reason) *reason = failure;
+        return false;
+    }
+
+    if (consumed) *consumed = origin[position - 1] + 1 - start;
+
+    QString loop = QString("    ; for (%1 = %2; %1 %3 %4; %1++) over int arrays\n")
+                       .arg(inductionVar).arg(lowerBound)
+                       .arg(inclusiveBound ? "<=" : "<").arg(upperBound);
+    loop += QString("    mov ecx, %1\n").arg(operand(lowerBound));
+    loop += QString("    mov edx, %1\n").arg(operand(upperBound));
+    if (inclusiveBound) {
+        loop += "    inc edx\n";
+    }
+
+    QString why;
+    bool packed = false;
+    if (isa == VectorISA::SCALAR) {
+        why = "vectorization disabled";
+    } else {
+        packed = emitVectorLoop(label, loop, &why);
+    }
+    if (!packed) {
+        loop += QString("    ; not vectorized: %1\n").arg(why);
+    }
+
+    loop += emitScalarLoop(label);
+    if (packed && isa == VectorISA::AVX2) {
+        loop += "    vzeroupper\n";
+    }
+    if (!declaresInduction) {
+        loop += QString("    mov [%1], ecx\n").arg(inductionVar);
+    }
+    code += loop + "\n";
+
+    if (vectorized) *vectorized = packed;
+    if (reason) *reason = why;
+    return true;
+}
+
+// ============================================================
+//  RECOGNITION
+// ============================================================
+
+bool LoopVectorizer::fail(const QString& why) {
+    if (failure.isEmpty()) {
+        failure = why;
+    }
+    return false;
+}
+
+bool LoopVectorizer::parseLoop() {
+    if (position >= loopTokens.size() || loopTokens[position].getLexeme() != "for") {
+        return fail("not a for loop");
+    }
+    ++position;
+
+    if (!parseHeader()) {
+        return false;
+    }
+
+    if (position < loopTokens.size() && loopTokens[position].getType() == TokenType::LBRACE) {
+        ++position;
+        while (position < loopTokens.size() && loopTokens[position].getType() != TokenType::RBRACE) {
+            if (!parseStatement()) {
+                return false;
+            }
+        }
+        if (position >= loopTokens.size()) {
+            return fail("unterminated loop body");
+        }
+        ++position;
+    } else if (!parseStatement()) {
+        return false;
+    }
+
+    if (stores.isEmpty()) {
+        return fail("loop body stores to no array");
+    }
+    return true;
+}
+
+bool LoopVectorizer::parseHeader() {
+    auto at = [this](int offset) {
+        int index = position + offset;
+        return index < loopTokens.size() ? loopTokens[index] : Token(TokenType::END_OF_FILE, "");
+    };
+
+    if (at(0).getType() != TokenType::LPAREN) {
+        return fail("expected '(' after for");
+    }
+    ++position;
+
+    // Initialisation: [int] i = lower ;
+    if (at(0).getType() == TokenType::KEYWORD && at(0).getLexeme() == "int") {
+        declaresInduction = true;
+        ++position;
+    }
+    if (at(0).getType() != TokenType::IDENTIFIER || at(1).getType() != TokenType::ASSIGN) {
+        return fail("loop does not initialise an induction variable");
+    }
+    inductionVar = at(0).getLexeme();
+    position += 2;
+    if (!parseOperand(lowerBound) || at(0).getType() != TokenType::SEMICOLON) {
+        return fail("lower bound is not a constant or scalar");
+    }
+    ++position;
+
+    // Condition: i < upper  or  i <= upper
+    if (at(0).getLexeme() != inductionVar ||
+        (at(1).getType() != TokenType::LESS_THAN && at(1).getType() != TokenType::LESS_EQUAL)) {
+        return fail("condition is not i < n");
+    }
+    inclusiveBound = at(1).getType() == TokenType::LESS_EQUAL;
+    position += 2;
+    if (!parseOperand(upperBound) || at(0).getType() != TokenType::SEMICOLON) {
+        return fail("upper bound is not a constant or scalar");
+    }
+    ++position;
+
+    // Increment: i++, ++i, i += 1 or i = i + 1 (the lexer splits ++ and += into two tokens)
+    int length = 0;
+    if (at(0).getType() == TokenType::PLUS && at(1).getType() == TokenType::PLUS &&
+        at(2).getLexeme() == inductionVar) {
+        length = 3;
+    } else if (at(0).getLexeme() == inductionVar && at(1).getType() == TokenType::PLUS &&
+               at(2).getType() == TokenType::PLUS) {
+        length = 3;
+    } else if (at(0).getLexeme() == inductionVar && at(1).getType() == TokenType::PLUS &&
+               at(2).getType() == TokenType::ASSIGN && at(3).getLexeme() == "1") {
+        length = 4;
+    } else if (at(0).getLexeme() == inductionVar && at(1).getType() == TokenType::ASSIGN &&
+               at(2).getLexeme() == inductionVar && at(3).getType() == TokenType::PLUS &&
+               at(4).getLexeme() == "1") {
+        length = 5;
+    }
+    if (length == 0) {
+        return fail("induction variable does not step by one");
+    }
+    position += length;
+
+    if (at(0).getType() != TokenType::RPAREN) {
+        return fail("expected ')' after loop header");
+    }
+    ++position;
+    return true;
+}
+
+bool LoopVectorizer::parseOperand(QString& operand) {
+    if (position >= loopTokens.size()) {
+        return false;
+    }
+
+    const Token& tok = loopTokens[position];
+    if (tok.getType() == TokenType::INTEGER_LITERAL) {
+        operand = tok.getLexeme();
+        ++position;
+        return true;
+    }
+    if (tok.getType() == TokenType::MINUS && position + 1 < loopTokens.size() &&
+        loopTokens[position + 1].getType() == TokenType::INTEGER_LITERAL) {
+        operand = "-" + loopTokens[position + 1].getLexeme();
+        position += 2;
+        return true;
+    }
+    if (tok.getType() == TokenType::IDENTIFIER && tok.getLexeme() != inductionVar &&
+        !intArrays.contains(tok.getLexeme())) {
+        operand = tok.getLexeme();
+        ++position;
+        return true;
+    }
+    return false;
+}
+
+bool LoopVectorizer::parseIndex() {
+    if (position + 2 >= loopTokens.size() ||
+        loopTokens[position].getType() != TokenType::LBRACKET ||
+        loopTokens[position + 1].getLexeme() != inductionVar ||
+        loopTokens[position + 2].getType() != TokenType::RBRACKET) {
+        return fail(QString("array access is not unit stride on '%1'").arg(inductionVar));
+    }
+    position += 3;
+    return true;
+}
+
+bool LoopVectorizer::isCompoundOperator(TokenType op) {
+    return op == TokenType::PLUS || op == TokenType::MINUS || op == TokenType::MULTIPLY ||
+           op == TokenType::BITWISE_AND || op == TokenType::BITWISE_OR || op == TokenType::BITWISE_XOR;
+}
+
+bool LoopVectorizer::parseStatement() {
+    if (position >= loopTokens.size() || loopTokens[position].getType() != TokenType::IDENTIFIER) {
+        return fail("loop body contains a statement other than an array store");
+    }
+
+    QString array = loopTokens[position].getLexeme();
+    if (!intArrays.contains(array)) {
+        return fail(QString("'%1' is written but is not a declared int array").arg(array));
+    }
+    ++position;
+    if (!parseIndex()) {
+        return false;
+    }
+
+    // a[i] = expr  or  a[i] op= expr
+    TokenType compound = TokenType::UNKNOWN;
+    if (position < loopTokens.size() && loopTokens[position].getType() == TokenType::ASSIGN) {
+        ++position;
+    } else if (position + 1 < loopTokens.size() && isCompoundOperator(loopTokens[position].getType()) &&
+               loopTokens[position + 1].getType() == TokenType::ASSIGN) {
+        compound = loopTokens[position].getType();
+        position += 2;
+    } else {
+        return fail("expected assignment to array element");
+    }
+
+    int root = parseExpression(1);
+    if (root < 0) {
+        return false;
+    }
+    if (compound != TokenType::UNKNOWN) {
+        root = addNode(ExprNode::BINARY, QString(), compound, addNode(ExprNode::ARRAY, array), root);
+    }
+
+    if (position >= loopTokens.size() || loopTokens[position].getType() != TokenType::SEMICOLON) {
+        return fail("expected ';' after array store");
+    }
+    ++position;
+
+    Store store;
+    store.array = array;
+    store.root = root;
+    stores.append(store);
+    return true;
+}
+
+int LoopVectorizer::precedence(TokenType op) {
+    switch (op) {
+    case TokenType::MULTIPLY:
+        return 5;
+    case TokenType::PLUS:
+    case TokenType::MINUS:
+        return 4;
+    case TokenType::BITWISE_AND:
+        return 3;
+    case TokenType::BITWISE_XOR:
+        return 2;
+    case TokenType::BITWISE_OR:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+int LoopVectorizer::parseExpression(int minPrecedence) {
+    int left = parsePrimary();
+    if (left < 0) {
+        return -1;
+    }
+
+    while (position < loopTokens.size()) {
+        TokenType op = loopTokens[position].getType();
+        if (op == TokenType::DIVIDE || op == TokenType::MODULO) {
+            fail("integer division has no packed form");
+            return -1;
+        }
+
+        int prec = precedence(op);
+        if (prec == 0 || prec < minPrecedence) {
+            break;
+        }
+        ++position;
+
+        int right = parseExpression(prec + 1);
+        if (right < 0) {
+            return -1;
+        }
+        left = addNode(ExprNode::BINARY, QString(), op, left, right);
+    }
+    return left;
+}
+
+int LoopVectorizer::parsePrimary() {
+    if (position >= loopTokens.size()) {
+        fail("unexpected end of loop body");
+        return -1;
+    }
+
+    Token tok = loopTokens[position];
+    switch (tok.getType()) {
+    case TokenType::INTEGER_LITERAL:
+        ++position;
+        return addNode(ExprNode::CONSTANT, tok.getLexeme());
+
+    case TokenType::MINUS: {
+        // Unary minus becomes 0 - x
+        ++position;
+        int operandNode = parsePrimary();
+        if (operandNode < 0) {
+            return -1;
+        }
+        return addNode(ExprNode::BINARY, QString(), TokenType::MINUS,
+                       addNode(ExprNode::CONSTANT, "0"), operandNode);
+    }
+
+    case TokenType::LPAREN: {
+        ++position;
+        int inner = parseExpression(1);
+        if (inner < 0) {
+            return -1;
+        }
+        if (position >= loopTokens.size() || loopTokens[position].getType() != TokenType::RPAREN) {
+            fail("expected ')'");
+            return -1;
+        }
+        ++position;
+        return inner;
+    }
+
+    case TokenType::IDENTIFIER: {
+        QString name = tok.getLexeme();
+        ++position;
+        if (name == inductionVar) {
+            fail(QString("induction variable '%1' is used as a value").arg(name));
+            return -1;
+        }
+
+        TokenType next = position < loopTokens.size() ? loopTokens[position].getType() : TokenType::END_OF_FILE;
+        if (next == TokenType::LPAREN) {
+            fail(QString("call to '%1' in loop body").arg(name));
+            return -1;
+        }
+        if (next == TokenType::LBRACKET) {
+            if (!intArrays.contains(name)) {
+                fail(QString("'%1' is not a declared int array").arg(name));
+                return -1;
+            }
+            if (!parseIndex()) {
+                return -1;
+            }
+            return addNode(ExprNode::ARRAY, name);
+        }
+        if (intArrays.contains(name)) {
+            fail(QString("array '%1' used without an index").arg(name));
+            return -1;
+        }
+        return addNode(ExprNode::SCALAR, name);
+    }
+
+    default:
+        fail(QString("unsupported token '%1' in loop body").arg(tok.getLexeme()));
+        return -1;
+    }
+}
+
+int LoopVectorizer::addNode(ExprNode::Kind kind, const QString& name, TokenType op, int left, int right) {
+    ExprNode node;
+    node.kind = kind;
+    node.name = name;
+    node.op = op;
+    node.left = left;
+    node.right = right;
+    nodes.append(node);
+    return nodes.size() - 1;
+}
+
+// ============================================================
+//  EMISSION
+// ============================================================
+
+QString LoopVectorizer::operand(const QString& value) const {
+    if (!value.isEmpty() && (value[0].isDigit() || value[0] == '-')) {
+        return value;
+    }
+    return QString("[%1]").arg(value);
+}
+
+QString LoopVectorizer::emitScalarLoop(const QString& label) const {
+    QString code = QString(".%1_scalar:\n").arg(label);
+    code += "    cmp ecx, edx\n";
+    code += QString("    jge .%1_done\n").arg(label);
+    for (const Store& store : stores) {
+        emitScalarExpression(store.root, code);
+        code += QString("    mov [%1 + ecx*4], eax\n").arg(store.array);
+    }
+    code += "    inc ecx\n";
+    code += QString("    jmp .%1_scalar\n").arg(label);
+    code += QString(".%1_done:\n").arg(label);
+    return code;
+}
+
+void LoopVectorizer::emitScalarExpression(int node, QString& code) const {
+    const ExprNode& n = nodes[node];
+    auto leaf = [this](const ExprNode& e) {
+        if (e.kind == ExprNode::ARRAY) return QString("[%1 + ecx*4]").arg(e.name);
+        return operand(e.name);
+    };
+
+    if (n.kind != ExprNode::BINARY) {
+        code += QString("    mov eax, %1\n").arg(leaf(n));
+        return;
+    }
+
+    QString mnemonic;
+    switch (n.op) {
+    case TokenType::PLUS: mnemonic = "add"; break;
+    case TokenType::MINUS: mnemonic = "sub"; break;
+    case TokenType::MULTIPLY: mnemonic = "imul"; break;
+    case TokenType::BITWISE_AND: mnemonic = "and"; break;
+    case TokenType::BITWISE_OR: mnemonic = "or"; break;
+    default: mnemonic = "xor"; break;
+    }
+
+    const ExprNode& right = nodes[n.right];
+    if (right.kind != ExprNode::BINARY) {
+        // Leaf right operand: use it straight from memory or as an immediate
+        emitScalarExpression(n.left, code);
+        if (n.op == TokenType::MULTIPLY && right.kind == ExprNode::CONSTANT) {
+            code += QString("    imul eax, eax, %1\n").arg(right.name);
+        } else {
+            code += QString("    %1 eax, %2\n").arg(mnemonic).arg(leaf(right));
+        }
+        return;
+    }
+
+    emitScalarExpression(n.right, code);
+    code += "    push eax\n";
+    emitScalarExpression(n.left, code);
+    code += "    pop ebx\n";
+    code += QString("    %1 eax, ebx\n").arg(mnemonic);
+}
+
+QString LoopVectorizer::vectorRegister(int index) const {
+    return QString(isa == VectorISA::AVX2 ? "ymm%1" : "xmm%1").arg(index);
+}
+
+QString LoopVectorizer::vectorOpcode(TokenType op) const {
+    QString opcode;
+    switch (op) {
+    case TokenType::PLUS: opcode = "paddd"; break;
+    case TokenType::MINUS: opcode = "psubd"; break;
+    case TokenType::MULTIPLY: opcode = "pmulld"; break;
+    case TokenType::BITWISE_AND: opcode = "pand"; break;
+    case TokenType::BITWISE_OR: opcode = "por"; break;
+    default: opcode = "pxor"; break;
+    }
+    return isa == VectorISA::AVX2 ? "v" + opcode : opcode;
+}
+
+int LoopVectorizer::emitVectorExpression(int node, int target, const QMap<QString, int>& invariants,
+                                         QString& code, int* highest) const {
+    const ExprNode& n = nodes[node];
+    QString load = isa == VectorISA::AVX2 ? "vmovdqu" : "movdqu";
+
+    if (n.kind == ExprNode::ARRAY) {
+        *highest = qMax(*highest, target);
+        code += QString("    %1 %2, [%3 + ecx*4]\n").arg(load).arg(vectorRegister(target)).arg(n.name);
+        return target;
+    }
+    if (n.kind != ExprNode::BINARY) {
+        return invariants.value(n.name);
+    }
+
+    int left = emitVectorExpression(n.left, target, invariants, code, highest);
+    int right = emitVectorExpression(n.right, target + 1, invariants, code, highest);
+    *highest = qMax(*highest, target);
+
+    if (isa == VectorISA::AVX2) {
+        code += QString("    %1 %2, %3, %4\n").arg(vectorOpcode(n.op))
+                    .arg(vectorRegister(target)).arg(vectorRegister(left)).arg(vectorRegister(right));
+        return target;
+    }
+
+    if (left != target) {
+        code += QString("    movdqa %1, %2\n").arg(vectorRegister(target)).arg(vectorRegister(left));
+    }
+
+    if (n.op != TokenType::MULTIPLY) {
+        code += QString("    %1 %2, %3\n").arg(vectorOpcode(n.op))
+                    .arg(vectorRegister(target)).arg(vectorRegister(right));
+        return target;
+    }
+
+    // SSE2 has no pmulld: multiply even and odd lanes with pmuludq and re-interleave
+    if (right != target + 1) {
+        code += QString("    movdqa %1, %2\n").arg(vectorRegister(target + 1)).arg(vectorRegister(right));
+        right = target + 1;
+    }
+    int odd = target + 2;
+    *highest = qMax(*highest, odd);
+    QString t = vectorRegister(target);
+    QString r = vectorRegister(right);
+    QString o = vectorRegister(odd);
+    code += QString("    pshufd %1, %2, 0xF5\n").arg(o).arg(t);
+    code += QString("    pmuludq %1, %2\n").arg(t).arg(r);
+    code += QString("    pshufd %1, %1, 0xF5\n").arg(r);
+    code += QString("    pmuludq %1, %2\n").arg(o).arg(r);
+    code += QString("    pshufd %1, %1, 0x08\n").arg(t);
+    code += QString("    pshufd %1, %1, 0x08\n").arg(o);
+    code += QString("    punpckldq %1, %2\n").arg(t).arg(o);
+    return target;
+}
+
+bool LoopVectorizer::emitVectorLoop(const QString& label, QString& code, QString* reason) const {
+    const int registerCount = 8;
+    int lanes = laneCount();
+
+    // Loop invariants are broadcast once, into the highest vector registers
+    QMap<QString, int> invariants;
+    QVector<QString> invariantOrder;
+    for (const ExprNode& n : nodes) {
+        if ((n.kind == ExprNode::SCALAR || n.kind == ExprNode::CONSTANT) && !invariants.contains(n.name)) {
+            invariants.insert(n.name, registerCount - 1 - invariantOrder.size());
+            invariantOrder.append(n.name);
+        }
+    }
+
+    QString body;
+    int highest = -1;
+    QString store = isa == VectorISA::AVX2 ? "vmovdqu" : "movdqu";
+    for (const Store& s : stores) {
+        int result = emitVectorExpression(s.root, 0, invariants, body, &highest);
+        body += QString("    %1 [%2 + ecx*4], %3\n").arg(store).arg(s.array).arg(vectorRegister(result));
+    }
+
+    if (highest + 1 + invariantOrder.size() > registerCount) {
+        if (reason) *reason = "expression needs more than 8 vector registers";
+        return false;
+    }
+
+    code += QString("    ; vectorized: %1 x int32 per iteration (%2)\n")
+                .arg(lanes).arg(isa == VectorISA::AVX2 ? "AVX2" : "SSE2");
+
+    for (const QString& name : invariantOrder) {
+        QString reg = vectorRegister(invariants.value(name));
+        code += QString("    mov eax, %1\n").arg(operand(name));
+        if (isa == VectorISA::AVX2) {
+            code += QString("    vmovd xmm%1, eax\n").arg(invariants.value(name));
+            code += QString("    vpbroadcastd %1, xmm%2\n").arg(reg).arg(invariants.value(name));
+        } else {
+            code += QString("    movd %1, eax\n").arg(reg);
+            code += QString("    pshufd %1, %1, 0\n").arg(reg);
+        }
+    }
+
+    code += QString(".%1_vector:\n").arg(label);
+    code += QString("    lea eax, [ecx + %1]\n").arg(lanes);
+    code += "    cmp eax, edx\n";
+    code += QString("    jg .%1_scalar\n").arg(label);
+    code += body;
+    code += QString("    add ecx, %1\n").arg(lanes);
+    code += QString("    jmp .%1_vector\n").arg(label);
+    return true;
+}
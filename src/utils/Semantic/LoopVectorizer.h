@@ -0,0 +1,99 @@
+#ifndef LOOPVECTORIZER_H
+#define LOOPVECTORIZER_H
+
+#include "./models/LexicalAnalysis/Token.h"
+#include <QString>
+#include <QVector>
+#include <QMap>
+
+enum class VectorISA {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Translates counted array loops of the form
+//     for (int i = lo; i < hi; i++) { a[i] = b[i] + k * c[i]; ... }
+// into NASM with a packed main loop and a scalar epilogue. Every access must
+// be unit stride on the induction variable, so no dependence can be carried
+// between iterations; the arrays are distinct static buffers, so they never
+// overlap and need no runtime alias checks.
+class LoopVectorizer {
+private:
+    struct ExprNode {
+        enum Kind { ARRAY, SCALAR, CONSTANT, BINARY };
+        Kind kind;
+        QString name;      // array / scalar name or literal text
+        TokenType op;      // BINARY only
+        int left;
+        int right;
+    };
+
+    struct Store {
+        QString array;
+        int root;
+    };
+
+    VectorISA isa;
+    QMap<QString, int> intArrays;          // declared int arrays -> element count
+
+    // State of the loop being translated
+    QVector<Token> loopTokens;             // the loop without comments
+    int position;
+    QVector<ExprNode> nodes;
+    QVector<Store> stores;
+    QString inductionVar;
+    bool declaresInduction;
+    QString lowerBound;
+    QString upperBound;
+    bool inclusiveBound;
+    QString failure;
+
+public:
+    LoopVectorizer();
+
+    void setISA(VectorISA target) { isa = target; }
+    VectorISA getISA() const { return isa; }
+    void setIntArrays(const QMap<QString, int>& arrays) { intArrays = arrays; }
+
+    // Lanes per packed operation for the current ISA (1 for SCALAR)
+    int laneCount() const;
+
+    /**
+     * Translates the loop starting at tokens[start] (the 'for' keyword).
+     * Returns false and leaves 'code' untouched when the loop is not a
+     * counted array loop. On success *consumed is the number of tokens
+     * covered and *vectorized tells whether the packed path was emitted.
+     */
+    bool translate(const QVector<Token>& tokens, int start, const QString& label,
+                   QString& code, int* consumed, bool* vectorized = nullptr,
+                   QString* reason = nullptr);
+
+private:
+    // --- Recognition ---
+    bool parseLoop();
+    bool parseHeader();
+    bool parseStatement();
+    int parseExpression(int minPrecedence);
+    int parsePrimary();
+    bool parseIndex();
+    bool parseOperand(QString& operand);
+    int addNode(ExprNode::Kind kind, const QString& name, TokenType op = TokenType::UNKNOWN,
+                int left = -1, int right = -1);
+    bool fail(const QString& why);
+
+    static int precedence(TokenType op);
+    static bool isCompoundOperator(TokenType op);
+
+    // --- Emission ---
+    QString operand(const QString& value) const;
+    QString emitScalarLoop(const QString& label) const;
+    void emitScalarExpression(int node, QString& code) const;
+    bool emitVectorLoop(const QString& label, QString& code, QString* reason) const;
+    int emitVectorExpression(int node, int target, const QMap<QString, int>& invariants,
+                             QString& code, int* highest) const;
+    QString vectorRegister(int index) const;
+    QString vectorOpcode(TokenType op) const;
+};
+
+#endif // LOOPVECTORIZER_H
@@ -4,13 +4,18 @@
 #include <QEventLoop>
 #include <QTimer>
 #include <QUrlQuery>
+#include <QRegularExpression>
 
 MLTranslationBridge::MLTranslationBridge(QObject *parent)
     : QObject(parent)
     , pythonServerUrl("http://localhost:5000")
-    , networkManager(new QNetworkAccessManager(this))
+    , networkManager(nullptr)
     , isServerRunning(false)
     , requestTimeout(30000) // 30 seconds
+    , healthCheckInterval(0)
+    , translationGeneration(0)
+    , prefetchReply(nullptr)
+    , prefetchAdopted(false)
 {
 }
 
@@ -18,6 +23,14 @@ MLTranslationBridge::~MLTranslationBridge() {
     delete networkManager;
 }
 
+QNetworkAccessManager* MLTranslationBridge::network() {
+    // Created on the first request so constructing the bridge stays cheap
+    if (!networkManager) {
+        networkManager = new QNetworkAccessManager(this);
+    }
+    return networkManager;
+}
+
 void MLTranslationBridge::setServerUrl(const QString& url) {
     pythonServerUrl = url;
 }
@@ -26,7 +39,7 @@ bool MLTranslationBridge::checkServerHealth() {
     QNetworkRequest request(QUrl(pythonServerUrl + "/health"));
     request.setRawHeader("Content-Type", "application/json");
 
-    QNetworkReply* reply = networkManager->get(request);
+    QNetworkReply* reply = network()->get(request);
 
     // Create event loop for synchronous request
     QEventLoop loop;
@@ -54,83 +67,213 @@ bool MLTranslationBridge::checkServerHealth() {
 
     reply->deleteLater();
     isServerRunning = isHealthy;
+    lastHealthCheck.start();
     return isHealthy;
 }
 
+bool MLTranslationBridge::serverAvailable() {
+    if (isServerRunning && healthCheckInterval > 0 &&
+        lastHealthCheck.isValid() && lastHealthCheck.elapsed() < healthCheckInterval) {
+        return true;
+    }
+    return checkServerHealth();
+}
+
 void MLTranslationBridge::translateCode(const QString& sourceCode,
                                        const QString& targetLanguage,
-                                       const QVector<Token>& tokens) {
+                                       const QVector<Token>& tokens,
+                                       const DraftSource& draft) {
+    QString languageCode = targetLanguageToCode(targetLanguage);
+    QString key = requestKey(sourceCode, languageCode);
+    ++translationGeneration;
+
+    // A finished prefetch for the same input answers without a round trip
+    if (!prefetchedKey.isEmpty() && prefetchedKey == key) {
+        showTranslationStatus("Serving prefetched ML translation");
+        emit translationCompleted(prefetchedTranslation);
+        return;
+    }
+    // One still in flight is adopted, so the work already done is not repeated
+    if (prefetchReply && prefetchReply->property("requestKey").toString() == key) {
+        prefetchAdopted = true;
+        prefetchReply->setProperty("generation", translationGeneration);
+        showTranslationStatus("Waiting for prefetched ML translation...");
+        return;
+    }
+    cancelPrefetch();
+
     showTranslationStatus("Checking ML server availability...");
 
     // Check if server is running first
-    if (!checkServerHealth()) {
+    if (!serverAvailable()) {
         emit translationError("ML server is not running. Please start the Python ML server.");
         return;
     }
 
-    showTranslationStatus("Preparing translation request...");
+    showTranslationStatus("Sending code to ML model...");
+    QNetworkReply* reply = sendTranslationRequest(sourceCode, languageCode, tokens, draft, QNetworkRequest::NormalPriority);
+    reply->setProperty("generation", translationGeneration);
+}
+
+void MLTranslationBridge::prefetchTranslation(const QString& sourceCode,
+                                             const QString& targetLanguage,
+                                             const QVector<Token>& tokens,
+                                             const DraftSource& draft) {
+    QString languageCode = targetLanguageToCode(targetLanguage);
+    QString key = requestKey(sourceCode, languageCode);
+    if (prefetchedKey == key ||
+        (prefetchReply && prefetchReply->property("requestKey").toString() == key)) {
+        return;
+    }
+    cancelPrefetch();
+
+    // No blocking health check here; a server that is down just leaves nothing prefetched
+    prefetchAdopted = false;
+    prefetchReply = sendTranslationRequest(sourceCode, languageCode, tokens, draft, QNetworkRequest::LowPriority);
+    showTranslationStatus("Prefetching ML translation in the background...");
+}
 
+void MLTranslationBridge::cancelPrefetch() {
+    prefetchedKey.clear();
+    prefetchedTranslation.clear();
+    if (!prefetchReply) {
+        return;
+    }
+
+    // Cleared first: abort() finishes the reply synchronously
+    QNetworkReply* reply = prefetchReply;
+    prefetchReply = nullptr;
+    // The user is waiting for an adopted one, unless a later translateCode superseded it
+    if (prefetchAdopted && reply->property("generation").toInt() == translationGeneration) {
+        return;
+    }
+    reply->setProperty("cancelled", true);
+    reply->abort();
+}
+
+QString MLTranslationBridge::requestKey(const QString& sourceCode, const QString& languageCode) {
+    return languageCode + '\n' + sourceCode;
+}
+
+QNetworkReply* MLTranslationBridge::sendTranslationRequest(const QString& sourceCode,
+                                                           const QString& languageCode,
+                                                           const QVector<Token>& tokens,
+                                                           const DraftSource& draft,
+                                                           QNetworkRequest::Priority priority) {
     // Prepare request data
     QJsonObject requestData;
     requestData["source_code"] = sourceCode;
-    requestData["target_language"] = targetLanguageToCode(targetLanguage);
+    requestData["target_language"] = languageCode;
 
     // Convert tokens to JSON array (optional context for ML model)
     QJsonArray tokenArray;
     for (const auto& token : tokens) {
         QJsonObject tokenObj;
-        tokenObj["type"] = QString::fromStdString(token.typeToString());
-        tokenObj["value"] = token.value;
-        tokenObj["line"] = token.line;
-        tokenObj["column"] = token.column;
+        tokenObj["type"] = token.getTypeString();
+        tokenObj["value"] = token.getLexeme();
+        tokenObj["line"] = token.getLine();
+        tokenObj["column"] = token.getColumn();
         tokenArray.append(tokenObj);
     }
     requestData["tokens"] = tokenArray;
 
+    // Lets the server verify the rule-based translation instead of decoding token by token
+    QString draftText = draft ? draft() : QString();
+    if (!draftText.isEmpty()) {
+        requestData["draft"] = draftText;
+    }
+
     QJsonDocument jsonDoc(requestData);
 
     // Create network request
     QNetworkRequest request(QUrl(pythonServerUrl + "/translate"));
     request.setRawHeader("Content-Type", "application/json");
     request.setRawHeader("Accept", "application/json");
-
-    showTranslationStatus("Sending code to ML model...");
+    request.setPriority(priority);
 
     // Send POST request
-    QNetworkReply* reply = networkManager->post(request, jsonDoc.toJson());
+    QNetworkReply* reply = network()->post(request, jsonDoc.toJson());
+    reply->setProperty("requestKey", requestKey(sourceCode, languageCode));
 
-    // Handle the response asynchronously
+    // Every outcome, including errors and timeouts, is reported from finished
     connect(reply, &QNetworkReply::finished, this, &MLTranslationBridge::onNetworkReplyFinished);
-    connect(reply, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::error),
-            this, &MLTranslationBridge::onNetworkError);
 
-    // Set up timeout
-    QTimer* timeoutTimer = new QTimer(this);
+    // The timer belongs to the reply, so it goes away with it
+    QTimer* timeoutTimer = new QTimer(reply);
     timeoutTimer->setSingleShot(true);
     timeoutTimer->setInterval(requestTimeout);
 
-    connect(timeoutTimer, &QTimer::timeout, [reply, this]() {
+    connect(timeoutTimer, &QTimer::timeout, reply, [reply]() {
         if (!reply->isFinished()) {
+            reply->setProperty("timedOut", true);
             reply->abort();
-            emit translationError("Translation request timed out (30 seconds). Please try again.");
         }
     });
 
     timeoutTimer->start();
+    return reply;
 }
 
 void MLTranslationBridge::onNetworkReplyFinished() {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
 
-    // Clean up timeout timer if it exists
     reply->deleteLater();
+    if (reply->property("cancelled").toBool()) {
+        return;
+    }
 
-    if (reply->error() != QNetworkReply::NoError) {
-        emit translationError(QString("Network error: %1").arg(reply->errorString()));
+    bool speculative = false;
+    if (reply == prefetchReply) {
+        prefetchReply = nullptr;
+        speculative = !prefetchAdopted;
+    }
+
+    QString translatedCode;
+    QString errorMsg;
+    bool ok = readTranslationReply(reply, &translatedCode, &errorMsg);
+
+    // Nobody asked for a speculative result yet, so it is kept rather than shown
+    if (speculative) {
+        if (ok) {
+            prefetchedKey = reply->property("requestKey").toString();
+            prefetchedTranslation = translatedCode;
+            showTranslationStatus("ML translation prefetched");
+        }
         return;
     }
 
+    // A later translateCode asked for something else; this result would overwrite it
+    if (reply->property("generation").toInt() != translationGeneration) {
+        return;
+    }
+
+    if (!ok) {
+        if (reply->property("timedOut").toBool()) {
+            emit requestTimedOut();
+        }
+        emit translationError(errorMsg);
+        return;
+    }
+
+    showTranslationStatus("ML translation completed successfully");
+    emit translationCompleted(translatedCode);
+}
+
+bool MLTranslationBridge::readTranslationReply(QNetworkReply* reply, QString* translatedCode, QString* errorMsg) {
+    if (reply->property("timedOut").toBool()) {
+        isServerRunning = false;
+        *errorMsg = QString("Translation request timed out (%1 seconds). Please try again.")
+                        .arg(requestTimeout / 1000.0);
+        return false;
+    }
+
+    if (reply->error() != QNetworkReply::NoError) {
+        isServerRunning = false;
+        *errorMsg = describeNetworkError(reply);
+        return false;
+    }
+
     showTranslationStatus("Processing ML translation result...");
 
     QByteArray responseData = reply->readAll();
@@ -138,44 +281,48 @@ void MLTranslationBridge::onNetworkReplyFinished() {
     QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
 
     if (parseError.error != QJsonParseError::NoError) {
-        emit translationError(QString("Invalid JSON response from ML server: %1").arg(parseError.errorString()));
-        return;
+        *errorMsg = QString("Invalid JSON response from ML server: %1").arg(parseError.errorString());
+        return false;
     }
 
     QJsonObject jsonObj = jsonDoc.object();
 
     // Check for error response
     if (jsonObj.contains("error")) {
-        QString errorMsg = jsonObj.value("error").toString();
+        QString error = jsonObj.value("error").toString();
         QString details = jsonObj.value("details").toString();
         if (!details.isEmpty()) {
-            errorMsg += QString(": %1").arg(details);
+            error += QString(": %1").arg(details);
         }
-        emit translationError(QString("ML translation failed: %1").arg(errorMsg));
-        return;
+        *errorMsg = QString("ML translation failed: %1").arg(error);
+        return false;
     }
 
     // Extract translated code
     if (!jsonObj.contains("translated_code")) {
-        emit translationError("Invalid response format: missing translated_code field");
-        return;
+        *errorMsg = "Invalid response format: missing translated_code field";
+        return false;
     }
 
-    QString translatedCode = jsonObj.value("translated_code").toString();
-
     // Postprocess the result
-    QString finalCode = postprocessResult(translatedCode);
-
-    showTranslationStatus("ML translation completed successfully");
-    emit translationCompleted(finalCode);
+    *translatedCode = postprocessResult(jsonObj.value("translated_code").toString());
+    return true;
 }
 
-void MLTranslationBridge::onNetworkError(QNetworkReply::NetworkError error) {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) return;
+QString MLTranslationBridge::describeNetworkError(QNetworkReply* reply) const {
+    // The server answers failed translations with a JSON body, which is more useful than the HTTP status
+    QJsonObject body = QJsonDocument::fromJson(reply->readAll()).object();
+    if (body.contains("error")) {
+        QString errorMsg = body.value("error").toString();
+        QString details = body.value("details").toString();
+        if (!details.isEmpty()) {
+            errorMsg += QString(": %1").arg(details);
+        }
+        return QString("ML translation failed: %1").arg(errorMsg);
+    }
 
     QString errorMsg;
-    switch (error) {
+    switch (reply->error()) {
     case QNetworkReply::ConnectionRefusedError:
         errorMsg = "Connection refused - ML server may not be running";
         break;
@@ -189,8 +336,7 @@ void MLTranslationBridge::onNetworkError(QNetworkReply::NetworkError error) {
         errorMsg = QString("Network error: %1").arg(reply->errorString());
         break;
     }
-
-    emit translationError(errorMsg);
+    return errorMsg;
 }
 
 QString MLTranslationBridge::preprocessCode(const QString& sourceCode, const QVector<Token>& tokens) {
@@ -225,10 +371,10 @@ QString MLTranslationBridge::tokensToJson(const QVector<Token>& tokens) {
     QJsonArray tokenArray;
     for (const auto& token : tokens) {
         QJsonObject tokenObj;
-        tokenObj["type"] = QString::fromStdString(token.typeToString());
-        tokenObj["value"] = token.value;
-        tokenObj["line"] = token.line;
-        tokenObj["column"] = token.column;
+        tokenObj["type"] = token.getTypeString();
+        tokenObj["value"] = token.getLexeme();
+        tokenObj["line"] = token.getLine();
+        tokenObj["column"] = token.getColumn();
         tokenArray.append(tokenObj);
     }
 
@@ -11,8 +11,10 @@
 #include <QJsonArray>
 #include <QTimer>
 #include <QEventLoop>
+#include <QElapsedTimer>
 #include <QDebug>
-#include "../LexicalAnalysis/Token.h"
+#include <functional>
+#include "./models/LexicalAnalysis/Token.h"
 
 class MLTranslationBridge : public QObject {
     Q_OBJECT
@@ -22,31 +24,71 @@ private:
     QNetworkAccessManager* networkManager;
     bool isServerRunning;
     int requestTimeout;
+    int healthCheckInterval;          // 0 checks before every request
+    QElapsedTimer lastHealthCheck;
+    int translationGeneration;        // bumped by every translateCode; older replies are dropped
+
+    // Speculative translation of the input the user is expected to translate next
+    QNetworkReply* prefetchReply;     // in flight, owned by the network manager
+    bool prefetchAdopted;             // a translateCode call is waiting on it
+    QString prefetchedKey;            // requestKey of prefetchedTranslation
+    QString prefetchedTranslation;
 
 public:
+    // Produces the rule-based draft sent along with a request. It is called
+    // at most once, before translateCode or prefetchTranslation returns, and
+    // only if a request is actually sent.
+    typedef std::function<QString()> DraftSource;
+
     explicit MLTranslationBridge(QObject *parent = nullptr);
     ~MLTranslationBridge();
 
     void setServerUrl(const QString& url);
+    void setRequestTimeout(int ms) { requestTimeout = qMax(1, ms); }
+    int getRequestTimeout() const { return requestTimeout; }
+    // Trust a healthy server for this long instead of checking per request;
+    // a failed request forces the next one to check again
+    void setHealthCheckInterval(int ms) { healthCheckInterval = qMax(0, ms); }
     bool checkServerHealth();
     void translateCode(const QString& sourceCode,
                       const QString& targetLanguage,
-                      const QVector<Token>& tokens);
+                      const QVector<Token>& tokens,
+                      const DraftSource& draft = DraftSource());
+    // Starts a low-priority translation whose result is kept, not emitted, until
+    // translateCode asks for the same source and language. Any earlier prefetch
+    // is cancelled.
+    void prefetchTranslation(const QString& sourceCode,
+                             const QString& targetLanguage,
+                             const QVector<Token>& tokens,
+                             const DraftSource& draft = DraftSource());
+    // Aborts the prefetch in flight and drops the kept result
+    void cancelPrefetch();
 
 signals:
     void translationCompleted(const QString& translatedCode);
     void translationError(const QString& error);
+    // Emitted just before the translationError of a request that timed out
+    void requestTimedOut();
 
 private slots:
     void onNetworkReplyFinished();
-    void onNetworkError(QNetworkReply::NetworkError error);
 
 private:
+    bool serverAvailable();
+    QString describeNetworkError(QNetworkReply* reply) const;
+    QNetworkReply* sendTranslationRequest(const QString& sourceCode,
+                                          const QString& languageCode,
+                                          const QVector<Token>& tokens,
+                                          const DraftSource& draft,
+                                          QNetworkRequest::Priority priority);
+    bool readTranslationReply(QNetworkReply* reply, QString* translatedCode, QString* errorMsg);
+    static QString requestKey(const QString& sourceCode, const QString& languageCode);
     QString preprocessCode(const QString& sourceCode, const QVector<Token>& tokens);
     QString postprocessResult(const QString& mlResult);
     QString tokensToJson(const QVector<Token>& tokens);
     QString targetLanguageToCode(const QString& targetLanguage);
     bool startPythonServer();
+    QNetworkAccessManager* network();
     void showTranslationStatus(const QString& message);
 };
 
@@ -0,0 +1,349 @@
+#include "ParallelFrontEnd.h"
+#include "./src/utils/Grammar/AdaptiveParser.h"
+#include "./src/utils/Grammar/GrammarAnalyzer.h"
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QSet>
+#include <QHash>
+#include <algorithm>
+
+namespace {
+
+class BatchTask : public QRunnable {
+public:
+    explicit BatchTask(std::function<void()> work) : work(std::move(work)) {}
+    void run() override { work(); }
+
+private:
+    std::function<void()> work;
+};
+
+// Per-batch output of the semantic pass
+struct AnalysisResult {
+    QVector<SemanticError> errors;
+    QVector<Symbol> symbols;                    // discovered, in order
+    QVector<QPair<QString, QString>> assigned;  // globals of earlier batches assigned here, last value
+    QVector<EnvironmentSnapshot> snapshots;     // token indices relative to the batch
+};
+
+}
+
+ParallelFrontEnd::ParallelFrontEnd(int workerCount)
+    : workerCount(workerCount > 0 ? workerCount : std::max(1, QThread::idealThreadCount())) {
+}
+
+// ============================================================
+// Pre-scan
+// ============================================================
+
+QVector<DeclarationRange> ParallelFrontEnd::findTopLevelDeclarations(const QVector<Token>& tokens) {
+    QVector<DeclarationRange> ranges;
+    int depth = 0;
+    int begin = 0;
+    int end = Token::inputLength(tokens);
+
+    for (int i = 0; i < end; ++i) {
+        switch (tokens[i].getType()) {
+        case TokenType::LPAREN:
+        case TokenType::LBRACE:
+        case TokenType::LBRACKET:
+            ++depth;
+            break;
+        case TokenType::RPAREN:
+        case TokenType::RBRACKET:
+            if (depth > 0) --depth;
+            break;
+        case TokenType::RBRACE:
+            if (depth > 0) --depth;
+            // A closing brace ends a function body or block unless the
+            // construct goes on: "} else", "do { } while (...);", "};"
+            if (depth == 0 && !continuesDeclaration(tokens, i + 1)) {
+                ranges.append(DeclarationRange(begin, i + 1));
+                begin = i + 1;
+            }
+            break;
+        case TokenType::SEMICOLON:
+            if (depth == 0) {
+                ranges.append(DeclarationRange(begin, i + 1));
+                begin = i + 1;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (begin < end) {
+        ranges.append(DeclarationRange(begin, end));
+    }
+    return ranges;
+}
+
+bool ParallelFrontEnd::continuesDeclaration(const QVector<Token>& tokens, int index) {
+    if (index >= tokens.size()) return false;
+
+    const Token& next = tokens[index];
+    switch (next.getType()) {
+    case TokenType::SEMICOLON:
+    case TokenType::COMMA:
+        return true;
+    case TokenType::KEYWORD: {
+        QString keyword = next.getLexeme().toLower();
+        return keyword == "else" || keyword == "while";
+    }
+    default:
+        return false;
+    }
+}
+
+// Same shape SemanticAnalyzer::analyzeDeclaration accepts: type identifier ...
+bool ParallelFrontEnd::declaresGlobal(const QVector<Token>& tokens, const DeclarationRange& range, Symbol* symbol) {
+    if (range.end - range.begin < 2) return false;
+
+    const Token& typeTok = tokens[range.begin];
+    const Token& idTok = tokens[range.begin + 1];
+    if (typeTok.getType() != TokenType::KEYWORD || !SemanticAnalyzer::isTypeKeyword(typeTok.getLexeme()) ||
+        idTok.getType() != TokenType::IDENTIFIER) {
+        return false;
+    }
+    if (range.begin + 2 < range.end && tokens[range.begin + 2].getType() == TokenType::LPAREN) {
+        return false;   // function
+    }
+
+    *symbol = Symbol(idTok.getLexeme(), SymbolTable::stringToType(typeTok.getLexeme()), 0, idTok.getLine());
+    return true;
+}
+
+int ParallelFrontEnd::lineAt(const QVector<Token>& tokens, int index) {
+    if (index < tokens.size()) return tokens[index].getLine();
+    return tokens.isEmpty() ? 0 : tokens.last().getLine();
+}
+
+// ============================================================
+// Scheduling
+// ============================================================
+
+// A few batches per worker so an expensive function does not leave the
+// other workers idle, but no more: every batch pays for its own analyzer.
+QVector<ParallelFrontEnd::Batch> ParallelFrontEnd::makeBatches(const QVector<DeclarationRange>& declarations) const {
+    QVector<Batch> batches;
+    if (declarations.isEmpty()) return batches;
+
+    int totalTokens = declarations.last().end - declarations.first().begin;
+    int batchCount = std::min(declarations.size(), workerCount * 4);
+    int target = std::max(1, totalTokens / batchCount);
+
+    int first = 0;
+    int size = 0;
+    for (int d = 0; d < declarations.size(); ++d) {
+        size += declarations[d].end - declarations[d].begin;
+        if (size >= target || d == declarations.size() - 1) {
+            batches.append({first, d + 1});
+            first = d + 1;
+            size = 0;
+        }
+    }
+    return batches;
+}
+
+void ParallelFrontEnd::runBatches(int batchCount, const std::function<void(int)>& work) const {
+    int threads = std::min(workerCount, batchCount);
+    if (threads <= 1) {
+        for (int b = 0; b < batchCount; ++b) {
+            work(b);
+        }
+        return;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    QAtomicInt next(0);
+    for (int t = 0; t < threads; ++t) {
+        pool.start(new BatchTask([&]() {
+            int b;
+            while ((b = next.fetchAndAddRelaxed(1)) < batchCount) {
+                work(b);
+            }
+        }));
+    }
+    pool.waitForDone();
+}
+
+// ============================================================
+// Parsing
+// ============================================================
+
+QString ParallelFrontEnd::listItemRule(const Grammar& grammar) {
+    QString start = grammar.getStartSymbol();
+    QVector<Production> productions = grammar.getProductionsFor(start);
+    if (productions.size() != 2) return QString();
+
+    GrammarAnalyzer analyzer(grammar);
+    QString item;
+    bool hasEmpty = false;
+    for (const Production& production : productions) {
+        QVector<QString> body = GrammarAnalyzer::bodyOf(production);
+        if (body.isEmpty()) {
+            hasEmpty = true;
+        } else if (body.size() == 2 && body[1] == start && body[0] != start && analyzer.isNonTerminal(body[0])) {
+            item = body[0];
+        }
+    }
+    return hasEmpty ? item : QString();
+}
+
+bool ParallelFrontEnd::parse(const QVector<Token>& tokens, const Grammar& grammar, ParseTree* tree) const {
+    QString item = listItemRule(grammar);
+    if (item.isEmpty() || !GrammarAnalyzer(grammar).isLL1()) return false;
+
+    QVector<DeclarationRange> declarations = findTopLevelDeclarations(tokens);
+    if (declarations.isEmpty()) return false;
+    QVector<Batch> batches = makeBatches(declarations);
+
+    Grammar itemGrammar = grammar;
+    itemGrammar.setStartSymbol(item);
+
+    // Builds (or finds) the shared model once, before the workers race for it
+    AdaptiveParser prototype(itemGrammar);
+    if (!prototype.isValid()) return false;
+
+    // One slot per declaration; workers only touch their own slots
+    QVector<std::shared_ptr<ParseTreeNode>> roots(declarations.size());
+    std::shared_ptr<ParseTreeNode>* rootSlots = roots.data();
+    QAtomicInt failed(0);
+
+    runBatches(batches.size(), [&](int b) {
+        AdaptiveParser parser(itemGrammar);
+        for (int d = batches[b].first; d < batches[b].last && !failed.loadRelaxed(); ++d) {
+            const DeclarationRange& range = declarations[d];
+            ParseTree declaration = parser.parse(tokens.mid(range.begin, range.end - range.begin));
+            if (parser.hasErrors() || !declaration.getRoot()) {
+                failed.storeRelaxed(1);
+                return;
+            }
+            rootSlots[d] = declaration.getRoot();
+        }
+    });
+    if (failed.loadRelaxed()) return false;
+
+    // S(X1, S(X2, ... S(ε)))
+    QString start = grammar.getStartSymbol();
+    auto root = std::make_shared<ParseTreeNode>(start, false);
+    auto list = root;
+    for (const auto& declaration : roots) {
+        auto rest = std::make_shared<ParseTreeNode>(start, false);
+        list->addChild(declaration);
+        list->addChild(rest);
+        list = rest;
+    }
+    list->addChild(std::make_shared<ParseTreeNode>("ε", true));
+
+    *tree = ParseTree(grammar.getName());
+    tree->setRoot(root);
+    return true;
+}
+
+// ============================================================
+// Semantic analysis
+// ============================================================
+
+bool ParallelFrontEnd::analyze(const QVector<Token>& tokens) {
+    errors.clear();
+    warnings.clear();
+    discoveredSymbols.clear();
+    snapshots.clear();
+
+    QVector<DeclarationRange> declarations = findTopLevelDeclarations(tokens);
+    QVector<Batch> batches = makeBatches(declarations);
+
+    // Globals visible to each batch: declared by an earlier declaration, first one wins
+    QVector<Symbol> globals;
+    QVector<int> visibleGlobals;
+    QSet<QString> globalNames;
+    for (const Batch& batch : batches) {
+        visibleGlobals.append(globals.size());
+        for (int d = batch.first; d < batch.last; ++d) {
+            Symbol symbol;
+            if (declaresGlobal(tokens, declarations[d], &symbol) && !globalNames.contains(symbol.name)) {
+                globalNames.insert(symbol.name);
+                globals.append(symbol);
+            }
+        }
+    }
+
+    QVector<AnalysisResult> results(batches.size());
+    AnalysisResult* resultSlots = results.data();
+
+    runBatches(batches.size(), [&](int b) {
+        const Batch& batch = batches[b];
+        int begin = declarations[batch.first].begin;
+        int end = declarations[batch.last - 1].end;
+        QVector<Symbol> external = globals.mid(0, visibleGlobals[b]);
+
+        SemanticAnalyzer analyzer;
+        analyzer.setExternalSymbols(external);
+        analyzer.setTokens(tokens.mid(begin, end - begin));
+        analyzer.analyzeProgram(false);
+
+        AnalysisResult& result = resultSlots[b];
+        result.errors = analyzer.getErrors();
+        result.symbols = analyzer.getSymbolTable()->getDiscoveredSymbols();
+        result.snapshots = analyzer.getSnapshots();
+        for (const Symbol& symbol : external) {
+            const Symbol* global = analyzer.getSymbolTable()->lookup(symbol.name);
+            if (global && global->scope == 0 && global->isInitialized) {
+                result.assigned.append(qMakePair(symbol.name, global->value));
+            }
+        }
+    });
+
+    // Merge in source order; assignments to an earlier batch's global land
+    // on its declaration, later batches overwriting earlier ones
+    QHash<QString, int> globalIndex;    // name -> its declaration in discoveredSymbols
+    for (int b = 0; b < results.size(); ++b) {
+        const AnalysisResult& result = results[b];
+        for (const auto& assignment : result.assigned) {
+            int index = globalIndex.value(assignment.first, -1);
+            if (index >= 0) {
+                discoveredSymbols[index].value = assignment.second;
+                discoveredSymbols[index].isInitialized = true;
+            }
+        }
+        errors += result.errors;
+        for (const Symbol& symbol : result.symbols) {
+            if (symbol.scope == 0 && !globalIndex.contains(symbol.name)) {
+                globalIndex.insert(symbol.name, discoveredSymbols.size());
+            }
+            discoveredSymbols.append(symbol);
+        }
+
+        // A batch's closing snapshot sits on the next batch's first token
+        int offset = declarations[batches[b].first].begin;
+        for (EnvironmentSnapshot snapshot : result.snapshots) {
+            snapshot.tokenIndex += offset;
+            snapshot.line = lineAt(tokens, snapshot.tokenIndex);
+            if (!snapshots.isEmpty() && snapshots.last().tokenIndex == snapshot.tokenIndex) {
+                snapshots.last() = snapshot;
+            } else {
+                snapshots.append(snapshot);
+            }
+        }
+    }
+
+    // Statements past the last declaration (end of input) see the final globals
+    if (!snapshots.isEmpty() && snapshots.last().tokenIndex < tokens.size()) {
+        snapshots.append(EnvironmentSnapshot(tokens.size(), lineAt(tokens, tokens.size()),
+                                             snapshots.last().environment));
+    }
+
+    for (const Symbol& symbol : discoveredSymbols) {
+        if (!symbol.isInitialized) {
+            warnings.append(SemanticError(QString("Variable '%1' declared but never initialized")
+                                              .arg(symbol.name), symbol.line, "Warning"));
+        }
+    }
+
+    return errors.isEmpty();
+}
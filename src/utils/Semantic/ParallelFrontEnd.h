@@ -0,0 +1,71 @@
+#ifndef PARALLELFRONTEND_H
+#define PARALLELFRONTEND_H
+
+#include "./src/models/Grammar/Grammar.h"
+#include "./src/models/Grammar/ParseTree.h"
+#include "./src/models/LexicalAnalysis/Token.h"
+#include "./src/models/Semantic/SymbolTable.h"
+#include "./src/utils/Semantic/SemanticAnalyzer.h"
+#include <QVector>
+#include <functional>
+
+// Token range [begin, end) of one top-level declaration or statement
+struct DeclarationRange {
+    int begin;
+    int end;
+
+    DeclarationRange(int b = 0, int e = 0) : begin(b), end(e) {}
+};
+
+// Splits a token stream at its top-level declarations and parses or analyzes
+// them on a thread pool. Declarations are grouped into contiguous batches;
+// each batch only sees the globals declared before it, so the merged result
+// is the same as a sequential pass over the whole file, in source order.
+class ParallelFrontEnd {
+public:
+    explicit ParallelFrontEnd(int workerCount = 0);     // 0 = one worker per core
+
+    int getWorkerCount() const { return workerCount; }
+
+    // Brace/semicolon pre-scan; the end-of-file token is not part of any range
+    static QVector<DeclarationRange> findTopLevelDeclarations(const QVector<Token>& tokens);
+
+    // Parses a program grammar whose start rule is a list, S -> X S | ε, one
+    // declaration per X with AdaptiveParser (shared DFA cache), and links the
+    // items into the S chain the sequential parse builds. Only LL(1) grammars
+    // qualify: their tree is unique, so the merged tree is the sequential one.
+    // False, with *tree untouched, when the grammar does not qualify or a
+    // declaration is not one X; the caller then parses sequentially.
+    bool parse(const QVector<Token>& tokens, const Grammar& grammar, ParseTree* tree) const;
+
+    // X of a start rule S -> X S | ε, or empty
+    static QString listItemRule(const Grammar& grammar);
+
+    // Semantic analysis with SemanticAnalyzer's rules
+    bool analyze(const QVector<Token>& tokens);
+    QVector<SemanticError> getErrors() const { return errors; }
+    QVector<SemanticError> getWarnings() const { return warnings; }
+    QVector<Symbol> getDiscoveredSymbols() const { return discoveredSymbols; }
+    QVector<EnvironmentSnapshot> getSnapshots() const { return snapshots; }
+
+private:
+    struct Batch {
+        int first;          // first declaration
+        int last;           // one past the last declaration
+    };
+
+    int workerCount;
+    QVector<SemanticError> errors;
+    QVector<SemanticError> warnings;
+    QVector<Symbol> discoveredSymbols;
+    QVector<EnvironmentSnapshot> snapshots;
+
+    QVector<Batch> makeBatches(const QVector<DeclarationRange>& declarations) const;
+    void runBatches(int batchCount, const std::function<void(int)>& work) const;
+
+    static bool continuesDeclaration(const QVector<Token>& tokens, int index);
+    static int lineAt(const QVector<Token>& tokens, int index);
+    static bool declaresGlobal(const QVector<Token>& tokens, const DeclarationRange& range, Symbol* symbol);
+};
+
+#endif // PARALLELFRONTEND_H
@@ -0,0 +1,91 @@
+#include "ProgramProfile.h"
+#include <QCryptographicHash>
+#include <QFile>
+
+namespace {
+
+quint32 readLittleEndian32(const char* data) {
+    quint32 value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= quint32(quint8(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+ProgramProfile::ProgramProfile()
+    : programHash(0), runs(0) {}
+
+bool ProgramProfile::load(const QString& path, QString* errorMsg) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMsg) *errorMsg = QString("Cannot open %1.").arg(path);
+        return false;
+    }
+
+    QByteArray data = file.readAll();
+    if (data.size() < HeaderSize ||
+        readLittleEndian32(data.constData()) != Magic ||
+        readLittleEndian32(data.constData() + 4) != Version) {
+        if (errorMsg) *errorMsg = QString("%1 is not a profile file.").arg(path);
+        return false;
+    }
+
+    quint32 probes = readLittleEndian32(data.constData() + 12);
+    if (quint64(data.size()) != HeaderSize + 4 * quint64(probes)) {
+        if (errorMsg) *errorMsg = QString("%1 is truncated.").arg(path);
+        return false;
+    }
+
+    programHash = readLittleEndian32(data.constData() + 8);
+    counts.resize(int(probes));
+    for (int i = 0; i < counts.size(); ++i) {
+        counts[i] = readLittleEndian32(data.constData() + HeaderSize + 4 * i);
+    }
+    runs = 1;
+    return true;
+}
+
+bool ProgramProfile::merge(const ProgramProfile& other, QString* errorMsg) {
+    if (other.isEmpty()) {
+        return true;
+    }
+    if (isEmpty()) {
+        *this = other;
+        return true;
+    }
+    if (other.programHash != programHash || other.counts.size() != counts.size()) {
+        if (errorMsg) *errorMsg = "Profiles were recorded for different programs.";
+        return false;
+    }
+
+    for (int i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    runs += other.runs;
+    return true;
+}
+
+quint32 ProgramProfile::hashTokens(const QVector<Token>& tokens) {
+    // Stable across processes, unlike qHash
+    QByteArray text;
+    for (const Token& token : tokens) {
+        text.append(QByteArray::number(int(token.getType())));
+        text.append(' ');
+        text.append(token.getLexeme().toUtf8());
+        text.append('\n');
+    }
+    QByteArray digest = QCryptographicHash::hash(text, QCryptographicHash::Md5);
+    return readLittleEndian32(digest.constData());
+}
+
+ProgramProfile ProgramProfile::mergeMatching(const QVector<ProgramProfile>& profiles, quint32 hash) {
+    ProgramProfile merged;
+    for (const ProgramProfile& profile : profiles) {
+        if (profile.programHash == hash) {
+            merged.merge(profile);
+        }
+    }
+    return merged;
+}
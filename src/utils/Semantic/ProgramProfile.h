@@ -0,0 +1,47 @@
+#ifndef PROGRAMPROFILE_H
+#define PROGRAMPROFILE_H
+
+#include "./models/LexicalAnalysis/Token.h"
+#include <QString>
+#include <QVector>
+
+// Execution counts written by an instrumented assembly program on exit.
+// File layout, little endian:
+//     "CPRF"  magic
+//     u32     format version
+//     u32     program hash (hashTokens of the generated token stream)
+//     u32     probe count n
+//     u32[n]  probe counters
+// Probes are numbered in source order by the code generator: each if gets
+// one counter per outgoing edge (then, else), each while one for loop
+// entries and one for body executions.
+class ProgramProfile {
+private:
+    quint32 programHash;
+    QVector<quint64> counts;
+    int runs;
+
+public:
+    static const quint32 Magic = 0x46525043;     // "CPRF"
+    static const quint32 Version = 1;
+    static const int HeaderSize = 16;
+
+    ProgramProfile();
+
+    bool load(const QString& path, QString* errorMsg = nullptr);
+    // Adds the counts of another run of the same program
+    bool merge(const ProgramProfile& other, QString* errorMsg = nullptr);
+
+    bool isEmpty() const { return runs == 0; }
+    quint32 getProgramHash() const { return programHash; }
+    int getProbeCount() const { return counts.size(); }
+    int getRunCount() const { return runs; }
+    quint64 count(int probe) const { return probe >= 0 && probe < counts.size() ? counts[probe] : 0; }
+
+    // Identifies a program across the instrumented and optimizing builds
+    static quint32 hashTokens(const QVector<Token>& tokens);
+    // Sum of the profiles recorded for the program with the given hash
+    static ProgramProfile mergeMatching(const QVector<ProgramProfile>& profiles, quint32 hash);
+};
+
+#endif // PROGRAMPROFILE_H
@@ -0,0 +1,253 @@
+#include "ScheduleBenchmark.h"
+#include "CodeGenerator.h"
+#include "SemanticAnalyzer.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTemporaryDir>
+
+ScheduleBenchmark::ScheduleBenchmark(quint32 seed)
+    : random(seed), stepsDone(0), cancelled(false) {}
+
+bool ScheduleBenchmark::keepGoing() {
+    if (!cancelled && progressCallback && !progressCallback(stepsDone)) {
+        cancelled = true;
+    }
+    return !cancelled;
+}
+
+QVector<Token> ScheduleBenchmark::generateProgram(int statements, int inputs) {
+    QVector<Token> tokens;
+    inputs = qMax(1, inputs);
+
+    auto declare = [&](const QString& name) {
+        tokens.append(Token(TokenType::KEYWORD, "int"));
+        tokens.append(Token(TokenType::IDENTIFIER, name));
+        tokens.append(Token(TokenType::ASSIGN, "="));
+    };
+
+    // Inputs are never reassigned, so they are safe divisors
+    for (int i = 0; i < inputs; ++i) {
+        declare(QString("a%1").arg(i));
+        tokens.append(Token(TokenType::INTEGER_LITERAL, QString::number(1 + random.next() % 99)));
+        tokens.append(Token(TokenType::SEMICOLON, ";"));
+    }
+
+    static const TokenType opTypes[] = { TokenType::PLUS, TokenType::MINUS, TokenType::MULTIPLY,
+                                         TokenType::DIVIDE, TokenType::MODULO };
+    static const char* opLexemes[] = { "+", "-", "*", "/", "%" };
+
+    for (int k = 0; k < statements; ++k) {
+        // Mostly recent values, so chains form next to independent work
+        auto anyValue = [&]() {
+            if (k > 0 && random.next() % 2 == 0) {
+                int back = 1 + random.next() % qMin(k, 4);
+                return Token(TokenType::IDENTIFIER, QString("v%1").arg(k - back));
+            }
+            return Token(TokenType::IDENTIFIER, QString("a%1").arg(random.next() % inputs));
+        };
+
+        int op = random.next() % 8;
+        op = op < 2 ? 0 : op < 3 ? 1 : op < 6 ? 2 : op < 7 ? 3 : 4;
+
+        Token rhs;
+        if (op >= 3) {
+            rhs = random.next() % 2 == 0
+                ? Token(TokenType::IDENTIFIER, QString("a%1").arg(random.next() % inputs))
+                : Token(TokenType::INTEGER_LITERAL, QString::number(2 + random.next() % 8));
+        } else {
+            rhs = random.next() % 4 == 0
+                ? Token(TokenType::INTEGER_LITERAL, QString::number(1 + random.next() % 50))
+                : anyValue();
+        }
+
+        declare(QString("v%1").arg(k));
+        tokens.append(anyValue());
+        tokens.append(Token(opTypes[op], opLexemes[op]));
+        tokens.append(rhs);
+        tokens.append(Token(TokenType::SEMICOLON, ";"));
+    }
+    return tokens;
+}
+
+namespace {
+
+int countInstructions(const QString& assembly) {
+    int count = 0;
+    bool inText = false;
+    for (const QString& raw : assembly.split('\n')) {
+        QString line = raw.trimmed();
+        if (line.startsWith("section")) {
+            inText = line.contains(".text");
+            continue;
+        }
+        if (!inText || line.isEmpty() || line.startsWith(';') || line.endsWith(':') || line.startsWith("global")) {
+            continue;
+        }
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+QVector<ScheduleBenchmarkResult> ScheduleBenchmark::run(int statements, CoreModel core, int iterations) {
+    QVector<ScheduleBenchmarkResult> results;
+
+    QVector<Token> tokens = generateProgram(statements);
+    SemanticAnalyzer analyzer;
+    analyzer.setTokens(tokens);
+    analyzer.analyzeProgram();
+    if (analyzer.hasErrors()) {
+        return results;
+    }
+
+    CodeGenerator generator;
+    generator.setTokens(tokens);
+    generator.setSymbolTable(analyzer.getSymbolTable());
+    generator.setTargetLanguage(TargetLanguage::ASSEMBLY);
+    QString baseline = generator.generate();
+
+    bool native = canRunNative();
+    QString looped = native ? wrapInLoop(baseline, iterations) : QString();
+
+    static const char* labels[] = { "O0 as emitted", "O1 scheduled", "O2 sched+rename" };
+    for (int level = 0; level <= 2; ++level) {
+        InstructionScheduler scheduler;
+        scheduler.setCoreModel(core);
+        scheduler.setRenaming(level >= 2);
+
+        ScheduleBenchmarkResult result;
+        result.label = labels[level];
+        QString program = level == 0 ? baseline : scheduler.schedule(baseline, &result.stats);
+        result.instructions = countInstructions(program);
+        result.modelCycles = scheduler.estimateCycles(program);
+        result.iterations = iterations;
+        result.nanoseconds = -1;
+        if (native) {
+            result.nanoseconds = measureNative(level == 0 ? looped : scheduler.schedule(looped));
+        }
+        if (cancelled) {
+            break;
+        }
+        results.append(result);
+        ++stepsDone;
+        if (!keepGoing()) {
+            break;
+        }
+    }
+    return results;
+}
+
+bool ScheduleBenchmark::canRunNative() {
+#ifdef Q_OS_LINUX
+    return !QStandardPaths::findExecutable("nasm").isEmpty() && !QStandardPaths::findExecutable("ld").isEmpty();
+#else
+    return false;     // the backend emits Linux int 0x80 system calls
+#endif
+}
+
+QString ScheduleBenchmark::wrapInLoop(const QString& assembly, int iterations) {
+    // ebp is never allocated by the backend nor renamed by the scheduler
+    static const QString exitSequence = "    mov eax, 1\n    mov ebx, 0\n    int 0x80\n";
+    int start = assembly.indexOf("_start:\n");
+    int exit = assembly.lastIndexOf(exitSequence);
+    if (start < 0 || exit < start) {
+        return assembly;
+    }
+
+    start += 8;
+    return assembly.left(start)
+           + QString("    mov ebp, %1\n.repeat:\n").arg(qMax(1, iterations))
+           + assembly.mid(start, exit - start)
+           + "    dec ebp\n    jnz .repeat\n"
+           + assembly.mid(exit);
+}
+
+qint64 ScheduleBenchmark::measureNative(const QString& assembly) {
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        return -1;
+    }
+
+    QString source = dir.filePath("bench.asm");
+    QString object = dir.filePath("bench.o");
+    QString binary = dir.filePath("bench");
+    QFile file(source);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return -1;
+    }
+    file.write(assembly.toUtf8());
+    file.close();
+
+    if (!runProcess("nasm", QStringList() << "-f" << "elf32" << source << "-o" << object) ||
+        !runProcess("ld", QStringList() << "-m" << "elf_i386" << object << "-o" << binary)) {
+        return -1;
+    }
+
+    // Best of three, so a descheduled run does not count
+    qint64 best = -1;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        QElapsedTimer timer;
+        timer.start();
+        if (!runProcess(binary, QStringList())) {
+            return -1;
+        }
+        qint64 elapsed = timer.nsecsElapsed();
+        if (best < 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+bool ScheduleBenchmark::runProcess(const QString& program, const QStringList& arguments) {
+    // Started rather than executed, so a cancel can kill it between polls
+    QProcess process;
+    process.start(program, arguments);
+    if (!process.waitForStarted()) {
+        return false;
+    }
+    while (process.state() != QProcess::NotRunning) {
+        if (!keepGoing()) {
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+        process.waitForFinished(100);
+    }
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
+QString ScheduleBenchmark::formatResults(const QVector<ScheduleBenchmarkResult>& results) {
+    if (results.isEmpty()) {
+        return "No benchmark results.";
+    }
+
+    QStringList lines;
+    int baseline = qMax(results.first().modelCycles, 1);
+    for (const auto& r : results) {
+        QString line = QString("%1: %2 instructions, %3 model cycles (%4% of %5)")
+                           .arg(r.label, -16)
+                           .arg(r.instructions)
+                           .arg(r.modelCycles)
+                           .arg(100.0 * r.modelCycles / baseline, 0, 'f', 1)
+                           .arg(results.first().label);
+        if (r.stats.regions > 0) {
+            line += QString(", %1/%2 runs reordered, %3 values renamed")
+                        .arg(r.stats.reordered)
+                        .arg(r.stats.regions)
+                        .arg(r.stats.renamedValues);
+        }
+        if (r.nanoseconds >= 0) {
+            line += QString(", native %1 ns/iteration").arg(r.nsPerIteration(), 0, 'f', 2);
+        }
+        lines << line;
+    }
+    if (results.first().nanoseconds < 0) {
+        lines << "Native timing skipped: nasm and ld (elf_i386) are needed on the PATH.";
+    }
+    return lines.join("\n");
+}
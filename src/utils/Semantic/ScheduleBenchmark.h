@@ -0,0 +1,59 @@
+#ifndef SCHEDULEBENCHMARK_H
+#define SCHEDULEBENCHMARK_H
+
+#include "InstructionScheduler.h"
+#include "./models/LexicalAnalysis/Token.h"
+#include "./src/utils/Xorshift32.h"
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+struct ScheduleBenchmarkResult {
+    QString label;
+    int instructions;
+    int modelCycles;             // straight-line runs on the machine model
+    ScheduleStats stats;
+    qint64 nanoseconds;          // native time of all iterations, -1 when not measured
+    int iterations;
+
+    double nsPerIteration() const { return nanoseconds >= 0 && iterations ? double(nanoseconds) / iterations : -1.0; }
+};
+
+// Compares the assembly backend's output with and without list scheduling.
+// Programs are chains of "int vK = x op y;" over a few initialised inputs,
+// so loads, multiplies and divides compete for the same registers. Model
+// cycles are always reported; when nasm and ld are on the PATH the program
+// body is also wrapped in a counted loop and timed natively.
+class ScheduleBenchmark {
+private:
+    Xorshift32 random;
+    int stepsDone;
+    bool cancelled;
+    std::function<bool(int)> progressCallback;
+
+public:
+    // Steps reported by run(): one per optimisation level
+    static const int StepsPerRun = 3;
+
+    explicit ScheduleBenchmark(quint32 seed = 12345);
+
+    // Called with the levels done so far, on the measuring thread, also while
+    // nasm, ld or a native run are busy; returning false kills the running
+    // process and run() returns the levels it has
+    void setProgressCallback(std::function<bool(int)> callback) { progressCallback = std::move(callback); }
+
+    QVector<Token> generateProgram(int statements, int inputs = 6);
+    QVector<ScheduleBenchmarkResult> run(int statements, CoreModel core, int iterations = 200000);
+
+    static bool canRunNative();
+    static QString formatResults(const QVector<ScheduleBenchmarkResult>& results);
+
+private:
+    static QString wrapInLoop(const QString& assembly, int iterations);
+    qint64 measureNative(const QString& assembly);
+    bool runProcess(const QString& program, const QStringList& arguments);
+    bool keepGoing();
+};
+
+#endif // SCHEDULEBENCHMARK_H
@@ -1,4 +1,6 @@
 #include "./src/utils/Semantic/SemanticAnalyzer.h"
+#include "./src/utils/Semantic/ParallelFrontEnd.h"
+#include <algorithm>
 #include <QDebug>
 
 SemanticAnalyzer::SemanticAnalyzer() : currentPosition(0) {
@@ -20,28 +22,90 @@ void SemanticAnalyzer::reset() {
     warnings.clear();
     currentPosition = 0;
     discoveredSymbols.clear();
+    snapshots.clear();
+
+    for (const auto& symbol : externalSymbols) {
+        symbolTable->declareExternal(symbol);
+    }
 }
 
-bool SemanticAnalyzer::analyzeProgram() {
+bool SemanticAnalyzer::analyzeProgram(bool reportUninitialized) {
     reset();
 
     while (!isAtEnd()) {
         analyzeStatement();
     }
+    recordSnapshot();
 
     // Check for unused variables
-    QVector<Symbol> allSymbols = symbolTable->getDiscoveredSymbols();
-    for (const auto& symbol : allSymbols) {
-        if (!symbol.isInitialized) {
-            addWarning(QString("Variable '%1' declared but never initialized")
-                           .arg(symbol.name), symbol.line);
+    if (reportUninitialized) {
+        QVector<Symbol> allSymbols = symbolTable->getDiscoveredSymbols();
+        for (const auto& symbol : allSymbols) {
+            if (!symbol.isInitialized) {
+                addWarning(QString("Variable '%1' declared but never initialized")
+                               .arg(symbol.name), symbol.line);
+            }
         }
     }
 
     return !hasErrors();
 }
 
+bool SemanticAnalyzer::analyzeProgramParallel(int workerCount) {
+    ParallelFrontEnd frontEnd(workerCount);
+    if (frontEnd.getWorkerCount() <= 1) {
+        return analyzeProgram();
+    }
+
+    reset();
+    frontEnd.analyze(tokens);
+
+    errors = frontEnd.getErrors();
+    warnings = frontEnd.getWarnings();
+    discoveredSymbols = frontEnd.getDiscoveredSymbols();
+    snapshots = frontEnd.getSnapshots();
+    for (const auto& symbol : discoveredSymbols) {
+        symbolTable->importDiscovered(symbol);
+    }
+
+    return !hasErrors();
+}
+
+void SemanticAnalyzer::recordSnapshot() {
+    // Nested statements can start at the same token as their parent
+    if (!snapshots.isEmpty() && snapshots.last().tokenIndex == currentPosition) {
+        snapshots.last().environment = symbolTable->getEnvironment();
+        return;
+    }
+    int line = currentPosition < tokens.size() ? tokens[currentPosition].getLine()
+                                               : (tokens.isEmpty() ? 0 : tokens.last().getLine());
+    snapshots.append(EnvironmentSnapshot(currentPosition, line, symbolTable->getEnvironment()));
+}
+
+SymbolEnvironment SemanticAnalyzer::environmentAt(int tokenIndex) const {
+    auto it = std::upper_bound(snapshots.begin(), snapshots.end(), tokenIndex,
+                               [](int index, const EnvironmentSnapshot& snapshot) {
+                                   return index < snapshot.tokenIndex;
+                               });
+    if (it == snapshots.begin()) {
+        return SymbolEnvironment();
+    }
+    return (it - 1)->environment;
+}
+
+SymbolEnvironment SemanticAnalyzer::environmentAtLine(int line) const {
+    auto it = std::upper_bound(snapshots.begin(), snapshots.end(), line,
+                               [](int ln, const EnvironmentSnapshot& snapshot) {
+                                   return ln < snapshot.line;
+                               });
+    if (it == snapshots.begin()) {
+        return SymbolEnvironment();
+    }
+    return (it - 1)->environment;
+}
+
 void SemanticAnalyzer::analyzeStatement() {
+    recordSnapshot();
     Token tok = peek();
 
     if (tok.getType() == TokenType::KEYWORD) {
@@ -226,13 +290,11 @@ void SemanticAnalyzer::analyzeAssignment() {
                      .arg(varName), line);
     } else {
         symbolTable->updateSymbol(varName, valueTok.getLexeme());
-        // Update discovered symbol as well
-        for(auto& sym : discoveredSymbols) {
-            if(sym.name == varName && sym.scope == symbol->scope) {
-                sym.isInitialized = true;
-                sym.value = valueTok.getLexeme();
-                break;
-            }
+        // Update discovered symbol as well (same order as the table's list)
+        int index = symbolTable->discoveredIndexOf(varName);
+        if (index >= 0 && index < discoveredSymbols.size()) {
+            discoveredSymbols[index].isInitialized = true;
+            discoveredSymbols[index].value = valueTok.getLexeme();
         }
     }
 
@@ -390,7 +452,7 @@ void SemanticAnalyzer::analyzeIfStatement() {
     }
 }
 
-bool SemanticAnalyzer::isTypeKeyword(const QString& keyword) const {
+bool SemanticAnalyzer::isTypeKeyword(const QString& keyword) {
     QString lower = keyword.toLower();
     return lower == "int" || lower == "float" || lower == "string" ||
            lower == "bool" || lower == "char" || lower == "double" ||
@@ -21,6 +21,16 @@ struct SemanticError {
     }
 };
 
+// Symbols visible before the statement that starts at tokenIndex
+struct EnvironmentSnapshot {
+    int tokenIndex;
+    int line;
+    SymbolEnvironment environment;
+
+    EnvironmentSnapshot(int index = 0, int ln = 0, const SymbolEnvironment& env = SymbolEnvironment())
+        : tokenIndex(index), line(ln), environment(env) {}
+};
+
 class SemanticAnalyzer {
 private:
     QVector<Token> tokens;
@@ -29,9 +39,12 @@ private:
     QVector<SemanticError> errors;
     QVector<SemanticError> warnings;
     QVector<Symbol> discoveredSymbols;
+    QVector<Symbol> externalSymbols;     // globals declared before the tokens
+    QVector<EnvironmentSnapshot> snapshots;   // one per statement, in token order
 
     // Private methods
     void analyzeStatement();
+    void recordSnapshot();
     void analyzeDeclaration();
     void analyzeAssignment();
     void analyzeExpression();
@@ -40,7 +53,6 @@ private:
     SymbolType inferType(const Token& token);
     bool isTypeCompatible(SymbolType expected, SymbolType actual);
     bool isFunctionDeclaration() const;
-    bool isTypeKeyword(const QString& keyword) const;
 
     // Token navigation methods
     Token peek() const;
@@ -61,7 +73,12 @@ public:
 
     void setTokens(const QVector<Token>& toks);
     void reset();
-    bool analyzeProgram();
+    bool analyzeProgram(bool reportUninitialized = true);
+    // Same result as analyzeProgram, top-level declarations analyzed on workerCount threads (0 = per core)
+    bool analyzeProgramParallel(int workerCount = 0);
+    void setExternalSymbols(const QVector<Symbol>& symbols) { externalSymbols = symbols; }
+
+    static bool isTypeKeyword(const QString& keyword);
 
     // ADD THESE PUBLIC METHODS
     SymbolTable* getSymbolTable() const { return symbolTable; }
@@ -69,6 +86,11 @@ public:
     bool hasErrors() const { return !errors.isEmpty(); }
     QVector<SemanticError> getErrors() const { return errors; }
     QVector<SemanticError> getWarnings() const { return warnings; }
+
+    // What is visible at a program point, in O(log n), e.g. for hover
+    QVector<EnvironmentSnapshot> getSnapshots() const { return snapshots; }
+    SymbolEnvironment environmentAt(int tokenIndex) const;
+    SymbolEnvironment environmentAtLine(int line) const;
 };
 
 #endif // SEMANTICANALYZER_H
@@ -0,0 +1,23 @@
+#ifndef XORSHIFT32_H
+#define XORSHIFT32_H
+
+#include <QtGlobal>
+
+// xorshift32 generator for benchmark inputs: deterministic across runs and
+// platforms, unlike qrand() or std:: distributions. A zero seed becomes 1.
+class Xorshift32 {
+public:
+    explicit Xorshift32(quint32 seed = 12345) : state(seed ? seed : 1) {}
+
+    quint32 next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+private:
+    quint32 state;
+};
+
+#endif // XORSHIFT32_H
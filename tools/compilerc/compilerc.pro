@@ -0,0 +1,57 @@
+# Headless compiler pipeline with a --watch incremental build mode
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = compilerc
+TEMPLATE = app
+
+ROOTDIR = $$PWD/../..
+SRCDIR = $$ROOTDIR/src
+
+SOURCES += \
+    $$PWD/main.cpp \
+    $$SRCDIR/utils/Build/FileWatcher.cpp \
+    $$SRCDIR/utils/Build/IncrementalBuilder.cpp \
+    $$SRCDIR/models/Automaton/Automaton.cpp \
+    $$SRCDIR/models/Automaton/AutomatonLayout.cpp \
+    $$SRCDIR/models/Automaton/State.cpp \
+    $$SRCDIR/models/Automaton/Transition.cpp \
+    $$SRCDIR/models/Grammar/Grammar.cpp \
+    $$SRCDIR/models/Grammar/ParseTree.cpp \
+    $$SRCDIR/models/Grammar/Production.cpp \
+    $$SRCDIR/models/LexicalAnalysis/Token.cpp \
+    $$SRCDIR/models/Semantic/SymbolEnvironment.cpp \
+    $$SRCDIR/models/Semantic/SymbolTable.cpp \
+    $$SRCDIR/utils/Automaton/AutomatonRegistry.cpp \
+    $$SRCDIR/utils/Automaton/CompiledDFA.cpp \
+    $$SRCDIR/utils/Automaton/CompressedTable.cpp \
+    $$SRCDIR/utils/Automaton/ShuffleTable.cpp \
+    $$SRCDIR/utils/Automaton/DFACanonicalizer.cpp \
+    $$SRCDIR/utils/Automaton/DFAMinimizer.cpp \
+    $$SRCDIR/utils/Automaton/GlushkovAutomaton.cpp \
+    $$SRCDIR/utils/Automaton/NFAtoDFA.cpp \
+    $$SRCDIR/utils/Automaton/RegexParser.cpp \
+    $$SRCDIR/utils/Automaton/StateLayout.cpp \
+    $$SRCDIR/utils/Grammar/AdaptiveParser.cpp \
+    $$SRCDIR/utils/Grammar/GrammarAnalyzer.cpp \
+    $$SRCDIR/utils/Grammar/ParserGenerator.cpp \
+    $$SRCDIR/utils/Grammar/TerminalBinding.cpp \
+    $$SRCDIR/utils/LexicalAnalysis/AutomatonManager.cpp \
+    $$SRCDIR/utils/LexicalAnalysis/Lexer.cpp \
+    $$SRCDIR/utils/Semantic/CodeGenerator.cpp \
+    $$SRCDIR/utils/Semantic/LoopVectorizer.cpp \
+    $$SRCDIR/utils/Semantic/InstructionScheduler.cpp \
+    $$SRCDIR/utils/Semantic/ProgramProfile.cpp \
+    $$SRCDIR/utils/Semantic/ParallelFrontEnd.cpp \
+    $$SRCDIR/utils/Semantic/SemanticAnalyzer.cpp
+
+HEADERS += \
+    $$SRCDIR/utils/Build/FileWatcher.h \
+    $$SRCDIR/utils/Build/IncrementalBuilder.h
+
+INCLUDEPATH += \
+    $$ROOTDIR \
+    $$SRCDIR \
+    $$SRCDIR/utils
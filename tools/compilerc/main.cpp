@@ -0,0 +1,124 @@
+#include "./src/utils/Build/IncrementalBuilder.h"
+#include "./src/utils/Build/FileWatcher.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <cstdio>
+
+// compilerc [--target python|java|javascript|assembly] [-O0|-O1|-O2] [--tune skylake|zen2]
+//           [--profile-generate | --profile-use <file>] [--out <dir>] [--watch] <file>...
+// .rules files define token automata, .grammar files are compiled to parsers,
+// anything else is a source file translated to the target language. Outputs
+// mirror the input directories below the deepest one shared by all inputs.
+// -O1 list-schedules the assembly output for the --tune core, -O2 also renames
+// registers inside each block. With --watch the pipeline stays resident and
+// rebuilds on every save.
+//
+// Profile-guided assembly, one training run per profile:
+//   compilerc --target assembly --profile-generate --out build prog.cpp
+//   nasm -f elf32 build/prog.s && ld -m elf_i386 build/prog.o -o prog && ./prog
+//   compilerc --target assembly --profile-use build/prog.prof -O2 --out build prog.cpp
+// The instrumented program writes build/prog.prof on exit. --profile-use takes
+// one profile and may be repeated; profiles of the same program are summed,
+// profiles of other programs are ignored.
+static void usage() {
+    fprintf(stderr, "usage: compilerc [--target python|java|javascript|assembly] [-O0|-O1|-O2] "
+                    "[--tune skylake|zen2] [--profile-generate | --profile-use <file>] "
+                    "[--out <dir>] [--watch] <file>...\n");
+}
+
+static void printReport(const BuildReport& report) {
+    for (const QString& diagnostic : report.diagnostics) {
+        fprintf(stderr, "%s\n", qPrintable(diagnostic));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    IncrementalBuilder builder;
+    bool watch = false;
+    int inputs = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        QString arg = QString::fromLocal8Bit(argv[i]);
+        if (arg == "--watch") {
+            watch = true;
+        } else if (arg == "--out" && i + 1 < argc) {
+            builder.setOutputDirectory(QString::fromLocal8Bit(argv[++i]));
+        } else if (arg == "--target" && i + 1 < argc) {
+            QString target = QString(argv[++i]).toLower();
+            if (target == "python") builder.setTargetLanguage(TargetLanguage::PYTHON);
+            else if (target == "java") builder.setTargetLanguage(TargetLanguage::JAVA);
+            else if (target == "javascript") builder.setTargetLanguage(TargetLanguage::JAVASCRIPT);
+            else if (target == "assembly") builder.setTargetLanguage(TargetLanguage::ASSEMBLY);
+            else {
+                usage();
+                return 2;
+            }
+        } else if (arg == "--profile-generate") {
+            builder.setProfileGenerate(true);
+        } else if (arg == "--profile-use" && i + 1 < argc) {
+            ProgramProfile profile;
+            QString error;
+            if (!profile.load(QString::fromLocal8Bit(argv[++i]), &error)) {
+                fprintf(stderr, "%s\n", qPrintable(error));
+                return 1;
+            }
+            builder.addProfile(profile);
+        } else if (arg == "-O0" || arg == "-O1" || arg == "-O2") {
+            builder.setOptimizationLevel(arg.mid(2).toInt());
+        } else if (arg == "--tune" && i + 1 < argc) {
+            QString core = QString(argv[++i]).toLower();
+            if (core == "skylake") builder.setTuneCore(CoreModel::SKYLAKE);
+            else if (core == "zen2") builder.setTuneCore(CoreModel::ZEN2);
+            else {
+                usage();
+                return 2;
+            }
+        } else if (arg.startsWith("-")) {
+            usage();
+            return 2;
+        } else {
+            QString suffix = QFileInfo(arg).suffix();
+            if (suffix == "rules") builder.addRulesFile(arg);
+            else if (suffix == "grammar") builder.addGrammarFile(arg);
+            else builder.addSourceFile(arg);
+            inputs++;
+        }
+    }
+    if (inputs == 0) {
+        usage();
+        return 2;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    BuildReport report = builder.buildAll();
+    printReport(report);
+    fprintf(stderr, "built %d file(s) in %lld ms\n", inputs, static_cast<long long>(timer.elapsed()));
+    if (!watch) {
+        return report.errors > 0 ? 1 : 0;
+    }
+
+    FileWatcher watcher;
+    for (const QString& path : builder.getInputs()) {
+        QString error;
+        if (!watcher.addPath(path, &error)) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "watching %d file(s)\n", builder.getInputs().size());
+    for (;;) {
+        QStringList changed = watcher.waitForChanges();
+        if (changed.isEmpty()) {
+            return 1;   // watcher failed
+        }
+
+        timer.restart();
+        report = builder.build(changed);
+        printReport(report);
+        fprintf(stderr, "%d changed: lexed %d, analyzed %d, generated %d, grammars %d, wrote %d in %.2f ms\n",
+                changed.size(), report.lexed, report.analyzed, report.generated, report.grammars,
+                report.written, timer.nsecsElapsed() / 1e6);
+    }
+}
@@ -0,0 +1,78 @@
+# Parity check of the parallel front end against the sequential one
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = frontendcheck
+TEMPLATE = app
+
+ROOTDIR = $$PWD/../..
+SRCDIR = $$ROOTDIR/src
+
+SOURCES += \
+    $$PWD/main.cpp \
+    $$SRCDIR/models/Automaton/Automaton.cpp \
+    $$SRCDIR/models/Automaton/AutomatonLayout.cpp \
+    $$SRCDIR/models/Automaton/State.cpp \
+    $$SRCDIR/models/Automaton/Transition.cpp \
+    $$SRCDIR/models/Grammar/Grammar.cpp \
+    $$SRCDIR/models/Grammar/ParseTree.cpp \
+    $$SRCDIR/models/Grammar/Production.cpp \
+    $$SRCDIR/models/LexicalAnalysis/Token.cpp \
+    $$SRCDIR/models/Semantic/SymbolEnvironment.cpp \
+    $$SRCDIR/models/Semantic/SymbolTable.cpp \
+    $$SRCDIR/utils/Automaton/AutomatonRegistry.cpp \
+    $$SRCDIR/utils/Automaton/CompiledDFA.cpp \
+    $$SRCDIR/utils/Automaton/CompressedTable.cpp \
+    $$SRCDIR/utils/Automaton/ShuffleTable.cpp \
+    $$SRCDIR/utils/Automaton/DFACanonicalizer.cpp \
+    $$SRCDIR/utils/Automaton/DFAMinimizer.cpp \
+    $$SRCDIR/utils/Automaton/GlushkovAutomaton.cpp \
+    $$SRCDIR/utils/Automaton/NFAtoDFA.cpp \
+    $$SRCDIR/utils/Automaton/RegexParser.cpp \
+    $$SRCDIR/utils/Automaton/StateLayout.cpp \
+    $$SRCDIR/utils/Grammar/AdaptiveParser.cpp \
+    $$SRCDIR/utils/Grammar/GrammarAnalyzer.cpp \
+    $$SRCDIR/utils/Grammar/Parser.cpp \
+    $$SRCDIR/utils/Grammar/ParserGenerator.cpp \
+    $$SRCDIR/utils/Grammar/TerminalBinding.cpp \
+    $$SRCDIR/utils/LexicalAnalysis/AutomatonManager.cpp \
+    $$SRCDIR/utils/LexicalAnalysis/Lexer.cpp \
+    $$SRCDIR/utils/Semantic/ParallelFrontEnd.cpp \
+    $$SRCDIR/utils/Semantic/SemanticAnalyzer.cpp
+
+INCLUDEPATH += \
+    $$ROOTDIR \
+    $$SRCDIR \
+    $$SRCDIR/utils
+
+# Parser falls back to the generated expression parser; built as in CompilerProject.pro
+GRAMMAR2CPP_DIR = $$OUT_PWD/grammar2cpp
+win32: GRAMMAR2CPP = $$GRAMMAR2CPP_DIR/release/grammar2cpp.exe
+else: GRAMMAR2CPP = $$GRAMMAR2CPP_DIR/grammar2cpp
+
+grammar2cpp.target = $$GRAMMAR2CPP
+grammar2cpp.commands = $$QMAKE_MKDIR $$shell_path($$GRAMMAR2CPP_DIR) $$escape_expand(\\n\\t) \
+    cd $$shell_path($$GRAMMAR2CPP_DIR) && $$QMAKE_QMAKE $$shell_path($$ROOTDIR/tools/grammar2cpp/grammar2cpp.pro) && $(MAKE)
+QMAKE_EXTRA_TARGETS += grammar2cpp
+
+GRAMMARS += \
+    $$SRCDIR/grammars/Expression.grammar
+
+grammar_header.input = GRAMMARS
+grammar_header.output = $$OUT_PWD/generated/${QMAKE_FILE_BASE}Parser.h
+grammar_header.commands = $$GRAMMAR2CPP --header ${QMAKE_FILE_NAME} ${QMAKE_FILE_OUT}
+grammar_header.depends = $$GRAMMAR2CPP
+grammar_header.variable_out = HEADERS
+grammar_header.CONFIG += target_predeps no_link
+QMAKE_EXTRA_COMPILERS += grammar_header
+
+grammar_source.input = GRAMMARS
+grammar_source.output = $$OUT_PWD/generated/${QMAKE_FILE_BASE}Parser.cpp
+grammar_source.commands = $$GRAMMAR2CPP --source ${QMAKE_FILE_NAME} ${QMAKE_FILE_OUT}
+grammar_source.depends = $$GRAMMAR2CPP
+grammar_source.variable_out = GENERATED_SOURCES
+QMAKE_EXTRA_COMPILERS += grammar_source
+
+INCLUDEPATH += $$OUT_PWD/generated
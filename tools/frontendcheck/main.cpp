@@ -0,0 +1,320 @@
+#include "./src/utils/Grammar/Parser.h"
+#include "./src/utils/Grammar/ParserGenerator.h"
+#include "./src/utils/LexicalAnalysis/AutomatonManager.h"
+#include "./src/utils/LexicalAnalysis/Lexer.h"
+#include "./src/utils/Semantic/ParallelFrontEnd.h"
+#include "./src/utils/Semantic/SemanticAnalyzer.h"
+#include <QFile>
+#include <QMap>
+#include <QStringList>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+// frontendcheck [--workers N] [--grammar <file>] [<source>...]
+// Parses and analyzes every source twice, sequentially and through
+// ParallelFrontEnd, and exits with 1 when the two disagree on the parse tree,
+// the diagnostics, the discovered symbols or the environment snapshots. It
+// also checks SymbolEnvironment against a QMap model. Without sources the built-in
+// fixtures are checked against the built-in declaration grammar; each of them
+// must also be split, except the one with a syntax error, which must fall
+// back to the sequential parse.
+static void usage() {
+    fprintf(stderr, "usage: frontendcheck [--workers N] [--grammar <file>] [<source>...]\n");
+}
+
+// LL(1), and its start rule is a list of top-level declarations
+static const char* declarationGrammar =
+    "%name Declarations\n"
+    "%start Program\n"
+    "Program -> Decl Program\n"
+    "Program -> ε\n"
+    "Decl -> Type id DeclTail\n"
+    "DeclTail -> ;\n"
+    "DeclTail -> = Expr ;\n"
+    "DeclTail -> ( Params ) Block\n"
+    "Type -> int\n"
+    "Type -> float\n"
+    "Params -> Type id ParamRest\n"
+    "Params -> ε\n"
+    "ParamRest -> , Type id ParamRest\n"
+    "ParamRest -> ε\n"
+    "Block -> { Stmts }\n"
+    "Stmts -> Stmt Stmts\n"
+    "Stmts -> ε\n"
+    "Stmt -> Type id DeclTail\n"
+    "Stmt -> id = Expr ;\n"
+    "Stmt -> if ( Expr ) Block Else\n"
+    "Stmt -> while ( Expr ) Block\n"
+    "Stmt -> return Expr ;\n"
+    "Else -> else Block\n"
+    "Else -> ε\n"
+    "Expr -> Sum Compare\n"
+    "Compare -> < Sum\n"
+    "Compare -> > Sum\n"
+    "Compare -> ε\n"
+    "Sum -> Term SumRest\n"
+    "SumRest -> + Term SumRest\n"
+    "SumRest -> - Term SumRest\n"
+    "SumRest -> ε\n"
+    "Term -> Factor TermRest\n"
+    "TermRest -> * Factor TermRest\n"
+    "TermRest -> ε\n"
+    "Factor -> ( Expr )\n"
+    "Factor -> id\n"
+    "Factor -> num\n";
+
+namespace {
+
+struct Fixture {
+    const char* name;
+    const char* source;
+    bool splits;        // ParallelFrontEnd::parse must accept it
+};
+
+const Fixture fixtures[] = {
+    { "globals",
+      "int width = 640;\n"
+      "int height = 480;\n"
+      "float scale;\n"
+      "int area = width * height;\n",
+      true },
+    { "functions",
+      "int total = 0;\n"
+      "int square(int x) {\n"
+      "    return x * x;\n"
+      "}\n"
+      "int sum(int n) {\n"
+      "    int i = 0;\n"
+      "    while (i < n) {\n"
+      "        total = total + i * i;\n"
+      "        i = i + 1;\n"
+      "    }\n"
+      "    return total;\n"
+      "}\n",
+      true },
+    { "same local in two functions",
+      "int first() {\n"
+      "    int value;\n"
+      "    return 1;\n"
+      "}\n"
+      "int second() {\n"
+      "    int value;\n"
+      "    value = 2;\n"
+      "    if (value > 1) {\n"
+      "        value = value - 1;\n"
+      "    } else {\n"
+      "        value = 0;\n"
+      "    }\n"
+      "    return value;\n"
+      "}\n",
+      true },
+    { "semantic errors",
+      "int a = 1;\n"
+      "int f() {\n"
+      "    b = a + 1;\n"
+      "    return b;\n"
+      "}\n"
+      "int a = 2;\n"
+      "int g() {\n"
+      "    a = 3;\n"
+      "    return a;\n"
+      "}\n",
+      true },
+    { "syntax error",
+      "int a = 1;\n"
+      "int b = ;\n"
+      "int c = a + 2;\n",
+      false },
+};
+
+struct Options {
+    int workers = 4;
+    QString grammarPath;
+    QStringList sources;
+};
+
+QString symbolsText(const QVector<Symbol>& symbols) {
+    QStringList lines;
+    for (const Symbol& symbol : symbols) {
+        lines << QString("%1 %2 scope %3 line %4 = %5%6")
+                     .arg(symbol.name).arg(symbol.getTypeString()).arg(symbol.scope).arg(symbol.line)
+                     .arg(symbol.value).arg(symbol.isInitialized ? "" : " (uninitialized)");
+    }
+    return lines.join("\n");
+}
+
+// Names, scopes and types visible at each statement. Values are left out:
+// a batch does not know what earlier batches assigned to their globals.
+QString snapshotsText(const QVector<EnvironmentSnapshot>& snapshots) {
+    QStringList lines;
+    for (const EnvironmentSnapshot& snapshot : snapshots) {
+        QStringList visible;
+        for (const Symbol& symbol : snapshot.environment.symbols()) {
+            visible << QString("%1:%2:%3").arg(symbol.name).arg(symbol.scope).arg(symbol.getTypeString());
+        }
+        std::sort(visible.begin(), visible.end());
+        lines << QString("token %1 line %2: %3").arg(snapshot.tokenIndex).arg(snapshot.line).arg(visible.join(" "));
+    }
+    return lines.join("\n");
+}
+
+// Random inserts into a chain of versions; every retained version must still
+// hold what the model held when it was made
+bool checkEnvironmentModel() {
+    std::mt19937 random(12345);
+    SymbolEnvironment environment;
+    QMap<QString, Symbol> model;
+    QVector<SymbolEnvironment> versions;
+    QVector<QMap<QString, Symbol>> models;
+
+    for (int i = 0; i < 20000; ++i) {
+        Symbol symbol(QString("v%1").arg(random() % 5000), SymbolType::INTEGER, random() % 4, i);
+        environment = environment.insert(symbol);
+        model.insert(symbol.name, symbol);
+        if (i % 97 == 0) {
+            versions.append(environment);
+            models.append(model);
+        }
+    }
+
+    for (int v = 0; v < versions.size(); ++v) {
+        const QMap<QString, Symbol>& expected = models[v];
+        if (versions[v].size() != expected.size()) {
+            fprintf(stderr, "environment version %d: %d symbols, expected %d\n", v, versions[v].size(), expected.size());
+            return false;
+        }
+        for (auto it = expected.constBegin(); it != expected.constEnd(); ++it) {
+            const Symbol* found = versions[v].lookup(it.key());
+            if (!found || found->line != it.value().line || found->scope != it.value().scope) {
+                fprintf(stderr, "environment version %d: wrong entry for %s\n", v, qPrintable(it.key()));
+                return false;
+            }
+        }
+    }
+    printf("environment: %d versions match the model\n", versions.size());
+    return true;
+}
+
+QString diagnosticsText(const QVector<SemanticError>& diagnostics) {
+    QStringList lines;
+    for (const SemanticError& diagnostic : diagnostics) {
+        lines << diagnostic.type + " " + diagnostic.toString();
+    }
+    return lines.join("\n");
+}
+
+bool same(const QString& name, const QString& what, const QString& sequential, const QString& parallel) {
+    if (sequential == parallel) return true;
+    fprintf(stderr, "%s: %s differ\n--- sequential\n%s\n--- parallel\n%s\n", qPrintable(name), qPrintable(what),
+            qPrintable(sequential), qPrintable(parallel));
+    return false;
+}
+
+// Returns false on a mismatch; splitRequired is -1 when either outcome is fine
+bool check(const QString& name, const QString& source, Lexer& lexer, Grammar& grammar,
+           const Options& options, int splitRequired) {
+    lexer.reset();
+    if (!lexer.tokenize(source)) {
+        fprintf(stderr, "%s: %s\n", qPrintable(name), qPrintable(lexer.getErrorsString()));
+        return false;
+    }
+    QVector<Token> tokens = lexer.getTokens();
+    bool ok = true;
+
+    // Parser::parse splits inputs this large itself
+    if (tokens.size() < Parser::ParallelParseTokens) {
+        Parser parser(&grammar);
+        parser.setTokens(tokens);
+        ParseTree sequential = parser.parse();
+
+        ParseTree parallel;
+        bool split = ParallelFrontEnd(options.workers).parse(tokens, grammar, &parallel);
+        if (split) {
+            ok &= same(name, "parse trees", sequential.toString(), parallel.toString());
+            if (parser.hasErrors()) {
+                fprintf(stderr, "%s: split although the sequential parse failed\n", qPrintable(name));
+                ok = false;
+            }
+        }
+        if (splitRequired >= 0 && split != (splitRequired != 0)) {
+            fprintf(stderr, "%s: expected the parse %s\n", qPrintable(name),
+                    splitRequired ? "to be split" : "to fall back");
+            ok = false;
+        }
+        printf("%s: %d tokens, parse %s\n", qPrintable(name), tokens.size(), split ? "split" : "sequential");
+    } else {
+        printf("%s: %d tokens, parse skipped\n", qPrintable(name), tokens.size());
+    }
+
+    SemanticAnalyzer sequential;
+    sequential.setTokens(tokens);
+    sequential.analyzeProgram();
+    SemanticAnalyzer parallel;
+    parallel.setTokens(tokens);
+    parallel.analyzeProgramParallel(options.workers);
+
+    ok &= same(name, "errors", diagnosticsText(sequential.getErrors()), diagnosticsText(parallel.getErrors()));
+    ok &= same(name, "warnings", diagnosticsText(sequential.getWarnings()), diagnosticsText(parallel.getWarnings()));
+    ok &= same(name, "symbols", symbolsText(sequential.getSymbolTable()->getDiscoveredSymbols()),
+               symbolsText(parallel.getSymbolTable()->getDiscoveredSymbols()));
+    ok &= same(name, "snapshots", snapshotsText(sequential.getSnapshots()), snapshotsText(parallel.getSnapshots()));
+    return ok;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        QString arg = QString::fromLocal8Bit(argv[i]);
+        if (arg == "--workers" && i + 1 < argc) {
+            options.workers = QString(argv[++i]).toInt();
+        } else if (arg == "--grammar" && i + 1 < argc) {
+            options.grammarPath = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg.startsWith("-")) {
+            usage();
+            return 2;
+        } else {
+            options.sources << arg;
+        }
+    }
+    if (options.workers < 2) {
+        usage();
+        return 2;
+    }
+
+    Grammar grammar;
+    QString error;
+    bool loaded = options.grammarPath.isEmpty()
+                      ? ParserGenerator::parseGrammarText(QString::fromUtf8(declarationGrammar), grammar, &error)
+                      : ParserGenerator::readGrammarFile(options.grammarPath, grammar, &error);
+    if (!loaded) {
+        fprintf(stderr, "%s\n", qPrintable(error));
+        return 1;
+    }
+
+    AutomatonManager automatonManager;
+    Lexer lexer(&automatonManager);
+    lexer.setSkipWhitespace(true);
+    lexer.setSkipComments(true);
+
+    bool ok = checkEnvironmentModel();
+    if (options.sources.isEmpty()) {
+        for (const Fixture& fixture : fixtures) {
+            ok &= check(fixture.name, QString::fromUtf8(fixture.source), lexer, grammar, options,
+                        options.grammarPath.isEmpty() ? fixture.splits : -1);
+        }
+    }
+    for (const QString& path : options.sources) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "Cannot open %s\n", qPrintable(path));
+            return 1;
+        }
+        ok &= check(path, QString::fromUtf8(file.readAll()), lexer, grammar, options, -1);
+    }
+
+    printf("%s\n", ok ? "sequential and parallel results match" : "MISMATCH");
+    return ok ? 0 : 1;
+}
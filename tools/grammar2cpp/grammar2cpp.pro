@@ -0,0 +1,32 @@
+# Build-time generator of direct-coded parsers; run by CompilerProject.pro
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = grammar2cpp
+TEMPLATE = app
+
+ROOTDIR = $$PWD/../..
+SRCDIR = $$ROOTDIR/src
+
+SOURCES += \
+    $$PWD/main.cpp \
+    $$SRCDIR/models/Grammar/Grammar.cpp \
+    $$SRCDIR/models/Grammar/Production.cpp \
+    $$SRCDIR/models/LexicalAnalysis/Token.cpp \
+    $$SRCDIR/utils/Grammar/GrammarAnalyzer.cpp \
+    $$SRCDIR/utils/Grammar/ParserGenerator.cpp \
+    $$SRCDIR/utils/Grammar/TerminalBinding.cpp
+
+HEADERS += \
+    $$SRCDIR/models/Grammar/Grammar.h \
+    $$SRCDIR/models/Grammar/Production.h \
+    $$SRCDIR/models/LexicalAnalysis/Token.h \
+    $$SRCDIR/utils/Grammar/GrammarAnalyzer.h \
+    $$SRCDIR/utils/Grammar/ParserGenerator.h \
+    $$SRCDIR/utils/Grammar/TerminalBinding.h
+
+INCLUDEPATH += \
+    $$ROOTDIR \
+    $$SRCDIR
@@ -0,0 +1,45 @@
+#include "./src/utils/Grammar/ParserGenerator.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <cstdio>
+
+// grammar2cpp --header|--source <input.grammar> <output>
+// The generated class is named after the output file, e.g. ExpressionParser.h -> ExpressionParser.
+int main(int argc, char *argv[]) {
+    if (argc != 4 || (QString(argv[1]) != "--header" && QString(argv[1]) != "--source")) {
+        fprintf(stderr, "usage: grammar2cpp --header|--source <input.grammar> <output>\n");
+        return 2;
+    }
+
+    QString mode = argv[1];
+    QString inputPath = QString::fromLocal8Bit(argv[2]);
+    QString outputPath = QString::fromLocal8Bit(argv[3]);
+
+    Grammar grammar;
+    QString error;
+    if (!ParserGenerator::readGrammarFile(inputPath, grammar, &error)) {
+        fprintf(stderr, "%s: %s\n", qPrintable(inputPath), qPrintable(error));
+        return 1;
+    }
+
+    QFileInfo outputInfo(outputPath);
+    ParserGenerator generator(grammar, outputInfo.completeBaseName());
+    if (!generator.validate(&error)) {
+        fprintf(stderr, "%s: %s\n", qPrintable(inputPath), qPrintable(error));
+        return 1;
+    }
+
+    QString code = mode == "--header"
+                       ? generator.generateHeader()
+                       : generator.generateSource(outputInfo.completeBaseName() + ".h");
+
+    QDir().mkpath(outputInfo.absolutePath());
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        fprintf(stderr, "%s: cannot write\n", qPrintable(outputPath));
+        return 1;
+    }
+    output.write(code.toUtf8());
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include "./src/utils/Semantic/MLTranslationBridge.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+
+// mlload [--url <server>] [--clients N] [--requests N] [--timeout ms]
+//        [--health-interval ms] [--target <language>] [--distinct N] [--source <file>]
+// Drives MLTranslationBridge from N concurrent clients, each with one request
+// in flight, until --requests translations have been attempted, then reports
+// latency percentiles, errors, timeouts and throughput.
+//
+// Offline, against the deterministic stand-in server:
+//   python src/ml_translator/stand_in_server.py --port 5001 --latency lognormal:80,0.4 \
+//       --workers 2 --batch-size 8 --batch-window-ms 10 --cache --error-rate 0.01
+//   mlload --url http://127.0.0.1:5001 --clients 16 --requests 2000 --distinct 50
+// --distinct varies the source text so a server-side cache sees that many
+// different programs; the server's /stats counters are printed when present.
+static void usage() {
+    fprintf(stderr, "usage: mlload [--url <server>] [--clients N] [--requests N] [--timeout ms] "
+                    "[--health-interval ms] [--target <language>] [--distinct N] [--source <file>]\n");
+}
+
+static const char* defaultSource =
+    "int main() {\n"
+    "    int total = 0;\n"
+    "    int i = 0;\n"
+    "    while (i < 10) {\n"
+    "        total = total + i * i;\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    return total;\n"
+    "}\n";
+
+namespace {
+
+struct LoadOptions {
+    QString url = "http://localhost:5000";
+    int clients = 8;
+    int requests = 200;
+    int timeout = 30000;
+    int healthInterval = 5000;
+    int distinct = 1;
+    QString target = "python";
+    QString source = defaultSource;
+};
+
+struct LoadClient {
+    MLTranslationBridge* bridge = nullptr;
+    QElapsedTimer started;
+    bool timedOut = false;
+};
+
+class LoadDriver : public QObject {
+public:
+    explicit LoadDriver(const LoadOptions& options)
+        : options(options), issued(0), finished(0), succeeded(0), failed(0), timeouts(0) {
+        for (int i = 0; i < options.clients; ++i) {
+            LoadClient* client = new LoadClient;
+            client->bridge = new MLTranslationBridge(this);
+            client->bridge->setServerUrl(options.url);
+            client->bridge->setRequestTimeout(options.timeout);
+            client->bridge->setHealthCheckInterval(options.healthInterval);
+
+            connect(client->bridge, &MLTranslationBridge::translationCompleted, this, [this, client](const QString&) {
+                succeeded++;
+                complete(client);
+            });
+            connect(client->bridge, &MLTranslationBridge::requestTimedOut, this, [client]() {
+                client->timedOut = true;
+            });
+            connect(client->bridge, &MLTranslationBridge::translationError, this, [this, client](const QString& error) {
+                if (client->timedOut) {
+                    timeouts++;
+                } else {
+                    failed++;
+                    errorCounts[error]++;
+                }
+                complete(client);
+            });
+            clients.append(client);
+        }
+    }
+
+    ~LoadDriver() override {
+        qDeleteAll(clients);
+    }
+
+    void start() {
+        wallClock.start();
+        for (LoadClient* client : clients) {
+            issue(client);
+        }
+    }
+
+    void report() const {
+        QVector<double> sorted = latencies;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) {
+            if (sorted.isEmpty()) return 0.0;
+            int index = qBound(0, int(p * sorted.size() + 0.5) - 1, sorted.size() - 1);
+            return sorted[index];
+        };
+        double mean = 0.0;
+        for (double latency : sorted) {
+            mean += latency;
+        }
+        mean = sorted.isEmpty() ? 0.0 : mean / sorted.size();
+        double seconds = wallClock.nsecsElapsed() / 1e9;
+
+        printf("%d requests from %d clients in %.2f s: %d ok, %d errors, %d timeouts\n",
+               finished, clients.size(), seconds, succeeded, failed, timeouts);
+        printf("throughput %.1f requests/s (%.1f ok/s)\n",
+               seconds > 0 ? finished / seconds : 0.0, seconds > 0 ? succeeded / seconds : 0.0);
+        printf("latency ms: mean %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+               mean, percentile(0.50), percentile(0.90), percentile(0.99),
+               sorted.isEmpty() ? 0.0 : sorted.last());
+        for (auto it = errorCounts.constBegin(); it != errorCounts.constEnd(); ++it) {
+            printf("  %5d x %s\n", it.value(), qPrintable(it.key()));
+        }
+    }
+
+private:
+    LoadOptions options;
+    QVector<LoadClient*> clients;
+    QVector<double> latencies;       // ms, every finished request including failures
+    QHash<QString, int> errorCounts;
+    QElapsedTimer wallClock;
+    int issued;
+    int finished;
+    int succeeded;
+    int failed;
+    int timeouts;
+
+    void issue(LoadClient* client) {
+        if (issued >= options.requests) {
+            return;
+        }
+        int variant = issued++ % qMax(1, options.distinct);
+        QString source = options.distinct > 1
+            ? QString("// variant %1\n%2").arg(QString::number(variant), options.source)
+            : options.source;
+
+        client->timedOut = false;
+        client->started.start();
+        client->bridge->translateCode(source, options.target, QVector<Token>());
+    }
+
+    void complete(LoadClient* client) {
+        latencies.append(client->started.nsecsElapsed() / 1e6);
+        if (++finished >= options.requests) {
+            QCoreApplication::quit();
+            return;
+        }
+        // Not from inside the bridge's signal, whose reply is still being finished
+        QTimer::singleShot(0, this, [this, client]() { issue(client); });
+    }
+};
+
+// Counters exposed by the stand-in server; a real server has no /stats
+void printServerStats(const QString& url) {
+    QNetworkAccessManager network;
+    QNetworkReply* reply = network.get(QNetworkRequest(QUrl(url + "/stats")));
+    QEventLoop loop;
+    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    QTimer::singleShot(2000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    if (reply->isFinished() && reply->error() == QNetworkReply::NoError) {
+        QJsonObject stats = QJsonDocument::fromJson(reply->readAll()).object();
+        if (!stats.isEmpty()) {
+            printf("server: %s\n", QJsonDocument(stats).toJson(QJsonDocument::Compact).constData());
+        }
+    }
+    reply->abort();
+    delete reply;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("default.debug=false");    // the bridge logs every status change
+    LoadOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        QString arg = QString::fromLocal8Bit(argv[i]);
+        bool ok = true;
+        if (arg == "--url" && i + 1 < argc) {
+            options.url = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg == "--clients" && i + 1 < argc) {
+            options.clients = QString(argv[++i]).toInt(&ok);
+            ok = ok && options.clients > 0;
+        } else if (arg == "--requests" && i + 1 < argc) {
+            options.requests = QString(argv[++i]).toInt(&ok);
+            ok = ok && options.requests > 0;
+        } else if (arg == "--timeout" && i + 1 < argc) {
+            options.timeout = QString(argv[++i]).toInt(&ok);
+        } else if (arg == "--health-interval" && i + 1 < argc) {
+            options.healthInterval = QString(argv[++i]).toInt(&ok);
+        } else if (arg == "--distinct" && i + 1 < argc) {
+            options.distinct = QString(argv[++i]).toInt(&ok);
+        } else if (arg == "--target" && i + 1 < argc) {
+            options.target = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg == "--source" && i + 1 < argc) {
+            QFile file(QString::fromLocal8Bit(argv[++i]));
+            if (!file.open(QIODevice::ReadOnly)) {
+                fprintf(stderr, "cannot open %s\n", qPrintable(file.fileName()));
+                return 1;
+            }
+            options.source = QString::fromUtf8(file.readAll());
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage();
+            return 2;
+        }
+    }
+
+    LoadDriver driver(options);
+    driver.start();
+    app.exec();
+
+    driver.report();
+    printServerStats(options.url);
+    return 0;
+}
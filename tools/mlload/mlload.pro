@@ -0,0 +1,25 @@
+# Load driver for MLTranslationBridge; pair with src/ml_translator/stand_in_server.py
+QT = core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = mlload
+TEMPLATE = app
+
+ROOTDIR = $$PWD/../..
+SRCDIR = $$ROOTDIR/src
+
+SOURCES += \
+    $$PWD/main.cpp \
+    $$SRCDIR/models/LexicalAnalysis/Token.cpp \
+    $$SRCDIR/utils/Semantic/MLTranslationBridge.cpp
+
+HEADERS += \
+    $$SRCDIR/models/LexicalAnalysis/Token.h \
+    $$SRCDIR/utils/Semantic/MLTranslationBridge.h
+
+INCLUDEPATH += \
+    $$ROOTDIR \
+    $$SRCDIR \
+    $$SRCDIR/utils